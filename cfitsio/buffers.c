@@ -9,6 +9,10 @@
 #include <stdlib.h>
 #include "fitsio2.h"
 
+/* size of the I/O buffer pool given to files when they are opened */
+static int pool_niobuf = NIOBUF;
+static int pool_nreadahead = 0;
+
 /*--------------------------------------------------------------------------*/
 int ffmbyt(fitsfile *fptr,    /* I - FITS file pointer                */
            LONGLONG bytepos,     /* I - byte position in file to move to */
@@ -98,7 +102,7 @@ int ffpbyt(fitsfile *fptr,   /* I - FITS file pointer                    */
         (fptr->Fptr)->dirty[nbuff] = TRUE;       /* mark record as having been modified */
       }
 
-      for (ii = 0; ii < NIOBUF; ii++) /* flush any affected buffers to disk */
+      for (ii = 0; ii < (fptr->Fptr)->niobuf; ii++) /* flush any affected buffers to disk */
       {
         if ((fptr->Fptr)->bufrecnum[ii] >= recstart
             && (fptr->Fptr)->bufrecnum[ii] <= recend )
@@ -307,7 +311,7 @@ int ffgbyt(fitsfile *fptr,    /* I - FITS file pointer             */
       recstart = (long) (filepos / IOBUFLEN);               /* starting record */
       recend = (long) ((filepos + nbytes - 1) / IOBUFLEN);  /* ending record   */
 
-      for (ii = 0; ii < NIOBUF; ii++) /* flush any affected buffers to disk */
+      for (ii = 0; ii < (fptr->Fptr)->niobuf; ii++) /* flush any affected buffers to disk */
       {
         if ((fptr->Fptr)->dirty[ii] && 
             (fptr->Fptr)->bufrecnum[ii] >= recstart && (fptr->Fptr)->bufrecnum[ii] <= recend)
@@ -482,10 +486,11 @@ int ffldrc(fitsfile *fptr,        /* I - FITS file pointer             */
     if (fptr->HDUposition != (fptr->Fptr)->curhdu)
         ffmahd(fptr, (fptr->HDUposition) + 1, NULL, status);
 
-    for (ibuff = NIOBUF - 1; ibuff >= 0; ibuff--)
+    for (ibuff = (fptr->Fptr)->niobuf - 1; ibuff >= 0; ibuff--)
     {
       nbuff = (fptr->Fptr)->ageindex[ibuff];
       if (record == (fptr->Fptr)->bufrecnum[nbuff]) {
+         (fptr->Fptr)->bufhits++;
          goto updatebuf;  /* use 'goto' for efficiency */
       }
     }
@@ -502,6 +507,8 @@ int ffldrc(fitsfile *fptr,        /* I - FITS file pointer             */
     if ((fptr->Fptr)->dirty[nbuff])
        ffbfwt(fptr->Fptr, nbuff, status); /* write dirty buffer to disk */
 
+    (fptr->Fptr)->bufmisses++;
+
     if (rstart >= (fptr->Fptr)->filesize)  /* EOF? */
     {
       /* initialize an empty buffer with the correct fill value */
@@ -515,6 +522,10 @@ int ffldrc(fitsfile *fptr,        /* I - FITS file pointer             */
 
       (fptr->Fptr)->dirty[nbuff] = TRUE;  /* mark record as having been modified */
     }
+    else if (ffldra(fptr->Fptr, record, nbuff, status))
+    {
+      /* record was copied from the read-ahead block */
+    }
     else  /* not EOF, so read record from disk */
     {
       if ((fptr->Fptr)->io_pos != rstart)
@@ -524,6 +535,7 @@ int ffldrc(fitsfile *fptr,        /* I - FITS file pointer             */
       (fptr->Fptr)->io_pos = rstart + IOBUFLEN;  /* set new IO position */
     }
 
+    (fptr->Fptr)->lastmiss = record;
     (fptr->Fptr)->bufrecnum[nbuff] = record;   /* record number contained in buffer */
 
 updatebuf:
@@ -533,16 +545,208 @@ updatebuf:
     if (ibuff < 0)
     { 
       /* find the current position of the buffer in the age index */
-      for (ibuff = 0; ibuff < NIOBUF; ibuff++)
+      for (ibuff = 0; ibuff < (fptr->Fptr)->niobuf; ibuff++)
          if ((fptr->Fptr)->ageindex[ibuff] == nbuff)
             break;  
     }
 
     /* increment the age of all the buffers that were younger than it */
-    for (ibuff++; ibuff < NIOBUF; ibuff++)
+    for (ibuff++; ibuff < (fptr->Fptr)->niobuf; ibuff++)
       (fptr->Fptr)->ageindex[ibuff - 1] = (fptr->Fptr)->ageindex[ibuff];
 
-    (fptr->Fptr)->ageindex[NIOBUF - 1] = nbuff; /* this is now the youngest buffer */
+    (fptr->Fptr)->ageindex[(fptr->Fptr)->niobuf - 1] = nbuff; /* this is now the youngest buffer */
+    return(*status);
+}
+/*--------------------------------------------------------------------------*/
+int ffldra(FITSfile *Fptr,        /* I - FITS file structure            */
+           long record,           /* I - record number to be loaded     */
+           int nbuff,             /* I - buffer to load the record into */
+           int *status)           /* IO - error status                  */
+{
+/*
+  Load a record into an I/O buffer from the read-ahead block, refilling
+  the block first if the record follows the previous miss.  Returns 1 if
+  the record was loaded, or 0 if it should be read from the file as usual.
+  Read-ahead is only done on files opened READONLY, so that the block can
+  never hold stale copies of records that have since been written.
+*/
+    long nrec;
+    int rastatus = 0;
+    LONGLONG rstart;
+
+    if (Fptr->nreadahead < 2 || Fptr->writemode != READONLY || *status > 0)
+        return(0);
+
+    if (record < Fptr->rarecnum || record >= Fptr->rarecnum + Fptr->ranrec)
+    {
+        /* only read ahead when the records are being read in sequence */
+        if (record != Fptr->lastmiss + 1)
+            return(0);
+
+        rstart = (LONGLONG)record * IOBUFLEN;
+        nrec = (long) minvalue((LONGLONG) Fptr->nreadahead,
+                               (Fptr->filesize - rstart) / IOBUFLEN);
+        if (nrec < 2)
+            return(0);
+
+        if (Fptr->io_pos != rstart)
+            ffseek(Fptr, rstart);
+
+        /* on failure, fall back to reading the single record */
+        if (ffread(Fptr, nrec * IOBUFLEN, Fptr->rabuffer, &rastatus) > 0)
+        {
+            Fptr->ranrec = 0;
+            Fptr->io_pos = -1;
+            return(0);
+        }
+
+        Fptr->io_pos = rstart + nrec * IOBUFLEN;
+        Fptr->rarecnum = record;
+        Fptr->ranrec = nrec;
+    }
+    else
+        Fptr->rahits++;
+
+    memcpy(Fptr->iobuffer + (nbuff * IOBUFLEN),
+           Fptr->rabuffer + ((record - Fptr->rarecnum) * IOBUFLEN), IOBUFLEN);
+    return(1);
+}
+/*--------------------------------------------------------------------------*/
+int ffallocbuf(FITSfile *Fptr)   /* I - FITS file structure */
+{
+/*
+  Allocate the I/O buffers of a newly opened file, using the pool size
+  set with ffsbfp.  On failure, Fptr->iobuffer is left NULL.
+*/
+    int ii;
+
+    FFLOCK;
+    Fptr->niobuf = pool_niobuf;
+    Fptr->nreadahead = pool_nreadahead;
+    FFUNLOCK;
+    Fptr->iobuffer = (char *) calloc(Fptr->niobuf, IOBUFLEN);
+    Fptr->bufrecnum = (long *) calloc(Fptr->niobuf, sizeof(long));
+    Fptr->dirty = (int *) calloc(Fptr->niobuf, sizeof(int));
+    Fptr->ageindex = (int *) calloc(Fptr->niobuf, sizeof(int));
+    Fptr->rabuffer = NULL;
+    if (Fptr->nreadahead > 1)
+        Fptr->rabuffer = (char *) malloc((size_t) Fptr->nreadahead * IOBUFLEN);
+
+    Fptr->lock = NULL;
+#ifdef _REENTRANT
+    {
+        pthread_mutexattr_t attr;
+
+        /* recursive, since locked routines call each other */
+        Fptr->lock = malloc(sizeof(pthread_mutex_t));
+        if (Fptr->lock)
+        {
+            pthread_mutexattr_init(&attr);
+            pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+            pthread_mutex_init((pthread_mutex_t *) Fptr->lock, &attr);
+            pthread_mutexattr_destroy(&attr);
+        }
+    }
+#endif
+
+    if (!Fptr->iobuffer || !Fptr->bufrecnum || !Fptr->dirty || 
+        !Fptr->ageindex || (Fptr->nreadahead > 1 && !Fptr->rabuffer))
+    {
+        fffreebuf(Fptr);
+        return(MEMORY_ALLOCATION);
+    }
+
+    /* initialize the ageindex array (relative age of the I/O buffers) */
+    /* and initialize the bufrecnum array as being empty */
+    for (ii = 0; ii < Fptr->niobuf; ii++)  {
+        Fptr->ageindex[ii] = ii;
+        Fptr->bufrecnum[ii] = -1;
+    }
+
+    Fptr->rarecnum = -1;
+    Fptr->ranrec = 0;
+    Fptr->lastmiss = -2;
+    Fptr->bufhits = 0;
+    Fptr->bufmisses = 0;
+    Fptr->rahits = 0;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+void fffreebuf(FITSfile *Fptr)   /* I - FITS file structure */
+{
+/*
+  free the I/O buffers of a file, and its lock
+*/
+#ifdef _REENTRANT
+    if (Fptr->lock)
+        pthread_mutex_destroy((pthread_mutex_t *) Fptr->lock);
+#endif
+    free(Fptr->lock);
+    Fptr->lock = NULL;
+
+    free(Fptr->iobuffer);
+    free(Fptr->bufrecnum);
+    free(Fptr->dirty);
+    free(Fptr->ageindex);
+    free(Fptr->rabuffer);
+    Fptr->iobuffer = NULL;
+    Fptr->bufrecnum = NULL;
+    Fptr->dirty = NULL;
+    Fptr->ageindex = NULL;
+    Fptr->rabuffer = NULL;
+}
+/*--------------------------------------------------------------------------*/
+int ffsbfp(int nbuffers,          /* I - number of I/O buffers per file  */
+           int nreadahead,        /* I - records to read ahead, 0 = none */
+           int *status)           /* IO - error status                   */
+{
+/*
+  Set the number of I/O buffers given to each file, and the number of
+  records read ahead on sequential access.  Only files opened after the
+  call are affected.  The pool never shrinks below NIOBUF buffers.  The
+  settings are shared by the whole process, so code that raises them for
+  its own files should restore the ones returned by ffgbfp once those
+  files are open.
+*/
+    if (*status > 0)
+        return(*status);
+
+    FFLOCK;
+    pool_niobuf = maxvalue(nbuffers, NIOBUF);
+    pool_nreadahead = maxvalue(nreadahead, 0);
+    FFUNLOCK;
+
+    return(*status);
+}
+/*--------------------------------------------------------------------------*/
+int ffgbfp(int *nbuffers,         /* O - number of I/O buffers per file  */
+           int *nreadahead,       /* O - records to read ahead           */
+           int *status)           /* IO - error status                   */
+{
+/*
+  Return the buffer pool settings used for newly opened files
+*/
+    FFLOCK;
+    *nbuffers = pool_niobuf;
+    *nreadahead = pool_nreadahead;
+    FFUNLOCK;
+    return(*status);
+}
+/*--------------------------------------------------------------------------*/
+int ffgbfs(fitsfile *fptr,        /* I - FITS file pointer               */
+           long *hits,            /* O - records found in the buffers    */
+           long *misses,          /* O - records loaded into a buffer    */
+           long *rahits,          /* O - loads served by read-ahead      */
+           int *status)           /* IO - error status                   */
+{
+/*
+  Return the I/O buffer counters of the file, for profiling.  Large reads
+  that go directly into the caller's array bypass the buffers and are
+  not counted.
+*/
+    *hits = (fptr->Fptr)->bufhits;
+    *misses = (fptr->Fptr)->bufmisses;
+    *rahits = (fptr->Fptr)->rahits;
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
@@ -595,7 +799,7 @@ int ffflsh(fitsfile *fptr,        /* I - FITS file pointer           */
     if (fptr->HDUposition != (fptr->Fptr)->curhdu)
         ffmahd(fptr, (fptr->HDUposition) + 1, NULL, status);
 */
-    for (ii = 0; ii < NIOBUF; ii++)
+    for (ii = 0; ii < (fptr->Fptr)->niobuf; ii++)
     {
 	/* flush modified buffer to disk */
         if ((fptr->Fptr)->bufrecnum[ii] >= 0 &&(fptr->Fptr)->dirty[ii])
@@ -619,7 +823,7 @@ int ffbfeof(fitsfile *fptr,        /* I - FITS file pointer           */
 */
     int ii;
 
-    for (ii = 0; ii < NIOBUF; ii++)
+    for (ii = 0; ii < (fptr->Fptr)->niobuf; ii++)
     {
         if ( (LONGLONG) (fptr->Fptr)->bufrecnum[ii] * IOBUFLEN >= fptr->Fptr->filesize)
         {
@@ -683,7 +887,7 @@ int ffbfwt(FITSfile *Fptr,        /* I - FITS file pointer           */
       if (Fptr->io_pos != Fptr->filesize)
          ffseek(Fptr, Fptr->filesize);
 
-      ibuff = NIOBUF;  /* initialize to impossible value */
+      ibuff = Fptr->niobuf;  /* initialize to impossible value */
       while(ibuff != nbuff) /* repeat until requested buffer is written */
       {
         minrec = (long) (Fptr->filesize / IOBUFLEN);
@@ -693,7 +897,7 @@ int ffbfwt(FITSfile *Fptr,        /* I - FITS file pointer           */
         irec = Fptr->bufrecnum[nbuff]; /* initially point to the requested buffer */
         ibuff = nbuff;
 
-        for (ii = 0; ii < NIOBUF; ii++)
+        for (ii = 0; ii < Fptr->niobuf; ii++)
         {
           if (Fptr->bufrecnum[ii] >= minrec &&
             Fptr->bufrecnum[ii] < irec)
@@ -743,7 +947,7 @@ int ffgrsz( fitsfile *fptr, /* I - FITS file pionter                        */
 {
     int typecode, bytesperpixel;
 
-    /* There are NIOBUF internal buffers available each IOBUFLEN bytes long. */
+    /* There are niobuf internal buffers available each IOBUFLEN bytes long. */
 
     if (fptr->HDUposition != (fptr->Fptr)->curhdu)
         ffmahd(fptr, (fptr->HDUposition) + 1, NULL, status);
@@ -756,11 +960,11 @@ int ffgrsz( fitsfile *fptr, /* I - FITS file pionter                        */
       /* image pixels are in column 2 of the 'table' */
       ffgtcl(fptr, 2, &typecode, NULL, NULL, status);
       bytesperpixel = typecode / 10;
-      *ndata = ((NIOBUF - 1) * IOBUFLEN) / bytesperpixel;
+      *ndata = (((fptr->Fptr)->niobuf - 1) * IOBUFLEN) / bytesperpixel;
     }
     else   /* calc number of rows that fit in buffers */
     {
-      *ndata = (long) (((NIOBUF - 1) * IOBUFLEN) / maxvalue(1,
+      *ndata = (long) ((((fptr->Fptr)->niobuf - 1) * IOBUFLEN) / maxvalue(1,
                (fptr->Fptr)->rowlength));
       *ndata = maxvalue(1, *ndata); 
     }
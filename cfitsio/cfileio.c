@@ -14,7 +14,7 @@
 #include "group.h"
 
 #define MAX_PREFIX_LEN 20  /* max length of file type prefix (e.g. 'http://') */
-#define MAX_DRIVERS 24     /* max number of file I/O drivers */
+#define MAX_DRIVERS 26     /* max number of file I/O drivers */
 
 typedef struct    /* structure containing pointers to I/O driver functions */ 
 {   char prefix[MAX_PREFIX_LEN];
@@ -58,6 +58,7 @@ pthread_mutex_t Fitsio_InitLock = PTHREAD_MUTEX_INITIALIZER;
 int fitsio_init_lock(void)
 {
   static int need_to_init = 1;
+  int status = 0;
   
 #ifdef _REENTRANT
 
@@ -67,26 +68,32 @@ int fitsio_init_lock(void)
 
   if (need_to_init) {
 
-    /* Init the main fitsio lock here since we need a a recursive lock */
+    /* Init the main fitsio lock here since we need a a recursive lock. */
+    /* These calls must not sit inside assert(), which NDEBUG removes.  */
 
-    assert(!pthread_mutexattr_init(&mutex_init));
+    status = pthread_mutexattr_init(&mutex_init);
+    if (!status) {
 #ifdef linux
-    assert(!pthread_mutexattr_settype(&mutex_init,
-				     PTHREAD_MUTEX_RECURSIVE_NP));
+      status = pthread_mutexattr_settype(&mutex_init,
+				     PTHREAD_MUTEX_RECURSIVE_NP);
 #else
-    assert(!pthread_mutexattr_settype(&mutex_init,
-				     PTHREAD_MUTEX_RECURSIVE));
+      status = pthread_mutexattr_settype(&mutex_init,
+				     PTHREAD_MUTEX_RECURSIVE);
 #endif
+      if (!status)
+        status = pthread_mutex_init(&Fitsio_Lock,&mutex_init);
+      pthread_mutexattr_destroy(&mutex_init);
+    }
 
-    assert(!pthread_mutex_init(&Fitsio_Lock,&mutex_init));
-    need_to_init = 0;
+    if (!status)
+      need_to_init = 0;
   }
 
   FFUNLOCK1(Fitsio_InitLock);
 
 #endif
 
-    return(0);
+    return(status);
 }
 /*--------------------------------------------------------------------------*/
 int ffomem(fitsfile **fptr,      /* O - FITS file pointer                   */ 
@@ -102,7 +109,7 @@ int ffomem(fitsfile **fptr,      /* O - FITS file pointer                   */
   of ffopen.
 */
 {
-    int ii, driver, handle, hdutyp, slen, movetotype, extvers, extnum;
+    int driver, handle, hdutyp, slen, movetotype, extvers, extnum;
     char extname[FLEN_VALUE];
     LONGLONG filesize;
     char urltype[MAX_PREFIX_LEN], infile[FLEN_FILENAME], outfile[FLEN_FILENAME];
@@ -220,7 +227,7 @@ int ffomem(fitsfile **fptr,      /* O - FITS file pointer                   */
     }
 
     /* mem for file I/O buffers */
-    ((*fptr)->Fptr)->iobuffer = (char *) calloc(NIOBUF, IOBUFLEN);
+    ffallocbuf((*fptr)->Fptr);
 
     if ( !(((*fptr)->Fptr)->iobuffer) )
     {
@@ -235,13 +242,6 @@ int ffomem(fitsfile **fptr,      /* O - FITS file pointer                   */
         return(*status = MEMORY_ALLOCATION);
     }
 
-    /* initialize the ageindex array (relative age of the I/O buffers) */
-    /* and initialize the bufrecnum array as being empty */
-    for (ii = 0; ii < NIOBUF; ii++)  {
-        ((*fptr)->Fptr)->ageindex[ii] = ii;
-        ((*fptr)->Fptr)->bufrecnum[ii] = -1;
-    }
-
         /* store the parameters describing the file */
     ((*fptr)->Fptr)->MAXHDU = 1000;              /* initial size of headstart */
     ((*fptr)->Fptr)->filehandle = handle;        /* file handle */
@@ -467,7 +467,7 @@ int ffopen(fitsfile **fptr,      /* O - FITS file pointer                   */
 */
 {
     fitsfile *newptr;
-    int  ii, driver, hdutyp, hdunum, slen, writecopy, isopen;
+    int  driver, hdutyp, hdunum, slen, writecopy, isopen;
     LONGLONG filesize;
     long rownum, nrows, goodrows;
     int extnum, extvers, handle, movetotype, tstatus = 0, only_one = 0;
@@ -777,7 +777,7 @@ int ffopen(fitsfile **fptr,      /* O - FITS file pointer                   */
     }
 
     /* mem for file I/O buffers */
-    ((*fptr)->Fptr)->iobuffer = (char *) calloc(NIOBUF, IOBUFLEN);
+    ffallocbuf((*fptr)->Fptr);
 
     if ( !(((*fptr)->Fptr)->iobuffer) )
     {
@@ -792,13 +792,6 @@ int ffopen(fitsfile **fptr,      /* O - FITS file pointer                   */
         return(*status = MEMORY_ALLOCATION);
     }
 
-    /* initialize the ageindex array (relative age of the I/O buffers) */
-    /* and initialize the bufrecnum array as being empty */
-    for (ii = 0; ii < NIOBUF; ii++)  {
-        ((*fptr)->Fptr)->ageindex[ii] = ii;
-        ((*fptr)->Fptr)->bufrecnum[ii] = -1;
-    }
-
         /* store the parameters describing the file */
     ((*fptr)->Fptr)->MAXHDU = 1000;              /* initial size of headstart */
     ((*fptr)->Fptr)->filehandle = handle;        /* file handle */
@@ -1320,7 +1313,10 @@ int ffreopen(fitsfile *openfptr, /* I - FITS file pointer to open file  */
 
     (*newfptr)->Fptr = openfptr->Fptr; /* both point to the same structure */
     (*newfptr)->HDUposition = 0;  /* set initial position to primary array */
+
+    FFLOCK;  /* the usage count is shared with fits_already_open */
     (((*newfptr)->Fptr)->open_count)++;   /* increment the file usage counter */
+    FFUNLOCK;
 
     return(*status);
 }
@@ -1355,12 +1351,14 @@ int fits_clear_Fptr(FITSfile *Fptr,  /* O - FITS file pointer               */
 {
     int ii;
 
+    FFLOCK;
     for (ii = 0; ii < NMAXFILES; ii++) {
         if (FptrTable[ii] == Fptr) {
             FptrTable[ii] = 0;
             break;
         }
     }
+    FFUNLOCK;
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
@@ -1439,9 +1437,11 @@ int fits_already_open(fitsfile **fptr, /* I/O - FITS file pointer       */
     else
       strcpy(tmpinfile,infile);
 
+    FFLOCK;  /* ffclos removes entries from the table */
     for (ii = 0; ii < NMAXFILES; ii++)   /* check every buffer */
     {
-        if (FptrTable[ii] != 0)
+        /* a count of zero means the file is being closed */
+        if (FptrTable[ii] != 0 && FptrTable[ii]->open_count > 0)
         {
           oldFptr = FptrTable[ii];
 
@@ -1451,6 +1451,7 @@ int fits_already_open(fitsfile **fptr, /* I/O - FITS file pointer       */
 
           if (*status > 0)
           {
+            FFUNLOCK;
             ffpmsg("could not parse the previously opened filename: (ffopen)");
             ffpmsg(oldFptr->filename);
             return(*status);
@@ -1504,6 +1505,7 @@ int fits_already_open(fitsfile **fptr, /* I/O - FITS file pointer       */
                       the network, or STDIN), so return with an error.
                     */
 
+                    FFUNLOCK;
                     ffpmsg(
                 "cannot reopen file READWRITE when previously opened READONLY");
                     ffpmsg(url);
@@ -1514,6 +1516,7 @@ int fits_already_open(fitsfile **fptr, /* I/O - FITS file pointer       */
 
                   if (!(*fptr))
                   {
+                     FFUNLOCK;
                      ffpmsg(
                    "failed to allocate structure for following file: (ffopen)");
                      ffpmsg(url);
@@ -1537,6 +1540,7 @@ int fits_already_open(fitsfile **fptr, /* I/O - FITS file pointer       */
             }
         }
     }
+    FFUNLOCK;
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
@@ -3354,7 +3358,7 @@ int ffinit(fitsfile **fptr,      /* O - FITS file pointer                   */
   Create and initialize a new FITS file.
 */
 {
-    int ii, driver, slen, clobber = 0;
+    int driver, slen, clobber = 0;
     char *url;
     char urltype[MAX_PREFIX_LEN], outfile[FLEN_FILENAME];
     char tmplfile[FLEN_FILENAME], compspec[80];
@@ -3517,7 +3521,7 @@ int ffinit(fitsfile **fptr,      /* O - FITS file pointer                   */
     }
 
     /* mem for file I/O buffers */
-    ((*fptr)->Fptr)->iobuffer = (char *) calloc(NIOBUF, IOBUFLEN);
+    ffallocbuf((*fptr)->Fptr);
 
     if ( !(((*fptr)->Fptr)->iobuffer) )
     {
@@ -3532,13 +3536,6 @@ int ffinit(fitsfile **fptr,      /* O - FITS file pointer                   */
         return(*status = MEMORY_ALLOCATION);
     }
 
-    /* initialize the ageindex array (relative age of the I/O buffers) */
-    /* and initialize the bufrecnum array as being empty */
-    for (ii = 0; ii < NIOBUF; ii++)  {
-        ((*fptr)->Fptr)->ageindex[ii] = ii;
-        ((*fptr)->Fptr)->bufrecnum[ii] = -1;
-    }
-
         /* store the parameters describing the file */
     ((*fptr)->Fptr)->MAXHDU = 1000;              /* initial size of headstart */
     ((*fptr)->Fptr)->filehandle = handle;        /* store the file pointer */
@@ -3581,7 +3578,7 @@ int ffimem(fitsfile **fptr,      /* O - FITS file pointer                   */
   Create and initialize a new FITS file in memory
 */
 {
-    int ii, driver, slen;
+    int driver, slen;
     char urltype[MAX_PREFIX_LEN];
     int handle;
 
@@ -3669,7 +3666,7 @@ int ffimem(fitsfile **fptr,      /* O - FITS file pointer                   */
     }
 
     /* mem for file I/O buffers */
-    ((*fptr)->Fptr)->iobuffer = (char *) calloc(NIOBUF, IOBUFLEN);
+    ffallocbuf((*fptr)->Fptr);
 
     if ( !(((*fptr)->Fptr)->iobuffer) )
     {
@@ -3683,13 +3680,6 @@ int ffimem(fitsfile **fptr,      /* O - FITS file pointer                   */
         return(*status = MEMORY_ALLOCATION);
     }
 
-    /* initialize the ageindex array (relative age of the I/O buffers) */
-    /* and initialize the bufrecnum array as being empty */
-    for (ii = 0; ii < NIOBUF; ii++)  {
-        ((*fptr)->Fptr)->ageindex[ii] = ii;
-        ((*fptr)->Fptr)->bufrecnum[ii] = -1;
-    }
-
         /* store the parameters describing the file */
     ((*fptr)->Fptr)->MAXHDU = 1000;              /* initial size of headstart */
     ((*fptr)->Fptr)->filehandle = handle;        /* file handle */
@@ -3720,7 +3710,11 @@ int fits_init_cfitsio(void)
       char cval[2];
     } u;
 
-    fitsio_init_lock();
+    if (fitsio_init_lock())
+    {
+      ffpmsg("failed to initialize the CFITSIO lock (fits_init_cfitsio)");
+      return(1);
+    }
 
     FFLOCK;   /* lockout other threads while executing this critical */
               /* section of code  */
@@ -4350,6 +4344,69 @@ int fits_init_cfitsio(void)
       /* === End of net drivers section === */  
 #endif
 
+/* ==================== MEMORY MAPPED FILE DRIVER SECTION ================== */
+
+#ifdef HAVE_MMAP_SERVICES
+
+    /* 22a------------------memory mapped disk file driver----------------*/
+    status = fits_register_driver("mmap://", 
+            mmap_init,
+            mmap_shutdown,
+            mmap_setoptions,
+            mmap_getoptions, 
+            mmap_getversion,
+            mmap_checkfile,
+            mmap_open,
+            NULL,            /* files are mapped read-only, cannot create */ 
+            NULL,            /* truncate file not supported */ 
+            mmap_close,
+            NULL,            /* remove file not supported */ 
+            mmap_size,
+            mmap_flush,
+            mmap_seek,
+            mmap_read,
+            mmap_write );
+
+    if (status)
+    {
+        ffpmsg("failed to register the mmap:// driver (init_cfitsio)");
+        FFUNLOCK;
+        return(status);
+    }
+
+#endif
+/* ==================== END OF MEMORY MAPPED FILE DRIVER SECTION =========== */
+
+/* ==================== GZIP STREAM DRIVER SECTION ========================= */
+
+    /* 22b------------------gzip file inflated while it is read-----------*/
+    status = fits_register_driver("gzstream://", 
+            gzstream_init,
+            gzstream_shutdown,
+            gzstream_setoptions,
+            gzstream_getoptions, 
+            gzstream_getversion,
+            gzstream_checkfile,
+            gzstream_open,
+            NULL,            /* compressed files are read-only */ 
+            NULL,            /* truncate file not supported */ 
+            gzstream_close,
+            NULL,            /* remove file not supported */ 
+            gzstream_size,
+            gzstream_flush,
+            gzstream_seek,
+            gzstream_read,
+            gzstream_write );
+
+    if (status)
+    {
+        ffpmsg("failed to register the gzstream:// driver (init_cfitsio)");
+        FFUNLOCK;
+        return(status);
+    }
+
+/* ==================== END OF GZIP STREAM DRIVER SECTION ================== */
+
 /* ==================== SHARED MEMORY DRIVER SECTION ======================= */
 
 #ifdef HAVE_SHMEM_SERVICES
@@ -6424,26 +6481,38 @@ int ffclos(fitsfile *fptr,      /* I - FITS file pointer */
   then calling the system dependent routine to physically close the FITS file
 */   
 {
-    int tstatus = NO_CLOSE_ERROR, zerostatus = 0;
+    int tstatus = NO_CLOSE_ERROR, zerostatus = 0, lastopen;
 
     if (!fptr)
         return(*status = NULL_INPUT_PTR);
     else if ((fptr->Fptr)->validcode != VALIDSTRUC) /* check for magic value */
         return(*status = BAD_FILEPTR); 
 
+    /* other handles on the same structure may still be reading from it */
+    FFLOCKF(fptr);
+
     /* close and flush the current HDU */
     if (*status > 0)
        ffchdu(fptr, &tstatus);  /* turn off the error message from ffchdu */
     else
        ffchdu(fptr, status);         
 
+    /*
+      the usage count is only changed under the global lock, and
+      fits_already_open does not attach to a structure whose count has
+      dropped to zero, so nobody can pick this one up while it is closed
+    */
+    FFLOCK;
     ((fptr->Fptr)->open_count)--;           /* decrement usage counter */
+    lastopen = ((fptr->Fptr)->open_count == 0);
+    FFUNLOCK;
 
-    if ((fptr->Fptr)->open_count == 0)  /* if no other files use structure */
+    if (lastopen)  /* if no other files use structure */
     {
         ffflsh(fptr, TRUE, status);   /* flush and disassociate IO buffers */
 
         /* call driver function to actually close the file */
+        FFLOCK;  /* the driver handle tables are shared by all files */
         if ((*driverTable[(fptr->Fptr)->driver].close)((fptr->Fptr)->filehandle))
         {
             if (*status <= 0)
@@ -6456,7 +6525,11 @@ int ffclos(fitsfile *fptr,      /* I - FITS file pointer */
         }
 
         fits_clear_Fptr( fptr->Fptr, status);  /* clear Fptr address */
-        free((fptr->Fptr)->iobuffer);    /* free memory for I/O buffers */
+        FFUNLOCK;
+
+        /* this was the last handle, so nobody else can be waiting */
+        FFUNLOCKF(fptr);
+        fffreebuf(fptr->Fptr);    /* free memory for I/O buffers */
         free((fptr->Fptr)->headstart);    /* free memory for headstart array */
         free((fptr->Fptr)->filename);     /* free memory for the filename */
         (fptr->Fptr)->filename = 0;
@@ -6477,6 +6550,7 @@ int ffclos(fitsfile *fptr,      /* I - FITS file pointer */
         else
             ffflsh(fptr, FALSE, status); 
 
+        FFUNLOCKF(fptr);
         free(fptr);               /* free memory for the FITS file structure */
     }
 
@@ -6535,7 +6609,7 @@ int ffdelt(fitsfile *fptr,      /* I - FITS file pointer */
     }
 
     fits_clear_Fptr( fptr->Fptr, status);  /* clear Fptr address */
-    free((fptr->Fptr)->iobuffer);    /* free memory for I/O buffers */
+    fffreebuf(fptr->Fptr);    /* free memory for I/O buffers */
     free((fptr->Fptr)->headstart);    /* free memory for headstart array */
     free((fptr->Fptr)->filename);     /* free memory for the filename */
     (fptr->Fptr)->filename = 0;
@@ -8,6 +8,198 @@
 #include <string.h>
 #include <stdlib.h>
 #include "fitsio2.h"
+#ifdef HAVE_SIMD_KERNELS
+#include <emmintrin.h>
+#ifdef HAVE_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+#endif
+#ifdef _REENTRANT
+#include <unistd.h>
+#endif
+
+#define CSUM_BLOCK      2048   /* records read and summed at a time        */
+#define CSUM_THREADREC   256   /* min. records per thread in a threaded sum */
+#define CSUM_MAXTHREADS    4
+
+/*
+  The 32-bit 1's complement sum of the big-endian words of a block only
+  depends on the sums of the bytes at each of the 4 positions within a
+  word, B0..B3, as (B0 << 24) + (B1 << 16) + (B2 << 8) + B3 with the
+  overflow folded back in.  The byte sums need no byte swapping, vectorise
+  well, and the sums of separate blocks can simply be added, so a large
+  block can also be split between threads.
+*/
+#ifdef HAVE_SIMD_KERNELS
+#ifdef HAVE_AVX2_KERNELS
+/*--------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static long ffcbytes_avx2(unsigned char *buf, long nbytes, LONGLONG *bsum)
+{
+    long ii, pp;
+    __m256i v, zero = _mm256_setzero_si256(), mask[4], acc[4];
+    LONGLONG lanes[4];
+
+    for (pp = 0; pp < 4; pp++)
+    {
+        mask[pp] = _mm256_set1_epi32(0xFF << (8 * pp));
+        acc[pp] = zero;
+    }
+
+    for (ii = 0; ii + 32 <= nbytes; ii += 32)
+    {
+        v = _mm256_loadu_si256((__m256i *) (buf + ii));
+        for (pp = 0; pp < 4; pp++)
+            acc[pp] = _mm256_add_epi64(acc[pp],
+                _mm256_sad_epu8(_mm256_and_si256(v, mask[pp]), zero));
+    }
+
+    for (pp = 0; pp < 4; pp++)
+    {
+        _mm256_storeu_si256((__m256i *) lanes, acc[pp]);
+        bsum[pp] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    return(ii);
+}
+#endif
+/*--------------------------------------------------------------------------*/
+static long ffcbytes_simd(unsigned char *buf, long nbytes, LONGLONG *bsum)
+/*
+  add the bytes at each position within the 32-bit words to bsum[0..3];
+  returns the number of bytes done, the caller finishes the remainder
+*/
+{
+    long ii, pp;
+    __m128i v, zero = _mm_setzero_si128(), mask[4], acc[4];
+    LONGLONG lanes[2];
+
+#ifdef HAVE_AVX2_KERNELS
+    if (ffsimd() >= 2)
+        return(ffcbytes_avx2(buf, nbytes, bsum));
+#endif
+
+    for (pp = 0; pp < 4; pp++)
+    {
+        mask[pp] = _mm_set1_epi32(0xFF << (8 * pp));
+        acc[pp] = zero;
+    }
+
+    for (ii = 0; ii + 16 <= nbytes; ii += 16)
+    {
+        v = _mm_loadu_si128((__m128i *) (buf + ii));
+        for (pp = 0; pp < 4; pp++)
+            acc[pp] = _mm_add_epi64(acc[pp],
+                _mm_sad_epu8(_mm_and_si128(v, mask[pp]), zero));
+    }
+
+    for (pp = 0; pp < 4; pp++)
+    {
+        _mm_storeu_si128((__m128i *) lanes, acc[pp]);
+        bsum[pp] += lanes[0] + lanes[1];
+    }
+    return(ii);
+}
+#endif
+/*--------------------------------------------------------------------------*/
+static unsigned long ffcfold(LONGLONG sum)
+/*
+  fold the overflow bits back into a 32-bit 1's complement sum
+*/
+{
+    while (sum >> 32)
+        sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+
+    return((unsigned long) sum);
+}
+/*--------------------------------------------------------------------------*/
+static unsigned long ffcsumbuf(unsigned char *buf, long nbytes)
+/*
+  1's complement sum of a buffer of big-endian 32-bit words
+*/
+{
+    LONGLONG bsum[4] = {0, 0, 0, 0};
+    long ii = 0;
+
+#ifdef HAVE_SIMD_KERNELS
+    ii = ffcbytes_simd(buf, nbytes, bsum);
+#endif
+
+    for (; ii < nbytes; ii += 4)
+    {
+        bsum[0] += buf[ii];
+        bsum[1] += buf[ii+1];
+        bsum[2] += buf[ii+2];
+        bsum[3] += buf[ii+3];
+    }
+
+    return(ffcfold((bsum[0] << 24) + (bsum[1] << 16) + (bsum[2] << 8) + bsum[3]));
+}
+#ifdef _REENTRANT
+typedef struct    /* part of a block summed on its own thread */
+{
+    unsigned char *buf;
+    long nbytes;
+    unsigned long sum;
+} csumpart;
+/*--------------------------------------------------------------------------*/
+static void *ffcsumthread(void *ptr)
+{
+    csumpart *part = (csumpart *) ptr;
+
+    part->sum = ffcsumbuf(part->buf, part->nbytes);
+    return(NULL);
+}
+#endif
+/*--------------------------------------------------------------------------*/
+static unsigned long ffcsumblk(unsigned char *buf, long nrec)
+/*
+  1's complement sum of nrec 2880-byte records, split between threads
+  when the block is large enough to be worth it
+*/
+{
+#ifdef _REENTRANT
+    csumpart part[CSUM_MAXTHREADS];
+    pthread_t threads[CSUM_MAXTHREADS];
+    long nparts = 1, first, ii, ncpu = 1;
+    LONGLONG sum;
+
+#ifdef _SC_NPROCESSORS_ONLN
+    ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    nparts = minvalue(minvalue(ncpu, CSUM_MAXTHREADS), nrec / CSUM_THREADREC);
+
+    if (nparts > 1)
+    {
+        for (ii = 0, first = 0; ii < nparts; ii++)
+        {
+            part[ii].buf = buf + first * 2880;
+            part[ii].nbytes = ((nrec * (ii + 1)) / nparts - first) * 2880;
+            first = (nrec * (ii + 1)) / nparts;
+        }
+
+        /* the calling thread sums the first part itself */
+        for (ii = 1; ii < nparts; ii++)
+        {
+            if (pthread_create(&threads[ii], NULL, ffcsumthread, &part[ii]))
+                ffcsumthread(&part[ii]);   /* could not start it, do it here */
+            else
+                part[ii].nbytes = -part[ii].nbytes;  /* mark as started */
+        }
+        ffcsumthread(&part[0]);
+
+        sum = part[0].sum;
+        for (ii = 1; ii < nparts; ii++)
+        {
+            if (part[ii].nbytes < 0)
+                pthread_join(threads[ii], NULL);
+            sum += part[ii].sum;
+        }
+        return(ffcfold(sum));
+    }
+#endif
+
+    return(ffcsumbuf(buf, nrec * 2880));
+}
 /*------------------------------------------------------------------------*/
 int ffcsum(fitsfile *fptr,      /* I - FITS file pointer                  */
            long nrec,           /* I - number of 2880-byte blocks to sum  */
@@ -23,49 +215,49 @@ int ffcsum(fitsfile *fptr,      /* I - FITS file pointer                  */
     sampled evenly. 
 */
 {
-    long ii, jj;
-    unsigned short sbuf[1440];
-    unsigned long hi, lo, hicarry, locarry;
+    long jj, nblock, ntodo;
+    LONGLONG bytepos;
+    unsigned char sbuf[2880], *buf;
 
     if (*status > 0)
         return(*status);
   /*
     Sum the specified number of FITS 2880-byte records.  This assumes that
     the FITSIO file pointer points to the start of the records to be summed.
-    Read each FITS block as 1440 short values (do byte swapping if needed).
+    Records are read CSUM_BLOCK at a time, which bypasses the I/O buffers,
+    falling back to one at a time if there is no memory for the block.
   */
-    for (jj = 0; jj < nrec; jj++)
+    nblock = minvalue(nrec, CSUM_BLOCK);
+    buf = NULL;
+    if (nblock > 1)
+        buf = (unsigned char *) malloc(nblock * 2880);
+    if (!buf)
     {
-      ffgbyt(fptr, 2880, sbuf, status);
-
-#if BYTESWAPPED
+        buf = sbuf;
+        nblock = 1;
+    }
 
-      ffswap2( (short *)sbuf, 1440); /* reverse order of bytes in each value */
+    /* large reads go straight to the file and leave the position alone */
+    bytepos = (fptr->Fptr)->bytepos;
 
-#endif
+    for (jj = 0; jj < nrec; jj += ntodo)
+    {
+      ntodo = minvalue(nblock, nrec - jj);
 
-      hi = (*sum >> 16);
-      lo = *sum & 0xFFFF;
+      if (ffmbyt(fptr, bytepos + (LONGLONG) jj * 2880, REPORT_EOF, status) > 0 ||
+          ffgbyt(fptr, ntodo * 2880, buf, status) > 0)
+          break;
 
-      for (ii = 0; ii < 1440; ii += 2)
-      {
-        hi += sbuf[ii];
-        lo += sbuf[ii+1];
-      }
+      *sum = ffcfold((LONGLONG) *sum + ffcsumblk(buf, ntodo));
+    }
 
-      hicarry = hi >> 16;    /* fold carry bits in */
-      locarry = lo >> 16;
+    if (buf != sbuf)
+        free(buf);
 
-      while (hicarry | locarry)
-      {
-        hi = (hi & 0xFFFF) + locarry;
-        lo = (lo & 0xFFFF) + hicarry;
-        hicarry = hi >> 16;
-        locarry = lo >> 16;
-      }
+    /* leave the file positioned after the records, as before */
+    if (nblock > 1)
+        ffmbyt(fptr, bytepos + (LONGLONG) nrec * 2880, IGNORE_EOF, status);
 
-      *sum = (hi << 16) + lo;
-    }
     return(*status);
 }
 /*-------------------------------------------------------------------------*/
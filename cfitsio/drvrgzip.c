@@ -0,0 +1,652 @@
+/*  This file, drvrgzip.c contains driver routines for gzip compressed    */
+/*  disk files that are inflated while they are being read.  Unlike the   */
+/*  compress:// driver, which inflates the whole file into memory before   */
+/*  the open returns, the header of the first HDU is available as soon as  */
+/*  its first block is inflated, and reads only wait for the part of the   */
+/*  file they need.  In a reentrant build the inflation runs on separate   */
+/*  threads, ahead of the reader; files written as a series of BGZF        */
+/*  members (as produced by bgzip) are inflated by several threads at      */
+/*  once.  Without thread support the file is inflated on demand inside    */
+/*  the read calls, so, like the rest of a CFITSIO built without           */
+/*  --enable-reentrant, a file must then be read from one thread at a      */
+/*  time.  The compressed file is mapped into memory where memory mapping  */
+/*  is available, and read into memory otherwise.                          */
+
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "fitsio2.h"
+#include "zlib.h"
+
+#ifdef HAVE_MMAP_SERVICES
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define GZ_MAXTHREADS  8          /* max inflating threads per file        */
+#define GZ_CHUNK       1048576    /* bytes inflated per step of one stream */
+
+#ifdef _REENTRANT
+#define GZLOCK(gz)      pthread_mutex_lock(&(gz)->mutex)
+#define GZUNLOCK(gz)    pthread_mutex_unlock(&(gz)->mutex)
+#define GZSIGNAL(gz)    pthread_cond_broadcast(&(gz)->cond)
+#else
+#define GZLOCK(gz)
+#define GZUNLOCK(gz)
+#define GZSIGNAL(gz)
+#endif
+
+typedef struct    /* one inflated file, shared by all handles open on it */
+{
+    char *filename;
+    int refcount;
+    unsigned char *gzmap; /* the compressed file, mapped read-only */
+    size_t gzsize;
+    char *data;           /* the inflated file */
+    LONGLONG filesize;    /* size of the inflated file */
+    LONGLONG avail;       /* leading bytes of data that have been inflated */
+    int error;            /* nonzero once the compressed stream is bad */
+
+    /* BGZF files: every member is inflated independently */
+    long nmembers;
+    LONGLONG *mstart;     /* offset of each member in the compressed file */
+    LONGLONG *mout;       /* offset of each member in the inflated file */
+    char *mdone;          /* which members have been inflated */
+    long nextmember;      /* next member not yet claimed by a thread */
+    long donemembers;     /* leading members that have all been inflated */
+
+    /* other files: a single stream, inflated front to back */
+    z_stream strm;
+    int strminit;
+
+#ifdef _REENTRANT
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_t threads[GZ_MAXTHREADS];
+    int nthreads;
+    int stop;
+#endif
+} gzstream;
+
+typedef struct    /* structure containing one open handle */
+{
+    gzstream *gz;
+    LONGLONG currentpos;
+} gzhandle;
+
+static gzhandle gzTable[NMAXFILES];  /* allocate handle tables */
+
+static int gzstream_probe(gzstream *gz);
+static int gzstream_step(gzstream *gz);
+static int gzstream_wait(gzstream *gz, LONGLONG end);
+static void gzstream_free(gzstream *gz);
+static void gzstream_feed(gzstream *gz);
+
+/*--------------------------------------------------------------------------*/
+int gzstream_init(void)
+{
+    int ii;
+
+    for (ii = 0; ii < NMAXFILES; ii++) /* initialize all empty slots in table */
+       gzTable[ii].gz = 0;
+
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_setoptions(int options)
+{
+  /* do something with the options argument, to stop compiler warning */
+  options = 0;
+  return(options);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_getoptions(int *options)
+{
+  *options = 0;
+  return(0);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_getversion(int *version)
+{
+    *version = 10;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_shutdown(void)
+{
+  return(0);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_checkfile (char *urltype, char *infile, char *outfile)
+{
+    FILE *diskfile;
+    unsigned char buffer[2];
+    int gzip = 0;
+
+    /* only gzip files are streamed; everything else, and files that */
+    /* are to be copied to an output file, go to the file:// driver  */
+    if (!strlen(outfile) && file_is_compressed(infile) &&
+        !file_openfile(infile, READONLY, &diskfile))
+    {
+        gzip = (fread(buffer, 1, 2, diskfile) == 2 &&
+                memcmp(buffer, "\037\213", 2) == 0);
+        fclose(diskfile);
+    }
+
+    if (!gzip)
+    {
+        strcpy(urltype, "file://");
+        return(file_checkfile(urltype, infile, outfile));
+    }
+
+    return 0;
+}
+/*--------------------------------------------------------------------------*/
+#ifdef _REENTRANT
+static void *gzstream_worker(void *ptr)
+/*
+  inflate the file until it is complete, or until the last handle closes
+*/
+{
+    gzstream *gz = (gzstream *) ptr;
+
+    while (gzstream_step(gz) == 0)
+        ;
+
+    return(NULL);
+}
+#endif
+/*--------------------------------------------------------------------------*/
+int gzstream_open(char *filename, int rwmode, int *handle)
+{
+    FILE *diskfile;
+    struct stat filestat;
+    gzstream *gz = NULL;
+    void *map;
+    int ii, status;
+
+    if (rwmode != READONLY)
+    {
+        ffpmsg(
+  "cannot open compressed file with WRITE access (gzstream_open)");
+        ffpmsg(filename);
+        return(READONLY_FILE);
+    }
+
+    *handle = -1;
+    for (ii = 0; ii < NMAXFILES; ii++)  /* find empty slot in table */
+    {
+        if (gzTable[ii].gz == 0)
+        {
+            *handle = ii;
+            break;
+        }
+    }
+
+    if (*handle == -1)
+       return(TOO_MANY_FILES);    /* too many files opened */
+
+    /* the file may already be open, and partly inflated, on another handle */
+    for (ii = 0; ii < NMAXFILES; ii++)
+    {
+        if (gzTable[ii].gz && !strcmp(gzTable[ii].gz->filename, filename))
+        {
+            gz = gzTable[ii].gz;
+            GZLOCK(gz);
+            gz->refcount++;
+            GZUNLOCK(gz);
+            break;
+        }
+    }
+
+    if (!gz)
+    {
+        status = file_openfile(filename, READONLY, &diskfile);
+        if (status)
+        {
+            ffpmsg("failed to open compressed disk file (gzstream_open)");
+            ffpmsg(filename);
+            return(status);
+        }
+
+        if (fstat(fileno(diskfile), &filestat) != 0 || filestat.st_size < 18)
+        {
+            fclose(diskfile);
+            return(FILE_NOT_OPENED);
+        }
+
+#ifdef HAVE_MMAP_SERVICES
+        map = mmap(NULL, (size_t) filestat.st_size, PROT_READ, MAP_SHARED,
+                   fileno(diskfile), 0);
+        fclose(diskfile);
+        if (map == MAP_FAILED)
+        {
+            ffpmsg("failed to map compressed file (gzstream_open)");
+            ffpmsg(filename);
+            return(FILE_NOT_OPENED);
+        }
+        madvise(map, (size_t) filestat.st_size, MADV_SEQUENTIAL);
+#else
+        map = malloc((size_t) filestat.st_size);
+        if (!map)
+        {
+            fclose(diskfile);
+            return(MEMORY_ALLOCATION);
+        }
+        if (fread(map, 1, (size_t) filestat.st_size, diskfile) !=
+            (size_t) filestat.st_size)
+        {
+            ffpmsg("failed to read compressed file (gzstream_open)");
+            ffpmsg(filename);
+            fclose(diskfile);
+            free(map);
+            return(READ_ERROR);
+        }
+        fclose(diskfile);
+#endif
+
+        gz = (gzstream *) calloc(1, sizeof(gzstream));
+        if (!gz)
+        {
+#ifdef HAVE_MMAP_SERVICES
+            munmap(map, (size_t) filestat.st_size);
+#else
+            free(map);
+#endif
+            return(MEMORY_ALLOCATION);
+        }
+
+        gz->gzmap = (unsigned char *) map;
+        gz->gzsize = (size_t) filestat.st_size;
+        gz->refcount = 1;
+        gz->filename = (char *) malloc(strlen(filename) + 1);
+        if (gz->filename)
+            strcpy(gz->filename, filename);
+
+        /* find the inflated size, and the members of a BGZF file */
+        status = gz->filename ? gzstream_probe(gz) : MEMORY_ALLOCATION;
+        if (!status)
+        {
+            gz->data = (char *) malloc((size_t) gz->filesize);
+            if (!gz->data)
+                status = MEMORY_ALLOCATION;
+        }
+
+        if (!status && !gz->nmembers)
+        {
+            /* 16 + MAX_WBITS: let zlib parse the gzip header and trailer */
+            if (inflateInit2(&gz->strm, 16 + MAX_WBITS) != Z_OK)
+                status = MEMORY_ALLOCATION;
+            else
+            {
+                gz->strminit = 1;
+                gz->strm.next_in = gz->gzmap;
+                gzstream_feed(gz);
+            }
+        }
+
+        if (status)
+        {
+            gzstream_free(gz);
+            return(status);
+        }
+
+#ifdef _REENTRANT
+        pthread_mutex_init(&gz->mutex, NULL);
+        pthread_cond_init(&gz->cond, NULL);
+
+        /* a single stream can only be inflated by one thread */
+        gz->nthreads = 1;
+        if (gz->nmembers > 1)
+        {
+            long ncpu = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+            ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+            gz->nthreads = (int) minvalue(maxvalue(ncpu, 1), GZ_MAXTHREADS);
+        }
+
+        for (ii = 0; ii < gz->nthreads; ii++)
+        {
+            if (pthread_create(&gz->threads[ii], NULL, gzstream_worker, gz))
+                break;
+        }
+        gz->nthreads = ii;
+
+        if (!gz->nthreads)
+        {
+            ffpmsg("failed to start inflating thread (gzstream_open)");
+            pthread_cond_destroy(&gz->cond);
+            pthread_mutex_destroy(&gz->mutex);
+            gzstream_free(gz);
+            return(FILE_NOT_OPENED);
+        }
+#endif
+    }
+
+    gzTable[*handle].gz = gz;
+    gzTable[*handle].currentpos = 0;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+static int gzstream_probe(gzstream *gz)
+/*
+  Determine the size of the inflated file.  A BGZF file gives the
+  compressed size of every member in its header, so the members can be
+  listed, and their inflated sizes summed, without inflating anything.
+  For any other gzip file the size is taken from the trailer.
+*/
+{
+    unsigned char *p = gz->gzmap;
+    LONGLONG pos, out;
+    long nalloc = 0, bsize;
+
+    for (pos = 0, out = 0; pos < (LONGLONG) gz->gzsize; pos += bsize)
+    {
+        p = gz->gzmap + pos;
+
+        /* gzip magic, deflate method, FEXTRA flag, and a 'BC' subfield */
+        if (pos + 18 > (LONGLONG) gz->gzsize || p[0] != 31 || p[1] != 139 ||
+            p[2] != 8 || !(p[3] & 4) || p[10] + (p[11] << 8) < 6 ||
+            p[12] != 'B' || p[13] != 'C' || p[14] != 2 || p[15] != 0)
+            break;
+
+        bsize = (p[16] | (p[17] << 8)) + 1;
+        if (pos + bsize > (LONGLONG) gz->gzsize)
+            break;
+
+        if (gz->nmembers + 1 >= nalloc)
+        {
+            nalloc = maxvalue(2 * nalloc, 1024);
+            gz->mstart = (LONGLONG *) realloc(gz->mstart, (nalloc + 1) * sizeof(LONGLONG));
+            gz->mout = (LONGLONG *) realloc(gz->mout, (nalloc + 1) * sizeof(LONGLONG));
+            if (!gz->mstart || !gz->mout)
+                return(MEMORY_ALLOCATION);
+        }
+
+        gz->mstart[gz->nmembers] = pos;
+        gz->mout[gz->nmembers] = out;
+        gz->nmembers++;
+
+        /* ISIZE, the inflated size of this member */
+        p = gz->gzmap + pos + bsize - 4;
+        out += (LONGLONG) p[0] | ((LONGLONG) p[1] << 8) |
+               ((LONGLONG) p[2] << 16) | ((LONGLONG) p[3] << 24);
+    }
+
+    if (gz->nmembers && pos == (LONGLONG) gz->gzsize)
+    {
+        gz->mstart[gz->nmembers] = pos;
+        gz->mout[gz->nmembers] = out;
+        gz->mdone = (char *) calloc(gz->nmembers, 1);
+        if (!gz->mdone)
+            return(MEMORY_ALLOCATION);
+        gz->filesize = out;
+    }
+    else
+    {
+        /* not BGZF: one stream, with the size mod 2^32 in the trailer; */
+        /* concatenated gzip files are only read up to the size of the  */
+        /* last one                                                      */
+        gz->nmembers = 0;
+        p = gz->gzmap + gz->gzsize - 4;
+        gz->filesize = (LONGLONG) p[0] | ((LONGLONG) p[1] << 8) |
+                       ((LONGLONG) p[2] << 16) | ((LONGLONG) p[3] << 24);
+    }
+
+    /* a FITS file is a whole number of 2880 byte blocks; anything else */
+    /* (e.g. a file of more than 4 GB) is left to the compress:// driver */
+    if (gz->filesize <= 0 || gz->filesize % 2880)
+    {
+        ffpmsg("cannot determine the size of the gzip file (gzstream_open)");
+        ffpmsg(gz->filename);
+        return(FILE_NOT_OPENED);
+    }
+
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+static int gzstream_step(gzstream *gz)
+/*
+  Inflate the next piece of the file: the next unclaimed BGZF member,
+  or the next GZ_CHUNK bytes of a single stream.  Returns 1 once there
+  is nothing left to do.
+*/
+{
+    z_stream strm;
+    long member, ii;
+    int zstatus;
+    LONGLONG start, end;
+
+    GZLOCK(gz);
+#ifdef _REENTRANT
+    if (gz->stop)
+    {
+        GZUNLOCK(gz);
+        return(1);
+    }
+#endif
+    if (gz->error || gz->avail == gz->filesize ||
+        (gz->nmembers && gz->nextmember == gz->nmembers))
+    {
+        GZUNLOCK(gz);
+        return(1);
+    }
+
+    if (gz->nmembers)
+    {
+        /* claim a member, and inflate it without holding the lock */
+        member = gz->nextmember++;
+        GZUNLOCK(gz);
+
+        memset(&strm, 0, sizeof(strm));
+        zstatus = inflateInit2(&strm, 16 + MAX_WBITS);
+        if (zstatus == Z_OK)
+        {
+            strm.next_in = gz->gzmap + gz->mstart[member];
+            strm.avail_in = (uInt) (gz->mstart[member + 1] - gz->mstart[member]);
+            strm.next_out = (Bytef *) gz->data + gz->mout[member];
+            strm.avail_out = (uInt) (gz->mout[member + 1] - gz->mout[member]);
+            zstatus = inflate(&strm, Z_FINISH);
+            inflateEnd(&strm);
+        }
+
+        GZLOCK(gz);
+        if (zstatus != Z_STREAM_END)
+            gz->error = READ_ERROR;
+        gz->mdone[member] = 1;
+
+        /* publish the members that are now complete from the start */
+        for (ii = gz->donemembers; ii < gz->nmembers && gz->mdone[ii]; ii++)
+            ;
+        gz->donemembers = ii;
+        gz->avail = gz->mout[ii];
+    }
+    else
+    {
+        /* only one thread ever inflates a single stream */
+        GZUNLOCK(gz);
+
+        start = gz->strm.total_out;
+        end = minvalue(start + GZ_CHUNK, gz->filesize);
+        gz->strm.next_out = (Bytef *) gz->data + start;
+        gz->strm.avail_out = (uInt) (end - start);
+
+        gzstream_feed(gz);
+        zstatus = inflate(&gz->strm, Z_NO_FLUSH);
+
+        /* concatenated gzip files inflate to the concatenation */
+        gzstream_feed(gz);
+        while (zstatus == Z_STREAM_END && gz->strm.avail_in > 0 &&
+               gz->strm.avail_out > 0 && gz->strm.next_in[0] == 31)
+        {
+            inflateReset(&gz->strm);
+            zstatus = inflate(&gz->strm, Z_NO_FLUSH);
+            gzstream_feed(gz);
+        }
+
+        GZLOCK(gz);
+        if (zstatus != Z_OK && zstatus != Z_STREAM_END &&
+            !(zstatus == Z_BUF_ERROR && gz->strm.avail_out == 0))
+            gz->error = READ_ERROR;
+        else if (zstatus == Z_STREAM_END && gz->strm.avail_out > 0)
+            gz->error = READ_ERROR;  /* shorter than the trailer said */
+
+        gz->avail = gz->strm.total_out;
+    }
+
+    GZSIGNAL(gz);
+    GZUNLOCK(gz);
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+static void gzstream_feed(gzstream *gz)
+/*
+  give a single stream the rest of the compressed file, or as much of it
+  as avail_in (a uInt) can describe
+*/
+{
+    size_t used = (size_t) (gz->strm.next_in - gz->gzmap);
+
+    gz->strm.avail_in = (uInt) minvalue(gz->gzsize - used, (size_t) UINT_MAX);
+}
+/*--------------------------------------------------------------------------*/
+static int gzstream_wait(gzstream *gz, LONGLONG end)
+/*
+  wait until the first 'end' bytes of the file have been inflated
+*/
+{
+    int status;
+
+    GZLOCK(gz);
+#ifdef _REENTRANT
+    while (gz->avail < end && !gz->error)
+        pthread_cond_wait(&gz->cond, &gz->mutex);
+#else
+    /* no inflating threads, so do the work here */
+    while (gz->avail < end && !gz->error)
+        gzstream_step(gz);
+#endif
+    status = gz->error;
+    GZUNLOCK(gz);
+
+    return(status);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_size(int handle, LONGLONG *filesize)
+/*
+  return the size of the inflated file in bytes
+*/
+{
+    *filesize = gzTable[handle].gz->filesize;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+static void gzstream_free(gzstream *gz)
+{
+    if (gz->strminit)
+        inflateEnd(&gz->strm);
+#ifdef HAVE_MMAP_SERVICES
+    if (gz->gzmap)
+        munmap(gz->gzmap, gz->gzsize);
+#else
+    free(gz->gzmap);
+#endif
+
+    free(gz->data);
+    free(gz->mstart);
+    free(gz->mout);
+    free(gz->mdone);
+    free(gz->filename);
+    free(gz);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_close(int handle)
+/*
+  close the handle, and free the file once its last handle is closed
+*/
+{
+    gzstream *gz = gzTable[handle].gz;
+    int refcount;
+#ifdef _REENTRANT
+    int ii;
+#endif
+
+    gzTable[handle].gz = 0;
+
+    GZLOCK(gz);
+    refcount = --gz->refcount;
+#ifdef _REENTRANT
+    if (!refcount)
+        gz->stop = 1;
+#endif
+    GZUNLOCK(gz);
+
+    if (refcount)
+        return(0);
+
+#ifdef _REENTRANT
+    for (ii = 0; ii < gz->nthreads; ii++)
+        pthread_join(gz->threads[ii], NULL);
+
+    pthread_cond_destroy(&gz->cond);
+    pthread_mutex_destroy(&gz->mutex);
+#endif
+
+    gzstream_free(gz);
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_flush(int handle)
+/*
+  nothing to flush, since the file is read-only
+*/
+{
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_seek(int handle, LONGLONG offset)
+/*
+  seek to position relative to start of the file
+*/
+{
+    if (offset > gzTable[handle].gz->filesize)
+        return(END_OF_FILE);
+
+    gzTable[handle].currentpos = offset;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_read(int hdl, void *buffer, long nbytes)
+/*
+  read bytes from the current position in the file, waiting for them
+  to be inflated if necessary
+*/
+{
+    gzstream *gz = gzTable[hdl].gz;
+    LONGLONG pos = gzTable[hdl].currentpos;
+
+    if (pos + nbytes > gz->filesize)
+        return(END_OF_FILE);
+
+    if (gzstream_wait(gz, pos + nbytes))
+    {
+        ffpmsg("error inflating the gzip file (gzstream_read)");
+        ffpmsg(gz->filename);
+        return(READ_ERROR);
+    }
+
+    memcpy(buffer, gz->data + pos, nbytes);
+    gzTable[hdl].currentpos += nbytes;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int gzstream_write(int hdl, void *buffer, long nbytes)
+/*
+  the inflated file is read-only
+*/
+{
+    return(WRITE_ERROR);
+}
@@ -0,0 +1,255 @@
+/*  This file, drvrmmap.c contains driver routines for memory mapped       */
+/*  disk files.  The file is mapped read-only in its entirety, and reads   */
+/*  are served by copying straight out of the mapping, so the data are     */
+/*  copied once from the page cache instead of going through stdio.        */
+
+#include <string.h>
+#include <stdlib.h>
+#include "fitsio2.h"
+
+#ifdef HAVE_MMAP_SERVICES
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+/* switch the mapping to random access after this many consecutive seeks */
+#define MMAP_RANDOM_SEEKS 4
+
+typedef struct    /* structure containing mapped file structure */
+{
+    char *map;            /* start of the mapping, NULL if empty file */
+    LONGLONG filesize;    /* size of the file and of the mapping */
+    LONGLONG currentpos;
+    int open;             /* 1 if this slot is in use */
+    int advice;           /* madvise hint currently in effect */
+    int nseeks;           /* seeks since the last long sequential read */
+} mmapdriver;
+
+static mmapdriver mmapTable[NMAXFILES]; /* allocate mapped file handle tables */
+
+/*--------------------------------------------------------------------------*/
+int mmap_init(void)
+{
+    int ii;
+
+    for (ii = 0; ii < NMAXFILES; ii++) /* initialize all empty slots in table */
+    {
+       mmapTable[ii].open = 0;
+       mmapTable[ii].map = 0;
+    }
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_setoptions(int options)
+{
+  /* do something with the options argument, to stop compiler warning */
+  options = 0;
+  return(options);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_getoptions(int *options)
+{
+  *options = 0;
+  return(0);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_getversion(int *version)
+{
+    *version = 10;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_shutdown(void)
+{
+  return(0);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_checkfile (char *urltype, char *infile, char *outfile)
+{
+    /* compressed files, and files that are to be copied to an output */
+    /* file before they are opened, are left to the file:// driver    */
+    if ( strlen(outfile) || file_is_compressed(infile) )
+    {
+        strcpy(urltype, "file://");
+        return(file_checkfile(urltype, infile, outfile));
+    }
+
+    return 0;
+}
+/*--------------------------------------------------------------------------*/
+int mmap_open(char *filename, int rwmode, int *handle)
+{
+    FILE *diskfile;
+    struct stat filestat;
+    void *map;
+    int ii, status;
+
+    if (rwmode != READONLY)
+    {
+        ffpmsg("the mmap:// driver only supports READONLY access (mmap_open)");
+        ffpmsg(filename);
+        return(FILE_NOT_OPENED);
+    }
+
+    *handle = -1;
+    for (ii = 0; ii < NMAXFILES; ii++)  /* find empty slot in table */
+    {
+        if (mmapTable[ii].open == 0)
+        {
+            *handle = ii;
+            break;
+        }
+    }
+
+    if (*handle == -1)
+       return(TOO_MANY_FILES);    /* too many files opened */
+
+    /* open the file the same way the file:// driver does, then map it */
+    status = file_openfile(filename, READONLY, &diskfile);
+    if (status)
+       return(status);
+
+    if (fstat(fileno(diskfile), &filestat) != 0)
+    {
+        fclose(diskfile);
+        return(FILE_NOT_OPENED);
+    }
+
+    map = NULL;
+    if (filestat.st_size > 0)
+    {
+        map = mmap(NULL, (size_t) filestat.st_size, PROT_READ, MAP_SHARED,
+                   fileno(diskfile), 0);
+        if (map == MAP_FAILED)
+        {
+            ffpmsg("failed to map file into memory (mmap_open)");
+            ffpmsg(filename);
+            fclose(diskfile);
+            return(FILE_NOT_OPENED);
+        }
+    }
+
+    /* the mapping stays valid after the descriptor is closed */
+    fclose(diskfile);
+
+    mmapTable[*handle].map = (char *) map;
+    mmapTable[*handle].filesize = (LONGLONG) filestat.st_size;
+    mmapTable[*handle].currentpos = 0;
+    mmapTable[*handle].open = 1;
+    mmapTable[*handle].nseeks = 0;
+
+    /* headers and pixels are normally read front to back */
+    mmapTable[*handle].advice = MADV_SEQUENTIAL;
+    if (map)
+        madvise(map, (size_t) filestat.st_size, MADV_SEQUENTIAL);
+
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_size(int handle, LONGLONG *filesize)
+/*
+  return the size of the file in bytes
+*/
+{
+    *filesize = mmapTable[handle].filesize;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_close(int handle)
+/*
+  unmap and close the file
+*/
+{
+    if (mmapTable[handle].map)
+    {
+        if (munmap(mmapTable[handle].map, (size_t) mmapTable[handle].filesize))
+            return(FILE_NOT_CLOSED);
+    }
+
+    mmapTable[handle].map = 0;
+    mmapTable[handle].open = 0;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_flush(int handle)
+/*
+  nothing to flush, since the file is read-only
+*/
+{
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_seek(int handle, LONGLONG offset)
+/*
+  seek to position relative to start of the file
+*/
+{
+    if (offset > mmapTable[handle].filesize)
+        return(END_OF_FILE);
+
+    if (offset != mmapTable[handle].currentpos)
+    {
+        /* repeated jumps around the file (e.g. reading image sections */
+        /* or table columns) defeat read-ahead, so tell the kernel     */
+        mmapTable[handle].nseeks++;
+        if (mmapTable[handle].nseeks >= MMAP_RANDOM_SEEKS &&
+            mmapTable[handle].advice != MADV_RANDOM && mmapTable[handle].map)
+        {
+            madvise(mmapTable[handle].map, (size_t) mmapTable[handle].filesize,
+                    MADV_RANDOM);
+            mmapTable[handle].advice = MADV_RANDOM;
+        }
+    }
+
+    mmapTable[handle].currentpos = offset;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_read(int hdl, void *buffer, long nbytes)
+/*
+  read bytes from the current position in the file
+*/
+{
+    LONGLONG pos = mmapTable[hdl].currentpos;
+
+    if (pos + nbytes > mmapTable[hdl].filesize)
+    {
+        /* some editors will add a single end-of-file character to a file */
+        /* Ignore it if the character is a zero, 10, or 32 */
+        if (mmapTable[hdl].filesize - pos == 1)
+        {
+            char c = mmapTable[hdl].map[pos];
+            if (c == 0 || c == 10 || c == 32)
+                return(END_OF_FILE);
+        }
+        return(READ_ERROR);
+    }
+
+    memcpy(buffer, mmapTable[hdl].map + pos, nbytes);
+
+    /* a long enough sequential run restores read-ahead */
+    if (nbytes >= IOBUFLEN * NIOBUF)
+    {
+        mmapTable[hdl].nseeks = 0;
+        if (mmapTable[hdl].advice != MADV_SEQUENTIAL)
+        {
+            madvise(mmapTable[hdl].map, (size_t) mmapTable[hdl].filesize,
+                    MADV_SEQUENTIAL);
+            mmapTable[hdl].advice = MADV_SEQUENTIAL;
+        }
+    }
+
+    mmapTable[hdl].currentpos += nbytes;
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+int mmap_write(int hdl, void *buffer, long nbytes)
+/*
+  the mapping is read-only
+*/
+{
+    return(WRITE_ERROR);
+}
+
+#endif
@@ -27,6 +27,8 @@ The following modifications have been made to the original code:
     the input bytes to a char array, instead of reading them from a file stream
   - changed the function declarations to the more modern ANSI C style
   - changed calls to printf and perror to call the CFITSIO ffpmsg routine
+  - made nextchar and the bit buffer thread local, so that independent tiles
+    can be decompressed concurrently from different threads
   - replace "exit" statements with "return" statements
 
  ############################################################################  */
@@ -45,7 +47,23 @@ The following modifications have been made to the original code:
 #define max(a,b)        (((a)>(b))?(a):(b))
 #endif
 
-static long nextchar;
+/* decoder state is kept per thread where the compiler supports it, */
+/* otherwise the decoders have to be serialized with the global lock */
+#if defined(_MSC_VER)
+#define HDECOMP_LOCAL __declspec(thread)
+#define HDECOMP_LOCK
+#define HDECOMP_UNLOCK
+#elif defined(__GNUC__)
+#define HDECOMP_LOCAL __thread
+#define HDECOMP_LOCK
+#define HDECOMP_UNLOCK
+#else
+#define HDECOMP_LOCAL
+#define HDECOMP_LOCK   FFLOCK
+#define HDECOMP_UNLOCK FFUNLOCK
+#endif
+
+static HDECOMP_LOCAL long nextchar;
 
 static int decode(unsigned char *infile, int *a, int *nx, int *ny, int *scale);
 static int decode64(unsigned char *infile, LONGLONG *a, int *nx, int *ny, int *scale);
@@ -103,9 +121,9 @@ int stat;
 
 	/* decode the input array */
 
-        FFLOCK;  /* decode uses the nextchar global variable */
+        HDECOMP_LOCK;  /* decode uses the nextchar variable */
 	stat = decode(input, a, nx, ny, scale);
-        FFUNLOCK;
+        HDECOMP_UNLOCK;
 
         *status = stat;
 	if (stat) return(*status);
@@ -146,9 +164,9 @@ int fits_hdecompress64(unsigned char *input, int smooth, LONGLONG *a, int *ny, i
 
 	/* decode the input array */
 
-        FFLOCK;  /* decode uses the nextchar global variable */
+        HDECOMP_LOCK;  /* decode uses the nextchar variable */
 	stat = decode64(input, a, nx, ny, scale);
-        FFUNLOCK;
+        HDECOMP_UNLOCK;
 
         *status = stat;
 	if (stat) return(*status);
@@ -2468,8 +2486,8 @@ static void qread(unsigned char *file, char buffer[], int n)
 
 /* THE BIT BUFFER */
 
-static int buffer2;			/* Bits waiting to be input	*/
-static int bits_to_go;			/* Number of bits still in buffer */
+static HDECOMP_LOCAL int buffer2;	/* Bits waiting to be input	*/
+static HDECOMP_LOCAL int bits_to_go;	/* Number of bits still in buffer */
 
 /* INITIALIZE BIT INPUT */
 
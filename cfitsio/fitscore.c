@@ -167,6 +167,20 @@ float ffvers(float *version)  /* IO - version number */
     return(*version);
 }
 /*--------------------------------------------------------------------------*/
+int fits_is_reentrant(void)
+/*
+  return 1 if CFITSIO was compiled with -D_REENTRANT (configure
+  --enable-reentrant), so that it may be called from several threads at
+  once, else 0
+*/
+{
+#ifdef _REENTRANT
+    return(1);
+#else
+    return(0);
+#endif
+}
+/*--------------------------------------------------------------------------*/
 int ffflnm(fitsfile *fptr,    /* I - FITS file pointer  */
            char *filename,    /* O - name of the file   */
            int *status)       /* IO - error status      */
@@ -3097,7 +3111,19 @@ int ffgcno( fitsfile *fptr,  /* I - FITS file pionter                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcnn( fitsfile *fptr,  /* I - FITS file pointer                       */
+/* the wildcard search position is kept per thread where the compiler */
+/* supports it, so lookups on different files do not disturb each other */
+#if defined(_MSC_VER)
+#define FFGCNN_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define FFGCNN_LOCAL __thread
+#else
+#define FFGCNN_LOCAL
+#endif
+
+static FFGCNN_LOCAL int startcol;
+
+static int ffgcnn_unlocked( fitsfile *fptr,  /* I - FITS file pointer                       */
             int  casesen,    /* I - case sensitive string comparison? 0=no  */
             char *templt,    /* I - input name of column (w/wildcards)      */
             char *colname,   /* O - full column name up to 68 + 1 chars long*/
@@ -3113,7 +3139,6 @@ int ffgcnn( fitsfile *fptr,  /* I - FITS file pointer                       */
 */
 {
     char errmsg[FLEN_ERRMSG];
-    static int startcol;
     int tstatus, ii, founde, foundw, match, exact, unique;
     long ivalue;
     tcolumn *colptr;
@@ -3228,6 +3253,17 @@ int ffgcnn( fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcnn(fitsfile *fptr, int casesen, char *templt, char *colname,
+           int *colnum, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcnn_unlocked(fptr, casesen, templt, colname, colnum, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 void ffcmps(char *templt,   /* I - input template (may have wildcards)      */
             char *colname,  /* I - full column name up to 68 + 1 chars long */
             int  casesen,   /* I - case sensitive string comparison? 1=yes  */
@@ -6298,7 +6334,7 @@ int ffchdu(fitsfile *fptr,      /* I - FITS file pointer */
     - check the data fill values, and rewrite them if not correct
 */
     char message[FLEN_ERRMSG];
-    int stdriver;
+    int stdriver, lastopen;
 
     /* reset position to the correct HDU if necessary */
     if (fptr->HDUposition != (fptr->Fptr)->curhdu)
@@ -6321,7 +6357,11 @@ int ffchdu(fitsfile *fptr,      /* I - FITS file pointer */
         ffpdfl(fptr, status);  /* insure correct data fill values */
     }
 
-    if ((fptr->Fptr)->open_count == 1)
+    FFLOCK;  /* ffreopen and fits_already_open change the count */
+    lastopen = ((fptr->Fptr)->open_count == 1);
+    FFUNLOCK;
+
+    if (lastopen)
     {
     /* free memory for the CHDU structure only if no other files are using it */
         if ((fptr->Fptr)->tableptr)
@@ -6967,7 +7007,7 @@ int ffdblk(fitsfile *fptr,      /* I - FITS file pointer                    */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffghdt(fitsfile *fptr,      /* I - FITS file pointer             */
+static int ffghdt_unlocked(fitsfile *fptr,      /* I - FITS file pointer             */
            int *exttype,        /* O - type of extension, 0, 1, or 2 */
                                 /*  for IMAGE_HDU, ASCII_TBL, or BINARY_TBL */
            int *status)         /* IO - error status                 */
@@ -7008,7 +7048,17 @@ int ffghdt(fitsfile *fptr,      /* I - FITS file pointer             */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int fits_is_compressed_image(fitsfile *fptr,  /* I - FITS file pointer  */
+int ffghdt(fitsfile *fptr, int *exttype, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffghdt_unlocked(fptr, exttype, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int fits_is_compressed_image_unlocked(fitsfile *fptr,  /* I - FITS file pointer  */
                  int *status)                 /* IO - error status      */
 /*
    Returns TRUE if the CHDU is a compressed image, else returns zero.
@@ -7036,6 +7086,16 @@ int fits_is_compressed_image(fitsfile *fptr,  /* I - FITS file pointer  */
     return(0);
 }
 /*--------------------------------------------------------------------------*/
+int fits_is_compressed_image(fitsfile *fptr, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = fits_is_compressed_image_unlocked(fptr, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgipr(fitsfile *infptr,   /* I - FITS file pointer                     */
         int maxaxis,           /* I - max number of axes to return          */
         int *bitpix,           /* O - image data type                       */
@@ -7094,7 +7154,7 @@ int ffgiprll(fitsfile *infptr,   /* I - FITS file pointer                   */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgidt( fitsfile *fptr,  /* I - FITS file pointer                       */
+static int ffgidt_unlocked( fitsfile *fptr,  /* I - FITS file pointer                       */
             int  *imgtype,   /* O - image data type                         */
             int  *status)    /* IO - error status                           */
 /*
@@ -7132,7 +7192,17 @@ int ffgidt( fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgiet( fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffgidt(fitsfile *fptr, int *imgtype, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgidt_unlocked(fptr, imgtype, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgiet_unlocked( fitsfile *fptr,  /* I - FITS file pointer                       */
             int  *imgtype,   /* O - image data type                         */
             int  *status)    /* IO - error status                           */
 /*
@@ -7256,7 +7326,17 @@ int ffgiet( fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgidm( fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffgiet(fitsfile *fptr, int *imgtype, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgiet_unlocked(fptr, imgtype, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgidm_unlocked( fitsfile *fptr,  /* I - FITS file pointer                       */
             int  *naxis  ,   /* O - image dimension (NAXIS value)           */
             int  *status)    /* IO - error status                           */
 /*
@@ -7291,7 +7371,17 @@ int ffgidm( fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgisz( fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffgidm(fitsfile *fptr, int *naxis, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgidm_unlocked(fptr, naxis, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgisz_unlocked( fitsfile *fptr,  /* I - FITS file pointer                       */
             int nlen,        /* I - number of axes to return                */
             long  *naxes,    /* O - size of image dimensions                */
             int  *status)    /* IO - error status                           */
@@ -7338,7 +7428,17 @@ int ffgisz( fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgiszll( fitsfile *fptr,  /* I - FITS file pointer                     */
+int ffgisz(fitsfile *fptr, int nlen, long *naxes, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgisz_unlocked(fptr, nlen, naxes, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgiszll_unlocked( fitsfile *fptr,  /* I - FITS file pointer                     */
             int nlen,          /* I - number of axes to return              */
             LONGLONG  *naxes,  /* O - size of image dimensions              */
             int  *status)      /* IO - error status                         */
@@ -7381,8 +7481,18 @@ int ffgiszll( fitsfile *fptr,  /* I - FITS file pointer                     */
     }
 
     return(*status);
+}
+/*--------------------------------------------------------------------------*/
+int ffgiszll(fitsfile *fptr, int nlen, LONGLONG *naxes, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgiszll_unlocked(fptr, nlen, naxes, status);
+    FFUNLOCKF(fptr);
+    return(retval);
 }/*--------------------------------------------------------------------------*/
-int ffmahd(fitsfile *fptr,      /* I - FITS file pointer             */
+static int ffmahd_unlocked(fitsfile *fptr,      /* I - FITS file pointer             */
            int hdunum,          /* I - number of the HDU to move to  */
            int *exttype,        /* O - type of extension, 0, 1, or 2 */
            int *status)         /* IO - error status                 */
@@ -7463,7 +7573,17 @@ int ffmahd(fitsfile *fptr,      /* I - FITS file pointer             */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffmrhd(fitsfile *fptr,      /* I - FITS file pointer                    */
+int ffmahd(fitsfile *fptr, int hdunum, int *exttype, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffmahd_unlocked(fptr, hdunum, exttype, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffmrhd_unlocked(fitsfile *fptr,      /* I - FITS file pointer                    */
            int hdumov,          /* I - rel. no. of HDUs to move by (+ or -) */ 
            int *exttype,        /* O - type of extension, 0, 1, or 2        */
            int *status)         /* IO - error status                        */
@@ -7483,6 +7603,16 @@ int ffmrhd(fitsfile *fptr,      /* I - FITS file pointer                    */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffmrhd(fitsfile *fptr, int hdumov, int *exttype, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffmrhd_unlocked(fptr, hdumov, exttype, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffmnhd(fitsfile *fptr,      /* I - FITS file pointer                    */
            int exttype,         /* I - desired extension type               */
            char *hduname,       /* I - desired EXTNAME value for the HDU    */
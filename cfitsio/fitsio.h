@@ -171,7 +171,9 @@ SERVICES PROVIDED HEREUNDER."
 #endif
  
 #define NIOBUF  40  /* number of IO buffers to create (default = 40) */
-          /* !! Significantly increasing NIOBUF may degrade performance !! */
+          /* the number actually used can be raised at run time with */
+          /* fits_set_buffer_pool, for files opened after the call   */
+#define CFITSIO_BUFFER_POOL 1  /* fits_set_buffer_pool is available */
 
 #define IOBUFLEN 2880    /* size in bytes of each IO buffer (DONT CHANGE!) */
 
@@ -402,9 +404,19 @@ typedef struct      /* structure used to store basic FITS file information */
     int tileanynull;        /* anynulls in this tile? */
 
     char *iobuffer;         /* pointer to FITS file I/O buffers */
-    long bufrecnum[NIOBUF]; /* file record number of each of the buffers */
-    int dirty[NIOBUF];     /* has the corresponding buffer been modified? */
-    int ageindex[NIOBUF];  /* relative age of each buffer */  
+    int niobuf;             /* number of I/O buffers in the pool */
+    long *bufrecnum;        /* file record number of each of the buffers */
+    int *dirty;             /* has the corresponding buffer been modified? */
+    int *ageindex;          /* relative age of each buffer */  
+    char *rabuffer;         /* block of records read ahead of sequential reads */
+    int nreadahead;         /* size of the read-ahead block, in records */
+    long rarecnum;          /* first record held in the read-ahead block */
+    long ranrec;            /* number of records held in the read-ahead block */
+    long lastmiss;          /* last record that was not found in the buffers */
+    long bufhits;           /* records found in the I/O buffers */
+    long bufmisses;         /* records that had to be loaded into a buffer */
+    long rahits;            /* loaded records served from the read-ahead block */
+    void *lock;             /* per-file mutex, only used in reentrant builds */
 } FITSfile;
 
 typedef struct         /* structure used to store basic HDU information */
@@ -733,6 +745,9 @@ int fftplt(fitsfile **fptr, const char *filename, const char *tempname,
            int *status);
 int ffflus(fitsfile *fptr, int *status);
 int ffflsh(fitsfile *fptr, int clearbuf, int *status);
+int ffsbfp(int nbuffers, int nreadahead, int *status);
+int ffgbfp(int *nbuffers, int *nreadahead, int *status);
+int ffgbfs(fitsfile *fptr, long *hits, long *misses, long *rahits, int *status);
 int ffclos(fitsfile *fptr, int *status);
 int ffdelt(fitsfile *fptr, int *status);
 int ffflnm(fitsfile *fptr, char *filename, int *status);
@@ -742,6 +757,7 @@ int fits_delete_iraf_file(char *filename, int *status);
 /*---------------- utility routines -------------*/
 
 float ffvers(float *version);
+int fits_is_reentrant(void);
 void ffupch(char *string);
 void ffgerr(int status, char *errtext);
 void ffpmsg(const char *err_message);
@@ -1165,6 +1181,8 @@ int ffgpvk(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
            int nulval, int *array, int *anynul, int *status);
 int ffgpve(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
            float nulval, float *array, int *anynul, int *status);
+int ffgpbe(fitsfile *fptr, int binfactor, float *array, long *nxout,
+           long *nyout, int *status);
 int ffgpvd(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
            double nulval, double *array, int *anynul, int *status);
  
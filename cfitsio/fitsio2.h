@@ -22,14 +22,44 @@
 extern pthread_mutex_t Fitsio_Lock;
 extern int Fitsio_Pthread_Status;
 
-#define FFLOCK1(lockname)   (assert(!(Fitsio_Pthread_Status = pthread_mutex_lock(&lockname))))
-#define FFUNLOCK1(lockname) (assert(!(Fitsio_Pthread_Status = pthread_mutex_unlock(&lockname))))
+/*
+    The lock calls must not sit inside assert(), which drops them when
+    NDEBUG is defined.  Their result is not stored in Fitsio_Pthread_Status
+    (kept only for compatibility), since every thread would write it.
+*/
+#define FFLOCK1(lockname)   ((void) pthread_mutex_lock(&lockname))
+#define FFUNLOCK1(lockname) ((void) pthread_mutex_unlock(&lockname))
 #define FFLOCK   FFLOCK1(Fitsio_Lock)
 #define FFUNLOCK FFUNLOCK1(Fitsio_Lock)
 
+/*
+    Each FITSfile also carries its own recursive mutex, so that handles
+    opened with fits_reopen_file (which share one FITSfile, its I/O
+    buffers and its current HDU) can be read from different threads.
+    The global lock only guards the tables shared by all files and the
+    usage counts of the FITSfiles.
+
+    The read entry points take the file lock: HDU movement (ffmahd,
+    ffmrhd), image geometry (ffghdt, ffgidt, ffgiet, ffgidm, ffgisz),
+    pixel reads (ffgpv, ffgpxv, ffgpxf, ffgpf, ffgsv and typed variants
+    ffgpv<t>, ffgpf<t>, ffg2d<t>, ffg3d<t>, ffgsv<t>, ffgsf<t>, ffggp<t>),
+    column reads (ffgcv, ffgcf, ffgcv<t>, ffgcf<t>, ffgcx), column name
+    lookup (ffgcnn) and keyword reads (ffgky, ffgkey, ffgcrd, ffgrec,
+    ffgnky, ffgkys, ffgkls and the other scalar ffgky<t>).  Writing,
+    creating or deleting HDUs, the keyword list readers (ffgkn<t>) and
+    the lower level ffgcl<t> routines do not lock, so threads that call
+    them on a shared FITSfile must serialize those calls themselves.
+*/
+#define FFLOCKF(fptr)   ((fptr)->Fptr->lock ? \
+    pthread_mutex_lock((pthread_mutex_t *) (fptr)->Fptr->lock) : 0)
+#define FFUNLOCKF(fptr) ((fptr)->Fptr->lock ? \
+    pthread_mutex_unlock((pthread_mutex_t *) (fptr)->Fptr->lock) : 0)
+
 #else
 #define FFLOCK
 #define FFUNLOCK
+#define FFLOCKF(fptr)
+#define FFUNLOCKF(fptr)
 #endif
 
 /*
@@ -351,7 +381,21 @@ int ffgbytoff(fitsfile *fptr, long gsize, long ngroups, long offset,
            void *buffer, int *status);
 int ffpbytoff(fitsfile *fptr, long gsize, long ngroups, long offset,
            void *buffer, int *status);
+/* vectorised byte swapping and datatype conversion kernels are built on */
+/* x86 processors with SSE2; AVX2 versions are selected at run time      */
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define HAVE_SIMD_KERNELS
+#if defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+#define HAVE_AVX2_KERNELS
+#endif
+#endif
+int ffsimd(void);
+
 int ffldrc(fitsfile *fptr, long record, int err_mode, int *status);
+int ffldra(FITSfile *Fptr, long record, int nbuff, int *status);
+int ffallocbuf(FITSfile *Fptr);
+void fffreebuf(FITSfile *Fptr);
 int ffwhbf(fitsfile *fptr, int *nbuff);
 int ffbfeof(fitsfile *fptr, int *status);
 int ffbfwt(FITSfile *Fptr, int nbuff, int *status);
@@ -1064,6 +1108,44 @@ int file_read (int driverhandle, void *buffer, long nbytes);
 int file_write(int driverhandle, void *buffer, long nbytes);
 int file_is_compressed(char *filename);
 
+/* memory mapped file driver I/O routines */
+
+#if defined(unix) || defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#define HAVE_MMAP_SERVICES
+#endif
+
+#ifdef HAVE_MMAP_SERVICES
+int mmap_init(void);
+int mmap_setoptions(int options);
+int mmap_getoptions(int *options);
+int mmap_getversion(int *version);
+int mmap_shutdown(void);
+int mmap_checkfile(char *urltype, char *infile, char *outfile);
+int mmap_open(char *filename, int rwmode, int *driverhandle);
+int mmap_size(int driverhandle, LONGLONG *filesize);
+int mmap_close(int driverhandle);
+int mmap_flush(int driverhandle);
+int mmap_seek(int driverhandle, LONGLONG offset);
+int mmap_read (int driverhandle, void *buffer, long nbytes);
+int mmap_write(int driverhandle, void *buffer, long nbytes);
+#endif
+
+/* gzip stream driver I/O routines */
+
+int gzstream_init(void);
+int gzstream_setoptions(int options);
+int gzstream_getoptions(int *options);
+int gzstream_getversion(int *version);
+int gzstream_shutdown(void);
+int gzstream_checkfile(char *urltype, char *infile, char *outfile);
+int gzstream_open(char *filename, int rwmode, int *driverhandle);
+int gzstream_size(int driverhandle, LONGLONG *filesize);
+int gzstream_close(int driverhandle);
+int gzstream_flush(int driverhandle);
+int gzstream_seek(int driverhandle, LONGLONG offset);
+int gzstream_read (int driverhandle, void *buffer, long nbytes);
+int gzstream_write(int driverhandle, void *buffer, long nbytes);
+
 /* stream driver I/O routines */
 
 int stream_open(char *filename, int rwmode, int *driverhandle);
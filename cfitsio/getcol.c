@@ -10,7 +10,7 @@
 #include "fitsio2.h"
 
 /*--------------------------------------------------------------------------*/
-int ffgpxv( fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgpxv_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  datatype,    /* I - datatype of the value                   */
             long *firstpix,   /* I - coord of first pixel to read (1s based) */
             LONGLONG nelem,   /* I - number of values to read                */
@@ -45,7 +45,18 @@ int ffgpxv( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpxvll( fitsfile *fptr, /* I - FITS file pointer                       */
+int ffgpxv(fitsfile *fptr, int datatype, long *firstpix, LONGLONG nelem,
+           void *nulval, void *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpxv_unlocked(fptr, datatype, firstpix, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpxvll_unlocked( fitsfile *fptr, /* I - FITS file pointer                       */
             int  datatype,    /* I - datatype of the value                   */
             LONGLONG *firstpix, /* I - coord of first pixel to read (1s based) */
             LONGLONG nelem,   /* I - number of values to read                */
@@ -235,7 +246,18 @@ int ffgpxvll( fitsfile *fptr, /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpxf( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpxvll(fitsfile *fptr, int datatype, LONGLONG *firstpix, LONGLONG nelem,
+             void *nulval, void *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpxvll_unlocked(fptr, datatype, firstpix, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpxf_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  datatype,    /* I - datatype of the value                   */
             long *firstpix,   /* I - coord of first pixel to read (1s based) */
             LONGLONG nelem,       /* I - number of values to read            */
@@ -269,7 +291,18 @@ int ffgpxf( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpxfll( fitsfile *fptr, /* I - FITS file pointer                       */
+int ffgpxf(fitsfile *fptr, int datatype, long *firstpix, LONGLONG nelem,
+           void *array, char *nullarray, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpxf_unlocked(fptr, datatype, firstpix, nelem, array, nullarray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpxfll_unlocked( fitsfile *fptr, /* I - FITS file pointer                       */
             int  datatype,    /* I - datatype of the value                   */
             LONGLONG *firstpix, /* I - coord of first pixel to read (1s based) */
             LONGLONG nelem,       /* I - number of values to read              */
@@ -384,7 +417,18 @@ int ffgpxfll( fitsfile *fptr, /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsv(  fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpxfll(fitsfile *fptr, int datatype, LONGLONG *firstpix, LONGLONG nelem,
+             void *array, char *nullarray, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpxfll_unlocked(fptr, datatype, firstpix, nelem, array, nullarray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsv_unlocked(  fitsfile *fptr,   /* I - FITS file pointer                       */
             int  datatype,    /* I - datatype of the value                   */
             long *blc,        /* I - 'bottom left corner' of the subsection  */
             long *trc ,       /* I - 'top right corner' of the subsection    */
@@ -536,7 +580,18 @@ int ffgsv(  fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpv(  fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgsv(fitsfile *fptr, int datatype, long *blc, long *trc, long *inc,
+          void *nulval, void *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsv_unlocked(fptr, datatype, blc, trc, inc, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpv_unlocked(  fitsfile *fptr,   /* I - FITS file pointer                       */
             int  datatype,    /* I - datatype of the value                   */
             LONGLONG firstelem,   /* I - first vector element to read (1 = 1st)  */
             LONGLONG nelem,       /* I - number of values to read                */
@@ -672,7 +727,18 @@ int ffgpv(  fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpf(  fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpv(fitsfile *fptr, int datatype, LONGLONG firstelem, LONGLONG nelem,
+          void *nulval, void *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpv_unlocked(fptr, datatype, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpf_unlocked(  fitsfile *fptr,   /* I - FITS file pointer                       */
             int  datatype,    /* I - datatype of the value                   */
             LONGLONG firstelem,   /* I - first vector element to read (1 = 1st)  */
             LONGLONG nelem,       /* I - number of values to read                */
@@ -761,7 +827,18 @@ int ffgpf(  fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcv(  fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpf(fitsfile *fptr, int datatype, LONGLONG firstelem, LONGLONG nelem,
+          void *array, char *nullarray, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpf_unlocked(fptr, datatype, firstelem, nelem, array, nullarray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcv_unlocked(  fitsfile *fptr,   /* I - FITS file pointer                       */
             int  datatype,    /* I - datatype of the value                   */
             int  colnum,      /* I - number of column to write (1 = 1st col) */
             LONGLONG  firstrow,   /* I - first row to write (1 = 1st row)        */
@@ -938,7 +1015,19 @@ int ffgcv(  fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcf(  fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcv(fitsfile *fptr, int datatype, int colnum, LONGLONG firstrow,
+          LONGLONG firstelem, LONGLONG nelem, void *nulval, void *array,
+          int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcv_unlocked(fptr, datatype, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcf_unlocked(  fitsfile *fptr,   /* I - FITS file pointer                       */
             int  datatype,    /* I - datatype of the value                   */
             int  colnum,      /* I - number of column to write (1 = 1st col) */
             LONGLONG  firstrow,   /* I - first row to write (1 = 1st row)        */
@@ -1052,4 +1141,15 @@ int ffgcf(  fitsfile *fptr,   /* I - FITS file pointer                       */
 
     return(*status);
 }
+/*--------------------------------------------------------------------------*/
+int ffgcf(fitsfile *fptr, int datatype, int colnum, LONGLONG firstrow,
+          LONGLONG firstelem, LONGLONG nelem, void *array, char *nullarray,
+          int *anynul, int *status)
+{
+    int retval;
 
+    FFLOCKF(fptr);
+    retval = ffgcf_unlocked(fptr, datatype, colnum, firstrow, firstelem, nelem, array, nullarray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
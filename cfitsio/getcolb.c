@@ -12,7 +12,7 @@
 #include "fitsio2.h"
 
 /*--------------------------------------------------------------------------*/
-int ffgpvb( fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgpvb_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -57,7 +57,19 @@ int ffgpvb( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpfb( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpvb(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+           unsigned char nulval, unsigned char *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpvb_unlocked(fptr, group, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpfb_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -100,7 +112,18 @@ int ffgpfb( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg2db(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffgpfb(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+           unsigned char *array, char *nularray, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpfb_unlocked(fptr, group, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg2db_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            unsigned char nulval, /* set undefined pixels equal to this     */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -125,7 +148,19 @@ int ffg2db(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg3db(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffg2db(fitsfile *fptr, long group, unsigned char nulval, LONGLONG ncols,
+           LONGLONG naxis1, LONGLONG naxis2, unsigned char *array,
+           int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg2db_unlocked(fptr, group, nulval, ncols, naxis1, naxis2, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg3db_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            unsigned char nulval, /* set undefined pixels equal to this     */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -210,7 +245,19 @@ int ffg3db(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsvb(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffg3db(fitsfile *fptr, long group, unsigned char nulval, LONGLONG ncols,
+           LONGLONG nrows, LONGLONG naxis1, LONGLONG naxis2, LONGLONG naxis3,
+           unsigned char *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg3db_unlocked(fptr, group, nulval, ncols, nrows, naxis1, naxis2, naxis3, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsvb_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -387,7 +434,19 @@ int ffgsvb(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsfb(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffgsvb(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+           long *trc, long *inc, unsigned char nulval, unsigned char *array,
+           int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsvb_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsfb_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -551,7 +610,19 @@ int ffgsfb(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffggpb( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgsfb(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+           long *trc, long *inc, unsigned char *array, char *flagval,
+           int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsfb_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, array, flagval, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffggpb_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             long  firstelem,  /* I - first vector element to read (1 = 1st)  */
             long  nelem,      /* I - number of values to read                */
@@ -580,7 +651,18 @@ int ffggpb( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcvb(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffggpb(fitsfile *fptr, long group, long firstelem, long nelem,
+           unsigned char *array, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffggpb_unlocked(fptr, group, firstelem, nelem, array, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcvb_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -605,7 +687,19 @@ int ffgcvb(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfb(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcvb(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, unsigned char nulval, unsigned char *array,
+           int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcvb_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcfb_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -630,6 +724,18 @@ int ffgcfb(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcfb(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, unsigned char *array, char *nularray, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfb_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgclb( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
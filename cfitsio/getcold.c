@@ -12,7 +12,7 @@
 #include "fitsio2.h"
 
 /*--------------------------------------------------------------------------*/
-int ffgpvd( fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgpvd_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -58,7 +58,18 @@ int ffgpvd( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpfd( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpvd(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+           double nulval, double *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpvd_unlocked(fptr, group, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpfd_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -101,7 +112,18 @@ int ffgpfd( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg2dd(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffgpfd(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+           double *array, char *nularray, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpfd_unlocked(fptr, group, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg2dd_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            double nulval,   /* set undefined pixels equal to this          */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -126,7 +148,19 @@ int ffg2dd(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg3dd(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffg2dd(fitsfile *fptr, long group, double nulval, LONGLONG ncols,
+           LONGLONG naxis1, LONGLONG naxis2, double *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg2dd_unlocked(fptr, group, nulval, ncols, naxis1, naxis2, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg3dd_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            double nulval,   /* set undefined pixels equal to this          */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -211,7 +245,19 @@ int ffg3dd(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsvd(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffg3dd(fitsfile *fptr, long group, double nulval, LONGLONG ncols,
+           LONGLONG nrows, LONGLONG naxis1, LONGLONG naxis2, LONGLONG naxis3,
+           double *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg3dd_unlocked(fptr, group, nulval, ncols, nrows, naxis1, naxis2, naxis3, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsvd_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -388,7 +434,19 @@ int ffgsvd(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsfd(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffgsvd(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+           long *trc, long *inc, double nulval, double *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsvd_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsfd_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -551,7 +609,19 @@ int ffgsfd(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffggpd( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgsfd(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+           long *trc, long *inc, double *array, char *flagval, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsfd_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, array, flagval, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffggpd_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             long  firstelem,  /* I - first vector element to read (1 = 1st)  */
             long  nelem,      /* I - number of values to read                */
@@ -580,7 +650,18 @@ int ffggpd( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcvd(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffggpd(fitsfile *fptr, long group, long firstelem, long nelem,
+           double *array, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffggpd_unlocked(fptr, group, firstelem, nelem, array, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcvd_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -605,7 +686,19 @@ int ffgcvd(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcvm(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcvd(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, double nulval, double *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcvd_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcvm_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -635,7 +728,19 @@ int ffgcvm(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfd(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcvm(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, double nulval, double *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcvm_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcfd_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -660,7 +765,19 @@ int ffgcfd(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfm(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcfd(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, double *array, char *nularray, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfd_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcfm_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -705,6 +822,18 @@ int ffgcfm(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcfm(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, double *array, char *nularray, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfm_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgcld( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
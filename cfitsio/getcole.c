@@ -11,8 +11,179 @@
 #include <string.h>
 #include "fitsio2.h"
 
+#ifdef HAVE_SIMD_KERNELS
+#include <emmintrin.h>
+#ifdef HAVE_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+/*
+  Vectorised versions of the no-null-check loops in fffi2r4, fffi4r4 and
+  fffr4r4.  Scaling is done in double precision, exactly as in the scalar
+  loops, so the results are identical.  Each routine returns the number of
+  elements converted; the caller finishes the remainder.
+*/
+/*--------------------------------------------------------------------------*/
+static __m128 ffscale4_sse2(__m128d lo, __m128d hi, __m128d vscale, __m128d vzero)
+{
+    lo = _mm_add_pd(_mm_mul_pd(lo, vscale), vzero);
+    hi = _mm_add_pd(_mm_mul_pd(hi, vscale), vzero);
+    return(_mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+}
+#ifdef HAVE_AVX2_KERNELS
+/*--------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static long ffi2r4_avx2(short *input, long ntodo, int scaled, double scale,
+                        double zero, float *output)
+{
+    long ii;
+    __m256i iv;
+    __m256d vscale = _mm256_set1_pd(scale), vzero = _mm256_set1_pd(zero), d;
+
+    for (ii = 0; ii + 8 <= ntodo; ii += 8)
+    {
+        iv = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i *) (input + ii)));
+        if (!scaled)
+        {
+            _mm256_storeu_ps(output + ii, _mm256_cvtepi32_ps(iv));
+            continue;
+        }
+        d = _mm256_cvtepi32_pd(_mm256_castsi256_si128(iv));
+        d = _mm256_add_pd(_mm256_mul_pd(d, vscale), vzero);
+        _mm_storeu_ps(output + ii, _mm256_cvtpd_ps(d));
+        d = _mm256_cvtepi32_pd(_mm256_extracti128_si256(iv, 1));
+        d = _mm256_add_pd(_mm256_mul_pd(d, vscale), vzero);
+        _mm_storeu_ps(output + ii + 4, _mm256_cvtpd_ps(d));
+    }
+    return(ii);
+}
+/*--------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static long ffi4r4_avx2(INT32BIT *input, long ntodo, int scaled, double scale,
+                        double zero, float *output)
+{
+    long ii;
+    __m256i iv;
+    __m256d vscale = _mm256_set1_pd(scale), vzero = _mm256_set1_pd(zero), d;
+
+    for (ii = 0; ii + 8 <= ntodo; ii += 8)
+    {
+        iv = _mm256_loadu_si256((__m256i *) (input + ii));
+        if (!scaled)
+        {
+            _mm256_storeu_ps(output + ii, _mm256_cvtepi32_ps(iv));
+            continue;
+        }
+        d = _mm256_cvtepi32_pd(_mm256_castsi256_si128(iv));
+        d = _mm256_add_pd(_mm256_mul_pd(d, vscale), vzero);
+        _mm_storeu_ps(output + ii, _mm256_cvtpd_ps(d));
+        d = _mm256_cvtepi32_pd(_mm256_extracti128_si256(iv, 1));
+        d = _mm256_add_pd(_mm256_mul_pd(d, vscale), vzero);
+        _mm_storeu_ps(output + ii + 4, _mm256_cvtpd_ps(d));
+    }
+    return(ii);
+}
 /*--------------------------------------------------------------------------*/
-int ffgpve( fitsfile *fptr,   /* I - FITS file pointer                       */
+__attribute__((target("avx2")))
+static long ffr4r4_avx2(float *input, long ntodo, double scale,
+                        double zero, float *output)
+{
+    long ii;
+    __m256d vscale = _mm256_set1_pd(scale), vzero = _mm256_set1_pd(zero), d;
+
+    for (ii = 0; ii + 4 <= ntodo; ii += 4)
+    {
+        d = _mm256_cvtps_pd(_mm_loadu_ps(input + ii));
+        d = _mm256_add_pd(_mm256_mul_pd(d, vscale), vzero);
+        _mm_storeu_ps(output + ii, _mm256_cvtpd_ps(d));
+    }
+    return(ii);
+}
+#endif
+/*--------------------------------------------------------------------------*/
+static long ffi2r4_simd(short *input, long ntodo, int scaled, double scale,
+                        double zero, float *output)
+{
+    long ii;
+    __m128i v, lo, hi;
+    __m128d vscale = _mm_set1_pd(scale), vzero = _mm_set1_pd(zero);
+
+#ifdef HAVE_AVX2_KERNELS
+    if (ffsimd() >= 2)
+        return(ffi2r4_avx2(input, ntodo, scaled, scale, zero, output));
+#endif
+
+    for (ii = 0; ii + 8 <= ntodo; ii += 8)
+    {
+        /* sign extend the shorts to 32-bit integers */
+        v = _mm_loadu_si128((__m128i *) (input + ii));
+        lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        if (!scaled)
+        {
+            _mm_storeu_ps(output + ii, _mm_cvtepi32_ps(lo));
+            _mm_storeu_ps(output + ii + 4, _mm_cvtepi32_ps(hi));
+            continue;
+        }
+        _mm_storeu_ps(output + ii, ffscale4_sse2(_mm_cvtepi32_pd(lo),
+            _mm_cvtepi32_pd(_mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2))),
+            vscale, vzero));
+        _mm_storeu_ps(output + ii + 4, ffscale4_sse2(_mm_cvtepi32_pd(hi),
+            _mm_cvtepi32_pd(_mm_shuffle_epi32(hi, _MM_SHUFFLE(1, 0, 3, 2))),
+            vscale, vzero));
+    }
+    return(ii);
+}
+/*--------------------------------------------------------------------------*/
+static long ffi4r4_simd(INT32BIT *input, long ntodo, int scaled, double scale,
+                        double zero, float *output)
+{
+    long ii;
+    __m128i v;
+    __m128d vscale = _mm_set1_pd(scale), vzero = _mm_set1_pd(zero);
+
+#ifdef HAVE_AVX2_KERNELS
+    if (ffsimd() >= 2)
+        return(ffi4r4_avx2(input, ntodo, scaled, scale, zero, output));
+#endif
+
+    for (ii = 0; ii + 4 <= ntodo; ii += 4)
+    {
+        v = _mm_loadu_si128((__m128i *) (input + ii));
+        if (!scaled)
+            _mm_storeu_ps(output + ii, _mm_cvtepi32_ps(v));
+        else
+            _mm_storeu_ps(output + ii, ffscale4_sse2(_mm_cvtepi32_pd(v),
+                _mm_cvtepi32_pd(_mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2))),
+                vscale, vzero));
+    }
+    return(ii);
+}
+/*--------------------------------------------------------------------------*/
+static long ffr4r4_simd(float *input, long ntodo, double scale,
+                        double zero, float *output)
+{
+    long ii;
+    __m128 v;
+    __m128d vscale = _mm_set1_pd(scale), vzero = _mm_set1_pd(zero);
+
+#ifdef HAVE_AVX2_KERNELS
+    if (ffsimd() >= 2)
+        return(ffr4r4_avx2(input, ntodo, scale, zero, output));
+#endif
+
+    for (ii = 0; ii + 4 <= ntodo; ii += 4)
+    {
+        v = _mm_loadu_ps(input + ii);
+        _mm_storeu_ps(output + ii, ffscale4_sse2(_mm_cvtps_pd(v),
+            _mm_cvtps_pd(_mm_movehl_ps(v, v)), vscale, vzero));
+    }
+    return(ii);
+}
+#endif
+
+/*--------------------------------------------------------------------------*/
+static int ffgpve_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -58,7 +229,137 @@ int ffgpve( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpfe( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpve(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+           float nulval, float *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpve_unlocked(fptr, group, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+int ffgpbe( fitsfile *fptr,   /* I - FITS file pointer                       */
+            int   binfactor,  /* I - size of the square blocks to average    */
+            float *array,     /* O - binned image, or NULL to get the size   */
+            long  *nxout,     /* O - width of the binned image               */
+            long  *nyout,     /* O - height of the binned image              */
+            int  *status)     /* IO - error status                           */
+/*
+  Read the first plane of the current image HDU reduced by BINFACTOR in
+  each direction: every output pixel is the mean of the non-null pixels
+  in a BINFACTOR x BINFACTOR block, or NaN if the whole block is null.
+  Partial blocks at the right and top edges are averaged over the pixels
+  they contain.  The image is read front to back in bands of whole block
+  rows, so only the output and one band are ever held in memory.  Call
+  with ARRAY = NULL to get the dimensions of the output first.
+*/
+{
+    union { unsigned int i; float f; } fnull;
+    long naxes[2] = {1, 1}, nx, ny, nbx, nby, bandrows, row, nrows, ii, jj, bx;
+    int naxis;
+    float *band, *pix, *end;
+    double *sum;
+    long *count;
+    int anynul;
+
+    if (*status > 0)
+        return(*status);
+
+    if (binfactor < 1)
+    {
+        ffpmsg("binning factor must be at least 1 (ffgpbe)");
+        return(*status = BAD_DIMEN);
+    }
+
+    FFLOCKF(fptr);
+    if (ffgidm(fptr, &naxis, status) || ffgisz(fptr, 2, naxes, status))
+    {
+        FFUNLOCKF(fptr);
+        return(*status);
+    }
+
+    if (naxis < 2)
+    {
+        FFUNLOCKF(fptr);
+        ffpmsg("image must have at least 2 dimensions (ffgpbe)");
+        return(*status = BAD_NAXIS);
+    }
+
+    nx = naxes[0];
+    ny = naxes[1];
+    *nxout = nbx = (nx + binfactor - 1) / binfactor;
+    *nyout = nby = (ny + binfactor - 1) / binfactor;
+
+    if (!array || nx == 0 || ny == 0)
+    {
+        FFUNLOCKF(fptr);
+        return(*status);
+    }
+
+    /* whole block rows, as many as fit in about a million pixels */
+    bandrows = binfactor * maxvalue(1, 1048576 / ((LONGLONG) binfactor * nx));
+    bandrows = minvalue(bandrows, ny);
+
+    band = (float *) malloc(bandrows * nx * sizeof(float));
+    sum = (double *) malloc(nbx * sizeof(double));
+    count = (long *) malloc(nbx * sizeof(long));
+    if (!band || !sum || !count)
+    {
+        free(band);
+        free(sum);
+        free(count);
+        FFUNLOCKF(fptr);
+        ffpmsg("could not allocate memory for binned image (ffgpbe)");
+        return(*status = MEMORY_ALLOCATION);
+    }
+
+    /* null pixels are read as NaN, and left out of the means */
+    fnull.i = 0x7FC00000;
+
+    for (row = 0; row < ny; row += bandrows)
+    {
+        nrows = minvalue(bandrows, ny - row);
+        if (ffgpve(fptr, 1, (LONGLONG) row * nx + 1, (LONGLONG) nrows * nx,
+                   fnull.f, band, &anynul, status) > 0)
+            break;
+
+        for (jj = 0; jj < nrows; jj += binfactor)
+        {
+            for (bx = 0; bx < nbx; bx++)
+            {
+                sum[bx] = 0.;
+                count[bx] = 0;
+            }
+
+            end = band + minvalue(jj + binfactor, nrows) * nx;
+            for (pix = band + jj * nx; pix < end; pix += nx)
+            {
+                for (ii = 0; ii < nx; ii++)
+                {
+                    if (pix[ii] == pix[ii])     /* false only for NaN */
+                    {
+                        sum[ii / binfactor] += pix[ii];
+                        count[ii / binfactor]++;
+                    }
+                }
+            }
+
+            for (bx = 0; bx < nbx; bx++)
+                array[((row + jj) / binfactor) * nbx + bx] =
+                    count[bx] ? (float) (sum[bx] / count[bx]) : fnull.f;
+        }
+    }
+
+    free(band);
+    free(sum);
+    free(count);
+    FFUNLOCKF(fptr);
+    return(*status);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpfe_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -101,7 +402,18 @@ int ffgpfe( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg2de(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffgpfe(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+           float *array, char *nularray, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpfe_unlocked(fptr, group, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg2de_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            float nulval,    /* set undefined pixels equal to this          */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -126,7 +438,19 @@ int ffg2de(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg3de(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffg2de(fitsfile *fptr, long group, float nulval, LONGLONG ncols,
+           LONGLONG naxis1, LONGLONG naxis2, float *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg2de_unlocked(fptr, group, nulval, ncols, naxis1, naxis2, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg3de_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            float nulval,    /* set undefined pixels equal to this          */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -211,7 +535,19 @@ int ffg3de(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsve(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffg3de(fitsfile *fptr, long group, float nulval, LONGLONG ncols,
+           LONGLONG nrows, LONGLONG naxis1, LONGLONG naxis2, LONGLONG naxis3,
+           float *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg3de_unlocked(fptr, group, nulval, ncols, nrows, naxis1, naxis2, naxis3, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsve_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -388,7 +724,19 @@ int ffgsve(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsfe(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffgsve(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+           long *trc, long *inc, float nulval, float *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsve_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsfe_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -552,7 +900,19 @@ int ffgsfe(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffggpe( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgsfe(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+           long *trc, long *inc, float *array, char *flagval, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsfe_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, array, flagval, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffggpe_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             long  firstelem,  /* I - first vector element to read (1 = 1st)  */
             long  nelem,      /* I - number of values to read                */
@@ -581,7 +941,18 @@ int ffggpe( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcve(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffggpe(fitsfile *fptr, long group, long firstelem, long nelem,
+           float *array, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffggpe_unlocked(fptr, group, firstelem, nelem, array, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcve_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -606,7 +977,19 @@ int ffgcve(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcvc(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcve(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, float nulval, float *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcve_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcvc_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -636,7 +1019,19 @@ int ffgcvc(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfe(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcvc(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, float nulval, float *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcvc_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcfe_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -661,7 +1056,19 @@ int ffgcfe(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfc(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcfe(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, float *array, char *nularray, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfe_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcfc_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -706,6 +1113,18 @@ int ffgcfc(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcfc(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, float *array, char *nularray, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfc_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgcle( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
@@ -1090,12 +1509,20 @@ int fffi2r4(short *input,         /* I - array of values to be converted     */
     {
         if (scale == 1. && zero == 0.)      /* no scaling */
         {       
-            for (ii = 0; ii < ntodo; ii++)
+            ii = 0;
+#ifdef HAVE_SIMD_KERNELS
+            ii = ffi2r4_simd(input, ntodo, 0, scale, zero, output);
+#endif
+            for (; ii < ntodo; ii++)
                 output[ii] = (float) input[ii];  /* copy input to output */
         }
         else             /* must scale the data */
         {
-            for (ii = 0; ii < ntodo; ii++)
+            ii = 0;
+#ifdef HAVE_SIMD_KERNELS
+            ii = ffi2r4_simd(input, ntodo, 1, scale, zero, output);
+#endif
+            for (; ii < ntodo; ii++)
             {
                 output[ii] = (float) (input[ii] * scale + zero);
             }
@@ -1174,12 +1601,20 @@ int fffi4r4(INT32BIT *input,      /* I - array of values to be converted     */
     {
         if (scale == 1. && zero == 0.)      /* no scaling */
         {       
-            for (ii = 0; ii < ntodo; ii++)
+            ii = 0;
+#ifdef HAVE_SIMD_KERNELS
+            ii = ffi4r4_simd(input, ntodo, 0, scale, zero, output);
+#endif
+            for (; ii < ntodo; ii++)
                 output[ii] = (float) input[ii];  /* copy input to output */
         }
         else             /* must scale the data */
         {
-            for (ii = 0; ii < ntodo; ii++)
+            ii = 0;
+#ifdef HAVE_SIMD_KERNELS
+            ii = ffi4r4_simd(input, ntodo, 1, scale, zero, output);
+#endif
+            for (; ii < ntodo; ii++)
             {
                 output[ii] = (float) (input[ii] * scale + zero);
             }
@@ -1346,7 +1781,11 @@ int fffr4r4(float *input,         /* I - array of values to be converted     */
         }
         else             /* must scale the data */
         {
-            for (ii = 0; ii < ntodo; ii++)
+            ii = 0;
+#ifdef HAVE_SIMD_KERNELS
+            ii = ffr4r4_simd(input, ntodo, scale, zero, output);
+#endif
+            for (; ii < ntodo; ii++)
             {
                 output[ii] = (float) (input[ii] * scale + zero);
             }
@@ -12,7 +12,7 @@
 #include "fitsio2.h"
 
 /*--------------------------------------------------------------------------*/
-int ffgpvi( fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgpvi_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -56,7 +56,18 @@ int ffgpvi( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpfi( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpvi(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+           short nulval, short *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpvi_unlocked(fptr, group, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpfi_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -99,7 +110,18 @@ int ffgpfi( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg2di(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffgpfi(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+           short *array, char *nularray, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpfi_unlocked(fptr, group, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg2di_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            short nulval,    /* set undefined pixels equal to this          */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -124,7 +146,19 @@ int ffg2di(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg3di(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffg2di(fitsfile *fptr, long group, short nulval, LONGLONG ncols,
+           LONGLONG naxis1, LONGLONG naxis2, short *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg2di_unlocked(fptr, group, nulval, ncols, naxis1, naxis2, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg3di_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            short nulval,    /* set undefined pixels equal to this          */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -209,7 +243,19 @@ int ffg3di(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsvi(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffg3di(fitsfile *fptr, long group, short nulval, LONGLONG ncols,
+           LONGLONG nrows, LONGLONG naxis1, LONGLONG naxis2, LONGLONG naxis3,
+           short *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg3di_unlocked(fptr, group, nulval, ncols, nrows, naxis1, naxis2, naxis3, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsvi_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -387,7 +433,19 @@ int ffgsvi(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsfi(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffgsvi(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+           long *trc, long *inc, short nulval, short *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsvi_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsfi_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -551,7 +609,19 @@ int ffgsfi(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffggpi( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgsfi(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+           long *trc, long *inc, short *array, char *flagval, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsfi_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, array, flagval, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffggpi_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             long  firstelem,  /* I - first vector element to read (1 = 1st)  */
             long  nelem,      /* I - number of values to read                */
@@ -580,7 +650,18 @@ int ffggpi( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcvi(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffggpi(fitsfile *fptr, long group, long firstelem, long nelem,
+           short *array, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffggpi_unlocked(fptr, group, firstelem, nelem, array, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcvi_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -605,7 +686,19 @@ int ffgcvi(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfi(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcvi(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, short nulval, short *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcvi_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcfi_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -630,6 +723,18 @@ int ffgcfi(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcfi(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, short *array, char *nularray, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfi_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgcli( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
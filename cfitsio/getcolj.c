@@ -12,7 +12,7 @@
 #include "fitsio2.h"
 
 /*--------------------------------------------------------------------------*/
-int ffgpvj( fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgpvj_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -58,7 +58,18 @@ int ffgpvj( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpfj( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpvj(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+           long nulval, long *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpvj_unlocked(fptr, group, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpfj_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -101,7 +112,18 @@ int ffgpfj( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg2dj(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffgpfj(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+           long *array, char *nularray, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpfj_unlocked(fptr, group, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg2dj_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            long  nulval,    /* set undefined pixels equal to this          */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -126,7 +148,19 @@ int ffg2dj(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg3dj(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffg2dj(fitsfile *fptr, long group, long nulval, LONGLONG ncols,
+           LONGLONG naxis1, LONGLONG naxis2, long *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg2dj_unlocked(fptr, group, nulval, ncols, naxis1, naxis2, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg3dj_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            long  nulval,    /* set undefined pixels equal to this          */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -209,7 +243,19 @@ int ffg3dj(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsvj(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffg3dj(fitsfile *fptr, long group, long nulval, LONGLONG ncols,
+           LONGLONG nrows, LONGLONG naxis1, LONGLONG naxis2, LONGLONG naxis3,
+           long *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg3dj_unlocked(fptr, group, nulval, ncols, nrows, naxis1, naxis2, naxis3, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsvj_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -386,7 +432,19 @@ int ffgsvj(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsfj(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffgsvj(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+           long *trc, long *inc, long nulval, long *array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsvj_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsfj_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -550,7 +608,19 @@ int ffgsfj(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffggpj( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgsfj(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+           long *trc, long *inc, long *array, char *flagval, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsfj_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, array, flagval, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffggpj_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             long  firstelem,  /* I - first vector element to read (1 = 1st)  */
             long  nelem,      /* I - number of values to read                */
@@ -579,7 +649,18 @@ int ffggpj( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcvj(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffggpj(fitsfile *fptr, long group, long firstelem, long nelem,
+           long *array, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffggpj_unlocked(fptr, group, firstelem, nelem, array, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcvj_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -604,7 +685,18 @@ int ffgcvj(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfj(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcvj(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, long nulval, long *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcvj_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcfj_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -629,6 +721,18 @@ int ffgcfj(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcfj(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, long *array, char *nularray, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfj_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgclj( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
@@ -1883,7 +1987,7 @@ int fffstri4(char *input,         /* I - array of values to be converted     */
 /* ======================================================================== */
 
 /*--------------------------------------------------------------------------*/
-int ffgpvjj(fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgpvjj_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -1929,7 +2033,18 @@ int ffgpvjj(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpfjj(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpvjj(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+            LONGLONG nulval, LONGLONG *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpvjj_unlocked(fptr, group, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpfjj_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -1973,7 +2088,18 @@ int ffgpfjj(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg2djj(fitsfile *fptr, /* I - FITS file pointer                       */
+int ffgpfjj(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+            LONGLONG *array, char *nularray, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpfjj_unlocked(fptr, group, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg2djj_unlocked(fitsfile *fptr, /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            LONGLONG nulval ,/* set undefined pixels equal to this          */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -1998,7 +2124,19 @@ int ffg2djj(fitsfile *fptr, /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg3djj(fitsfile *fptr, /* I - FITS file pointer                       */
+int ffg2djj(fitsfile *fptr, long group, LONGLONG nulval, LONGLONG ncols,
+            LONGLONG naxis1, LONGLONG naxis2, LONGLONG *array, int *anynul,
+            int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg2djj_unlocked(fptr, group, nulval, ncols, naxis1, naxis2, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg3djj_unlocked(fitsfile *fptr, /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            LONGLONG nulval, /* set undefined pixels equal to this          */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -2082,7 +2220,19 @@ int ffg3djj(fitsfile *fptr, /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsvjj(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffg3djj(fitsfile *fptr, long group, LONGLONG nulval, LONGLONG ncols,
+            LONGLONG nrows, LONGLONG naxis1, LONGLONG naxis2, LONGLONG naxis3,
+            LONGLONG *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg3djj_unlocked(fptr, group, nulval, ncols, nrows, naxis1, naxis2, naxis3, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsvjj_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -2259,7 +2409,19 @@ int ffgsvjj(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsfjj(fitsfile *fptr, /* I - FITS file pointer                         */
+int ffgsvjj(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+            long *trc, long *inc, LONGLONG nulval, LONGLONG *array,
+            int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsvjj_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsfjj_unlocked(fitsfile *fptr, /* I - FITS file pointer                         */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -2423,7 +2585,19 @@ int ffgsfjj(fitsfile *fptr, /* I - FITS file pointer                         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffggpjj(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgsfjj(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+            long *trc, long *inc, LONGLONG *array, char *flagval, int *anynul,
+            int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsfjj_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, array, flagval, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffggpjj_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             long  firstelem,  /* I - first vector element to read (1 = 1st)  */
             long  nelem,      /* I - number of values to read                */
@@ -2454,7 +2628,18 @@ int ffggpjj(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcvjj(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffggpjj(fitsfile *fptr, long group, long firstelem, long nelem,
+            LONGLONG *array, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffggpjj_unlocked(fptr, group, firstelem, nelem, array, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcvjj_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -2479,7 +2664,19 @@ int ffgcvjj(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfjj(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffgcvjj(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+            LONGLONG nelem, LONGLONG nulval, LONGLONG *array, int *anynul,
+            int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcvjj_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcfjj_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -2504,6 +2701,18 @@ int ffgcfjj(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcfjj(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+            LONGLONG nelem, LONGLONG *array, char *nularray, int *anynul,
+            int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfjj_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgcljj( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
@@ -9,7 +9,7 @@
 #include <string.h>
 #include "fitsio2.h"
 /*--------------------------------------------------------------------------*/
-int ffgcvl( fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgcvl_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -32,6 +32,17 @@ int ffgcvl( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcvl(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, char nulval, char *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcvl_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgcl(  fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
@@ -55,7 +66,7 @@ int ffgcl(  fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfl( fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgcfl_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -76,6 +87,18 @@ int ffgcfl( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcfl(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, char *array, char *nularray, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfl_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgcll( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
@@ -210,7 +233,7 @@ int ffgcll( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcx(  fitsfile *fptr,  /* I - FITS file pointer                       */
+static int ffgcx_unlocked(  fitsfile *fptr,  /* I - FITS file pointer                       */
             int   colnum,    /* I - number of column to write (1 = 1st col) */
             LONGLONG  frow,      /* I - first row to write (1 = 1st row)        */
             LONGLONG  fbit,      /* I - first bit to write (1 = 1st)            */
@@ -340,7 +363,18 @@ int ffgcx(  fitsfile *fptr,  /* I - FITS file pointer                       */
     }
 }
 /*--------------------------------------------------------------------------*/
-int ffgcxui(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcx(fitsfile *fptr, int colnum, LONGLONG frow, LONGLONG fbit,
+          LONGLONG nbit, char *larray, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcx_unlocked(fptr, colnum, frow, fbit, nbit, larray, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcxui_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
             LONGLONG  nrows,      /* I - no. of rows to read                     */
@@ -477,7 +511,19 @@ int ffgcxui(fitsfile *fptr,   /* I - FITS file pointer                       */
 }
 
 /*--------------------------------------------------------------------------*/
-int ffgcxuk(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcxui(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG nrows,
+            long input_first_bit, int input_nbits, unsigned short *array,
+            int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcxui_unlocked(fptr, colnum, firstrow, nrows, input_first_bit, input_nbits, array, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcxuk_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
             LONGLONG  nrows,      /* I - no. of rows to read                     */
@@ -612,3 +658,15 @@ int ffgcxuk(fitsfile *fptr,   /* I - FITS file pointer                       */
 
     return(*status);
 }
+/*--------------------------------------------------------------------------*/
+int ffgcxuk(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG nrows,
+            long input_first_bit, int input_nbits, unsigned int *array,
+            int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcxuk_unlocked(fptr, colnum, firstrow, nrows, input_first_bit, input_nbits, array, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
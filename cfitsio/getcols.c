@@ -12,7 +12,7 @@
 #include <ctype.h>
 #include "fitsio2.h"
 /*--------------------------------------------------------------------------*/
-int ffgcvs( fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgcvs_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -34,7 +34,19 @@ int ffgcvs( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfs( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgcvs(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, char *nulval, char **array, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcvs_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcfs_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col) */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)        */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st) */
@@ -56,6 +68,18 @@ int ffgcfs( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcfs(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+           LONGLONG nelem, char **array, char *nularray, int *anynul,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfs_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgcls( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col) */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)        */
@@ -476,7 +500,7 @@ int ffgcls( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcdw( fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgcdw_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column (1 = 1st col)      */
             int  *width,      /* O - display width                       */
             int  *status)     /* IO - error status                           */
@@ -619,6 +643,16 @@ int ffgcdw( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcdw(fitsfile *fptr, int colnum, int *width, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcdw_unlocked(fptr, colnum, width, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgcls2 ( fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col) */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)        */
@@ -12,7 +12,7 @@
 #include "fitsio2.h"
 
 /*--------------------------------------------------------------------------*/
-int ffgpvsb(fitsfile *fptr,   /* I - FITS file pointer                       */
+static int ffgpvsb_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -57,7 +57,18 @@ int ffgpvsb(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgpfsb(fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgpvsb(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+            signed char nulval, signed char *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpvsb_unlocked(fptr, group, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgpfsb_unlocked(fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
             LONGLONG  nelem,      /* I - number of values to read                */
@@ -100,7 +111,18 @@ int ffgpfsb(fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg2dsb(fitsfile *fptr, /* I - FITS file pointer                       */
+int ffgpfsb(fitsfile *fptr, long group, LONGLONG firstelem, LONGLONG nelem,
+            signed char *array, char *nularray, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgpfsb_unlocked(fptr, group, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg2dsb_unlocked(fitsfile *fptr, /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            signed char nulval,   /* set undefined pixels equal to this     */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -125,7 +147,19 @@ int ffg2dsb(fitsfile *fptr, /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffg3dsb(fitsfile *fptr, /* I - FITS file pointer                       */
+int ffg2dsb(fitsfile *fptr, long group, signed char nulval, LONGLONG ncols,
+            LONGLONG naxis1, LONGLONG naxis2, signed char *array, int *anynul,
+            int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg2dsb_unlocked(fptr, group, nulval, ncols, naxis1, naxis2, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffg3dsb_unlocked(fitsfile *fptr, /* I - FITS file pointer                       */
            long  group,     /* I - group to read (1 = 1st group)           */
            signed char nulval,   /* set undefined pixels equal to this     */
            LONGLONG  ncols,     /* I - number of pixels in each row of array   */
@@ -210,7 +244,19 @@ int ffg3dsb(fitsfile *fptr, /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsvsb(fitsfile *fptr, /* I - FITS file pointer                        */
+int ffg3dsb(fitsfile *fptr, long group, signed char nulval, LONGLONG ncols,
+            LONGLONG nrows, LONGLONG naxis1, LONGLONG naxis2, LONGLONG naxis3,
+            signed char *array, int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffg3dsb_unlocked(fptr, group, nulval, ncols, nrows, naxis1, naxis2, naxis3, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsvsb_unlocked(fitsfile *fptr, /* I - FITS file pointer                        */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -387,7 +433,19 @@ int ffgsvsb(fitsfile *fptr, /* I - FITS file pointer                        */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgsfsb(fitsfile *fptr, /* I - FITS file pointer                        */
+int ffgsvsb(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+            long *trc, long *inc, signed char nulval, signed char *array,
+            int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsvsb_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgsfsb_unlocked(fitsfile *fptr, /* I - FITS file pointer                        */
            int  colnum,    /* I - number of the column to read (1 = 1st)    */
            int naxis,      /* I - number of dimensions in the FITS array    */
            long  *naxes,   /* I - size of each dimension                    */
@@ -551,7 +609,19 @@ int ffgsfsb(fitsfile *fptr, /* I - FITS file pointer                        */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffggpsb( fitsfile *fptr,   /* I - FITS file pointer                       */
+int ffgsfsb(fitsfile *fptr, int colnum, int naxis, long *naxes, long *blc,
+            long *trc, long *inc, signed char *array, char *flagval,
+            int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgsfsb_unlocked(fptr, colnum, naxis, naxes, blc, trc, inc, array, flagval, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffggpsb_unlocked( fitsfile *fptr,   /* I - FITS file pointer                       */
             long  group,      /* I - group to read (1 = 1st group)           */
             long  firstelem,  /* I - first vector element to read (1 = 1st)  */
             long  nelem,      /* I - number of values to read                */
@@ -580,7 +650,18 @@ int ffggpsb( fitsfile *fptr,   /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcvsb(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffggpsb(fitsfile *fptr, long group, long firstelem, long nelem,
+            signed char *array, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffggpsb_unlocked(fptr, group, firstelem, nelem, array, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcvsb_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -605,7 +686,19 @@ int ffgcvsb(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcfsb(fitsfile *fptr,  /* I - FITS file pointer                       */
+int ffgcvsb(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+            LONGLONG nelem, signed char nulval, signed char *array,
+            int *anynul, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcvsb_unlocked(fptr, colnum, firstrow, firstelem, nelem, nulval, array, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcfsb_unlocked(fitsfile *fptr,  /* I - FITS file pointer                       */
            int  colnum,      /* I - number of column to read (1 = 1st col)  */
            LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
            LONGLONG  firstelem,  /* I - first vector element to read (1 = 1st)  */
@@ -630,6 +723,18 @@ int ffgcfsb(fitsfile *fptr,  /* I - FITS file pointer                       */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgcfsb(fitsfile *fptr, int colnum, LONGLONG firstrow, LONGLONG firstelem,
+            LONGLONG nelem, signed char *array, char *nularray, int *anynul,
+            int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcfsb_unlocked(fptr, colnum, firstrow, firstelem, nelem, array, nularray, anynul, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgclsb(fitsfile *fptr,   /* I - FITS file pointer                       */
             int  colnum,      /* I - number of column to read (1 = 1st col)  */
             LONGLONG  firstrow,   /* I - first row to read (1 = 1st row)         */
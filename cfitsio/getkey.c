@@ -154,7 +154,7 @@ int ffmrky(fitsfile *fptr,    /* I - FITS file pointer                   */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgnky(fitsfile *fptr,  /* I - FITS file pointer     */
+static int ffgnky_unlocked(fitsfile *fptr,  /* I - FITS file pointer     */
            char *card,      /* O - card string           */
            int *status)     /* IO - error status         */
 /*
@@ -214,6 +214,16 @@ int ffgnky(fitsfile *fptr,  /* I - FITS file pointer     */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgnky(fitsfile *fptr, char *card, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgnky_unlocked(fptr, card, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgnxk( fitsfile *fptr,     /* I - FITS file pointer              */
             char **inclist,     /* I - list of included keyword names */
             int ninc,           /* I - number of names in inclist     */
@@ -270,7 +280,7 @@ int ffgnxk( fitsfile *fptr,     /* I - FITS file pointer              */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgky( fitsfile *fptr,     /* I - FITS file pointer        */
+static int ffgky_unlocked( fitsfile *fptr,     /* I - FITS file pointer        */
            int  datatype,      /* I - datatype of the value    */
            const char *keyname,      /* I - name of keyword to read  */
            void *value,        /* O - keyword value            */
@@ -393,9 +403,20 @@ int ffgky( fitsfile *fptr,     /* I - FITS file pointer        */
         *status = BAD_DATATYPE;
 
     return(*status);
+}
+/*--------------------------------------------------------------------------*/
+int ffgky(fitsfile *fptr, int datatype, const char *keyname, void *value,
+          char *comm, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgky_unlocked(fptr, datatype, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
 } 
 /*--------------------------------------------------------------------------*/
-int ffgkey( fitsfile *fptr,     /* I - FITS file pointer        */
+static int ffgkey_unlocked( fitsfile *fptr,     /* I - FITS file pointer        */
             const char *keyname,      /* I - name of keyword to read  */
             char *keyval,       /* O - keyword value            */
             char *comm,         /* O - keyword comment          */
@@ -427,7 +448,18 @@ int ffgkey( fitsfile *fptr,     /* I - FITS file pointer        */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgrec( fitsfile *fptr,     /* I - FITS file pointer          */
+int ffgkey(fitsfile *fptr, const char *keyname, char *keyval, char *comm,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkey_unlocked(fptr, keyname, keyval, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgrec_unlocked( fitsfile *fptr,     /* I - FITS file pointer          */
             int nrec,           /* I - number of keyword to read  */
             char *card,         /* O - keyword card               */
             int  *status)       /* IO - error status              */
@@ -457,7 +489,17 @@ int ffgrec( fitsfile *fptr,     /* I - FITS file pointer          */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgcrd( fitsfile *fptr,     /* I - FITS file pointer        */
+int ffgrec(fitsfile *fptr, int nrec, char *card, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgrec_unlocked(fptr, nrec, card, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgcrd_unlocked( fitsfile *fptr,     /* I - FITS file pointer        */
             const char *name,         /* I - name of keyword to read  */
             char *card,         /* O - keyword card             */
             int  *status)       /* IO - error status            */
@@ -618,7 +660,17 @@ int ffgcrd( fitsfile *fptr,     /* I - FITS file pointer        */
     return(*status = KEY_NO_EXIST);  /* couldn't find the keyword */
 }
 /*--------------------------------------------------------------------------*/
-int ffgstr( fitsfile *fptr,     /* I - FITS file pointer        */
+int ffgcrd(fitsfile *fptr, const char *name, char *card, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgcrd_unlocked(fptr, name, card, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgstr_unlocked( fitsfile *fptr,     /* I - FITS file pointer        */
             const char *string, /* I - string to match  */
             char *card,         /* O - keyword card             */
             int  *status)       /* IO - error status            */
@@ -660,6 +712,16 @@ int ffgstr( fitsfile *fptr,     /* I - FITS file pointer        */
     return(*status = KEY_NO_EXIST);  /* couldn't find the keyword */
 }
 /*--------------------------------------------------------------------------*/
+int ffgstr(fitsfile *fptr, const char *string, char *card, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgstr_unlocked(fptr, string, card, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgknm( char *card,         /* I - keyword card                   */
             char *name,         /* O - name of the keyword            */
             int *length,        /* O - length of the keyword name     */
@@ -728,7 +790,7 @@ int ffgknm( char *card,         /* I - keyword card                   */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgunt( fitsfile *fptr,     /* I - FITS file pointer         */
+static int ffgunt_unlocked( fitsfile *fptr,     /* I - FITS file pointer         */
             const char *keyname,      /* I - name of keyword to read   */
             char *unit,         /* O - keyword units             */
             int  *status)       /* IO - error status             */
@@ -764,7 +826,17 @@ int ffgunt( fitsfile *fptr,     /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkys( fitsfile *fptr,     /* I - FITS file pointer         */
+int ffgunt(fitsfile *fptr, const char *keyname, char *unit, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgunt_unlocked(fptr, keyname, unit, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgkys_unlocked( fitsfile *fptr,     /* I - FITS file pointer         */
             const char *keyname,      /* I - name of keyword to read   */
             char *value,        /* O - keyword value             */
             char *comm,         /* O - keyword comment           */
@@ -790,7 +862,18 @@ int ffgkys( fitsfile *fptr,     /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkls( fitsfile *fptr,     /* I - FITS file pointer         */
+int ffgkys(fitsfile *fptr, const char *keyname, char *value, char *comm,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkys_unlocked(fptr, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgkls_unlocked( fitsfile *fptr,     /* I - FITS file pointer         */
             const char *keyname,      /* I - name of keyword to read   */
             char **value,       /* O - pointer to keyword value  */
             char *comm,         /* O - keyword comment           */
@@ -857,6 +940,17 @@ int ffgkls( fitsfile *fptr,     /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgkls(fitsfile *fptr, const char *keyname, char **value, char *comm,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkls_unlocked(fptr, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int fffree( char *value,       /* I - pointer to keyword value  */
             int  *status)      /* IO - error status             */
 /*
@@ -913,7 +1007,7 @@ int ffgcnt( fitsfile *fptr,     /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkyl( fitsfile *fptr,     /* I - FITS file pointer         */
+static int ffgkyl_unlocked( fitsfile *fptr,     /* I - FITS file pointer         */
             const char *keyname,      /* I - name of keyword to read   */
             int  *value,        /* O - keyword value             */
             char *comm,         /* O - keyword comment           */
@@ -935,7 +1029,18 @@ int ffgkyl( fitsfile *fptr,     /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkyj( fitsfile *fptr,     /* I - FITS file pointer         */
+int ffgkyl(fitsfile *fptr, const char *keyname, int *value, char *comm,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkyl_unlocked(fptr, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgkyj_unlocked( fitsfile *fptr,     /* I - FITS file pointer         */
             const char *keyname,      /* I - name of keyword to read   */
             long *value,        /* O - keyword value             */
             char *comm,         /* O - keyword comment           */
@@ -957,7 +1062,18 @@ int ffgkyj( fitsfile *fptr,     /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkyjj( fitsfile *fptr,     /* I - FITS file pointer         */
+int ffgkyj(fitsfile *fptr, const char *keyname, long *value, char *comm,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkyj_unlocked(fptr, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgkyjj_unlocked( fitsfile *fptr,     /* I - FITS file pointer         */
             const char *keyname,      /* I - name of keyword to read   */
             LONGLONG *value,    /* O - keyword value             */
             char *comm,         /* O - keyword comment           */
@@ -979,7 +1095,18 @@ int ffgkyjj( fitsfile *fptr,     /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkye( fitsfile *fptr,     /* I - FITS file pointer         */
+int ffgkyjj(fitsfile *fptr, const char *keyname, LONGLONG *value, char *comm,
+            int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkyjj_unlocked(fptr, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgkye_unlocked( fitsfile *fptr,     /* I - FITS file pointer         */
             const char  *keyname,     /* I - name of keyword to read   */
             float *value,       /* O - keyword value             */
             char  *comm,        /* O - keyword comment           */
@@ -1001,7 +1128,18 @@ int ffgkye( fitsfile *fptr,     /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkyd( fitsfile *fptr,      /* I - FITS file pointer         */
+int ffgkye(fitsfile *fptr, const char *keyname, float *value, char *comm,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkye_unlocked(fptr, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgkyd_unlocked( fitsfile *fptr,      /* I - FITS file pointer         */
             const char   *keyname,     /* I - name of keyword to read   */
             double *value,       /* O - keyword value             */
             char   *comm,        /* O - keyword comment           */
@@ -1023,7 +1161,18 @@ int ffgkyd( fitsfile *fptr,      /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkyc( fitsfile *fptr,     /* I - FITS file pointer         */
+int ffgkyd(fitsfile *fptr, const char *keyname, double *value, char *comm,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkyd_unlocked(fptr, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgkyc_unlocked( fitsfile *fptr,     /* I - FITS file pointer         */
             const char  *keyname,     /* I - name of keyword to read   */
             float *value,       /* O - keyword value (real,imag) */
             char  *comm,        /* O - keyword comment           */
@@ -1063,7 +1212,18 @@ int ffgkyc( fitsfile *fptr,     /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkym( fitsfile *fptr,     /* I - FITS file pointer         */
+int ffgkyc(fitsfile *fptr, const char *keyname, float *value, char *comm,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkyc_unlocked(fptr, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgkym_unlocked( fitsfile *fptr,     /* I - FITS file pointer         */
             const char  *keyname,     /* I - name of keyword to read   */
             double *value,      /* O - keyword value (real,imag) */
             char  *comm,        /* O - keyword comment           */
@@ -1104,7 +1264,18 @@ int ffgkym( fitsfile *fptr,     /* I - FITS file pointer         */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkyt( fitsfile *fptr,      /* I - FITS file pointer                 */
+int ffgkym(fitsfile *fptr, const char *keyname, double *value, char *comm,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkym_unlocked(fptr, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgkyt_unlocked( fitsfile *fptr,      /* I - FITS file pointer                 */
             const char   *keyname,     /* I - name of keyword to read           */
             long   *ivalue,      /* O - integer part of keyword value     */
             double *fraction,    /* O - fractional part of keyword value  */
@@ -1146,7 +1317,18 @@ int ffgkyt( fitsfile *fptr,      /* I - FITS file pointer                 */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffgkyn( fitsfile *fptr,      /* I - FITS file pointer             */
+int ffgkyt(fitsfile *fptr, const char *keyname, long *ivalue,
+           double *fraction, char *comm, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkyt_unlocked(fptr, keyname, ivalue, fraction, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffgkyn_unlocked( fitsfile *fptr,      /* I - FITS file pointer             */
             int    nkey,         /* I - number of the keyword to read */
             char   *keyname,     /* O - name of the keyword           */
             char   *value,       /* O - keyword value                 */
@@ -1193,6 +1375,17 @@ int ffgkyn( fitsfile *fptr,      /* I - FITS file pointer             */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
+int ffgkyn(fitsfile *fptr, int nkey, char *keyname, char *value, char *comm,
+           int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffgkyn_unlocked(fptr, nkey, keyname, value, comm, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
 int ffgkns( fitsfile *fptr,     /* I - FITS file pointer                    */
             const char *keyname,      /* I - root name of keywords to read        */
             int  nstart,        /* I - starting index number                */
@@ -3101,7 +3294,7 @@ int ffh2st(fitsfile *fptr,   /* I - FITS file pointer           */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffhdr2str( fitsfile *fptr,  /* I - FITS file pointer                    */
+static int ffhdr2str_unlocked( fitsfile *fptr,  /* I - FITS file pointer                    */
             int exclude_comm,   /* I - if TRUE, exclude commentary keywords */
             char **exclist,     /* I - list of excluded keyword names       */
             int nexc,           /* I - number of names in exclist           */
@@ -3193,7 +3386,18 @@ int ffhdr2str( fitsfile *fptr,  /* I - FITS file pointer                    */
     return(*status);
 }
 /*--------------------------------------------------------------------------*/
-int ffcnvthdr2str( fitsfile *fptr,  /* I - FITS file pointer                    */
+int ffhdr2str(fitsfile *fptr, int exclude_comm, char **exclist, int nexc,
+              char **header, int *nkeys, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffhdr2str_unlocked(fptr, exclude_comm, exclist, nexc, header, nkeys, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
+/*--------------------------------------------------------------------------*/
+static int ffcnvthdr2str_unlocked( fitsfile *fptr,  /* I - FITS file pointer                    */
             int exclude_comm,   /* I - if TRUE, exclude commentary keywords */
             char **exclist,     /* I - list of excluded keyword names       */
             int nexc,           /* I - number of names in exclist           */
@@ -3234,3 +3438,14 @@ int ffcnvthdr2str( fitsfile *fptr,  /* I - FITS file pointer
 
     return(*status);
 }
+/*--------------------------------------------------------------------------*/
+int ffcnvthdr2str(fitsfile *fptr, int exclude_comm, char **exclist, int nexc,
+                  char **header, int *nkeys, int *status)
+{
+    int retval;
+
+    FFLOCKF(fptr);
+    retval = ffcnvthdr2str_unlocked(fptr, exclude_comm, exclist, nexc, header, nkeys, status);
+    FFUNLOCKF(fptr);
+    return(retval);
+}
@@ -5069,7 +5069,9 @@ int imcomp_decompress_tile (fitsfile *infptr,
 
     /* **************************************************************** */
     /* check if this tile was cached; if so, just copy it out */
-    if (nrow == (infptr->Fptr)->tilerow && datatype == (infptr->Fptr)->tiletype ) {
+    /* the null flags are only cached if the tile was read with them */
+    if (nrow == (infptr->Fptr)->tilerow && datatype == (infptr->Fptr)->tiletype &&
+        (nullcheck != 2 || (infptr->Fptr)->tilenullarray) ) {
 
          memcpy(buffer, (infptr->Fptr)->tiledata, (infptr->Fptr)->tiledatasize);
 	 
@@ -5826,6 +5828,11 @@ int imcomp_decompress_tile (fitsfile *infptr,
             }
             memcpy((infptr->Fptr)->tilenullarray, bnullarray, tilelen);
       }
+      else if ((infptr->Fptr)->tilenullarray) {
+            /* flags left from an earlier tile would be stale */
+            free((infptr->Fptr)->tilenullarray);
+            (infptr->Fptr)->tilenullarray = 0;
+      }
 
       (infptr->Fptr)->tilerow = nrow;
       (infptr->Fptr)->tileanynull = *anynul;
@@ -32,6 +32,9 @@
 #define fits_create_template fftplt
 #define fits_flush_file     ffflus
 #define fits_flush_buffer   ffflsh
+#define fits_set_buffer_pool ffsbfp
+#define fits_get_buffer_pool ffgbfp
+#define fits_get_buffer_stats ffgbfs
 #define fits_close_file     ffclos
 #define fits_delete_file    ffdelt
 #define fits_file_name      ffflnm
@@ -305,6 +308,7 @@
 #define fits_read_img_uint     ffgpvuk
 #define fits_read_img_int     ffgpvk
 #define fits_read_img_flt     ffgpve
+#define fits_read_img_binned  ffgpbe
 #define fits_read_img_dbl     ffgpvd
 
 #define fits_read_imgnull_byt ffgpfb
@@ -8,24 +8,33 @@
   Every program which uses the CFITSIO interface must include the
   the fitsio.h header file.  This contains the prototypes for all
   the routines and defines the error status values and other symbolic
-  constants used in the interface.  
+  constants used in the interface.
 */
 #include "fitsio.h"
 
+/*
+  This program measures the speed of writing and reading FITS files with
+  cfitsio.  The image size and type, tile compression, the driver used to
+  read the file back and the I/O buffer settings can all be chosen on the
+  command line, so that changes to the library can be compared against
+  the same numbers on the same storage.  Each test reports its throughput
+  and a histogram of the time taken by the individual cfitsio calls,
+  either as a table or, with -j, as JSON.  Run "speed -h" for the options.
+*/
+
 #define minvalue(A,B) ((A) < (B) ? (A) : (B))
 
-/* size of the image */
+/* default size of the image */
 #define XSIZE 3000
 #define YSIZE 3000
 
-/* size of data buffer */
+/* default number of pixels or table rows read or written per call */
 #define SHTSIZE 20000
-static long sarray[ SHTSIZE ] = {SHTSIZE * 0};
 
-/* no. of rows in binary table */
+/* default no. of rows in binary table */
 #define BROWS 2500000
 
-/* no. of rows in ASCII table */
+/* default no. of rows in ASCII table */
 #define AROWS 400000
 
 /*  CLOCKS_PER_SEC should be defined by most compilers */
@@ -34,14 +43,44 @@ static long sarray[ SHTSIZE ] = {SHTSIZE * 0};
 #else
 /* on SUN OS machine, CLOCKS_PER_SEC is not defined, so set its value */
 #define CLOCKTICKS 1000000
-#define difftime(A,B) ((double) A - (double) B)
 #endif
 
-/* define variables for measuring elapsed time */
-clock_t scpu, ecpu;
-time_t start, finish;
-long startsec;   /* start of elapsed time interval */
-int startmilli;  /* start of elapsed time interval */
+/* latency histogram: bin k counts calls taking less than 2^k microseconds */
+#define NBINS 32
+#define MAXTESTS 16
+
+typedef struct          /* the settings of one run */
+{
+    long nx, ny;
+    int bitpix;
+    const char *compression;
+    const char *driver;
+    long perloop;
+    int nbuffers, nreadahead;
+    long brows, arows;
+    int checksums;
+    const char *filename;
+    int json;
+} config;
+
+typedef struct          /* the measurements of one test */
+{
+    const char *name;
+    double bytes;
+    double seconds, cpu;
+    long calls;
+    double minlat, maxlat, sumlat;
+    long histogram[NBINS];
+    long hits, misses, rahits;  /* I/O buffer use, -1 if not measured */
+} result;
+
+static config cfg;
+static result results[MAXTESTS];
+static int nresults = 0;
+
+static result *current;
+static double teststart, callstart;
+static clock_t cpustart;
 
 int writeimage(fitsfile *fptr, int *status);
 int writebintable(fitsfile *fptr, int *status);
@@ -50,11 +89,19 @@ int readimage(fitsfile *fptr, int *status);
 int readatable(fitsfile *fptr, int *status);
 int readbtable(fitsfile *fptr, int *status);
 void printerror( int status);
-int marktime(int *status);
-int gettime(double *elapse, float *elapscpu, int *status);
-int main(void);
-
-int main()
+int main(int argc, char *argv[]);
+
+static void usage(void);
+static double now(void);
+static void starttest(const char *name, double bytes);
+static void startcall(void);
+static void endcall(void);
+static void endtest(void);
+static void bufferstats(fitsfile *fptr, int start);
+static void report(void);
+static int pixeltype(int bitpix);
+
+int main(int argc, char *argv[])
 {
 /*************************************************************************
     This program tests the speed of writing/reading FITS files with cfitsio
@@ -62,87 +109,283 @@ int main()
 
     FILE *diskfile;
     fitsfile *fptr;        /* pointer to the FITS file, defined in fitsio.h */
-    int status, ii;
+    int status, ii, dataok, hduok;
     long rawloop;
-    char filename[] = "speedcc.fit";           /* name for new FITS file */
+    void *memptr = NULL;
+    size_t memsize;
+    char filename[FLEN_FILENAME], url[FLEN_FILENAME + 16];
     char buffer[2880] = {2880 * 0};
-    time_t tbegin, tend;
-    float rate, size, elapcpu, cpufrac;
-    double elapse;
 
-    tbegin = time(0);
+    cfg.nx = XSIZE;
+    cfg.ny = YSIZE;
+    cfg.bitpix = 32;
+    cfg.compression = "none";
+    cfg.driver = "file";
+    cfg.perloop = SHTSIZE;
+    cfg.nbuffers = 0;
+    cfg.nreadahead = 0;
+    cfg.brows = BROWS;
+    cfg.arows = AROWS;
+    cfg.checksums = 0;
+    cfg.filename = "speedcc.fit";
+    cfg.json = 0;
+
+    for (ii = 1; ii < argc; ii++)
+    {
+        if (argv[ii][0] != '-' || strlen(argv[ii]) != 2)
+            usage();
+
+        switch (argv[ii][1])
+        {
+            case 'k': cfg.checksums = 1; continue;
+            case 'j': cfg.json = 1;      continue;
+            case 'h': usage();
+        }
+
+        if (ii + 1 >= argc)
+            usage();
+
+        switch (argv[ii++][1])
+        {
+            case 'x': cfg.nx = atol(argv[ii]);         break;
+            case 'y': cfg.ny = atol(argv[ii]);         break;
+            case 'b': cfg.bitpix = atoi(argv[ii]);     break;
+            case 'c': cfg.compression = argv[ii];      break;
+            case 'd': cfg.driver = argv[ii];           break;
+            case 'p': cfg.perloop = atol(argv[ii]);    break;
+            case 'n': cfg.nbuffers = atoi(argv[ii]);   break;
+            case 'r': cfg.nreadahead = atoi(argv[ii]); break;
+            case 't': cfg.brows = atol(argv[ii]);      break;
+            case 'a': cfg.arows = atol(argv[ii]);      break;
+            case 'f': cfg.filename = argv[ii];         break;
+            default:  usage();
+        }
+    }
+
+    if (cfg.nx < 1 || cfg.ny < 1 || cfg.perloop < 1 || !pixeltype(cfg.bitpix))
+        usage();
+
+    /* the gzstream:// and compress:// drivers read a gzipped copy, */
+    /* which cfitsio writes when the file name ends in .gz          */
+    strcpy(filename, cfg.filename);
+    if (!strcmp(cfg.driver, "gzstream") || !strcmp(cfg.driver, "compress"))
+        strcat(filename, ".gz");
+
+    sprintf(url, "%s://%s", cfg.driver, filename);
+
+    status = 0;
+#ifdef CFITSIO_BUFFER_POOL
+    if (cfg.nbuffers || cfg.nreadahead)
+        fits_set_buffer_pool(cfg.nbuffers, cfg.nreadahead, &status);
+    fits_get_buffer_pool(&cfg.nbuffers, &cfg.nreadahead, &status);
+#endif
 
     remove(filename);               /* Delete old file if it already exists */
 
+    /* raw stdio throughput, for the same number of bytes as the image */
     diskfile =  fopen(filename,"w+b");
-    rawloop = XSIZE * YSIZE / 720;
-
-    printf("                                                ");
-    printf(" SIZE / ELAPSE(%%CPU) = RATE\n");
-    printf("RAW fwrite (2880 bytes/loop)...                 ");
-    marktime(&status);
+    if (!diskfile)
+    {
+        fprintf(stderr, "cannot create %s\n", filename);
+        return(1);
+    }
+    rawloop = (long) ((cfg.nx * (double) cfg.ny * abs(cfg.bitpix) / 8 + 2879) / 2880);
 
+    starttest("raw_fwrite", 2880. * rawloop);
     for (ii = 0; ii < rawloop; ii++)
+    {
+      startcall();
       if (fwrite(buffer, 1, 2880, diskfile) != 2880)
-        printf("write error \n");
-
-    gettime(&elapse, &elapcpu, &status);
-
-    cpufrac = elapcpu / elapse * 100.;
-    size = 2880. * rawloop / 1000000.;
-    rate = size / elapse;
-    printf(" %4.1fMB/%4.1fs(%3.0f) = %5.2fMB/s\n", size, elapse, cpufrac,rate);
+        fprintf(stderr, "write error \n");
+      endcall();
+    }
+    fflush(diskfile);
+    endtest();
 
     /* read back the binary records */
     fseek(diskfile, 0, 0);
 
-    printf("RAW fread  (2880 bytes/loop)...                 ");
-    marktime(&status);
-
+    starttest("raw_fread", 2880. * rawloop);
     for (ii = 0; ii < rawloop; ii++)
+    {
+      startcall();
       if (fread(buffer, 1, 2880, diskfile) != 2880)
-        printf("read error \n");
-
-    gettime(&elapse, &elapcpu, &status);
-
-    cpufrac = elapcpu / elapse * 100.;
-    size = 2880. * rawloop / 1000000.;
-    rate = size / elapse;
-    printf(" %4.1fMB/%4.1fs(%3.0f) = %5.2fMB/s\n", size, elapse, cpufrac,rate);
+        fprintf(stderr, "read error \n");
+      endcall();
+    }
+    endtest();
 
     fclose(diskfile);
     remove(filename);
 
-    status = 0;     
     fptr = 0;
 
     if (fits_create_file(&fptr, filename, &status)) /* create new FITS file */
-       printerror( status);          
-   
+       printerror( status);
+
     if (writeimage(fptr, &status))
-       printerror( status);     
+       printerror( status);
+
+    if (cfg.brows > 0 && writebintable(fptr, &status))
+       printerror( status);
 
-    if (writebintable(fptr, &status))
-       printerror( status);     
+    if (cfg.arows > 0 && writeasctable(fptr, &status))
+       printerror( status);
 
-    if (writeasctable(fptr, &status))
-       printerror( status);     
+    if (cfg.checksums)
+    {
+        /* the checksums of every HDU */
+        starttest("write_checksum", 0);
+        for (ii = 1; !fits_movabs_hdu(fptr, ii, NULL, &status); ii++)
+        {
+            startcall();
+            fits_write_chksum(fptr, &status);
+            endcall();
+        }
+        if (status == END_OF_FILE)
+        {
+            status = 0;
+            fits_clear_errmsg();
+        }
+        endtest();
+    }
+
+    /* closing a .gz file compresses it */
+    starttest("close", 0);
+    startcall();
+    if (fits_close_file(fptr, &status))
+         printerror( status );
+    endcall();
+    endtest();
+
+    /* read everything back through the chosen driver; mem means the */
+    /* whole file is loaded into memory first, as part of the open    */
+    starttest("open", 0);
+    startcall();
+    if (!strcmp(cfg.driver, "mem"))
+    {
+        diskfile = fopen(filename, "rb");
+        if (!diskfile)
+            printerror( FILE_NOT_OPENED );
+        fseek(diskfile, 0, SEEK_END);
+        memsize = ftell(diskfile);
+        fseek(diskfile, 0, SEEK_SET);
+        memptr = malloc(memsize);
+        if (!memptr)
+            printerror( MEMORY_ALLOCATION );
+        if (fread(memptr, 1, memsize, diskfile) != memsize)
+            printerror( READ_ERROR );
+        fclose(diskfile);
+
+        fits_open_memfile(&fptr, filename, READONLY, &memptr, &memsize, 0,
+                          NULL, &status);
+    }
+    else
+        fits_open_file(&fptr, url, READONLY, &status);
+    if (status)
+         printerror( status );
+    endcall();
+    endtest();
 
     if (readimage(fptr, &status))
-       printerror( status);     
+       printerror( status);
+
+    if (cfg.brows > 0 && readbtable(fptr, &status))
+       printerror( status);
 
-    if (readbtable(fptr, &status))
-       printerror( status);     
+    if (cfg.arows > 0 && readatable(fptr, &status))
+       printerror( status);
 
-    if (readatable(fptr, &status))
-       printerror( status);     
+    if (cfg.checksums)
+    {
+        starttest("verify_checksum", 0);
+        for (ii = 1; !fits_movabs_hdu(fptr, ii, NULL, &status); ii++)
+        {
+            startcall();
+            fits_verify_chksum(fptr, &dataok, &hduok, &status);
+            endcall();
+            if (dataok < 0 || hduok < 0)
+                fprintf(stderr, "checksum mismatch in HDU %d\n", ii);
+        }
+        if (status == END_OF_FILE)
+        {
+            status = 0;
+            fits_clear_errmsg();
+        }
+        endtest();
+    }
 
-    if (fits_close_file(fptr, &status))     
+    if (fits_close_file(fptr, &status))
          printerror( status );
+    free(memptr);
 
-    tend = time(0);
-    elapse = difftime(tend, tbegin) + 0.5;
-    printf("Total elapsed time = %.1fs, status = %d\n",elapse, status);
+    report();
+    remove(filename);
+    return(status);
+}
+/*--------------------------------------------------------------------------*/
+static void usage(void)
+{
+    fprintf(stderr,
+      "usage: speed [options]\n"
+      "  -x NX, -y NY    image size (default %d x %d)\n"
+      "  -b BITPIX       8, 16, 32, -32 or -64 (default 32)\n"
+      "  -c TYPE         tile compression: none, rice, gzip, hcompress, plio\n"
+      "  -d DRIVER       driver to read the file back with: file, mem, mmap,\n"
+      "                  gzstream or compress (default file)\n"
+      "  -p N            pixels or table rows per call (default %d)\n"
+      "  -n N            I/O buffers per file\n"
+      "  -r N            records to read ahead of sequential reads\n"
+      "  -t N            binary table rows, 0 to skip (default %d)\n"
+      "  -a N            ASCII table rows, 0 to skip (default %d)\n"
+      "  -k              also time writing and verifying checksums\n"
+      "  -f FILE         file to use (default speedcc.fit)\n"
+      "  -j              report in JSON\n",
+      XSIZE, YSIZE, SHTSIZE, BROWS, AROWS);
+    exit(1);
+}
+/*--------------------------------------------------------------------------*/
+static int pixeltype(int bitpix)
+{
+    /* datatype that the pixels are written and read as */
+    switch (bitpix)
+    {
+        case   8: return(TBYTE);
+        case  16: return(TSHORT);
+        case  32: return(TINT);
+        case -32: return(TFLOAT);
+        case -64: return(TDOUBLE);
+    }
+    return(0);
+}
+/*--------------------------------------------------------------------------*/
+static void fillpixels(double *dvalues, int datatype, long n, void *array)
+{
+    /* copy the pattern into an array of the pixel type */
+    long ii;
+
+    for (ii = 0; ii < n; ii++)
+    {
+        switch (datatype)
+        {
+            case TBYTE:  ((unsigned char *) array)[ii] = (unsigned char) dvalues[ii]; break;
+            case TSHORT: ((short *) array)[ii] = (short) dvalues[ii];                 break;
+            case TINT:   ((int *) array)[ii] = (int) dvalues[ii];                     break;
+            case TFLOAT: ((float *) array)[ii] = (float) dvalues[ii];                 break;
+            default:     ((double *) array)[ii] = dvalues[ii];
+        }
+    }
+}
+/*--------------------------------------------------------------------------*/
+static int compressiontype(void)
+{
+    if      (!strcmp(cfg.compression, "none"))      return(0);
+    else if (!strcmp(cfg.compression, "rice"))      return(RICE_1);
+    else if (!strcmp(cfg.compression, "gzip"))      return(GZIP_1);
+    else if (!strcmp(cfg.compression, "hcompress")) return(HCOMPRESS_1);
+    else if (!strcmp(cfg.compression, "plio"))      return(PLIO_1);
+
+    usage();
     return(0);
 }
 /*--------------------------------------------------------------------------*/
@@ -152,146 +395,132 @@ int writeimage(fitsfile *fptr, int *status)
     /* write the primary array containing a 2-D image */
     /**************************************************/
 {
-    long  nremain, ii;
-    float rate, size, elapcpu, cpufrac;
-    double elapse;
+    long ii, nremain, ntodo;
+    int datatype = pixeltype(cfg.bitpix), comptype = compressiontype();
+    long naxes[2];
+    double *dvalues;
+    void *array;
+
+    naxes[0] = cfg.nx;
+    naxes[1] = cfg.ny;
+
+    /* a compressed image goes in an extension, after an empty primary array */
+    if (comptype)
+    {
+        if ( fits_create_img(fptr, 8, 0, naxes, status) ||
+             fits_set_compression_type(fptr, comptype, status) )
+             printerror( *status );
+    }
 
-    /* initialize FITS image parameters */
-    int bitpix   =  32;   /* 32-bit  signed integer pixel values       */
-    long naxis    =   2;  /* 2-dimensional image                            */    
-    long naxes[2] = {XSIZE, YSIZE }; /* image size */
+    /* write the required keywords for the image */
+    if ( fits_create_img(fptr, cfg.bitpix, 2, naxes, status) )
+         printerror( *status );
 
-    /* write the required keywords for the primary array image */
-    if ( fits_create_img(fptr, bitpix, naxis, naxes, status) )
-         printerror( *status );          
+    /* smooth values with some noise, so that compression has work to do */
+    dvalues = (double *) malloc(cfg.perloop * sizeof(double));
+    array = malloc(cfg.perloop * sizeof(double));
+    if (!dvalues || !array)
+        printerror( MEMORY_ALLOCATION );
 
-    printf("\nWrite %dx%d I*4 image, %d pixels/loop:   ",XSIZE,YSIZE,SHTSIZE);
-    marktime(status);
+    for (ii = 0; ii < cfg.perloop; ii++)
+        dvalues[ii] = (ii % 200) * 0.5 + (rand() % 8);
+    fillpixels(dvalues, datatype, cfg.perloop, array);
 
-    nremain = XSIZE * YSIZE;
-    for (ii = 1; ii <= nremain; ii += SHTSIZE)
+    starttest("write_image", (double) cfg.nx * cfg.ny * abs(cfg.bitpix) / 8);
+
+    nremain = cfg.nx * cfg.ny;
+    for (ii = 1; ii <= nremain; ii += ntodo)
     {
-      ffpprj(fptr, 0, ii, SHTSIZE, sarray, status);
+      ntodo = minvalue(cfg.perloop, nremain - ii + 1);
+      startcall();
+      fits_write_img(fptr, datatype, ii, ntodo, array, status);
+      endcall();
     }
 
+    startcall();
     ffflus(fptr, status);  /* flush all buffers to disk */
+    endcall();
+    endtest();
 
-    gettime(&elapse, &elapcpu, status);
-
-    cpufrac = elapcpu / elapse * 100.;
-    size = XSIZE * 4. * YSIZE / 1000000.;
-    rate = size / elapse;
-    printf(" %4.1fMB/%4.1fs(%3.0f) = %5.2fMB/s\n", size, elapse, cpufrac,rate);
-
+    free(dvalues);
+    free(array);
     return( *status );
 }
 /*--------------------------------------------------------------------------*/
-int writebintable (fitsfile *fptr, int *status)
-
-    /*********************************************************/
-    /* Create a binary table extension containing 3 columns  */
-    /*********************************************************/
+static int writetable(fitsfile *fptr, int tbltype, long nrows, int *status)
 {
     int tfields = 2;
-    long nremain, ntodo, firstrow = 1, firstelem = 1, nrows;
-    float rate, size, elapcpu, cpufrac;
-    double elapse;
+    long nremain, ntodo, firstrow = 1, firstelem = 1, rowsperloop, ii;
+    long *sarray;
 
     char extname[] = "Speed_Test";           /* extension name */
 
     /* define the name, datatype, and physical units for the columns */
     char *ttype[] = { "first", "second" };
-    char *tform[] = {"1J",       "1J"   };
+    char *bform[] = {"1J",       "1J"   };
+    char *aform[] = {"I6",       "I6"   };
     char *tunit[] = { " ",       " "    };
 
-    /* append a new empty binary table onto the FITS file */
-
-    if ( fits_create_tbl( fptr, BINARY_TBL, BROWS, tfields, ttype, tform,
+    /* append a new empty table onto the FITS file */
+    if ( fits_create_tbl( fptr, tbltype, nrows, tfields, ttype,
+                tbltype == BINARY_TBL ? bform : aform,
                 tunit, extname, status) )
          printerror( *status );
 
     /* get table row size and optimum number of rows to write per loop */
-    fits_get_rowsize(fptr, &nrows, status);
-    nrows = minvalue(nrows, SHTSIZE);
-    nremain = BROWS;
+    fits_get_rowsize(fptr, &rowsperloop, status);
+    rowsperloop = minvalue(rowsperloop, cfg.perloop);
 
-    printf("Write %7drow x %dcol bintable %4ld rows/loop:", BROWS, tfields,
-       nrows);
-    marktime(status);
+    sarray = (long *) malloc(rowsperloop * sizeof(long));
+    if (!sarray)
+        printerror( MEMORY_ALLOCATION );
+    for (ii = 0; ii < rowsperloop; ii++)
+        sarray[ii] = ii % 100000;
 
+    if (tbltype == BINARY_TBL)
+        starttest("write_bintable", nrows * 8.);
+    else
+        starttest("write_asctable", nrows * 13.);
+
+    nremain = nrows;
     while(nremain)
     {
-      ntodo = minvalue(nrows, nremain);
+      ntodo = minvalue(rowsperloop, nremain);
+      startcall();
       ffpclj(fptr, 1, firstrow, firstelem, ntodo, sarray, status);
+      endcall();
+      startcall();
       ffpclj(fptr, 2, firstrow, firstelem, ntodo, sarray, status);
+      endcall();
       firstrow += ntodo;
       nremain -= ntodo;
     }
 
+    startcall();
     ffflus(fptr, status);  /* flush all buffers to disk */
+    endcall();
+    endtest();
 
-    gettime(&elapse, &elapcpu, status);
-
-    cpufrac = elapcpu / elapse * 100.;
-    size = BROWS * 8. / 1000000.;
-    rate = size / elapse;
-    printf(" %4.1fMB/%4.1fs(%3.0f) = %5.2fMB/s\n", size, elapse, cpufrac,rate);
-
+    free(sarray);
     return( *status );
 }
 /*--------------------------------------------------------------------------*/
+int writebintable (fitsfile *fptr, int *status)
+
+    /*********************************************************/
+    /* Create a binary table extension containing 2 columns  */
+    /*********************************************************/
+{
+    return(writetable(fptr, BINARY_TBL, cfg.brows, status));
+}
+/*--------------------------------------------------------------------------*/
 int writeasctable (fitsfile *fptr, int *status)
 
     /*********************************************************/
     /* Create an ASCII table extension containing 2 columns  */
     /*********************************************************/
 {
-    int tfields = 2;
-    long nremain, ntodo, firstrow = 1, firstelem = 1;
-    long nrows;
-    float rate, size, elapcpu, cpufrac;
-    double elapse;
-
-    char extname[] = "Speed_Test";           /* extension name */
-
-    /* define the name, datatype, and physical units for the columns */
-    char *ttype[] = { "first", "second" };
-    char *tform[] = {"I6",       "I6"   };
-    char *tunit[] = { " ",      " "     };
-
-    /* append a new empty ASCII table onto the FITS file */
-    if ( fits_create_tbl( fptr, ASCII_TBL, AROWS, tfields, ttype, tform,
-                tunit, extname, status) )
-         printerror( *status );
-
-    /* get table row size and optimum number of rows to write per loop */
-    fits_get_rowsize(fptr, &nrows, status);
-    nrows = minvalue(nrows, SHTSIZE);
-    nremain = AROWS;
-
-    printf("Write %7drow x %dcol asctable %4ld rows/loop:", AROWS, tfields,
-           nrows);
-    marktime(status);
-
-    while(nremain)
-    {
-      ntodo = minvalue(nrows, nremain);
-      ffpclj(fptr, 1, firstrow, firstelem, ntodo, sarray, status);
-      ffpclj(fptr, 2, firstrow, firstelem, ntodo, sarray, status);
-      firstrow += ntodo;
-      nremain -= ntodo;
-    }
-
-    ffflus(fptr, status);  /* flush all buffers to disk */
-
-    gettime(&elapse, &elapcpu, status);
-
-    cpufrac = elapcpu / elapse * 100.;
-    size = AROWS * 13. / 1000000.;
-    rate = size / elapse;
-    printf(" %4.1fMB/%4.1fs(%3.0f) = %5.2fMB/s\n", size, elapse, cpufrac,rate);
-
-    return( *status );
+    return(writetable(fptr, ASCII_TBL, cfg.arows, status));
 }
 /*--------------------------------------------------------------------------*/
 int readimage( fitsfile *fptr, int *status )
@@ -300,129 +529,103 @@ int readimage( fitsfile *fptr, int *status )
     /* Read a FITS image */
     /*********************/
 {
-    int anynull, hdutype;
-    long nremain, ii;
-    long longnull = 0;
-    float rate, size, elapcpu, cpufrac;
-    double elapse;
-
-    /* move to the primary array */
-    if ( fits_movabs_hdu(fptr, 1, &hdutype, status) ) 
+    int anynull, hdutype, datatype = pixeltype(cfg.bitpix);
+    long nremain, ntodo, ii;
+    void *array;
+
+    /* move to the image, which follows an empty primary if compressed */
+    if ( fits_movabs_hdu(fptr, compressiontype() ? 2 : 1, &hdutype, status) )
          printerror( *status );
 
-    printf("\nRead back image                                 ");
-    marktime(status);
+    array = malloc(cfg.perloop * sizeof(double));
+    if (!array)
+        printerror( MEMORY_ALLOCATION );
+
+    starttest("read_image", (double) cfg.nx * cfg.ny * abs(cfg.bitpix) / 8);
+    bufferstats(fptr, 1);
 
-    nremain = XSIZE * YSIZE;
-    for (ii=1; ii <= nremain; ii += SHTSIZE)
+    nremain = cfg.nx * cfg.ny;
+    for (ii = 1; ii <= nremain; ii += ntodo)
     {
-      ffgpvj(fptr, 0, ii, SHTSIZE, longnull, sarray, &anynull, status);
+      ntodo = minvalue(cfg.perloop, nremain - ii + 1);
+      startcall();
+      fits_read_img(fptr, datatype, ii, ntodo, NULL, array, &anynull, status);
+      endcall();
     }
 
-    gettime(&elapse, &elapcpu, status);
-
-    cpufrac = elapcpu / elapse * 100.;
-    size = XSIZE * 4. * YSIZE / 1000000.;
-    rate = size / elapse;
-    printf(" %4.1fMB/%4.1fs(%3.0f) = %5.2fMB/s\n", size, elapse, cpufrac,rate);
+    bufferstats(fptr, 0);
+    endtest();
 
+    free(array);
     return( *status );
 }
 /*--------------------------------------------------------------------------*/
-int readbtable( fitsfile *fptr, int *status )
-
-    /************************************************************/
-    /* read and print data values from the binary table */
-    /************************************************************/
+static int readtable( fitsfile *fptr, long nrows, int *status )
 {
     int hdutype, anynull;
     long nremain, ntodo, firstrow = 1, firstelem = 1;
-    long nrows;
+    long rowsperloop;
     long lnull = 0;
-    float rate, size, elapcpu, cpufrac;
-    double elapse;
+    long *sarray;
 
     /* move to the table */
-    if ( fits_movrel_hdu(fptr, 1, &hdutype, status) ) 
+    if ( fits_movrel_hdu(fptr, 1, &hdutype, status) )
            printerror( *status );
 
     /* get table row size and optimum number of rows to read per loop */
-    fits_get_rowsize(fptr, &nrows, status);
-    nrows = minvalue(nrows, SHTSIZE);
-    
-    /*  read the columns */  
-    nremain = BROWS;
+    fits_get_rowsize(fptr, &rowsperloop, status);
+    rowsperloop = minvalue(rowsperloop, cfg.perloop);
 
-    printf("Read back BINTABLE                              ");
-    marktime(status);
+    sarray = (long *) malloc(rowsperloop * sizeof(long));
+    if (!sarray)
+        printerror( MEMORY_ALLOCATION );
 
+    if (hdutype == BINARY_TBL)
+        starttest("read_bintable", nrows * 8.);
+    else
+        starttest("read_asctable", nrows * 13.);
+    bufferstats(fptr, 1);
+
+    /*  read the columns */
+    nremain = nrows;
     while(nremain)
     {
-      ntodo = minvalue(nrows, nremain);
+      ntodo = minvalue(rowsperloop, nremain);
+      startcall();
       ffgcvj(fptr, 1, firstrow, firstelem, ntodo,
                      lnull, sarray, &anynull, status);
+      endcall();
+      startcall();
       ffgcvj(fptr, 2, firstrow, firstelem, ntodo,
                      lnull, sarray, &anynull, status);
-      firstrow += ntodo; 
+      endcall();
+      firstrow += ntodo;
       nremain  -= ntodo;
     }
 
-    gettime(&elapse, &elapcpu, status);
-
-    cpufrac = elapcpu / elapse * 100.;
-    size = BROWS * 8. / 1000000.;
-    rate = size / elapse;
-    printf(" %4.1fMB/%4.1fs(%3.0f) = %5.2fMB/s\n", size, elapse, cpufrac,rate);
+    bufferstats(fptr, 0);
+    endtest();
 
+    free(sarray);
     return( *status );
 }
 /*--------------------------------------------------------------------------*/
+int readbtable( fitsfile *fptr, int *status )
+
+    /************************************************************/
+    /* read and print data values from the binary table */
+    /************************************************************/
+{
+    return(readtable(fptr, cfg.brows, status));
+}
+/*--------------------------------------------------------------------------*/
 int readatable( fitsfile *fptr, int *status )
 
     /************************************************************/
     /* read and print data values from an ASCII or binary table */
     /************************************************************/
 {
-    int hdutype, anynull;
-    long nremain, ntodo, firstrow = 1, firstelem = 1;
-    long nrows;
-    long lnull = 0;
-    float rate, size, elapcpu, cpufrac;
-    double elapse;
-
-    /* move to the table */
-    if ( fits_movrel_hdu(fptr, 1, &hdutype, status) ) 
-           printerror( *status );
-
-    /* get table row size and optimum number of rows to read per loop */
-    fits_get_rowsize(fptr, &nrows, status);
-    nrows = minvalue(nrows, SHTSIZE);
- 
-    /*  read the columns */  
-    nremain = AROWS;
-
-    printf("Read back ASCII Table                           ");
-    marktime(status);
-
-    while(nremain)
-    {
-      ntodo = minvalue(nrows, nremain);
-      ffgcvj(fptr, 1, firstrow, firstelem, ntodo,
-                     lnull, sarray, &anynull, status);
-      ffgcvj(fptr, 2, firstrow, firstelem, ntodo,
-                     lnull, sarray, &anynull, status);
-      firstrow += ntodo;
-      nremain  -= ntodo;
-    }
-
-    gettime(&elapse, &elapcpu, status);
-
-    cpufrac = elapcpu / elapse * 100.;
-    size = AROWS * 13. / 1000000.;
-    rate = size / elapse;
-    printf(" %4.1fMB/%4.1fs(%3.0f) = %5.2fMB/s\n", size, elapse, cpufrac,rate);
-
-    return( *status );
+    return(readtable(fptr, cfg.arows, status));
 }
 /*--------------------------------------------------------------------------*/
 void printerror( int status)
@@ -452,60 +655,163 @@ void printerror( int status)
     exit( status );       /* terminate the program, returning error status */
 }
 /*--------------------------------------------------------------------------*/
-int marktime( int *status)
+static double now(void)
 {
-    double telapse;
-    time_t temp;
+    /* wall clock time in seconds */
     struct  timeval tv;
-    struct  timezone tz;
-
-    temp = time(0);
 
-    /* Since elapsed time is only measured to the nearest second */
-    /* keep getting the time until the seconds tick just changes. */
-    /* This provides more consistent timing measurements since the */
-    /* intervals all start on an integer seconds. */
-
-    telapse = 0.;
-
-        scpu = clock();
-        start = time(0);
-/*
-    while (telapse == 0.)
+    gettimeofday (&tv, NULL);
+    return(tv.tv_sec + tv.tv_usec / 1000000.);
+}
+/*--------------------------------------------------------------------------*/
+static void starttest(const char *name, double bytes)
+{
+    if (nresults == MAXTESTS)
     {
-        scpu = clock();
-        start = time(0);
-        telapse = difftime( start, temp );
+        fprintf(stderr, "too many tests\n");
+        exit(1);
     }
-*/
-        gettimeofday (&tv, &tz);
 
-	startsec = tv.tv_sec;
-        startmilli = tv.tv_usec/1000;
+    current = &results[nresults++];
+    memset(current, 0, sizeof(result));
+    current->name = name;
+    current->bytes = bytes;
+    current->minlat = 1.e30;
+    current->hits = current->misses = current->rahits = -1;
 
-    return( *status );
+    cpustart = clock();
+    teststart = now();
 }
 /*--------------------------------------------------------------------------*/
-int gettime(double *elapse, float *elapscpu, int *status)
+static void startcall(void)
 {
-        struct  timeval tv;
-        struct  timezone tz;
-	int stopmilli;
-	long stopsec;
+    callstart = now();
+}
+/*--------------------------------------------------------------------------*/
+static void endcall(void)
+{
+    double usec = (now() - callstart) * 1.e6;
+    int bin;
+
+    /* bin k holds the calls that took less than 2^k microseconds */
+    for (bin = 0; bin < NBINS - 1 && usec >= (double) (1UL << bin); bin++)
+        ;
+    current->histogram[bin]++;
+
+    current->calls++;
+    current->sumlat += usec;
+    if (usec < current->minlat)
+        current->minlat = usec;
+    if (usec > current->maxlat)
+        current->maxlat = usec;
+}
+/*--------------------------------------------------------------------------*/
+static void endtest(void)
+{
+    current->seconds = now() - teststart;
+    current->cpu = (double) (clock() - cpustart) / CLOCKTICKS;
+    if (!current->calls)
+        current->minlat = 0.;
+}
+/*--------------------------------------------------------------------------*/
+static void bufferstats(fitsfile *fptr, int start)
+{
+    /* I/O buffer hits and misses during the current test */
+#ifdef CFITSIO_BUFFER_POOL
+    long hits, misses, rahits;
+    int status = 0;
 
+    if (fits_get_buffer_stats(fptr, &hits, &misses, &rahits, &status))
+        return;
 
-        gettimeofday (&tv, &tz);
-    ecpu = clock();
-    finish = time(0);
+    if (start)
+    {
+        current->hits = -hits;
+        current->misses = -misses;
+        current->rahits = -rahits;
+    }
+    else
+    {
+        current->hits += hits;
+        current->misses += misses;
+        current->rahits += rahits;
+    }
+#endif
+}
+/*--------------------------------------------------------------------------*/
+static void report(void)
+{
+    result *res;
+    float version;
+    double rate, cpufrac;
+    int ii, bin, first;
 
-        stopmilli = tv.tv_usec/1000;
-	stopsec = tv.tv_sec;
-	
+    fits_get_version(&version);
 
-	*elapse = (stopsec - startsec) + (stopmilli - startmilli)/1000.;
+    if (!cfg.json)
+    {
+        printf("CFITSIO %.2f, %ld x %ld BITPIX %d image, %s compression, "
+               "read with %s://\n", version, cfg.nx, cfg.ny, cfg.bitpix,
+               cfg.compression, cfg.driver);
+        printf("%d I/O buffers, %d records read ahead, %ld pixels or rows "
+               "per call\n\n", cfg.nbuffers, cfg.nreadahead, cfg.perloop);
+        printf("%-16s %9s %8s %5s %9s %8s %8s %8s\n", "test", "MB", "sec",
+               "cpu%", "MB/s", "calls", "us/call", "max us");
+
+        for (ii = 0; ii < nresults; ii++)
+        {
+            res = &results[ii];
+            rate = res->seconds > 0. ? res->bytes / 1.e6 / res->seconds : 0.;
+            cpufrac = res->seconds > 0. ? res->cpu / res->seconds * 100. : 0.;
+            printf("%-16s %9.1f %8.3f %5.0f %9.2f %8ld %8.1f %8.0f\n",
+                   res->name, res->bytes / 1.e6, res->seconds, cpufrac, rate,
+                   res->calls, res->calls ? res->sumlat / res->calls : 0.,
+                   res->maxlat);
+        }
+        return;
+    }
 
-/*    *elapse = difftime(finish, start) + 0.5; */
-    *elapscpu = (ecpu - scpu) * 1.0 / CLOCKTICKS;
+    printf("{\n");
+    printf("  \"cfitsio_version\": %.2f,\n", version);
+    printf("  \"config\": {\"nx\": %ld, \"ny\": %ld, \"bitpix\": %d, "
+           "\"compression\": \"%s\", \"driver\": \"%s\", "
+           "\"per_call\": %ld, \"iobuffers\": %d, \"readahead\": %d, "
+           "\"bintable_rows\": %ld, \"asctable_rows\": %ld},\n",
+           cfg.nx, cfg.ny, cfg.bitpix, cfg.compression, cfg.driver,
+           cfg.perloop, cfg.nbuffers, cfg.nreadahead, cfg.brows, cfg.arows);
+    printf("  \"tests\": [\n");
+
+    for (ii = 0; ii < nresults; ii++)
+    {
+        res = &results[ii];
+        rate = res->seconds > 0. ? res->bytes / 1.e6 / res->seconds : 0.;
+        cpufrac = res->seconds > 0. ? res->cpu / res->seconds * 100. : 0.;
+
+        printf("    {\"name\": \"%s\", \"bytes\": %.0f, \"seconds\": %.6f, "
+               "\"cpu_percent\": %.1f, \"mb_per_s\": %.2f, \"calls\": %ld,\n",
+               res->name, res->bytes, res->seconds, cpufrac, rate, res->calls);
+
+        if (res->hits >= 0)
+            printf("     \"buffer_hits\": %ld, \"buffer_misses\": %ld, "
+                   "\"readahead_hits\": %ld,\n",
+                   res->hits, res->misses, res->rahits);
+
+        printf("     \"latency_us\": {\"min\": %.1f, \"mean\": %.1f, "
+               "\"max\": %.1f, \"histogram\": [", res->minlat,
+               res->calls ? res->sumlat / res->calls : 0., res->maxlat);
+
+        /* only the occupied bins, as upper bound and count */
+        first = 1;
+        for (bin = 0; bin < NBINS; bin++)
+        {
+            if (!res->histogram[bin])
+                continue;
+            printf("%s{\"lt\": %lu, \"count\": %ld}", first ? "" : ", ",
+                   1UL << bin, res->histogram[bin]);
+            first = 0;
+        }
+        printf("]}}%s\n", ii < nresults - 1 ? "," : "");
+    }
 
-    return( *status );
+    printf("  ]\n}\n");
 }
@@ -8,6 +8,113 @@
 #include <string.h>
 #include <stdlib.h>
 #include "fitsio2.h"
+
+#ifdef HAVE_SIMD_KERNELS
+#include <emmintrin.h>
+#ifdef HAVE_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+#endif
+
+/*--------------------------------------------------------------------------*/
+int ffsimd(void)
+/*
+  Return the widest vector instruction set the byte swapping and datatype
+  conversion kernels may use on this CPU: 0 = none (plain C), 1 = SSE2,
+  2 = AVX2.  The CPU is only queried the first time.
+*/
+{
+    static int level = -1;
+
+    if (level < 0)
+    {
+#ifdef HAVE_SIMD_KERNELS
+#ifdef HAVE_AVX2_KERNELS
+        __builtin_cpu_init();
+        level = __builtin_cpu_supports("avx2") ? 2 : 1;
+#else
+        level = 1;
+#endif
+#else
+        level = 0;
+#endif
+    }
+    return(level);
+}
+
+#ifdef HAVE_SIMD_KERNELS
+/*--------------------------------------------------------------------------*/
+static long ffswap2_sse2(short *svalues, long nvals)
+{
+    long ii;
+    __m128i v;
+
+    for (ii = 0; ii + 8 <= nvals; ii += 8)
+    {
+        v = _mm_loadu_si128((__m128i *) (svalues + ii));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i *) (svalues + ii), v);
+    }
+    return(ii);
+}
+/*--------------------------------------------------------------------------*/
+static long ffswap4_sse2(INT32BIT *ivalues, long nvals)
+{
+    long ii;
+    __m128i v;
+
+    for (ii = 0; ii + 4 <= nvals; ii += 4)
+    {
+        /* exchange the 2-byte halves, then the bytes within each half */
+        v = _mm_loadu_si128((__m128i *) (ivalues + ii));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i *) (ivalues + ii), v);
+    }
+    return(ii);
+}
+/*--------------------------------------------------------------------------*/
+static long ffswap8_sse2(double *dvalues, long nvals)
+{
+    long ii;
+    __m128i v;
+
+    for (ii = 0; ii + 2 <= nvals; ii += 2)
+    {
+        /* reverse the 2-byte words, then the bytes within each word */
+        v = _mm_loadu_si128((__m128i *) (dvalues + ii));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i *) (dvalues + ii), v);
+    }
+    return(ii);
+}
+#ifdef HAVE_AVX2_KERNELS
+/*--------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static long ffswap_avx2(char *cvalues, long nbytes, int size)
+{
+    /* byte permutations reversing each 2, 4 or 8 byte value in a lane */
+    static const char perm2[16] = {1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14};
+    static const char perm4[16] = {3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12};
+    static const char perm8[16] = {7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8};
+    const char *perm = (size == 2) ? perm2 : (size == 4) ? perm4 : perm8;
+    long ii;
+    __m256i mask, v;
+
+    mask = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i *) perm));
+    for (ii = 0; ii + 32 <= nbytes; ii += 32)
+    {
+        v = _mm256_loadu_si256((__m256i *) (cvalues + ii));
+        v = _mm256_shuffle_epi8(v, mask);
+        _mm256_storeu_si256((__m256i *) (cvalues + ii), v);
+    }
+    return(ii / size);
+}
+#endif
+#endif
 /*--------------------------------------------------------------------------*/
 void ffswap2(short *svalues,  /* IO - pointer to shorts to be swapped       */
              long nvals)      /* I  - number of shorts to be swapped        */
@@ -23,9 +130,18 @@ void ffswap2(short *svalues,  /* IO - pointer to shorts to be swapped       */
         short sval;      /* a short */
     } u;
 
-    cvalues = (char *) svalues;      /* copy the initial pointer value */
+    ii = 0;
+#ifdef HAVE_SIMD_KERNELS
+#ifdef HAVE_AVX2_KERNELS
+    if (ffsimd() >= 2)
+        ii = ffswap_avx2((char *) svalues, nvals * 2, 2);
+#endif
+    ii += ffswap2_sse2(svalues + ii, nvals - ii);
+#endif
+
+    cvalues = (char *) (svalues + ii);  /* copy the initial pointer value */
 
-    for (ii = 0; ii < nvals;)
+    for (; ii < nvals;)
     {
         u.sval = svalues[ii++];  /* copy next short to temporary buffer */
 
@@ -49,9 +165,18 @@ void ffswap4(INT32BIT *ivalues,  /* IO - pointer to INT*4 to be swapped    */
         INT32BIT ival;      /* a I*4 */
     } u;
 
-    cvalues = (char *) ivalues;   /* copy the initial pointer value */
+    ii = 0;
+#ifdef HAVE_SIMD_KERNELS
+#ifdef HAVE_AVX2_KERNELS
+    if (ffsimd() >= 2)
+        ii = ffswap_avx2((char *) ivalues, nvals * 4, 4);
+#endif
+    ii += ffswap4_sse2(ivalues + ii, nvals - ii);
+#endif
 
-    for (ii = 0; ii < nvals;)
+    cvalues = (char *) (ivalues + ii);  /* copy the initial pointer value */
+
+    for (; ii < nvals;)
     {
         u.ival = ivalues[ii++];  /* copy next float to buffer */
 
@@ -73,9 +198,18 @@ void ffswap8(double *dvalues,  /* IO - pointer to doubles to be swapped     */
     register long ii;
     register char temp;
 
+    ii = 0;
+#ifdef HAVE_SIMD_KERNELS
+#ifdef HAVE_AVX2_KERNELS
+    if (ffsimd() >= 2)
+        ii = ffswap_avx2((char *) dvalues, nvals * 8, 8);
+#endif
+    ii += ffswap8_sse2(dvalues + ii, nvals - ii);
+#endif
+
     cvalues = (char *) dvalues;      /* copy the pointer value */
 
-    for (ii = 0; ii < nvals*8; ii += 8)
+    for (ii *= 8; ii < nvals*8; ii += 8)
     {
         temp = cvalues[ii];
         cvalues[ii] = cvalues[ii+7];
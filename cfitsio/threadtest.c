@@ -0,0 +1,263 @@
+/*
+  Stress test for concurrent reads in a reentrant (-D_REENTRANT) build.
+
+  A file is written with a mix of plain and tile compressed image HDUs
+  and one binary table, every image HDU is read once serially to give
+  the reference values, and then several threads read randomly chosen
+  HDUs, either through handles that share one FITSfile (fits_reopen_file)
+  or through independent READONLY handles on the same file.  The threads
+  alternate between fits_read_pix and the typed readers (ffgpve, ffgpf,
+  ffgkys), look table columns up by name and read them with ffgcv and
+  ffgcve, and the independent handles are closed and reopened as they
+  go.  Every value must match the reference.
+
+  Build with "make threadtest"; the library itself must have been
+  compiled with -D_REENTRANT for the shared handles to be safe.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "fitsio.h"
+
+#define NHDUS     12
+#define NX       300
+#define NY       200
+#define NTHREADS   8
+#define NREADS   200
+#define NROWS    500
+#define TABLEHDU (NHDUS + 1)
+
+static float *reference[NHDUS + 1];
+static fitsfile *sharedfptr;
+static const char *filename = "!threadtest.fit";
+
+typedef struct {
+    int id;
+    int shared;      /* 1 = read through a reopened handle */
+    int nerrors;
+} threadarg;
+
+static int writefile(void)
+{
+    fitsfile *fptr;
+    long naxes[2] = {NX, NY};
+    char *ttype[2] = {"INDEX", "VALUE"};
+    char *tform[2] = {"1J", "1E"};
+    char tag[FLEN_VALUE];
+    float value[NROWS];
+    int index[NROWS];
+    short *pix;
+    int status = 0, hdu, ii;
+
+    pix = (short *) malloc(NX * NY * sizeof(short));
+    if (fits_create_file(&fptr, filename, &status))
+        return(status);
+
+    /* empty primary array, then alternate plain and compressed images */
+    fits_create_img(fptr, SHORT_IMG, 0, naxes, &status);
+    for (hdu = 2; hdu <= NHDUS; hdu++)
+    {
+        for (ii = 0; ii < NX * NY; ii++)
+            pix[ii] = (short) ((ii * 7 + hdu * 131) % 3000 - 500);
+
+        if (hdu % 2)
+            fits_set_compression_type(fptr, RICE_1, &status);
+        else
+            fits_set_compression_type(fptr, 0, &status);
+
+        fits_create_img(fptr, SHORT_IMG, 2, naxes, &status);
+        fits_write_img(fptr, TSHORT, 1, NX * NY, pix, &status);
+        sprintf(tag, "image %d", hdu);
+        fits_write_key(fptr, TSTRING, "HDUTAG", tag, NULL, &status);
+    }
+
+    /* a table whose columns are found by wildcard name */
+    fits_set_compression_type(fptr, 0, &status);
+    fits_create_tbl(fptr, BINARY_TBL, NROWS, 2, ttype, tform, NULL,
+                    "VALUES", &status);
+    for (ii = 0; ii < NROWS; ii++)
+    {
+        value[ii] = ii * 0.5f;
+        index[ii] = ii;
+    }
+    fits_write_col(fptr, TINT, 1, 1, 1, NROWS, index, &status);
+    fits_write_col(fptr, TFLOAT, 2, 1, 1, NROWS, value, &status);
+
+    fits_close_file(fptr, &status);
+    free(pix);
+    return(status);
+}
+
+static int readhdu(fitsfile *fptr, int hdu, float *array)
+{
+    long fpixel[2] = {1, 1};
+    int status = 0, hdutype;
+
+    fits_movabs_hdu(fptr, hdu, &hdutype, &status);
+    fits_read_pix(fptr, TFLOAT, fpixel, NX * NY, NULL, array, NULL, &status);
+    return(status);
+}
+
+/* the same image through the typed readers, checking the keyword too */
+static int readtyped(fitsfile *fptr, int hdu, float *array, int which)
+{
+    char tag[FLEN_VALUE], expect[FLEN_VALUE];
+    char *nularray;
+    int status = 0, hdutype, anynul;
+
+    fits_movabs_hdu(fptr, hdu, &hdutype, &status);
+    ffgkys(fptr, "HDUTAG", tag, NULL, &status);
+    sprintf(expect, "image %d", hdu);
+    if (status == 0 && strcmp(tag, expect))
+        return(-1);
+
+    if (which)
+        ffgpve(fptr, 1, 1, NX * NY, 0.f, array, &anynul, &status);
+    else
+    {
+        nularray = (char *) malloc(NX * NY);
+        ffgpf(fptr, TFLOAT, 1, NX * NY, array, nularray, &anynul, &status);
+        free(nularray);
+    }
+    return(status);
+}
+
+static int readtable(fitsfile *fptr)
+{
+    float value[NROWS];
+    int index[NROWS];
+    int status = 0, hdutype, colnum, anynul, ii;
+
+    fits_movabs_hdu(fptr, TABLEHDU, &hdutype, &status);
+
+    fits_get_colnum(fptr, CASEINSEN, "val*", &colnum, &status);
+    ffgcve(fptr, colnum, 1, 1, NROWS, 0.f, value, &anynul, &status);
+    fits_get_colnum(fptr, CASEINSEN, "ind*", &colnum, &status);
+    ffgcv(fptr, TINT, colnum, 1, 1, NROWS, NULL, index, &anynul, &status);
+    if (status)
+        return(status);
+
+    for (ii = 0; ii < NROWS; ii++)
+        if (value[ii] != ii * 0.5f || index[ii] != ii)
+            return(-1);
+    return(0);
+}
+
+static void *reader(void *ptr)
+{
+    threadarg *arg = (threadarg *) ptr;
+    fitsfile *fptr;
+    float *array;
+    unsigned int seed = arg->id * 7919 + 1;
+    int ii, hdu, nerr, status = 0;
+
+    array = (float *) malloc(NX * NY * sizeof(float));
+
+    if (arg->shared)
+        fits_reopen_file(sharedfptr, &fptr, &status);
+    else
+        fits_open_file(&fptr, filename + 1, READONLY, &status);
+
+    if (status)
+    {
+        arg->nerrors++;
+        free(array);
+        return(NULL);
+    }
+
+    for (ii = 0; ii < NREADS; ii++)
+    {
+        seed = seed * 1103515245 + 12345;
+        hdu = 2 + (seed >> 16) % NHDUS;
+
+        /* independent handles come and go while the others read */
+        if (!arg->shared && ii % 20 == 19)
+        {
+            fits_close_file(fptr, &status);
+            fits_open_file(&fptr, filename + 1, READONLY, &status);
+            if (status)
+            {
+                arg->nerrors++;
+                free(array);
+                return(NULL);
+            }
+        }
+
+        if (hdu == TABLEHDU)
+            nerr = readtable(fptr) != 0;
+        else if (ii % 3 == 0)
+            nerr = readhdu(fptr, hdu, array) != 0;
+        else
+            nerr = readtyped(fptr, hdu, array, ii % 3 - 1) != 0;
+
+        if (nerr || (hdu != TABLEHDU &&
+            memcmp(array, reference[hdu], NX * NY * sizeof(float))))
+            arg->nerrors++;
+    }
+
+    status = 0;
+    fits_close_file(fptr, &status);
+    free(array);
+    return(NULL);
+}
+
+int main(void)
+{
+    pthread_t threads[NTHREADS];
+    threadarg args[NTHREADS];
+    fitsfile *fptr;
+    int ii, hdu, status = 0, nerrors = 0;
+
+    if (writefile())
+    {
+        fits_report_error(stderr, 1);
+        return(1);
+    }
+
+    /* serial reference read */
+    fits_open_file(&fptr, filename + 1, READONLY, &status);
+    for (hdu = 2; hdu <= NHDUS; hdu++)
+    {
+        reference[hdu] = (float *) malloc(NX * NY * sizeof(float));
+        readhdu(fptr, hdu, reference[hdu]);
+    }
+    fits_close_file(fptr, &status);
+    if (status)
+    {
+        fits_report_error(stderr, status);
+        return(1);
+    }
+
+    /* half the threads share one FITSfile, the others open their own */
+    fits_open_file(&sharedfptr, filename + 1, READONLY, &status);
+    for (ii = 0; ii < NTHREADS; ii++)
+    {
+        args[ii].id = ii;
+        args[ii].shared = ii % 2;
+        args[ii].nerrors = 0;
+        pthread_create(&threads[ii], NULL, reader, &args[ii]);
+    }
+
+    for (ii = 0; ii < NTHREADS; ii++)
+    {
+        pthread_join(threads[ii], NULL);
+        printf("thread %d (%s handle): %d errors in %d reads\n", ii,
+            args[ii].shared ? "shared" : "own", args[ii].nerrors, NREADS);
+        nerrors += args[ii].nerrors;
+    }
+    fits_close_file(sharedfptr, &status);
+
+    for (hdu = 2; hdu <= NHDUS; hdu++)
+        free(reference[hdu]);
+
+    if (nerrors)
+    {
+        printf("threadtest FAILED\n");
+        return(1);
+    }
+
+    printf("threadtest passed\n");
+    return(0);
+}
@@ -107,6 +107,7 @@ int	nlog;
     double faintmag=0.0; /* Faintest magnitude */
     double maxdist=0.0; /* Largest distance */
     int faintstar=0;    /* Faintest star */
+    int	*faintheap = NULL;	/* Stars in order of decreasing magnitude */
     int farstar=0;      /* Most distant star */
     int sysref;		/* Catalog coordinate system */
     double eqref;	/* Catalog coordinate equinox */
@@ -418,15 +419,23 @@ int	nlog;
 			strcpy (objname, star->objname);
 			tobj[faintstar] = objname;
 			}
-		    faintmag = 0.0;
-
-		    /* Find new faintest star */
-		    for (i = 0; i < nstarmax; i++) {
-			if (tmag[magsort][i] > faintmag) {
-			    faintmag = tmag[magsort][i];
-			    faintstar = i;
+		    /* Find new faintest star, keeping the list in heap order */
+		    if (faintheap != NULL)
+			faintstar = MagHeapDown (tmag[magsort], faintheap, nstarmax);
+		    else {
+			faintheap = (int *) calloc (nstarmax, sizeof (int));
+			if (faintheap != NULL) {
+			    MagHeapInit (tmag[magsort], faintheap, nstarmax);
+			    faintstar = faintheap[0];
+			    }
+			else {
+			    for (i = 0; i < nstarmax; i++) {
+				if (tmag[magsort][i] > tmag[magsort][faintstar])
+				    faintstar = i;
+				}
 			    }
 			}
+		    faintmag = tmag[magsort][faintstar];
 		    }
 		
 		nstar++;
@@ -462,6 +471,8 @@ int	nlog;
 
     free ((void *)star);
     free ((void *)tdist);
+    if (faintheap != NULL)
+	free ((void *)faintheap);
     return (nstar);
 }
 
@@ -1595,4 +1606,6 @@ char    *filename;      /* Name of file to check */
  * Nov 28 2007	Move moveb() to catutil.c
  *
  * Sep 25 2009	Call movebuff() instead of moveb() and move mvebuff() to catutil.c
+ *
+ * Oct 19 2026	Keep a heap of the faintest stars instead of rescanning a full list
  */
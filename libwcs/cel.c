@@ -134,6 +134,47 @@
 *                           2: Invalid projection parameters.
 *                           3: Invalid value of (x,y).
 *
+*   Vector transformations; celfwdn() and celrevn()
+*   -----------------------------------------------
+*   Apply celfwd() or celrev() to n points at once.  The coordinates are
+*   read and written as lng[k*sll], lat[k*sll], x[k*sxy], y[k*sxy] for
+*   k = 0..n-1, so interleaved (lng,lat) pairs may be passed with a stride
+*   of 2.  Output may overwrite input.  The native coordinates (phi,theta)
+*   are not returned.
+*
+*   For TAN, SIN (orthographic), STG, ARC and ZEA the spherical rotation
+*   and the projection are done together on the direction cosines of each
+*   point, using the rotation precomputed from cel->euler, which avoids
+*   the trigonometry on (phi,theta).  Other projections fall back to
+*   sphfwd()/sphrev() and the projection routine for each point.
+*
+*   Given:
+*      pcode[4] const char
+*                        WCS projection code.
+*      n        const int
+*                        Number of points.
+*      lng,lat  const double[]
+*      or x,y            Coordinates of the points.
+*      sll,sxy  const int
+*                        Strides of the (lng,lat) and (x,y) arrays.
+*
+*   Given and returned:
+*      cel      celprm*  Spherical coordinate transformation parameters.
+*      prj      prjprm*  Projection parameters.
+*
+*   Returned:
+*      x,y      double[] Projected coordinates (celfwdn), or
+*      lng,lat           celestial coordinates (celrevn), in degrees.
+*      stat     int[]    Status of each point: 0 for success, 3 if the
+*                        point is invalid (its output is not set).
+*
+*   Function return value:
+*               int      Error status
+*                           0: Success.
+*                           1: Invalid coordinate transformation parameters.
+*                           2: Invalid projection parameters.
+*                           3: One or more of the points are invalid.
+*
 *   Coordinate transformation parameters
 *   ------------------------------------
 *   The celprm struct consists of the following:
@@ -462,6 +503,274 @@ double *lng, *lat;
    return 0;
 }
 
+/*--------------------------------------------------------------------------*/
+
+/* Zenithal projections which celfwdn() and celrevn() evaluate directly on
+   direction cosines */
+#define ZENTAN 1
+#define ZENSIN 2
+#define ZENSTG 3
+#define ZENARC 4
+#define ZENZEA 5
+
+/* Return the ZENxxx code for a projection, or 0 if it is not one of them */
+
+static int
+celzen(prj)
+
+struct prjprm *prj;
+
+{
+   if (strcmp(prj->code, "TAN") == 0) {
+      return ZENTAN;
+   } else if (strcmp(prj->code, "SIN") == 0 && prj->w[1] == 0.0) {
+      return ZENSIN;
+   } else if (strcmp(prj->code, "STG") == 0) {
+      return ZENSTG;
+   } else if (strcmp(prj->code, "ARC") == 0) {
+      return ZENARC;
+   } else if (strcmp(prj->code, "ZEA") == 0) {
+      return ZENZEA;
+   }
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int
+celfwdn(pcode, n, lng, lat, sll, cel, prj, x, y, sxy, stat)
+
+const char pcode[4];
+const int n;
+const double lng[], lat[];
+const int sll;
+struct celprm *cel;
+struct prjprm *prj;
+double x[], y[];
+const int sxy;
+int stat[];
+
+{
+   int    err, i, nbad, zen;
+   double a, b, c, cosphip, coslat, dlng, k, phi, sinlat, sinphip, theta;
+   double u, v, w, xp, yp;
+   const double *eul;
+
+   if (cel->flag != CELSET) {
+      if (celset(pcode, cel, prj)) return 1;
+   }
+
+   eul = cel->euler;
+   cosphip = cosdeg (eul[2]);
+   sinphip = sindeg (eul[2]);
+   zen = celzen(prj);
+
+   nbad = 0;
+   for (i = 0; i < n; i++) {
+      stat[i] = 0;
+
+      if (zen) {
+         /* Native direction cosines (u,v,w) of the point. */
+         dlng = (lng[i*sll] - eul[0])*D2R;
+         coslat = cos(lat[i*sll]*D2R);
+         sinlat = sin(lat[i*sll]*D2R);
+         a = coslat*cos(dlng);
+         b = coslat*sin(dlng);
+         xp = sinlat*eul[4] - a*eul[3];
+         yp = -b;
+         w  = sinlat*eul[3] + a*eul[4];
+         u  = xp*cosphip - yp*sinphip;
+         v  = xp*sinphip + yp*cosphip;
+
+         /* Put points within roundoff of the native equator on it. */
+         if (fabs(w) < 1.0e-14) w = 0.0;
+
+         /* Radius in the plane divided by cos(theta). */
+         k = 0.0;
+         switch (zen) {
+         case ZENTAN:
+            if (w <= 0.0) {
+               stat[i] = 3;
+            } else {
+               k = prj->r0/w;
+            }
+            break;
+         case ZENSIN:
+            if (prj->flag > 0 && w < 0.0) {
+               stat[i] = 3;
+            } else {
+               k = prj->r0;
+            }
+            break;
+         case ZENSTG:
+            if (w == -1.0) {
+               stat[i] = 3;
+            } else {
+               k = prj->w[0]/(1.0 + w);
+            }
+            break;
+         case ZENARC:
+            c = sqrt(u*u + v*v);
+            if (c < 1.0e-10) {
+               k = (w > 0.0) ? prj->r0 : 0.0;
+            } else {
+               k = prj->r0*atan2(c, w)/c;
+            }
+            break;
+         case ZENZEA:
+            k = (w > -1.0) ? prj->r0*sqrt(2.0/(1.0 + w)) : 0.0;
+            break;
+         }
+
+         if (k != 0.0 || stat[i]) {
+            if (stat[i] == 0) {
+               x[i*sxy] =  k*v;
+               y[i*sxy] = -k*u;
+            } else {
+               nbad++;
+            }
+            continue;
+         }
+      }
+
+      /* Other projections, and the antipode of a zenithal projection. */
+      sphfwd(lng[i*sll], lat[i*sll], cel->euler, &phi, &theta);
+      if ((err = prj->prjfwd(phi, theta, prj, &x[i*sxy], &y[i*sxy]))) {
+         if (err == 1) return 2;
+         stat[i] = 3;
+         nbad++;
+      }
+   }
+
+   return nbad ? 3 : 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+int
+celrevn(pcode, n, x, y, sxy, prj, cel, lng, lat, sll, stat)
+
+const char pcode[4];
+const int n;
+const double x[], y[];
+const int sxy;
+struct prjprm *prj;
+struct celprm *cel;
+double lng[], lat[];
+const int sll;
+int stat[];
+
+{
+   int    err, i, nbad, zen;
+   double a, b, cosphip, m, phi, r, r2, rho, sinphip, t, theta, u, v, w;
+   double xi, xp, yi, yp, z;
+   const double *eul;
+   const double tol = 1.0e-12;
+
+   if (cel->flag != CELSET) {
+      if (celset(pcode, cel, prj)) return 1;
+   }
+
+   eul = cel->euler;
+   cosphip = cosdeg (eul[2]);
+   sinphip = sindeg (eul[2]);
+   zen = celzen(prj);
+
+   nbad = 0;
+   for (i = 0; i < n; i++) {
+      stat[i] = 0;
+      xi = x[i*sxy];
+      yi = y[i*sxy];
+
+      if (zen) {
+         /* cos(theta)/r and sin(theta) from the radius in the plane. */
+         r2 = xi*xi + yi*yi;
+         m = 0.0;
+         w = 0.0;
+         switch (zen) {
+         case ZENTAN:
+            r = sqrt(prj->r0*prj->r0 + r2);
+            m = 1.0/r;
+            w = prj->r0/r;
+            break;
+         case ZENSIN:
+            t = r2*prj->w[0]*prj->w[0];
+            if (t > 1.0) {
+               stat[i] = 3;
+            } else {
+               m = prj->w[0];
+               w = sqrt(1.0 - t);
+            }
+            break;
+         case ZENSTG:
+            t = r2*prj->w[1]*prj->w[1];
+            m = 2.0*prj->w[1]/(1.0 + t);
+            w = (1.0 - t)/(1.0 + t);
+            break;
+         case ZENARC:
+            r = sqrt(r2);
+            rho = r*prj->w[1]*D2R;
+            m = (r == 0.0) ? prj->w[1]*D2R : sin(rho)/r;
+            w = cos(rho);
+            break;
+         case ZENZEA:
+            t = r2*prj->w[1]*prj->w[1];
+            if (t > 1.0) {
+               if (fabs(sqrt(r2) - prj->w[0]) < tol) {
+                  t = 1.0;
+               } else {
+                  stat[i] = 3;
+               }
+            }
+            m = 2.0*prj->w[1]*sqrt(1.0 - t);
+            w = 1.0 - 2.0*t;
+            break;
+         }
+         if (stat[i]) {
+            nbad++;
+            continue;
+         }
+
+         /* Native direction cosines, then celestial ones. */
+         u = -yi*m;
+         v =  xi*m;
+         xp =  u*cosphip + v*sinphip;
+         yp = -u*sinphip + v*cosphip;
+         a = w*eul[4] - xp*eul[3];
+         b = -yp;
+         z = xp*eul[4] + w*eul[3];
+
+         lng[i*sll] = eul[0] + atan2(b, a)*R2D;
+         lat[i*sll] = atan2(z, sqrt(a*a + b*b))*R2D;
+
+      } else {
+         if ((err = prj->prjrev(xi, yi, prj, &phi, &theta))) {
+            if (err == 1) return 2;
+            stat[i] = 3;
+            nbad++;
+            continue;
+         }
+         sphrev(phi, theta, cel->euler, &lng[i*sll], &lat[i*sll]);
+         continue;
+      }
+
+      /* Normalize the celestial longitude as sphrev() does. */
+      if (eul[0] >= 0.0) {
+         if (lng[i*sll] < 0.0) lng[i*sll] += 360.0;
+      } else {
+         if (lng[i*sll] > 0.0) lng[i*sll] -= 360.0;
+      }
+      if (lng[i*sll] > 360.0) {
+         lng[i*sll] -= 360.0;
+      } else if (lng[i*sll] < -360.0) {
+         lng[i*sll] += 360.0;
+      }
+   }
+
+   return nbad ? 3 : 0;
+}
+
 /* Dec 20 1999	Doug Mink - Change cosd() and sind() to cosdeg() and sindeg()
  * Dec 20 1999	Doug Mink - Include wcslib.h, which includes wcsmath.h and cel.h
  *
@@ -471,4 +780,6 @@ double *lng, *lat;
  * Sep 19 2001	Doug Mink - Add above changes to WCSLIB-2.7 cel.c
  *
  * Mar 12 2002	Doug Mink - Add changes to WCSLIB-2.8.2 cel.c
+ *
+ * Oct 19 2026	Add celfwdn() and celrevn() to transform arrays of points
  */
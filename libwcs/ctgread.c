@@ -98,6 +98,7 @@ int	nlog;
     double faintmag=0.0; /* Faintest magnitude */
     double maxdist=0.0; /* Largest distance */
     int faintstar=0;    /* Faintest star */
+    int	*faintheap = NULL;	/* Stars in order of decreasing magnitude */
     int farstar=0;      /* Most distant star */
     double *tdist;      /* Array of distances to stars */
     int sysref;		/* Catalog coordinate system */
@@ -473,15 +474,23 @@ int	nlog;
 		    else
 			tobj[faintstar] = NULL;
 		    }
-		faintmag = 0.0;
-
-		/* Find new faintest star */
-		for (i = 0; i < nsmax; i++) {
-		    if (tmag[magsort][i] > faintmag) {
-			faintmag = tmag[magsort][i];
-			faintstar = i;
+		/* Find new faintest star, keeping the list in heap order */
+		if (faintheap != NULL)
+		    faintstar = MagHeapDown (tmag[magsort], faintheap, nsmax);
+		else {
+		    faintheap = (int *) calloc (nsmax, sizeof (int));
+		    if (faintheap != NULL) {
+			MagHeapInit (tmag[magsort], faintheap, nsmax);
+			faintstar = faintheap[0];
+			}
+		    else {
+			for (i = 0; i < nsmax; i++) {
+			    if (tmag[magsort][i] > tmag[magsort][faintstar])
+				faintstar = i;
+			    }
 			}
 		    }
+		faintmag = tmag[magsort][faintstar];
 		}
 
 	    nstar++;
@@ -512,6 +521,8 @@ int	nlog;
 
     free ((char *)tdist);
     free (star);
+    if (faintheap != NULL)
+	free ((void *)faintheap);
     return (nstar);
 }
 
@@ -2117,4 +2128,6 @@ char	*in;	/* Character string */
  *
  * Aug 27 2009	Add /k option for fractional hours of RA and degrees of Dec
  * Sep 30 2009	Add UCAC3
+ *
+ * Oct 19 2026	Keep a heap of the faintest stars instead of rescanning a full list
  */
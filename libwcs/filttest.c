@@ -0,0 +1,226 @@
+/* File filttest.c
+ * Check medfilt() and meanfilt() against the median and mean of each box
+ * found by sorting and summing its good pixels, and check that no filter
+ * spreads NaN pixels to their neighbors.
+ *
+ * Images of each type, with BLANK pixels and, for floating point, NaN
+ * pixels, are filtered with boxes of several shapes, in one band of rows
+ * and in three.  Without threads ("make REENTRANT=-D_REENTRANT") both use
+ * one band.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "fitsfile.h"
+
+#define NX	157
+#define NY	93
+#define NBOX	9
+#define BLANKVAL	-32768.0
+
+extern char *medfilt();
+extern char *meanfilt();
+extern char *gaussfilt();
+extern void setfiltthread();
+
+static int boxes[NBOX][2] = {{3,3},{1,5},{4,6},{5,5},{7,3},{31,31},{2,2},
+			     {15,1},{9,11}};
+
+static int
+dcomp (p1, p2)
+
+const void *p1, *p2;
+{
+    double d1 = *(double *) p1;
+    double d2 = *(double *) p2;
+
+    if (d1 < d2)
+	return (-1);
+    else if (d1 > d2)
+	return (1);
+    else
+	return (0);
+}
+
+/* Return pixel i, setting *good to 0 if it is BLANK or NaN, else 1 */
+
+static double
+testpix (image, bitpix, i, good)
+
+char	*image;
+int	bitpix;
+int	i;
+int	*good;
+{
+    double v;
+
+    switch (bitpix) {
+	case 16:
+	    v = (double) ((short *)image)[i];
+	    break;
+	case 32:
+	    v = (double) ((int *)image)[i];
+	    break;
+	case -32:
+	    v = (double) ((float *)image)[i];
+	    break;
+	default:
+	    v = ((double *)image)[i];
+	    break;
+	}
+    *good = (v != BLANKVAL && v == v);
+    return (v);
+}
+
+/* Fill an image with values, BLANK pixels and, if floating point, NaNs */
+
+static void
+makeimage (image, bitpix)
+
+char	*image;
+int	bitpix;
+{
+    double v;
+    int i, blank;
+
+    for (i = 0; i < NX * NY; i++) {
+	blank = (rand() % 20 == 0);
+	v = (double) (rand() % 300 - 50);
+	if (bitpix < 0)
+	    v = v + (rand() % 1000) / 1000.0;
+	if (blank && bitpix < 0 && rand() % 2)
+	    v = sqrt (-1.0 - (double) (rand() % 2));
+	else if (blank)
+	    v = BLANKVAL;
+	switch (bitpix) {
+	    case 16:
+		((short *)image)[i] = (short) v;
+		break;
+	    case 32:
+		((int *)image)[i] = (int) v * 1000;
+		break;
+	    case -32:
+		((float *)image)[i] = (float) v;
+		break;
+	    default:
+		((double *)image)[i] = v;
+		break;
+	    }
+	}
+    return;
+}
+
+/* Return the number of good pixels in the box around ix, iy, with their
+ * median and mean */
+
+static int
+boxstat (image, bitpix, ix, iy, ndx, ndy, med, mean)
+
+char	*image;
+int	bitpix;
+int	ix, iy;
+int	ndx, ndy;
+double	*med, *mean;
+{
+    static double vec[NX * NY];
+    double sum = 0.0;
+    int jx, jy, n, good;
+
+    n = 0;
+    for (jy = iy - ndy/2; jy <= iy + ndy/2; jy++) {
+	for (jx = ix - ndx/2; jx <= ix + ndx/2; jx++) {
+	    if (jx < 0 || jy < 0 || jx >= NX || jy >= NY)
+		continue;
+	    vec[n] = testpix (image, bitpix, jy*NX + jx, &good);
+	    if (good)
+		sum = sum + vec[n++];
+	    }
+	}
+    if (n > 0) {
+	qsort ((void *) vec, n, sizeof (double), dcomp);
+	*med = vec[n/2];
+	*mean = sum / (double) n;
+	if (bitpix == 16)
+	    *mean = (double) (short) *mean;
+	else if (bitpix == 32)
+	    *mean = (double) (int) *mean;
+	else if (bitpix == -32)
+	    *mean = (double) (float) *mean;
+	}
+    return (n);
+}
+
+int
+main ()
+{
+    static int bitpixes[4] = {16, 32, -32, -64};
+    char *header, *image, *med, *mean, *gauss;
+    double bmed, bmean, v, v0, tol;
+    int ib, ibox, nband, ix, iy, i, n, good, ndx, ndy;
+    int nmed = 0, nmean = 0, ngauss = 0;
+
+    srand (7);
+    header = (char *) malloc (2881);
+    image = (char *) malloc (NX * NY * sizeof (double));
+    for (ib = 0; ib < 4; ib++) {
+	memset (header, ' ', 2880);
+	header[2880] = (char) 0;
+	memcpy (header, "END", 3);
+	hlength (header, 2880);
+	hputl (header, "SIMPLE", 1);
+	hputi4 (header, "BITPIX", bitpixes[ib]);
+	hputi4 (header, "NAXIS", 2);
+	hputi4 (header, "NAXIS1", NX);
+	hputi4 (header, "NAXIS2", NY);
+	hputr8 (header, "BLANK", BLANKVAL);
+	tol = (bitpixes[ib] == -32) ? 1.0e-5 : 1.0e-9;
+
+	for (ibox = 0; ibox < NBOX; ibox++) {
+	    ndx = boxes[ibox][0];
+	    ndy = boxes[ibox][1];
+	    for (nband = 1; nband <= 3; nband = nband + 2) {
+		makeimage (image, bitpixes[ib]);
+		setfiltthread (nband);
+		med = medfilt (image, header, ndx, ndy, 0);
+		mean = meanfilt (image, header, ndx, ndy, 0);
+		gauss = gaussfilt (image, header, ndx, ndy, 0);
+		for (iy = 0; iy < NY; iy++) {
+		    for (ix = 0; ix < NX; ix++) {
+			i = iy*NX + ix;
+			n = boxstat (image, bitpixes[ib], ix, iy, ndx, ndy,
+				     &bmed, &bmean);
+			/* Only a NaN pixel may be left NaN */
+			v0 = testpix (image, bitpixes[ib], i, &good);
+			v = testpix (gauss, bitpixes[ib], i, &good);
+			if (v != v && v0 == v0)
+			    ngauss++;
+			if (n == 0)
+			    continue;
+			v = testpix (med, bitpixes[ib], i, &good);
+			if (v != bmed)
+			    nmed++;
+			v = testpix (mean, bitpixes[ib], i, &good);
+			if (!(fabs (v - bmean) <= tol * fabs (bmean) + 1.0e-9))
+			    nmean++;
+			}
+		    }
+		free (med);
+		free (mean);
+		free (gauss);
+		}
+	    }
+	}
+    free (image);
+    free (header);
+
+    printf ("%d median, %d mean, %d Gaussian mismatches\n",
+	    nmed, nmean, ngauss);
+    if (nmed || nmean || ngauss) {
+	printf ("filttest FAILED\n");
+	return (1);
+	}
+    printf ("filttest passed\n");
+    return (0);
+}
@@ -34,10 +34,78 @@
 #include "wcs.h"
 #include "wcscat.h"
 #include "lwcs.h"
+#ifdef _REENTRANT
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 #define ABS(a) ((a) < 0 ? (-(a)) : (a))
 
+/* A candidate pixel tested by SearchPixel(), with what came of it */
+struct BandEvent {
+    int		x, y;		/* Candidate pixel */
+    double	noise;		/* Local noise level */
+    double	minsig;		/* Local minimum signal above noise */
+    double	minll;		/* Local lower limit for a star */
+    int		kind;		/* FS_HOT, FS_NEAR, FS_KEPT, or FS_NONE */
+    int		sx, sy;		/* Brightest pixel walked to */
+    int		x1, x2;		/* Columns read while testing it */
+    int		y1, y2;		/* Rows read while testing it */
+};
+#define FS_NONE	0	/* Not a star */
+#define FS_HOT	1	/* Hot pixel, clamped */
+#define FS_NEAR	2	/* Too close to a star already found */
+#define FS_KEPT	3	/* Added to the star list */
+
+/* Search of one horizontal band of image rows by FindBand() */
+struct StarBand {
+    char	*image;		/* Image pixels, read but not written */
+    int		bitpix;		/* Bits per pixel, negative for floating point */
+    int		w, h;		/* Image width and height in pixels */
+    double	bz, bs;		/* Pixel value scaling */
+    int		xborder1;	/* Columns to ignore at the left */
+    int		xborder2;	/* Columns to ignore at the right */
+    int		y1, y2;		/* Search rows y1 through y2-1 */
+    double	noise;		/* Mean of central swath */
+    double	minsig;		/* Minimum signal above noise */
+    double	minll;		/* Lower limit for a star */
+    int		verbose;	/* 1 to print each star's position */
+    int		zap;		/* If 1, set star to background after reading */
+    int		defer;		/* 1 to clamp hot pixels only in the band's view */
+    int		logev;		/* 1 to log each candidate for CheckBand() */
+    int		nstars;		/* Number of stars found, -1 if trouble */
+    int		nstarmax;	/* Allocated length of star arrays */
+    double	*xa, *ya;	/* Star centroids */
+    double	*ba;		/* Star fluxes */
+    int		*pa;		/* Star peaks */
+    int		*ixa, *iya;	/* Star centroids rounded to pixels */
+    int		nprior;		/* Number of stars found in the bands above */
+    int		*ixprior;	/* Their centroids rounded to pixels */
+    int		*iyprior;
+    int		nhot;		/* Number of hot pixels clamped */
+    int		nhotmax;	/* Allocated length of hot pixel arrays */
+    int		*xhot, *yhot;	/* Hot pixels in the order they were found */
+    double	*hotll;		/* Level to which each hot pixel is clamped */
+    double	*hotval;	/* Value read back from each clamped pixel */
+    int		*hotnext;	/* Next hot pixel in the same row, -1 if none */
+    int		*hotrow;	/* First hot pixel in each image row, -1 if none */
+    int		rx1, rx2;	/* Columns read for the current candidate */
+    int		ry1, ry2;	/* Rows read for the current candidate */
+    int		nev;		/* Number of candidates logged */
+    int		nevmax;		/* Allocated length of candidate log */
+    struct BandEvent *ev;	/* Candidates in the order they were tested */
+};
+
+static void bandrow();
+static double bandpix();
+static void getbox3();
 static int HotPixel();
+static int SaveHot();
+static int NewStar();
+static int NearStar();
+static int SearchPixel();
+static int ReadChanged();
+static int CheckBand();
 static int starRadius();
 static void starCentroid();
 static int BrightWalk ();
@@ -45,6 +113,10 @@ static double FindFlux ();
 static void mean2d();
 static void mean1d();
 static void rotstars();
+static void *FindBand();
+static int InitBand();
+static void ClearBand();
+static void FreeBand();
 extern void setminmatch();
 extern void setnitmax();
 extern void setminstars();
@@ -133,6 +205,11 @@ void setrotate (rotate1)
 int rotate1;
 { rotate = rotate1; return;}
 
+static int nfsthread = NFSTHREAD; /* Threads searching bands, 0 for one per CPU */
+void setfsthread (nthread)
+int nthread;
+{ nfsthread = nthread; return;}
+
 
 /* Find the location and brightest pixel of stars in the given image.
  * Return malloced arrays of x and y and b.
@@ -158,19 +235,16 @@ int	zap;		/* If 1, set star to background after reading */
     int nstars;
     double minll;
     int bitpix;
-    int w, h, ilp, irp, i, idx, idy;
-    int x, y, x1, x2, y1, y2;
-    double xai, yai, bai;
+    int w, h, i, j, k;
+    int x1, x2, y1, y2;
     double minsig, sigma;
-    double *svec, *svb, *sv, *sv1, *sv2, *svlim;
-    double rmax;
     double bz, bs;		/* Pixel value scaling */
     int *ixa, *iya;
-    int lwidth;
-    int nextline;
     int xborder1, xborder2, yborder1, yborder2;
     char trimsec[32];
     int nstarmax = 100;
+    int nband, nrows;
+    struct StarBand *band, *sb;
     extern void setscale();
 
     hgeti4 (header,"NAXIS1", &w);
@@ -233,9 +307,6 @@ int	zap;		/* If 1, set star to background after reading */
 	yborder2 = fsborder;
 	}
 
-    /* Allocate a buffer to hold one image line */
-    svec = (double *) malloc (w * sizeof (double));
-
     /* Compute image noise from a central swath */
     x1 = (w / 2) - rnoise;
     if (x1 < 1)
@@ -254,13 +325,6 @@ int	zap;		/* If 1, set star to background after reading */
 	fprintf (stderr, "FindStar mean is %.2f, sigma is %.2f\n",
 		 noise, nsigma);
 
-    /* Fill in borders of the image line buffer with noise */
-    svlim = svec + w;
-    svb = svec + xborder1;
-    for (sv = svec; sv < svb; sv++)
-	*sv = noise;
-    for (sv = svlim - xborder2; sv < svlim; sv++)
-	*sv = noise;
     if (verbose) {
 	fprintf (stderr, "FindStar x=1-%d, %d-%d set to noise\n",
 		 xborder1, w-xborder2+1, w);
@@ -277,10 +341,189 @@ int	zap;		/* If 1, set star to background after reading */
     else
 	minsig = nsigma;
 
+    /* Split the rows to search into bands, one for each thread.  Bands
+     * read past their edges as far as the walk and radius need, but keep
+     * the hot pixels they clamp out of the image until every band is done.
+     * Zapping stars and printing progress depend on row order, so those
+     * searches are not split. */
+    nrows = h - yborder1 - yborder1;
+    nband = 1;
+#ifdef _REENTRANT
+    if (!zap && !verbose) {
+	nband = nfsthread;
+	if (nband < 1)
+	    nband = (int) sysconf (_SC_NPROCESSORS_ONLN);
+	if (nband > nrows / MINBAND)
+	    nband = nrows / MINBAND;
+	if (nband < 1)
+	    nband = 1;
+	}
+#endif
+    band = (struct StarBand *) calloc (nband, sizeof (struct StarBand));
+    if (band == NULL)
+	return (-1);
+    for (i = 0; i < nband; i++) {
+	sb = band + i;
+	sb->image = image;
+	sb->bitpix = bitpix;
+	sb->w = w;
+	sb->h = h;
+	sb->bz = bz;
+	sb->bs = bs;
+	sb->xborder1 = xborder1;
+	sb->xborder2 = xborder2;
+	sb->y1 = yborder1 + (int) (((double) nrows * i) / nband);
+	sb->y2 = yborder1 + (int) (((double) nrows * (i+1)) / nband);
+	sb->noise = noise;
+	sb->minsig = minsig;
+	sb->minll = minll;
+	sb->verbose = verbose;
+	sb->zap = zap;
+	sb->defer = (nband > 1);
+	sb->logev = (nband > 1 && i > 0);
+	}
+
     /* Scan for stars based on surrounding local noise figure */
+#ifdef _REENTRANT
+    if (nband > 1) {
+	pthread_t *threads;
+	int *started;
+	threads = (pthread_t *) calloc (nband, sizeof (pthread_t));
+	started = (int *) calloc (nband, sizeof (int));
+	for (i = 1; i < nband; i++) {
+	    if (threads != NULL && started != NULL)
+		started[i] = !pthread_create (&threads[i], NULL, FindBand,
+					      (void *) (band+i));
+	    }
+	(void) FindBand ((void *) band);
+	for (i = 1; i < nband; i++) {
+	    if (started != NULL && started[i])
+		pthread_join (threads[i], NULL);
+	    else
+		(void) FindBand ((void *) (band+i));
+	    }
+	if (threads != NULL)
+	    free ((char *)threads);
+	if (started != NULL)
+	    free ((char *)started);
+	}
+    else
+#endif
+	(void) FindBand ((void *) band);
+
+    /* Merge bands in row order.  A band searched alongside the others
+     * saw the image before the bands above clamped their hot pixels, and
+     * did not know their stars, so CheckBand() tests again the candidates
+     * this could have changed, as a single band would have tested them.
+     * Then the band's hot pixels are clamped in the image for the bands
+     * below. */
     nstars = 0;
+    for (k = 0; k < nband; k++) {
+	sb = band + k;
+	if (sb->logev && sb->nstars >= 0 &&
+	    CheckBand (band, k, ixa, iya, nstars))
+	    sb->nstars = -1;
+	if (sb->nstars < 0) {
+	    FreeBand (band, nband);
+	    free ((char *)ixa);
+	    free ((char *)iya);
+	    return (-1);
+	    }
+	if (sb->defer) {
+	    for (j = 0; j < sb->nhot; j++)
+		putpix (image, bitpix, w, h, bz, bs, sb->xhot[j], sb->yhot[j],
+			sb->hotll[j]);
+	    }
+
+	/* Make room for the band's stars */
+	if (nstars + sb->nstars > nstarmax) {
+	    nstarmax = nstars + sb->nstars;
+	    *xa = (double *) realloc (*xa, nstarmax*sizeof(double));
+	    *ya = (double *) realloc (*ya, nstarmax*sizeof(double));
+	    *ba = (double *) realloc (*ba, nstarmax*sizeof(double));
+	    *pa = (int *) realloc (*pa, nstarmax*sizeof(int));
+	    ixa = (int *) realloc (ixa, nstarmax*sizeof(int));
+	    iya = (int *) realloc (iya, nstarmax*sizeof(int));
+	    }
+	for (j = 0; j < sb->nstars; j++) {
+	    (*xa)[nstars] = sb->xa[j];
+	    (*ya)[nstars] = sb->ya[j];
+	    (*ba)[nstars] = sb->ba[j];
+	    (*pa)[nstars] = sb->pa[j];
+	    ixa[nstars] = sb->ixa[j];
+	    iya[nstars] = sb->iya[j];
+	    nstars++;
+	    }
+	}
+    FreeBand (band, nband);
+
+    /* Turn fluxes into instrument magnitudes */
+    (void) FluxSortStars (*xa, *ya, *ba, *pa, nstars);
+    if (nstars > 0) {
+	double *flux;
+	for (i = 0; i < nstars; i++) {
+	    flux = (*ba)+i;
+	    *flux = -2.5 * log10 (*flux);
+	    }
+	}
+
+    free ((char *)ixa);
+    free ((char *)iya);
+    return (nstars);
+}
+
+
+/* Search one band of image rows for stars, keeping them in the band's own
+ * arrays.  Hot pixels are clamped to the local noise limit as they are
+ * found.  If other bands are being searched at the same time, they are
+ * clamped only in the band's own view of the image, through bandrow(),
+ * and the caller clamps them in the image afterwards.
+ */
+
+static void *
+FindBand (arg)
+
+void	*arg;		/* Band to search (struct StarBand *) */
+{
+    struct StarBand *sb = (struct StarBand *) arg;
+    struct BandEvent ev;
+    char *image = sb->image;
+    int bitpix = sb->bitpix;
+    int w = sb->w;
+    double bz = sb->bz;
+    double bs = sb->bs;
+    int xborder1 = sb->xborder1;
+    int xborder2 = sb->xborder2;
+    int verbose = sb->verbose;
+    double noise, minsig, minll, sigma;
+    double *svec, *svb, *sv, *sv1, *sv2, *svlim;
+    int x, y, ilp, irp;
+    int lwidth, nextline;
+
+    noise = sb->noise;
+    minsig = sb->minsig;
+    minll = sb->minll;
+
+    /* Allocate a buffer to hold one image line */
+    svec = (double *) malloc (w * sizeof (double));
+    if (svec == NULL || InitBand (sb)) {
+	if (svec != NULL)
+	    free ((char *)svec);
+	sb->nstars = -1;
+	return (NULL);
+	}
+
+    /* Fill in borders of the image line buffer with noise */
+    svlim = svec + w;
+    svb = svec + xborder1;
+    for (sv = svec; sv < svb; sv++)
+	*sv = noise;
+    for (sv = svlim - xborder2; sv < svlim; sv++)
+	*sv = noise;
+
+    /* Scan for stars based on surrounding local noise figure */
     lwidth = w - xborder2 - xborder1 + 1;
-    for (y = yborder1; y < h-yborder1; y++) {
+    for (y = sb->y1; y < sb->y2; y++) {
         int ipix = 0;
 
 	/* Get one line of the image minus the noise-filled borders */
@@ -319,164 +562,572 @@ int	zap;		/* If 1, set star to background after reading */
 
 	    /* Pixel is a candidate if above the noise */
 	    if (svec[x] > minll) {
-		int sx, sy, r, rf;
-		double b;
-		int i;
 
 		/* Ignore faint stars */
 		if (svec[x] < bmin)
 		    continue;
 
-		/* Ignore hot pixels */
-		if (!HotPixel (image,bitpix,w,h,bz,bs, x, y, minll))
-		    continue;
-
-		/* Walkabout to find brightest pixel in neighborhood */
-		if (BrightWalk (image,bitpix,w,h,bz,bs,x,y,maxw,&sx,&sy,&b) < 0)
-		    continue;
-
-		/* Ignore really bright stars */
-		if (burnedout > 0 && b >= burnedout)
-		    continue;
+		ev.x = x;
+		ev.y = y;
+		ev.noise = noise;
+		ev.minsig = minsig;
+		ev.minll = minll;
+		sb->rx1 = x;
+		sb->rx2 = x;
+		sb->ry1 = y;
+		sb->ry2 = y;
+		if (SearchPixel (sb, &ev) < 0)
+		    break;
 
-		/* Skip star if already in list */
-		for (i = 0; i < nstars; i++) {
-		    idy = iya[i] - sy;
-		    if (idy < 0)
-			idy = -idy;
-		    if (idy <= minsep) {
-			idx = ixa[i] - sx;
-			if (idx < 0)
-			    idx = -idx;
-			if (idx <= minsep)
+		/* Log the candidate, with the pixels it read, for CheckBand() */
+		if (sb->logev) {
+		    if (sb->nev >= sb->nevmax) {
+			sb->nevmax = (sb->nevmax > 0) ? 2*sb->nevmax : 256;
+			sb->ev = (struct BandEvent *) realloc (sb->ev,
+				 sb->nevmax * sizeof (struct BandEvent));
+			if (sb->ev == NULL) {
+			    sb->nstars = -1;
 			    break;
+			    }
 			}
+		    ev.x1 = sb->rx1;
+		    ev.x2 = sb->rx2;
+		    ev.y1 = sb->ry1;
+		    ev.y2 = sb->ry2;
+		    sb->ev[sb->nev++] = ev;
 		    }
-		if (i < nstars)
-		    continue;
+		}
+	    }
+	if (sb->nstars < 0)
+	    break;
+	}
 
-		/* Keep it if it is within the size range for stars */
-		rmax = maxrad;
-		r = starRadius (image,bitpix,w,h,bz,bs, sx, sy, rmax,
-				minsig, noise);
-		if (r > minrad && r <= maxrad) {
-
-		/* Centroid star */
-		    nstars++;
-		    if (nstars > nstarmax) {
-			nstarmax = nstarmax * 2;
-			*xa= (double *) realloc(*xa, nstarmax*sizeof(double));
-			*ya= (double *) realloc(*ya, nstarmax*sizeof(double));
-			ixa= (int *) realloc(ixa, nstarmax*sizeof(int));
-			iya= (int *) realloc(iya, nstarmax*sizeof(int));
-			*ba= (double *) realloc(*ba, nstarmax*sizeof(double));
-			*pa= (int *) realloc(*pa, nstarmax*sizeof(int));
-			}
-		    starCentroid (image,bitpix,w,h,bz,bs, sx, sy, &xai, &yai); 
-		    (*xa)[nstars-1] = xai;
-		    (*ya)[nstars-1] = yai;
-		    ixa[nstars-1] = (int) (xai + 0.5);
-		    iya[nstars-1] = (int) (yai + 0.5);
-		    (*pa)[nstars-1] = (int) b;
-
-		/* Find radius of star for photometry */
-		/* Outermost 1-pixel radial band is one sigma above background */
-		    sx = (int) (xai + 0.5);
-		    sy = (int) (yai + 0.5);
-		    rmax = 2.0 * (double) maxrad;
-		    rf = starRadius (image,bitpix,w,h,bz,bs, sx, sy, rmax,
-				    minsig, noise);
-
-		/* Find flux from star */
-		    bai = FindFlux (image,bitpix,w,h,bz,bs,sx,sy,rf,noise,zap);
-		    (*ba)[nstars-1] = bai;
-		    if (verbose) {
-			fprintf (stderr, "Row %5d Col %5d: ", y+1, x+1);
-			fprintf (stderr," %d: (%d %d) -> (%7.3f %7.3f)",
-				 nstars, sx, sy, xai, yai);
-			fprintf (stderr," %8.1f -> %10.1f  %d -> %d    ",
-				 b, bai, r, rf);
-			(void)putc (13,stderr);
-			}
+    free ((char *)svec);
+    return (NULL);
+}
+
+
+/* Allocate the star arrays and hot pixel row index of a band before it is
+ * searched.  Return 0, or -1 if memory runs out */
+
+static int
+InitBand (sb)
+
+struct StarBand *sb;	/* Band to search */
+{
+    int y;
+
+    sb->nstars = 0;
+    sb->nstarmax = 100;
+    sb->xa = (double *) calloc (sb->nstarmax, sizeof(double));
+    sb->ya = (double *) calloc (sb->nstarmax, sizeof(double));
+    sb->ba = (double *) calloc (sb->nstarmax, sizeof(double));
+    sb->pa = (int *) calloc (sb->nstarmax, sizeof(int));
+    sb->ixa = (int *) calloc (sb->nstarmax, sizeof (int));
+    sb->iya = (int *) calloc (sb->nstarmax, sizeof (int));
+    sb->hotrow = (int *) malloc (sb->h * sizeof (int));
+    if (sb->xa == NULL || sb->ya == NULL || sb->ba == NULL ||
+	sb->pa == NULL || sb->ixa == NULL || sb->iya == NULL ||
+	sb->hotrow == NULL)
+	return (-1);
+    for (y = 0; y < sb->h; y++)
+	sb->hotrow[y] = -1;
+    return (0);
+}
+
+
+/* Test the candidate pixel ev->x, ev->y, which is above the local limit,
+ * for being a hot pixel or a new star, and set ev->kind to what it was.
+ * Return ev->kind, or -1 if memory runs out.
+ */
+
+static int
+SearchPixel (sb, ev)
+
+struct StarBand *sb;	/* Band being searched */
+struct BandEvent *ev;	/* Candidate and local statistics */
+{
+    int x = ev->x;
+    int y = ev->y;
+    double noise = ev->noise;
+    double minsig = ev->minsig;
+    double minll = ev->minll;
+    double rmax, xai, yai, bai, b;
+    int sx, sy, r, rf, n;
+
+    ev->kind = FS_NONE;
+    ev->sx = x;
+    ev->sy = y;
+
+    /* Ignore hot pixels, clamping them to the noise limit */
+    if (!HotPixel (sb, x, y, minll)) {
+	if (!sb->defer)
+	    putpix (sb->image, sb->bitpix, sb->w, sb->h, sb->bz, sb->bs,
+		    x, y, minll);
+	if (SaveHot (sb, x, y, minll) < 0) {
+	    sb->nstars = -1;
+	    return (-1);
+	    }
+	ev->kind = FS_HOT;
+	return (ev->kind);
+	}
+
+    /* Walkabout to find brightest pixel in neighborhood */
+    if (BrightWalk (sb, x, y, maxw, &sx, &sy, &b) < 0)
+	return (ev->kind);
+    ev->sx = sx;
+    ev->sy = sy;
+
+    /* Ignore really bright stars */
+    if (burnedout > 0 && b >= burnedout)
+	return (ev->kind);
+
+    /* Skip star if already in list, or found in a band above */
+    if (NearStar (sb->ixa, sb->iya, sb->nstars, sx, sy) ||
+	NearStar (sb->ixprior, sb->iyprior, sb->nprior, sx, sy)) {
+	ev->kind = FS_NEAR;
+	return (ev->kind);
+	}
+
+    /* Keep it if it is within the size range for stars */
+    rmax = maxrad;
+    r = starRadius (sb, sx, sy, rmax, minsig, noise);
+    if (r <= minrad || r > maxrad)
+	return (ev->kind);
+
+    /* Centroid star */
+    if ((n = NewStar (sb)) < 0)
+	return (-1);
+    starCentroid (sb, sx, sy, &xai, &yai); 
+    sb->xa[n] = xai;
+    sb->ya[n] = yai;
+    sb->ixa[n] = (int) (xai + 0.5);
+    sb->iya[n] = (int) (yai + 0.5);
+    sb->pa[n] = (int) b;
+
+    /* Find radius of star for photometry */
+    /* Outermost 1-pixel radial band is one sigma above background */
+    sx = (int) (xai + 0.5);
+    sy = (int) (yai + 0.5);
+    rmax = 2.0 * (double) maxrad;
+    rf = starRadius (sb, sx, sy, rmax, minsig, noise);
+
+    /* Find flux from star */
+    bai = FindFlux (sb, sx, sy, rf, noise, sb->zap);
+    sb->ba[n] = bai;
+    if (sb->verbose) {
+	fprintf (stderr, "Row %5d Col %5d: ", y+1, x+1);
+	fprintf (stderr," %d: (%d %d) -> (%7.3f %7.3f)",
+		 n+1, sx, sy, xai, yai);
+	fprintf (stderr," %8.1f -> %10.1f  %d -> %d    ",
+		 b, bai, r, rf);
+	(void)putc (13,stderr);
+	}
+    ev->kind = FS_KEPT;
+    return (ev->kind);
+}
+
+
+/* Add a star to the end of a band's list, making room for it.
+ * Return its index, or -1 if memory runs out */
+
+static int
+NewStar (sb)
+
+struct StarBand *sb;	/* Band being searched */
+{
+    int nstarmax = sb->nstarmax;
+
+    if (sb->nstars >= nstarmax) {
+	nstarmax = nstarmax * 2;
+	sb->xa= (double *) realloc(sb->xa, nstarmax*sizeof(double));
+	sb->ya= (double *) realloc(sb->ya, nstarmax*sizeof(double));
+	sb->ixa= (int *) realloc(sb->ixa, nstarmax*sizeof(int));
+	sb->iya= (int *) realloc(sb->iya, nstarmax*sizeof(int));
+	sb->ba= (double *) realloc(sb->ba, nstarmax*sizeof(double));
+	sb->pa= (int *) realloc(sb->pa, nstarmax*sizeof(int));
+	sb->nstarmax = nstarmax;
+	if (sb->xa == NULL || sb->ya == NULL || sb->ixa == NULL ||
+	    sb->iya == NULL || sb->ba == NULL || sb->pa == NULL) {
+	    sb->nstars = -1;
+	    return (-1);
+	    }
+	}
+    return (sb->nstars++);
+}
+
+
+/* Check band k, searched while the bands above it were, against the image
+ * as those bands left it and against their n stars.  A candidate which
+ * read a pixel that is now clamped differently, or which was skipped as
+ * near a star which a single band would not have had, is tested again;
+ * any other candidate keeps what it found, except that a star near one
+ * from the bands above is dropped, as a single band would have skipped
+ * it.  The band is then replaced by the result.
+ * Return 0, or -1 if memory runs out.
+ */
+
+static int
+CheckBand (band, k, ixprior, iyprior, nprior)
+
+struct StarBand *band;	/* Bands searched by FindBand() */
+int	k;		/* Band to check */
+int	*ixprior;	/* Stars of the bands above, rounded to pixels */
+int	*iyprior;
+int	nprior;		/* Number of stars in the bands above */
+{
+    struct StarBand *sb = band + k;
+    struct StarBand cb;
+    struct BandEvent *ev, redo;
+    int i, j, n, kind, changed;
+    int ndiff = 0;		/* Pixels clamped by one search, not both */
+    int ndiffmax = 0;
+    int *xdiff = NULL;
+    int *ydiff = NULL;
+
+    cb = *sb;
+    cb.logev = 0;
+    cb.nprior = nprior;
+    cb.ixprior = ixprior;
+    cb.iyprior = iyprior;
+    cb.xa = cb.ya = cb.ba = NULL;
+    cb.pa = cb.ixa = cb.iya = NULL;
+    cb.nhot = cb.nhotmax = 0;
+    cb.xhot = cb.yhot = cb.hotnext = cb.hotrow = NULL;
+    cb.hotll = cb.hotval = NULL;
+    cb.nev = cb.nevmax = 0;
+    cb.ev = NULL;
+    if (InitBand (&cb))
+	goto nomem;
+
+    for (i = 0, j = 0; i < sb->nev; i++) {
+	ev = sb->ev + i;
+	changed = ReadChanged (band, k, ev, xdiff, ydiff, ndiff);
+	if (!changed && ev->kind == FS_NEAR)
+	    changed = !NearStar (cb.ixa, cb.iya, cb.nstars, ev->sx, ev->sy) &&
+		      !NearStar (ixprior, iyprior, nprior, ev->sx, ev->sy);
+
+	/* Test the candidate again */
+	if (changed) {
+	    redo = *ev;
+	    if ((kind = SearchPixel (&cb, &redo)) < 0)
+		goto nomem;
+	    if ((kind == FS_HOT) != (ev->kind == FS_HOT)) {
+		if (ndiff >= ndiffmax) {
+		    ndiffmax = (ndiffmax > 0) ? 2*ndiffmax : 16;
+		    xdiff = (int *) realloc (xdiff, ndiffmax * sizeof (int));
+		    ydiff = (int *) realloc (ydiff, ndiffmax * sizeof (int));
+		    if (xdiff == NULL || ydiff == NULL)
+			goto nomem;
 		    }
-		/* else {
-		    fprintf (stderr," %d: (%d %d) %d > %d\n",
-			     nstars, sx, sy, r, maxrad);
-		    } */
+		xdiff[ndiff] = ev->x;
+		ydiff[ndiff] = ev->y;
+		ndiff++;
 		}
 	    }
+
+	/* Keep what the band found */
+	else if (ev->kind == FS_HOT) {
+	    if (SaveHot (&cb, ev->x, ev->y, ev->minll) < 0)
+		goto nomem;
+	    }
+	else if (ev->kind == FS_KEPT &&
+		 !NearStar (cb.ixa, cb.iya, cb.nstars, ev->sx, ev->sy) &&
+		 !NearStar (ixprior, iyprior, nprior, ev->sx, ev->sy)) {
+	    if ((n = NewStar (&cb)) < 0)
+		goto nomem;
+	    cb.xa[n] = sb->xa[j];
+	    cb.ya[n] = sb->ya[j];
+	    cb.ba[n] = sb->ba[j];
+	    cb.pa[n] = sb->pa[j];
+	    cb.ixa[n] = sb->ixa[j];
+	    cb.iya[n] = sb->iya[j];
+	    }
+	if (ev->kind == FS_KEPT)
+	    j++;
 	}
 
-    /* Turn fluxes into instrument magnitudes */
-    (void) FluxSortStars (*xa, *ya, *ba, *pa, nstars);
-    if (nstars > 0) {
-	double *flux;
-	for (i = 0; i < nstars; i++) {
-	    flux = (*ba)+i;
-	    *flux = -2.5 * log10 (*flux);
+    if (xdiff != NULL) free ((char *)xdiff);
+    if (ydiff != NULL) free ((char *)ydiff);
+    ClearBand (sb);
+    *sb = cb;
+    return (0);
+
+nomem:
+    if (xdiff != NULL) free ((char *)xdiff);
+    if (ydiff != NULL) free ((char *)ydiff);
+    ClearBand (&cb);
+    return (-1);
+}
+
+
+/* Return 1 if a pixel read by candidate ev of band k has a different value
+ * in the image as the bands above left it than it had in the band's view,
+ * else 0.  The n pixels x, y were clamped by the band's search and not by
+ * CheckBand(), or the other way around.
+ */
+
+static int
+ReadChanged (band, k, ev, x, y, n)
+
+struct StarBand *band;	/* Bands searched by FindBand() */
+int	k;		/* Band being checked */
+struct BandEvent *ev;	/* Candidate, with the pixels it read */
+int	*x, *y;		/* Pixels clamped in only one view */
+int	n;		/* Number of such pixels */
+{
+    int i, j, row;
+
+    for (i = 0; i < n; i++) {
+	if (x[i] >= ev->x1 && x[i] <= ev->x2 &&
+	    y[i] >= ev->y1 && y[i] <= ev->y2)
+	    return (1);
+	}
+
+    /* Hot pixels clamped by the bands above, each in its own rows */
+    for (row = ev->y1; row <= ev->y2 && row < band[k].y1; row++) {
+	for (j = 0; j < k; j++) {
+	    if (row >= band[j].y1 && row < band[j].y2)
+		break;
+	    }
+	if (j == k)
+	    continue;
+	for (i = band[j].hotrow[row]; i >= 0; i = band[j].hotnext[i]) {
+	    if (band[j].xhot[i] >= ev->x1 && band[j].xhot[i] <= ev->x2)
+		return (1);
 	    }
 	}
+    return (0);
+}
 
-    free ((char *)svec);
-    return (nstars);
+
+/* Free the arrays of a band searched by FindBand() so it can be searched
+ * again */
+
+static void
+ClearBand (sb)
+
+struct StarBand *sb;	/* Band searched by FindBand() */
+{
+    if (sb->xa != NULL) free ((char *)sb->xa);
+    if (sb->ya != NULL) free ((char *)sb->ya);
+    if (sb->ba != NULL) free ((char *)sb->ba);
+    if (sb->pa != NULL) free ((char *)sb->pa);
+    if (sb->ixa != NULL) free ((char *)sb->ixa);
+    if (sb->iya != NULL) free ((char *)sb->iya);
+    if (sb->xhot != NULL) free ((char *)sb->xhot);
+    if (sb->yhot != NULL) free ((char *)sb->yhot);
+    if (sb->hotll != NULL) free ((char *)sb->hotll);
+    if (sb->hotval != NULL) free ((char *)sb->hotval);
+    if (sb->hotnext != NULL) free ((char *)sb->hotnext);
+    if (sb->hotrow != NULL) free ((char *)sb->hotrow);
+    if (sb->ev != NULL) free ((char *)sb->ev);
+    sb->xa = NULL;
+    sb->ya = NULL;
+    sb->ba = NULL;
+    sb->pa = NULL;
+    sb->ixa = NULL;
+    sb->iya = NULL;
+    sb->xhot = NULL;
+    sb->yhot = NULL;
+    sb->hotll = NULL;
+    sb->hotval = NULL;
+    sb->hotnext = NULL;
+    sb->hotrow = NULL;
+    sb->ev = NULL;
+    sb->nstars = 0;
+    sb->nstarmax = 0;
+    sb->nhot = 0;
+    sb->nhotmax = 0;
+    sb->nev = 0;
+    sb->nevmax = 0;
+    return;
+}
+
+
+/* Free the bands searched by FindBand() */
+
+static void
+FreeBand (band, nband)
+
+struct StarBand *band;	/* Bands searched by FindBand() */
+int	nband;		/* Number of bands */
+{
+    struct StarBand *sb;
+
+    for (sb = band; sb < band + nband; sb++)
+	ClearBand (sb);
+    free ((char *)band);
+    return;
+}
+
+
+/* Save a hot pixel clamped by a band, with the value the image returns
+ * once it has been clamped, so bandrow() can return it before it is.
+ * Return 0, or -1 if memory runs out.
+ */
+
+static int
+SaveHot (sb, x, y, llimit)
+
+struct StarBand *sb;	/* Band being searched */
+int	x, y;		/* Hot pixel */
+double	llimit;		/* Level to which it is clamped */
+{
+    double pix[1];
+    int n;
+
+    if (sb->nhot >= sb->nhotmax) {
+	sb->nhotmax = (sb->nhotmax > 0) ? 2*sb->nhotmax : 64;
+	sb->xhot = (int *) realloc (sb->xhot, sb->nhotmax * sizeof (int));
+	sb->yhot = (int *) realloc (sb->yhot, sb->nhotmax * sizeof (int));
+	sb->hotll = (double *) realloc (sb->hotll,
+					sb->nhotmax * sizeof (double));
+	sb->hotval = (double *) realloc (sb->hotval,
+					 sb->nhotmax * sizeof (double));
+	sb->hotnext = (int *) realloc (sb->hotnext,
+				       sb->nhotmax * sizeof (int));
+	if (sb->xhot == NULL || sb->yhot == NULL || sb->hotll == NULL ||
+	    sb->hotval == NULL || sb->hotnext == NULL)
+	    return (-1);
+	}
+    n = sb->nhot++;
+    sb->xhot[n] = x;
+    sb->yhot[n] = y;
+    sb->hotll[n] = llimit;
+
+    /* Round trip through a one pixel image of the same type */
+    putpix ((char *)pix, sb->bitpix, 1, 1, sb->bz, sb->bs, 0, 0, llimit);
+    sb->hotval[n] = getpix ((char *)pix, sb->bitpix, 1, 1, sb->bz, sb->bs,
+			    0, 0);
+
+    /* Hot pixels are found in row order, so the newest is last in its row */
+    sb->hotnext[n] = sb->hotrow[y];
+    sb->hotrow[y] = n;
+    return (0);
+}
+
+
+/* Read n pixels of row y, starting at column x, as the band sees them.
+ * While other bands are being searched, the hot pixels this band has
+ * clamped are returned at their clamped values.  The pixels read for each
+ * candidate are bounded for CheckBand().
+ */
+
+static void
+bandrow (sb, x, y, n, row)
+
+struct StarBand *sb;	/* Band being searched */
+int	x, y;		/* First pixel to read */
+int	n;		/* Number of pixels to read */
+double	*row;		/* Pixel values (returned) */
+{
+    int i;
+
+    getrow (sb->image, sb->bitpix, sb->w, sb->h, sb->bz, sb->bs, x, y, n, row);
+    if (x < sb->rx1)
+	sb->rx1 = x;
+    if (x + n - 1 > sb->rx2)
+	sb->rx2 = x + n - 1;
+    if (y < sb->ry1)
+	sb->ry1 = y;
+    if (y > sb->ry2)
+	sb->ry2 = y;
+    if (!sb->defer || y < 0 || y >= sb->h)
+	return;
+
+    for (i = sb->hotrow[y]; i >= 0; i = sb->hotnext[i]) {
+	if (sb->xhot[i] >= x && sb->xhot[i] < x + n)
+	    row[sb->xhot[i] - x] = sb->hotval[i];
+	}
+    return;
+}
+
+
+/* Read one pixel as the band sees it */
+
+static double
+bandpix (sb, x, y)
+
+struct StarBand *sb;	/* Band being searched */
+int	x, y;		/* Pixel to read */
+{
+    double dpix;
+
+    bandrow (sb, x, y, 1, &dpix);
+    return (dpix);
+}
+
+
+/* Return 1 if x, y is within minsep of one of n stars, else 0 */
+
+static int
+NearStar (ixa, iya, n, x, y)
+
+int	*ixa, *iya;	/* Star centroids rounded to pixels */
+int	n;		/* Number of stars */
+int	x, y;		/* Brightest pixel of a new star */
+{
+    int i, idx, idy;
+
+    for (i = 0; i < n; i++) {
+	idy = iya[i] - y;
+	if (idy < 0)
+	    idy = -idy;
+	if (idy <= minsep) {
+	    idx = ixa[i] - x;
+	    if (idx < 0)
+		idx = -idx;
+	    if (idx <= minsep)
+		return (1);
+	    }
+	}
+    return (0);
+}
+
+
+/* Read the 3x3 box of pixels centered on x, y into p[3*(dy+1) + dx+1],
+ * with 0 for pixels off the image as getpix() would return.
+ */
+
+static void
+getbox3 (sb, x, y, p)
+
+struct StarBand *sb;	/* Band being searched */
+int	x, y;		/* Center pixel */
+double	*p;		/* Pixel values (returned) */
+
+{
+    bandrow (sb, x-1, y-1, 3, p);
+    bandrow (sb, x-1, y, 3, p+3);
+    bandrow (sb, x-1, y+1, 3, p+6);
+    return;
 }
 
 
 /* Check pixel at x/y for being "hot", ie, a pixel surrounded by noise.
  * If any are greater than pixel at x/y then return -1.
- * Else set the pixel at x/y to llimit and return 0.
+ * Else return 0; the caller sets the pixel at x/y to llimit.
  */
 
 static int
-HotPixel (image, bitpix, w, h, bz, bs, x, y, llimit)
+HotPixel (sb, x, y, llimit)
 
-char	*image;		/* Image array origin pointer */
-int	bitpix;		/* Bits per pixel, negative for floating point or unsigned int */
-int	w;		/* Image width in pixels */
-int	h;		/* Image height in pixels */
-double	bz;		/* Zero point for pixel scaling */
-double	bs;		/* Scale factor for pixel scaling */
+struct StarBand *sb;	/* Band being searched */
 int	x, y;
 double	llimit;
 
 {
-    double pix1, pix2, pix3;
-
-    /* Check for hot row */
-    pix1 = getpix (image,bitpix,w,h,bz,bs,x-1,y-1);
-    pix2 = getpix (image,bitpix,w,h,bz,bs,x,y-1);
-    pix3 = getpix (image,bitpix,w,h,bz,bs,x+1,y-1);
-    if (pix1 > llimit || pix2 > llimit || pix3 > llimit)
-	return (-1);
-    pix1 = getpix (image,bitpix,w,h,bz,bs,x-1,y+1);
-    pix2 = getpix (image,bitpix,w,h,bz,bs,x,y+1);
-    pix3 = getpix (image,bitpix,w,h,bz,bs,x+1,y+1);
-    if (pix1 > llimit || pix2 > llimit || pix3 > llimit)
-	return (-1);
-
-    /* Check for hot column */
-    pix1 = getpix (image,bitpix,w,h,bz,bs,x-1,y-1);
-    pix2 = getpix (image,bitpix,w,h,bz,bs,x-1,y);
-    pix3 = getpix (image,bitpix,w,h,bz,bs,x-1,y+1);
-    if (pix1 > llimit || pix2 > llimit || pix3 > llimit)
-	return (-1);
-    pix1 = getpix (image,bitpix,w,h,bz,bs,x+1,y-1);
-    pix2 = getpix (image,bitpix,w,h,bz,bs,x+1,y);
-    pix3 = getpix (image,bitpix,w,h,bz,bs,x+1,y+1);
-    if (pix1 > llimit || pix2 > llimit || pix3 > llimit)
-	return (-1);
+    double p[9];
+    int i;
 
-    /* Check for hot pixel */
-    pix1 = getpix (image,bitpix,w,h,bz,bs,x-1,y);
-    pix3 = getpix (image,bitpix,w,h,bz,bs,x+1,y);
-    if (pix1 > llimit || pix3 > llimit)
-	return (-1);
-    pix1 = getpix (image,bitpix,w,h,bz,bs,x,y-1);
-    pix3 = getpix (image,bitpix,w,h,bz,bs,x,y+1);
-    if (pix1 > llimit || pix3 > llimit)
-	return (-1);
+    /* Check the pixels in the rows and columns on either side */
+    getbox3 (sb, x, y, p);
+    for (i = 0; i < 9; i++) {
+	if (i != 4 && p[i] > llimit)
+	    return (-1);
+	}
 
-    putpix (image, bitpix, w, h, bz, bs, x, y, llimit);
     return (0);
 }
 
@@ -487,14 +1138,9 @@ double	llimit;
  */
 
 static int
-starRadius (imp, bitpix, w, h, bz, bs, x0, y0, rmax, minsig, background)
+starRadius (sb, x0, y0, rmax, minsig, background)
 
-char	*imp;		/* Image array origin pointer */
-int	bitpix;		/* Bits per pixel, negative for floating point or unsigned int */
-int	w;		/* Image width in pixels */
-int	h;		/* Image height in pixels */
-double	bz;		/* Zero point for pixel scaling */
-double	bs;		/* Scale factor for pixel scaling */
+struct StarBand *sb;	/* Band being searched */
 int	x0, y0;		/* Coordinates of center pixel of star */
 double	rmax;		/* Maximum allowable radius of star */
 double	minsig;		/* Minimum level for signal */
@@ -502,11 +1148,14 @@ double	background;	/* Mean background level */
 
 {
     int r, irmax;
-    double dp, sum, mean;
+    double sum, mean, *row;
     int xyrr, yrr, np;
     int inrr, outrr;
     int x, y;
     irmax = (int) rmax;
+    row = (double *) malloc ((2*irmax + 3) * sizeof (double));
+    if (row == NULL)
+	return (irmax + 1);
 
     /* Compute star's radius.
      * Scan in ever-greater circles until find one such that the mean at
@@ -520,11 +1169,11 @@ double	background;	/* Mean background level */
 
 	for (y = -r; y <= r; y++) { 
 	    yrr = y*y;
+	    bandrow (sb, x0-r, y0+y, 2*r+1, row);
 	    for (x = -r; x <= r; x++) {
 		xyrr = x*x + yrr;
 		if (xyrr >= inrr && xyrr < outrr) {
-		    dp = getpix (imp,bitpix,w,h,bz,bs,x0+x,y0+y);
-		    sum += dp;
+		    sum += row[x+r];
 		    np++;
 		    }
 		}
@@ -535,40 +1184,37 @@ double	background;	/* Mean background level */
 	    break;
 	}
 
+    free (row);
     return (r);
 }
 
 /* Compute the fine location of the star peaking at [x0,y0] */
 
 static void
-starCentroid (imp, bitpix, w, h, bz, bs, x0, y0, xp, yp)
+starCentroid (sb, x0, y0, xp, yp)
 
-char	*imp;
-int	bitpix;
-int	w;
-int	h;
-double	bz;		/* Zero point for pixel scaling */
-double	bs;		/* Scale factor for pixel scaling */
+struct StarBand *sb;	/* Band being searched */
 int	x0, y0;
 double	*xp, *yp;
 
 {
-    double p1, p2, p22, p3, d;
+    double p1, p2, p22, p3, d, p[9];
 
     /* Find maximum of best-fit parabola in each direction.
      * see Bevington, page 210
      */
 
-    p1 = getpix (imp,bitpix,w,h,bz,bs,x0-1,y0);
-    p2 = getpix (imp,bitpix,w,h,bz,bs,x0,y0);
+    getbox3 (sb, x0, y0, p);
+    p1 = p[3];
+    p2 = p[4];
     p22 = 2*p2;
-    p3 = getpix (imp,bitpix,w,h,bz,bs,x0+1,y0);
+    p3 = p[5];
     d = p3 - p22 + p1;
     *xp = (d == 0) ? x0 : x0 + 0.5 - (p3 - p2)/d;
     *xp = *xp + 1.0;
 
-    p1 = getpix (imp,bitpix,w,h,bz,bs,x0,y0-1);
-    p3 = getpix (imp,bitpix,w,h,bz,bs,x0,y0+1);
+    p1 = p[1];
+    p3 = p[7];
     d = p3 - p22 + p1;
     *yp = (d == 0) ? y0 : y0 + 0.5 - (p3 - p2)/d;
     *yp = *yp + 1.0;
@@ -583,14 +1229,9 @@ static int dx[8]={1,0,-1,1,-1,1,0,-1};
 static int dy[8]={1,1,1,0,0,-1,-1,-1};
 
 static int
-BrightWalk (image, bitpix, w, h, bz, bs, x0, y0, maxr, xp, yp, bp)
+BrightWalk (sb, x0, y0, maxr, xp, yp, bp)
 
-char	*image;
-int	bitpix;
-int	w;
-int	h;
-double	bz;		/* Zero point for pixel scaling */
-double	bs;		/* Scale factor for pixel scaling */
+struct StarBand *sb;	/* Band being searched */
 int	x0;
 int	y0;
 int	maxr;
@@ -600,11 +1241,11 @@ double	*bp;
 
 {
 
-    double b, tmpb, newb;
+    double b, tmpb, newb, p[9];
     int x, y, x1, y1, i, xa, ya;
 
     /* start by assuming seed point is brightest */
-    b = getpix (image,bitpix,w,h,bz,bs, x0,y0);
+    b = bandpix (sb, x0, y0);
     x = x0;
     y = y0;
     xa = x0;
@@ -617,10 +1258,11 @@ double	*bp;
 
 	/* Find brightest pixel in 3x3 region */
 	newb = b;
+	getbox3 (sb, x, y, p);
 	for (i = 0; i < 8; i++) {
 	    x1 = x + dx[i];
 	    y1 = y + dy[i];
-	    tmpb = getpix (image,bitpix,w,h,bz,bs, x1, y1);
+	    tmpb = p[3*(dy[i]+1) + dx[i]+1];
 	    if (tmpb >= newb) {
 		if (x1 == xa && y1 == ya)
 		    break;
@@ -669,10 +1311,10 @@ double	*mean;
 double	*sigma;
 
 {
-    double p, pmin, pmax;
+    double p, pmin, pmax, *pix;
     double pmean = 0.0;
     double sd = 0.0;
-    int x, y;
+    int x, y, nx, ny;
     int i;
     double sum;
     double dnpix;
@@ -681,6 +1323,22 @@ double	*sigma;
     pmin = -1.0e20;
     pmax = 1.0e20;
 
+    /* Read the region once, a row at a time */
+    nx = x2 - x1;
+    if (nx < 0)
+	nx = 0;
+    ny = y2 - y1;
+    if (ny < 0)
+	ny = 0;
+    pix = (double *) malloc ((nx * ny + 1) * sizeof (double));
+    if (pix == NULL) {
+	*mean = pmean;
+	*sigma = sd;
+	return;
+	}
+    for (y = y1; y < y2; y++)
+	getrow (image,bitpix,w,h,bz,bs, x1, y, nx, pix + (y-y1)*nx);
+
     for (i = 0; i < niterate; i++ ) {
 	sum = 0.0;
 	npix = 0;
@@ -689,7 +1347,7 @@ double	*sigma;
 	if (i == 0) {
 	    for (y = y1; y < y2; y++) {
 		for (x = x1; x < x2; x++) {
-		    p = getpix (image,bitpix,w,h,bz,bs, x, y);
+		    p = pix[(y-y1)*nx + x-x1];
 		    sum += p;
 		    npix++;
 		    }
@@ -698,7 +1356,7 @@ double	*sigma;
 	else {
 	    for (y = y1; y < y2; y++) {
 		for (x = x1; x < x2; x++) {
-		    p = getpix (image,bitpix,w,h,bz,bs, x, y);
+		    p = pix[(y-y1)*nx + x-x1];
 		    if (p > pmin && p < pmax) {
 			sum += p;
 			npix++;
@@ -714,7 +1372,7 @@ double	*sigma;
 	sum = 0.0;
 	for (y = y1; y < y2; y++) {
 	    for (x = x1; x < x2; x++) {
-		p = getpix (image,bitpix,w,h,bz,bs, x, y);
+		p = pix[(y-y1)*nx + x-x1];
 		if (p > pmin && p < pmax) {
 		    sum += fabs (p - pmean);
 		    npix++;
@@ -731,6 +1389,7 @@ double	*sigma;
 	pmax = pmean + sd * starsig;
 	}
 
+    free (pix);
     *mean = pmean;
     *sigma = sd;
     return;
@@ -802,14 +1461,9 @@ double *sigma;		/* Average deviation of pixels (returned) */
 /* Find total flux within a circular region minus a mean background level */
 
 static double
-FindFlux (image, bitpix, w, h, bz, bs, x0, y0, r, background, zap)
+FindFlux (sb, x0, y0, r, background, zap)
 
-char	*image;
-int	bitpix;
-int	w;
-int	h;
-double	bz;		/* Zero point for pixel scaling */
-double	bs;		/* Scale factor for pixel scaling */
+struct StarBand *sb;	/* Band being searched */
 int	x0;
 int	y0;
 int	r;
@@ -817,6 +1471,8 @@ double	background;	/* Background level (subtracted for flux) */
 int	zap;		/* If 1, set star to background after reading */
 {
     double sum = 0.0;
+    int w = sb->w;
+    int h = sb->h;
     int x, y, x1, x2, y1, y2, yy, xxyy, xi, yi;
     int rr = r * r;
     double dp;
@@ -837,6 +1493,12 @@ int	zap;		/* If 1, set star to background after reading */
     if (y0+r > 0)
 	y2 = h;
 
+/* Nothing beyond the radius falls within the circle */
+    if (x2 > r)
+	x2 = r;
+    if (y2 > r)
+	y2 = r;
+
 /* Integrate circular region around a star */
     for (y = y1; y <= y2; y++) { 
 	yy = y*y;
@@ -845,11 +1507,12 @@ int	zap;		/* If 1, set star to background after reading */
 	    if (xxyy <= rr) {
 		xi = x0 + x;
 		yi = y0 + x;
-		dp = getpix (image, bitpix, w,h,bz,bs, xi, yi);
+		dp = bandpix (sb, xi, yi);
 		if (dp > background) {
 		    sum += dp - background;
 		    if (zap)
-		        putpix (image, bitpix, w,h,bz,bs, xi, yi,background);
+		        putpix (sb->image, sb->bitpix, w, h, sb->bz, sb->bs,
+				xi, yi, background);
 		    }
 		}
 	    }
@@ -911,6 +1574,8 @@ char *parstring;
 	setnxydec ((int) atof (parvalue));
     else if (!strcmp (parname, "rnoise"))
 	setrnoise ((int) atof (parvalue));
+    else if (!strcmp (parname, "nthread"))
+	setfsthread ((int) atof (parvalue));
     return;
 }
 
@@ -1092,4 +1757,12 @@ int	h;	/* Original height of image */
  * Jan  8 2007	Drop unused variables
  * Jan 10 2007	Include wcs.h
  * Oct 19 2007	Fix pointers in trim section processing
+ *
+ * Oct 19 2026	Search bands of rows in separate threads if _REENTRANT
+ * Oct 19 2026	Add setfsthread() and nthread to setparm() to set thread count
+ * Oct 19 2026	Stop FindFlux() loops at the radius instead of the image edge
+ * Oct 19 2026	Read rows with getrow() in starRadius() and mean2d()
+ * Oct 19 2026	Read 3x3 boxes with getbox3() in HotPixel(), BrightWalk(), etc.
+ * Oct 19 2026	Check bands against the bands above with CheckBand() so the
+ *		stars found do not depend on the number of bands
  */
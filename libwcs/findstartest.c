@@ -0,0 +1,154 @@
+/* File findstartest.c
+ * Check that FindStars() finds the same stars, and clamps the same hot
+ * pixels, whether the rows are searched in one band or in several.
+ *
+ * Synthetic frames of stars and hot pixels on a noisy background are
+ * searched once with one band and once with NBAND bands, and the star
+ * lists and the clamped images must be identical.  Build the library
+ * with "make REENTRANT=-D_REENTRANT", then "make findstartest"; without
+ * threads both searches use one band and the test proves nothing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "fitsfile.h"
+#include "lwcs.h"
+
+#define NX	2000
+#define NY	2000
+#define NSTAR	3000
+#define NHOT	20000
+#define NSEED	6
+#define NBAND	8
+
+extern int FindStars();
+extern void setfsthread();
+
+static unsigned int seed;
+
+static double
+urand ()
+{
+    seed = seed * 1103515245 + 12345;
+    return ((double) ((seed >> 8) & 0xffffff) / 16777216.0);
+}
+
+/* Fill a 16-bit image with noise, Gaussian stars and single hot pixels */
+
+static void
+makeimage (image)
+
+short	*image;
+{
+    int i, x, y, x0, y0;
+    double xc, yc, peak, dx, dy, v;
+
+    for (i = 0; i < NX * NY; i++)
+	image[i] = (short) (1000.0 + 20.0 * (urand() + urand() + urand() - 1.5));
+
+    for (i = 0; i < NSTAR; i++) {
+	xc = 20.0 + urand() * (NX - 40);
+	yc = 20.0 + urand() * (NY - 40);
+	peak = 200.0 + urand() * 20000.0;
+	x0 = (int) xc;
+	y0 = (int) yc;
+	for (y = y0 - 6; y <= y0 + 6; y++) {
+	    for (x = x0 - 6; x <= x0 + 6; x++) {
+		dx = x - xc;
+		dy = y - yc;
+		v = image[y*NX + x] + peak * exp (-(dx*dx + dy*dy) / 4.5);
+		image[y*NX + x] = (short) (v > 32767.0 ? 32767.0 : v);
+		}
+	    }
+	}
+
+    for (i = 0; i < NHOT; i++) {
+	x = 1 + (int) (urand() * (NX - 2));
+	y = 1 + (int) (urand() * (NY - 2));
+	image[y*NX + x] = (short) (3000.0 + urand() * 20000.0);
+	}
+    return;
+}
+
+static int
+search (header, image, nband, xa, ya, ba, pa)
+
+char	*header;
+short	*image;
+int	nband;
+double	**xa, **ya, **ba;
+int	**pa;
+{
+    setfsthread (nband);
+    return (FindStars (header, (char *) image, xa, ya, ba, pa, 0, 0));
+}
+
+int
+main ()
+{
+    char *header;
+    short *image, *image1, *imagen;
+    double *xa1, *ya1, *ba1, *xan, *yan, *ban;
+    int *pa1, *pan;
+    int iseed, i, ns1, nsn, nbad = 0;
+
+    header = (char *) malloc (2881);
+    memset (header, ' ', 2880);
+    header[2880] = (char) 0;
+    memcpy (header, "END", 3);
+    hlength (header, 2880);
+    hputl (header, "SIMPLE", 1);
+    hputi4 (header, "BITPIX", 16);
+    hputi4 (header, "NAXIS", 2);
+    hputi4 (header, "NAXIS1", NX);
+    hputi4 (header, "NAXIS2", NY);
+
+    image = (short *) malloc (NX * NY * sizeof (short));
+    image1 = (short *) malloc (NX * NY * sizeof (short));
+    imagen = (short *) malloc (NX * NY * sizeof (short));
+
+    for (iseed = 1; iseed <= NSEED; iseed++) {
+	seed = iseed * 7919;
+	makeimage (image);
+	memcpy (image1, image, NX * NY * sizeof (short));
+	memcpy (imagen, image, NX * NY * sizeof (short));
+
+	ns1 = search (header, image1, 1, &xa1, &ya1, &ba1, &pa1);
+	nsn = search (header, imagen, NBAND, &xan, &yan, &ban, &pan);
+
+	if (ns1 != nsn)
+	    i = -1;
+	else {
+	    for (i = 0; i < ns1; i++) {
+		if (xa1[i] != xan[i] || ya1[i] != yan[i] ||
+		    ba1[i] != ban[i] || pa1[i] != pan[i])
+		    break;
+		}
+	    }
+	if (i < ns1 || memcmp (image1, imagen, NX * NY * sizeof (short))) {
+	    printf ("seed %d: %d stars in 1 band, %d in %d bands: FAILED\n",
+		    iseed, ns1, nsn, NBAND);
+	    nbad++;
+	    }
+	else
+	    printf ("seed %d: %d stars in 1 and %d bands\n",
+		    iseed, ns1, NBAND);
+
+	free (xa1); free (ya1); free (ba1); free (pa1);
+	free (xan); free (yan); free (ban); free (pan);
+	}
+
+    free (image);
+    free (image1);
+    free (imagen);
+    free (header);
+
+    if (nbad) {
+	printf ("findstartest FAILED\n");
+	return (1);
+	}
+    printf ("findstartest passed\n");
+    return (0);
+}
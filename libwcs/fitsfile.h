@@ -346,6 +346,17 @@ float ftgetr4(		/* Extract column for keyword from FITS table line
 	int pix1,	/* Offset of first pixel to extract */
 	int npix,	/* Number of pixels to extract */
 	double *dvec0);	/* Vector of pixels (returned) */
+    void getrow(	/* Read pixels from one row of 2-D array (0,0) */
+	char *image,	/* Image array as 1-D vector */
+	int bitpix,	/* FITS bits per pixel */
+	int w,		/* Image width in pixels */
+	int h,		/* Image height in pixels */
+	double bzero,	/* Zero point for pixel scaling */
+	double bscale,	/* Scale factor for pixel scaling */
+	int x,		/* Zero-based horizontal number of first pixel */
+	int y,		/* Zero-based vertical pixel number */
+	int npix,	/* Number of pixels to read */
+	double *dvec);	/* Vector of pixels, 0 off image (returned) */
     void putvec(	/* Write vector into 2-D array */
 	char *image,	/* Image array as 1-D vector */
 	int bitpix,	/* FITS bits per pixel */
@@ -1008,6 +1019,7 @@ extern void movepix1();	/* Move one pixel value between two 2-D arrays (1,1) */
 extern void addvec();	/* Add constant to vector from 2-D array */
 extern void multvec();	/* Multiply vector from 2-D array by a constant */
 extern void getvec();	/* Read vector from 2-D array */
+extern void getrow();	/* Read pixels from one row of 2-D array (0,0) */
 extern void putvec();	/* Write vector into 2-D array */
 extern void fillvec();   /* Write constant into a vector */
 extern void fillvec1();   /* Write constant into a vector */
@@ -1283,4 +1295,6 @@ void compnut();	/* Compute nutation in longitude and obliquity and mean obliquit
  * Sep  8 2008	Add ag2hr(), ang2deg(), deg2ang(), and hr2ang()
  *
  * Sep 25 2009	Add moveb()
+ *
+ * Oct 19 2026	Add getrow() to read part of an image row in imio.c
  */
@@ -115,6 +115,12 @@ extern "C" {
     char *blsearch (
 	const char* hstring,	/* FITS header string */
 	const char* keyword);	/* FITS keyword */
+    int hindex(			/* Build keyword index for FITS header */
+	const char* hstring);	/* FITS header string */
+    void hunindex(		/* Drop keyword index before changing or freeing header */
+	const char* hstring);	/* FITS header string */
+    int hindexed(		/* Return 1 if FITS header has keyword index */
+	const char* hstring);	/* FITS header string */
 
     char *strsrch (		/* Find string s2 within string s1 */
 	const char* s1,		/* String to search */
@@ -319,6 +325,11 @@ extern char *ksearch();
 /* Find beginning of fillable blank line before FITS header keyword */
 extern char *blsearch();
 
+/* Build or drop hash index used by ksearch() for a long header */
+extern int hindex();
+extern void hunindex();
+extern int hindexed();
+
 /* Search for substring s2 within string s1 */
 extern char *strsrch ();	/* s1 null-terminated */
 extern char *strnsrch ();	/* s1 ls1 characters long */
@@ -46,6 +46,9 @@
  * Subroutine:	blsearch (hstring,keyword) returns pointer to blank lines
 		before keyword
  * Subroutine:	ksearch (hstring,keyword) returns pointer to header string entry
+ * Subroutine:	hindex (hstring) builds a keyword index used by ksearch()
+ * Subroutine:	hunindex (hstring) drops the keyword index for a header
+ * Subroutine:	hindexed (hstring) returns 1 if a header has a keyword index
  * Subroutine:	str2ra (in) converts string to right ascension in degrees
  * Subroutine:	str2dec (in) converts string to declination in degrees
  * Subroutine:	strsrch (s1, s2) finds string s2 in null-terminated string s1
@@ -67,6 +70,9 @@
 #define INT_MAX  2147483647 /* Biggest number that can fit in long */
 #define SHRT_MAX 32767
 #endif
+#ifdef _REENTRANT
+#include <pthread.h>
+#endif
 #define VLENGTH 81
 
 #ifdef USE_SAOLIB
@@ -1062,6 +1068,312 @@ const char *keyword0;	/* character string containing the name of the keyword
 }
 
 
+/* Keyword index, so that ksearch() finds a keyword in a long header without
+   scanning every card.  An index is built by hindex() for one header string
+   and stays valid until that header is changed; hput.c drops it by calling
+   hunindex() whenever it edits a header.  An index knows its header only by
+   address, so hunindex() must also be called before an indexed header is
+   freed or reallocated, or a new header at the same address would be
+   searched with the old index.  The table of indexes is shared by all
+   threads, so if _REENTRANT it is only used with hindexlock held. */
+
+#define MAXHINDEX 8	/* Maximum number of headers indexed at once */
+
+struct HIndex {
+    const char *header;	/* Indexed header, NULL if this slot is unused */
+    int lhead;		/* Number of characters indexed */
+    int nhash;		/* Size of hash table (a power of 2) */
+    int *cards;		/* Offset of first card with each keyword, -1 if empty */
+};
+static struct HIndex hindexes[MAXHINDEX];
+
+#ifdef _REENTRANT
+static pthread_mutex_t hindexlock = PTHREAD_MUTEX_INITIALIZER;
+#define HINDEXLOCK	pthread_mutex_lock (&hindexlock)
+#define HINDEXUNLOCK	pthread_mutex_unlock (&hindexlock)
+#else
+#define HINDEXLOCK
+#define HINDEXUNLOCK
+#endif
+
+
+/* Return pointer to keyword at start of card and its length, as ksearch()
+   would match it, or NULL if the card does not start with a keyword */
+
+static const char *
+hcardkey (card, lcard, lkey)
+
+const char *card;	/* Start of 80-character header card */
+int	lcard;		/* Number of characters in card */
+int	*lkey;		/* Length of keyword (returned) */
+{
+    int icol, iend, c;
+
+    /* Keyword may be preceded by blanks, but must start in first 8 columns */
+    for (icol = 0; icol < 8 && icol < lcard && card[icol] == ' '; icol++);
+    if (icol > 7 || icol >= lcard)
+	return (NULL);
+
+    /* Keyword ends at an equal sign, blank, or nonprinting character */
+    for (iend = icol; iend < lcard; iend++) {
+	c = (int) card[iend];
+	if (c == 61 || c <= 32 || c >= 127)
+	    break;
+	}
+    *lkey = iend - icol;
+    if (*lkey == 0)
+	return (NULL);
+    return (card + icol);
+}
+
+
+/* Hash a keyword, ignoring case */
+
+static unsigned int
+hkeyhash (keyword, lkey)
+
+const char *keyword;	/* Keyword, not necessarily null-terminated */
+int	lkey;		/* Length of keyword */
+{
+    unsigned int hash = 2166136261U;
+    int i, c;
+
+    for (i = 0; i < lkey; i++) {
+	c = (int) keyword[i];
+	if (c > 96 && c < 123)
+	    c = c - 32;
+	hash = (hash ^ (unsigned int) (c & 255)) * 16777619U;
+	}
+    return (hash);
+}
+
+
+/* Return 1 if two keywords of the same length match, ignoring case */
+
+static int
+hkeymatch (key1, key2, lkey)
+
+const char *key1;	/* First keyword */
+const char *key2;	/* Second keyword */
+int	lkey;		/* Length of both keywords */
+{
+    int i, c1, c2;
+
+    for (i = 0; i < lkey; i++) {
+	c1 = (int) key1[i];
+	c2 = (int) key2[i];
+	if (c1 > 96 && c1 < 123)
+	    c1 = c1 - 32;
+	if (c2 > 96 && c2 < 123)
+	    c2 = c2 - 32;
+	if (c1 != c2)
+	    return (0);
+	}
+    return (1);
+}
+
+
+/* Drop keyword index for the FITS header containing this address, with
+   hindexlock held */
+
+static void
+hdrop (hstring)
+
+const char *hstring;	/* FITS header string, or a card within it */
+{
+    int ihx;
+
+    for (ihx = 0; ihx < MAXHINDEX; ihx++) {
+	if (hindexes[ihx].header != NULL &&
+	    hstring >= hindexes[ihx].header &&
+	    hstring <= hindexes[ihx].header + hindexes[ihx].lhead) {
+	    free (hindexes[ihx].cards);
+	    hindexes[ihx].cards = NULL;
+	    hindexes[ihx].header = NULL;
+	    }
+	}
+    return;
+}
+
+
+/* Build keyword index for FITS header string, returning number of keywords,
+   or 0 if the header could not be indexed and will be searched card by card */
+
+int
+hindex (hstring)
+
+const char *hstring;	/* FITS header string */
+{
+    struct HIndex *hx;
+    const char *key, *ckey;
+    int lhead, lmax, ncards, nhash, *cards, ihx, icard, lcard, lkey, lckey;
+    int nkeys;
+    unsigned int ih;
+
+    /* Find current length of header string, as ksearch() does */
+    if (lhead0)
+	lmax = lhead0;
+    else
+	lmax = 256000;
+    for (lhead = 0; lhead < lmax; lhead++) {
+	if (hstring[lhead] == (char) 0)
+	    break;
+	}
+
+    /* Keep the hash table at most half full */
+    ncards = (lhead + 79) / 80;
+    nhash = 16;
+    while (nhash < 2 * ncards)
+	nhash = nhash * 2;
+    cards = (int *) malloc (nhash * sizeof (int));
+    if (cards == NULL)
+	return (0);
+    for (ih = 0; ih < (unsigned int) nhash; ih++)
+	cards[ih] = -1;
+
+    /* Enter the first card for each keyword, which is the one ksearch() finds */
+    nkeys = 0;
+    for (icard = 0; icard < lhead; icard = icard + 80) {
+	lcard = lhead - icard;
+	if (lcard > 80)
+	    lcard = 80;
+	key = hcardkey (hstring + icard, lcard, &lkey);
+	if (key == NULL)
+	    continue;
+	ih = hkeyhash (key, lkey) & (nhash - 1);
+	while (cards[ih] >= 0) {
+	    lcard = lhead - cards[ih];
+	    if (lcard > 80)
+		lcard = 80;
+	    ckey = hcardkey (hstring + cards[ih], lcard, &lckey);
+	    if (lckey == lkey && hkeymatch (ckey, key, lkey))
+		break;
+	    ih = (ih + 1) & (nhash - 1);
+	    }
+	if (cards[ih] < 0) {
+	    cards[ih] = icard;
+	    nkeys++;
+	    }
+	}
+
+    /* Reuse the slot of an old index for this header, or find an empty one */
+    HINDEXLOCK;
+    hdrop (hstring);
+    hx = NULL;
+    for (ihx = 0; ihx < MAXHINDEX; ihx++) {
+	if (hindexes[ihx].header == NULL) {
+	    hx = &hindexes[ihx];
+	    break;
+	    }
+	}
+    if (hx == NULL) {
+	HINDEXUNLOCK;
+	free (cards);
+	return (0);
+	}
+    hx->header = hstring;
+    hx->lhead = lhead;
+    hx->nhash = nhash;
+    hx->cards = cards;
+    HINDEXUNLOCK;
+    return (nkeys);
+}
+
+
+/* Drop keyword index for the FITS header containing this address.  Call it
+   whenever the header is changed and before it is freed or reallocated. */
+
+void
+hunindex (hstring)
+
+const char *hstring;	/* FITS header string, or a card within it */
+{
+    HINDEXLOCK;
+    hdrop (hstring);
+    HINDEXUNLOCK;
+    return;
+}
+
+
+/* Return 1 if a keyword index has been built for this FITS header, else 0 */
+
+int
+hindexed (hstring)
+
+const char *hstring;	/* FITS header string */
+{
+    int ihx, indexed;
+
+    indexed = 0;
+    HINDEXLOCK;
+    for (ihx = 0; ihx < MAXHINDEX; ihx++) {
+	if (hindexes[ihx].header == hstring) {
+	    indexed = 1;
+	    break;
+	    }
+	}
+    HINDEXUNLOCK;
+    return (indexed);
+}
+
+
+/* Look keyword up in the index for this header, returning 1 and setting
+   pval if the index answers the search, or 0 if the header must be scanned */
+
+static int
+hlookup (hstring, keyword, pval)
+
+const char *hstring;	/* FITS header string */
+const char *keyword;	/* Keyword to find */
+char	**pval;		/* Pointer to card, or NULL if not found (returned) */
+{
+    struct HIndex *hx;
+    const char *ckey;
+    int ihx, lkey, lckey, lcard, i, c;
+    unsigned int ih;
+
+    /* Only single keywords are indexed; others are left to the scan */
+    lkey = strlen (keyword);
+    if (lkey == 0)
+	return (0);
+    for (i = 0; i < lkey; i++) {
+	c = (int) keyword[i];
+	if (c == 61 || c <= 32 || c >= 127)
+	    return (0);
+	}
+
+    /* Hold the lock while the index is used so no thread can drop it */
+    HINDEXLOCK;
+    hx = NULL;
+    for (ihx = 0; ihx < MAXHINDEX; ihx++) {
+	if (hindexes[ihx].header == hstring) {
+	    hx = &hindexes[ihx];
+	    break;
+	    }
+	}
+    if (hx == NULL) {
+	HINDEXUNLOCK;
+	return (0);
+	}
+
+    *pval = NULL;
+    ih = hkeyhash (keyword, lkey) & (hx->nhash - 1);
+    while (hx->cards[ih] >= 0) {
+	lcard = hx->lhead - hx->cards[ih];
+	if (lcard > 80)
+	    lcard = 80;
+	ckey = hcardkey (hstring + hx->cards[ih], lcard, &lckey);
+	if (lckey == lkey && hkeymatch (ckey, keyword, lkey)) {
+	    *pval = (char *) hstring + hx->cards[ih];
+	    break;
+	    }
+	ih = (ih + 1) & (hx->nhash - 1);
+	}
+    HINDEXUNLOCK;
+    return (1);
+}
+
+
 /* Find beginning of fillable blank line before FITS header keyword line */
 
 char *
@@ -1192,6 +1504,10 @@ const char *keyword;	/* character string containing the name of the variable
 
     pval = 0;
 
+/* Use the keyword index if one has been built for this header */
+    if (hlookup (hstring, keyword, &pval))
+	return (pval);
+
 /* Find current length of header string */
     if (lhead0)
 	lmax = lhead0;
@@ -1895,4 +2211,8 @@ int	dropzero;	/* If nonzero, drop trailing zeroes */
  * Aug 22 2007	If closing quote not found, make one up
  *
  * Nov 12 2009	In strfix(), if drop enclosing parantheses
+ *
+ * Oct 19 2026	Add hindex() and hunindex() to search long headers by hash
+ * Oct 19 2026	Add hindexed() so callers know whether to drop an index
+ * Oct 19 2026	Guard the keyword index table with a lock if _REENTRANT
  */
@@ -406,6 +406,9 @@ const char *value; /* character string containing the value for variable
     char *vp, *v1, *v2, *q1, *q2, *c1, *ve;
     int lkeyword, lcom, lval, lc, lv1, lhead, lblank, ln, nc, i;
 
+    /* Any keyword index for this header will be out of date */
+    hunindex (hstring);
+
     /* Find length of keyword, value, and header */
     lkeyword = (int) strlen (keyword);
     lval = (int) strlen (value);
@@ -601,6 +604,9 @@ hputcom (hstring,keyword,comment)
     int lkeyword, lcom, lhead, i, lblank, ln, nc, lc;
     char *vp, *v1, *v2, *c0, *c1, *q1, *q2;
 
+    /* Any keyword index for this header will be out of date */
+    hunindex (hstring);
+
     squot = (char) 39;
     slash = (char) 47;
     space = (char) 32;
@@ -746,6 +752,9 @@ const char *keyword;	/* Keyword of entry to be deleted */
 {
     char *v, *v1, *v2, *ve;
 
+    /* Any keyword index for this header will be out of date */
+    hunindex (hstring);
+
     /* Search for keyword */
     v1 = ksearch (hstring,keyword);
 
@@ -799,6 +808,9 @@ const char *keyword;	/* Keyword of entry to be deleted */
     char *v, *v1, *v2, *ve;
     int i, lkey;
 
+    /* Any keyword index for this header will be out of date */
+    hunindex (hplace);
+
     /*  Find end of header */
     ve = ksearch (hplace,"END");
 
@@ -847,6 +859,9 @@ const char *keyword2;	/* New keyword name */
     const char *v2;
     int lv2, i;
 
+    /* Any keyword index for this header will be out of date */
+    hunindex (hstring);
+
     /* Search for keyword */
     v1 = ksearch (hstring,keyword1);
 
@@ -1308,4 +1323,6 @@ int	ndec;		/* Number of decimal places in degree string */
  * Jan 16 2007	Fix bugs in ra2str() and dec2str() so ndec=0 works
  * Aug 20 2007	Fix bug so comments after quoted keywords work
  * Aug 22 2007	If closing quote not found, make one up
+ *
+ * Oct 19 2026	Drop any keyword index with hunindex() when a header is changed
  */
@@ -0,0 +1,1055 @@
+/*** File libwcs/hpxread.c
+ *** October 19, 2026
+ *** Local reference catalogs indexed by HEALPix pixel
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ * hpxopen (hpxfile)	Open (memory map) HEALPix-indexed catalog file
+ * hpxclose (hc)	Close HEALPix-indexed catalog file
+ * hpxcone (hc,cra,cdec,drad,mag1,mag2,sortmag,stars) Find stars in a circle
+ * hpxbox (hc,cra,cdec,dra,ddec,mag1,mag2,sortmag,stars) Find stars in a box
+ * hpxalloc (nmax, nmag)	Allocate arrays for stars returned by a search
+ * hpxfree (stars)	Free arrays for stars returned by a search
+ * hpxwrite (hpxfile,nside,...)	Write HEALPix-indexed catalog from arrays
+ * hpxconvert (refcatname,hpxfile,nside,mag1,mag2,nlog) Convert a catalog
+ * hpxpix (nside, ra, dec)	Return HEALPix RING pixel for a position
+
+ * A catalog file holds a header, the index of the first star in each
+ * HEALPix pixel (RING scheme), and then one column at a time the numbers,
+ * positions, proper motions, magnitudes and types of all the stars, sorted
+ * by pixel.  Files are written in native byte order and mapped into memory
+ * when they are opened, so a search only touches the pixels that overlap
+ * it and no catalog file is read or reopened per query.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "fitsfile.h"
+#include "wcs.h"
+#include "wcscat.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+#define HPXMAGIC "WCSHPX01"
+#define HPXHEAD	128		/* Size of file header in bytes */
+#define HPXMAXSIDE 8192		/* Largest HEALPix resolution accepted */
+#define HPXCELLMAX 200000	/* Stars read from a catalog at a time */
+
+#define HPXPI	3.14159265358979323846
+
+/* File header, at the start of the file */
+struct HpxHead {
+    char magic[8];		/* HPXMAGIC */
+    int nside;			/* HEALPix resolution parameter */
+    int nmag;			/* Number of magnitudes per star */
+    int nstars;			/* Number of stars in catalog */
+    int sysref;			/* Catalog coordinate system */
+    double eqref;		/* Catalog equinox */
+    double epref;		/* Catalog epoch */
+    int catprop;		/* 1 if proper motions are present */
+    int pad;
+    char title[80];		/* Catalog description */
+};
+
+static int hpxringinfo();
+static int hpxsearch();
+static int hpxreadcell();
+static int hpxgrow();
+
+/* HPXPIX -- Return HEALPix RING scheme pixel containing a position */
+
+int
+hpxpix (nside, ra, dec)
+
+int	nside;		/* HEALPix resolution parameter */
+double	ra;		/* Right ascension in degrees */
+double	dec;		/* Declination in degrees */
+{
+    double z, za, tt, tp, tmp, temp1, temp2;
+    int jp, jm, ir, ip, kshift;
+
+    z = sin (degrad (dec));
+    za = fabs (z);
+    tt = fmod (ra, 360.0);
+    if (tt < 0.0)
+	tt = tt + 360.0;
+    tt = tt / 90.0;		/* in [0,4) */
+    if (tt >= 4.0)
+	tt = 0.0;
+
+    /* Equatorial region */
+    if (za <= 2.0 / 3.0) {
+	temp1 = nside * (0.5 + tt);
+	temp2 = nside * z * 0.75;
+	jp = (int) (temp1 - temp2);	/* index of ascending edge line */
+	jm = (int) (temp1 + temp2);	/* index of descending edge line */
+	ir = nside + 1 + jp - jm;	/* ring number counted from z=2/3 */
+	kshift = 1 - (ir & 1);
+	ip = (jp + jm - nside + kshift + 1) / 2;
+	ip = ip % (4 * nside);
+	if (ip < 0)
+	    ip = ip + 4 * nside;
+	return (2 * nside * (nside - 1) + (ir - 1) * 4 * nside + ip);
+	}
+
+    /* North and south polar caps */
+    else {
+	tp = tt - (int) tt;
+	tmp = nside * sqrt (3.0 * (1.0 - za));
+	jp = (int) (tp * tmp);
+	jm = (int) ((1.0 - tp) * tmp);
+	ir = jp + jm + 1;		/* ring number counted from closest pole */
+	ip = (int) (tt * ir);
+	ip = ip % (4 * ir);
+	if (z > 0.0)
+	    return (2 * ir * (ir - 1) + ip);
+	else
+	    return (12 * nside * nside - 2 * ir * (ir + 1) + ip);
+	}
+}
+
+
+/* Return the first pixel, number of pixels, z of the pixel centers and
+ * the phase of the first pixel center (in pixels) for a RING scheme ring */
+
+static int
+hpxringinfo (nside, iring, startpix, npring, z, shift)
+
+int	nside;		/* HEALPix resolution parameter */
+int	iring;		/* Ring number, 1 to 4*nside-1 from north pole */
+int	*startpix;	/* First pixel in ring (returned) */
+int	*npring;	/* Number of pixels in ring (returned) */
+double	*z;		/* Sine of declination of ring (returned) */
+double	*shift;		/* 0.5 if first pixel center is half a pixel from
+			   RA 0, else 0 (returned) */
+{
+    int nr;
+
+    if (iring < nside) {
+	*startpix = 2 * iring * (iring - 1);
+	*npring = 4 * iring;
+	*z = 1.0 - (double) iring * iring / (3.0 * nside * nside);
+	*shift = 0.5;
+	}
+    else if (iring <= 3 * nside) {
+	*startpix = 2 * nside * (nside - 1) + (iring - nside) * 4 * nside;
+	*npring = 4 * nside;
+	*z = 4.0 / 3.0 - 2.0 * iring / (3.0 * nside);
+	if ((iring - nside) % 2 == 0)
+	    *shift = 0.5;
+	else
+	    *shift = 0.0;
+	}
+    else {
+	nr = 4 * nside - iring;
+	*startpix = 12 * nside * nside - 2 * nr * (nr + 1);
+	*npring = 4 * nr;
+	*z = -(1.0 - (double) nr * nr / (3.0 * nside * nside));
+	*shift = 0.5;
+	}
+    return (0);
+}
+
+
+/* HPXOPEN -- Open HEALPix-indexed catalog file, returning NULL on failure */
+
+struct HpxCat *
+hpxopen (hpxfile)
+
+char	*hpxfile;	/* Path name of catalog file */
+{
+    struct HpxCat *hc;
+    struct HpxHead head;
+    FILE *fcat;
+    char *data;
+    long lfile, lneed, npix, off;
+    int imag;
+
+    fcat = fopen (hpxfile, "rb");
+    if (fcat == NULL) {
+	fprintf (stderr, "HPXOPEN: Cannot read catalog %s\n", hpxfile);
+	return (NULL);
+	}
+    if (fread (&head, sizeof (head), 1, fcat) != 1 ||
+	strncmp (head.magic, HPXMAGIC, 8)) {
+	fprintf (stderr, "HPXOPEN: %s is not a HEALPix catalog\n", hpxfile);
+	fclose (fcat);
+	return (NULL);
+	}
+    if (head.nside < 1 || head.nside > HPXMAXSIDE || head.nstars < 0 ||
+	head.nmag < 0 || head.nmag > MAXNMAG) {
+	fprintf (stderr, "HPXOPEN: %s has wrong byte order or is damaged\n",
+		 hpxfile);
+	fclose (fcat);
+	return (NULL);
+	}
+
+    /* Check that the file holds the index and every column */
+    npix = 12L * head.nside * head.nside;
+    lneed = HPXHEAD + ((npix + 1) * 4 + 7) / 8 * 8 +
+	    (long) head.nstars * (8 * (5 + head.nmag) + 4);
+    fseek (fcat, 0L, SEEK_END);
+    lfile = ftell (fcat);
+    if (lfile < lneed) {
+	fprintf (stderr, "HPXOPEN: %s is truncated\n", hpxfile);
+	fclose (fcat);
+	return (NULL);
+	}
+
+#ifndef _WIN32
+    data = (char *) mmap (NULL, (size_t) lfile, PROT_READ, MAP_SHARED,
+			  fileno (fcat), 0);
+    fclose (fcat);
+    if (data == (char *) MAP_FAILED) {
+	fprintf (stderr, "HPXOPEN: Cannot map catalog %s\n", hpxfile);
+	return (NULL);
+	}
+#else
+    data = (char *) malloc (lfile);
+    fseek (fcat, 0L, SEEK_SET);
+    if (data == NULL || fread (data, 1, lfile, fcat) != (size_t) lfile) {
+	fprintf (stderr, "HPXOPEN: Cannot read catalog %s\n", hpxfile);
+	if (data != NULL)
+	    free (data);
+	fclose (fcat);
+	return (NULL);
+	}
+    fclose (fcat);
+#endif
+
+    hc = (struct HpxCat *) calloc (1, sizeof (struct HpxCat));
+    if (hc == NULL) {
+	fprintf (stderr, "HPXOPEN: Cannot allocate descriptor for %s\n",
+		 hpxfile);
+#ifndef _WIN32
+	munmap (data, (size_t) lfile);
+#else
+	free (data);
+#endif
+	return (NULL);
+	}
+    hc->data = data;
+    hc->ldata = lfile;
+    hc->nside = head.nside;
+    hc->nmag = head.nmag;
+    hc->nstars = head.nstars;
+    hc->sysref = head.sysref;
+    hc->eqref = head.eqref;
+    hc->epref = head.epref;
+    hc->catprop = head.catprop;
+    memcpy (hc->title, head.title, 79);
+    hc->title[79] = (char) 0;
+
+    /* Point the columns into the mapped file */
+    off = HPXHEAD;
+    hc->pixstart = (int *) (data + off);
+    off = off + ((npix + 1) * 4 + 7) / 8 * 8;
+    hc->num = (double *) (data + off);
+    off = off + 8L * head.nstars;
+    hc->ra = (double *) (data + off);
+    off = off + 8L * head.nstars;
+    hc->dec = (double *) (data + off);
+    off = off + 8L * head.nstars;
+    hc->pra = (double *) (data + off);
+    off = off + 8L * head.nstars;
+    hc->pdec = (double *) (data + off);
+    off = off + 8L * head.nstars;
+    for (imag = 0; imag < head.nmag; imag++) {
+	hc->mag[imag] = (double *) (data + off);
+	off = off + 8L * head.nstars;
+	}
+    hc->type = (int *) (data + off);
+
+    return (hc);
+}
+
+
+/* HPXCLOSE -- Close HEALPix-indexed catalog file */
+
+void
+hpxclose (hc)
+
+struct HpxCat *hc;	/* HEALPix catalog descriptor */
+{
+    if (hc == NULL)
+	return;
+#ifndef _WIN32
+    munmap (hc->data, (size_t) hc->ldata);
+#else
+    free (hc->data);
+#endif
+    free (hc);
+    return;
+}
+
+
+/* HPXALLOC -- Allocate arrays for up to nmax stars returned by a search */
+
+struct HpxStars *
+hpxalloc (nmax, nmag)
+
+int	nmax;		/* Maximum number of stars to return */
+int	nmag;		/* Number of magnitudes per star */
+{
+    struct HpxStars *stars;
+    int imag, nomem;
+
+    if (nmag > MAXNMAG)
+	nmag = MAXNMAG;
+    stars = (struct HpxStars *) calloc (1, sizeof (struct HpxStars));
+    if (stars == NULL) {
+	fprintf (stderr, "HPXALLOC: Cannot allocate search results\n");
+	return (NULL);
+	}
+    stars->nmax = nmax;
+    stars->nmag = nmag;
+    stars->num = (double *) calloc (nmax + 1, sizeof (double));
+    stars->ra = (double *) calloc (nmax + 1, sizeof (double));
+    stars->dec = (double *) calloc (nmax + 1, sizeof (double));
+    stars->pra = (double *) calloc (nmax + 1, sizeof (double));
+    stars->pdec = (double *) calloc (nmax + 1, sizeof (double));
+    for (imag = 0; imag < nmag; imag++)
+	stars->mag[imag] = (double *) calloc (nmax + 1, sizeof (double));
+    stars->type = (int *) calloc (nmax + 1, sizeof (int));
+
+    /* If any array is missing, free the rest and give up */
+    nomem = (stars->num == NULL || stars->ra == NULL || stars->dec == NULL ||
+	     stars->pra == NULL || stars->pdec == NULL || stars->type == NULL);
+    for (imag = 0; imag < nmag; imag++)
+	if (stars->mag[imag] == NULL)
+	    nomem = 1;
+    if (nomem) {
+	fprintf (stderr, "HPXALLOC: Cannot allocate arrays for %d stars\n",
+		 nmax);
+	hpxfree (stars);
+	return (NULL);
+	}
+    return (stars);
+}
+
+
+/* HPXFREE -- Free arrays for stars returned by a search */
+
+void
+hpxfree (stars)
+
+struct HpxStars *stars;	/* Stars returned by a search */
+{
+    int imag;
+
+    if (stars == NULL)
+	return;
+    free (stars->num);
+    free (stars->ra);
+    free (stars->dec);
+    free (stars->pra);
+    free (stars->pdec);
+    for (imag = 0; imag < stars->nmag; imag++)
+	free (stars->mag[imag]);
+    free (stars->type);
+    free (stars);
+    return;
+}
+
+
+/* HPXCONE -- Find catalog stars within a circle, returning the number found.
+ * If more than stars->nmax are found, the brightest in sortmag are kept. */
+
+int
+hpxcone (hc, cra, cdec, drad, mag1, mag2, sortmag, stars)
+
+struct HpxCat *hc;	/* HEALPix catalog descriptor */
+double	cra;		/* Search center right ascension in degrees */
+double	cdec;		/* Search center declination in degrees */
+double	drad;		/* Search radius in degrees */
+double	mag1, mag2;	/* Limiting magnitudes (none if equal) */
+int	sortmag;	/* Number of magnitude by which to limit and keep */
+struct HpxStars *stars;	/* Stars found (returned) */
+{
+    return (hpxsearch (hc, cra, cdec, drad, 0.0, 0.0, mag1, mag2, sortmag,
+		       stars));
+}
+
+
+/* HPXBOX -- Find catalog stars within a right ascension and declination box,
+ * returning the number found.  The half-width in right ascension is in
+ * degrees of right ascension, as in the other catalog search subroutines. */
+
+int
+hpxbox (hc, cra, cdec, dra, ddec, mag1, mag2, sortmag, stars)
+
+struct HpxCat *hc;	/* HEALPix catalog descriptor */
+double	cra;		/* Search center right ascension in degrees */
+double	cdec;		/* Search center declination in degrees */
+double	dra;		/* Search half width in right ascension in degrees */
+double	ddec;		/* Search half-width in declination in degrees */
+double	mag1, mag2;	/* Limiting magnitudes (none if equal) */
+int	sortmag;	/* Number of magnitude by which to limit and keep */
+struct HpxStars *stars;	/* Stars found (returned) */
+{
+    double drad, dist, ra, dec;
+    int i, j;
+
+    /* Search the circle through the farthest corner or edge of the box */
+    if (dra >= 180.0 || cdec + ddec >= 90.0 || cdec - ddec <= -90.0)
+	drad = 180.0;
+    else {
+	drad = 0.0;
+	for (i = -1; i < 2; i++) {
+	    for (j = -1; j < 2; j++) {
+		ra = cra + i * dra;
+		dec = cdec + j * ddec;
+		dist = wcsdist (cra, cdec, ra, dec);
+		if (dist > drad)
+		    drad = dist;
+		}
+	    }
+	}
+    if (dra <= 0.0)
+	dra = 180.0;
+    return (hpxsearch (hc, cra, cdec, drad, dra, ddec, mag1, mag2, sortmag,
+		       stars));
+}
+
+
+/* Find stars within drad of the center and, if dra and ddec are set, within
+ * that box, visiting only the rings and pixels which can contain them */
+
+static int
+hpxsearch (hc, cra, cdec, drad, dra, ddec, mag1, mag2, sortmag, stars)
+
+struct HpxCat *hc;	/* HEALPix catalog descriptor */
+double	cra, cdec;	/* Search center in degrees */
+double	drad;		/* Search radius in degrees */
+double	dra, ddec;	/* Box half-widths in degrees (no box if ddec is 0) */
+double	mag1, mag2;	/* Limiting magnitudes (none if equal) */
+int	sortmag;	/* Number of magnitude by which to limit and keep */
+struct HpxStars *stars;	/* Stars found (returned) */
+{
+    double rad, radpix, z0, cosdec0, sindec0, ra0, cosrad, cosdphi, dphi;
+    double z, shift, decring, dpix, phi, cosd, x0, y0, x, y, cd, dr;
+    double mag, faintmag, *smag, *rmag;
+    int nside, iring, startpix, npring, jlo, jhi, j, jj, ipix, is, is1, is2;
+    int nfound, nstars, faintstar, imag, i, magsort;
+    int *faintheap = NULL;
+
+    stars->nstars = 0;
+    if (hc == NULL)
+	return (0);
+    nside = hc->nside;
+
+    if (sortmag < 1 || sortmag > hc->nmag)
+	magsort = 0;
+    else
+	magsort = sortmag - 1;
+    if (mag2 < mag1) {
+	mag = mag1;
+	mag1 = mag2;
+	mag2 = mag;
+	}
+    smag = (hc->nmag > 0) ? hc->mag[magsort] : NULL;
+
+    /* Keep the brightest stars only if the list has the sort magnitude */
+    rmag = (smag != NULL && magsort < stars->nmag) ? stars->mag[magsort] : NULL;
+
+    /* A pixel center can be this far from a star in the pixel */
+    radpix = 1.5 * sqrt (HPXPI / 3.0) / nside;
+    rad = degrad (drad);
+    if (rad > HPXPI)
+	rad = HPXPI;
+    cosrad = cos (rad);
+
+    ra0 = degrad (cra);
+    sindec0 = sin (degrad (cdec));
+    cosdec0 = cos (degrad (cdec));
+    z0 = sindec0;
+    x0 = cosdec0 * cos (ra0);
+    y0 = cosdec0 * sin (ra0);
+
+    nfound = 0;
+    nstars = 0;
+    faintstar = 0;
+    faintmag = 0.0;
+    for (iring = 1; iring < 4 * nside; iring++) {
+	hpxringinfo (nside, iring, &startpix, &npring, &z, &shift);
+
+	/* Skip rings whose pixel centers are all too far away */
+	decring = asin (z);
+	if (fabs (decring - degrad (cdec)) > rad + radpix)
+	    continue;
+
+	/* Range of pixel centers in right ascension within reach */
+	if (rad + radpix >= HPXPI || cosdec0 < 1.0e-10)
+	    dphi = HPXPI;
+	else {
+	    cosdphi = (cos (rad + radpix) - z0 * z) /
+		      (cosdec0 * sqrt (1.0 - z * z));
+	    if (cosdphi <= -1.0)
+		dphi = HPXPI;
+	    else if (cosdphi >= 1.0)
+		dphi = 0.0;
+	    else
+		dphi = acos (cosdphi);
+	    }
+	dpix = 2.0 * HPXPI / npring;
+	if (dphi >= HPXPI) {
+	    jlo = 0;
+	    jhi = npring - 1;
+	    }
+	else {
+	    jlo = (int) ceil ((ra0 - dphi) / dpix - shift);
+	    jhi = (int) floor ((ra0 + dphi) / dpix - shift);
+	    if (jhi - jlo + 1 >= npring) {
+		jlo = 0;
+		jhi = npring - 1;
+		}
+	    }
+
+	for (j = jlo; j <= jhi; j++) {
+	    jj = j % npring;
+	    if (jj < 0)
+		jj = jj + npring;
+	    ipix = startpix + jj;
+	    is1 = hc->pixstart[ipix];
+	    is2 = hc->pixstart[ipix+1];
+	    for (is = is1; is < is2; is++) {
+
+		/* Check magnitude limits */
+		if (smag != NULL) {
+		    mag = smag[is];
+		    if (mag1 != mag2 && (mag < mag1 || mag > mag2))
+			continue;
+		    }
+		else
+		    mag = 0.0;
+
+		/* Check distance from center */
+		phi = degrad (hc->ra[is]);
+		cd = cos (degrad (hc->dec[is]));
+		x = cd * cos (phi);
+		y = cd * sin (phi);
+		cosd = x * x0 + y * y0 + sin (degrad (hc->dec[is])) * z0;
+		if (cosd < cosrad)
+		    continue;
+
+		/* Check box limits */
+		if (ddec > 0.0) {
+		    if (fabs (hc->dec[is] - cdec) > ddec)
+			continue;
+		    dr = fmod (hc->ra[is] - cra, 360.0);
+		    if (dr > 180.0)
+			dr = dr - 360.0;
+		    else if (dr < -180.0)
+			dr = dr + 360.0;
+		    if (fabs (dr) > dra)
+			continue;
+		    }
+		nfound++;
+
+		/* Add star, or replace the faintest star if this is brighter */
+		if (nstars < stars->nmax)
+		    i = nstars++;
+		else if (rmag != NULL && mag < faintmag)
+		    i = faintstar;
+		else
+		    continue;
+
+		stars->num[i] = hc->num[is];
+		stars->ra[i] = hc->ra[is];
+		stars->dec[i] = hc->dec[is];
+		stars->pra[i] = hc->pra[is];
+		stars->pdec[i] = hc->pdec[is];
+		for (imag = 0; imag < stars->nmag && imag < hc->nmag; imag++)
+		    stars->mag[imag][i] = hc->mag[imag][is];
+		stars->type[i] = hc->type[is];
+
+		/* Find the new faintest star once the list is full */
+		if (nstars == stars->nmax && rmag != NULL) {
+		    if (faintheap != NULL)
+			faintstar = MagHeapDown (rmag, faintheap, nstars);
+		    else if ((faintheap = (int *) calloc (nstars, sizeof (int))) != NULL) {
+			MagHeapInit (rmag, faintheap, nstars);
+			faintstar = faintheap[0];
+			}
+		    else {
+			for (i = 0; i < nstars; i++) {
+			    if (rmag[i] > rmag[faintstar])
+				faintstar = i;
+			    }
+			}
+		    faintmag = rmag[faintstar];
+		    }
+		}
+	    }
+	}
+
+    if (faintheap != NULL)
+	free ((void *)faintheap);
+    stars->nstars = nstars;
+    return (nfound);
+}
+
+
+/* HPXWRITE -- Write a HEALPix-indexed catalog from arrays of star data,
+ * returning the number of stars written or -1 on failure */
+
+int
+hpxwrite (hpxfile, nside, title, sysref, eqref, epref, catprop,
+	  nstars, nmag, num, ra, dec, pra, pdec, mag, type)
+
+char	*hpxfile;	/* Path name of catalog file to write */
+int	nside;		/* HEALPix resolution parameter */
+char	*title;		/* Catalog description */
+int	sysref;		/* Catalog coordinate system */
+double	eqref;		/* Catalog equinox */
+double	epref;		/* Catalog epoch */
+int	catprop;	/* 1 if proper motions are present */
+int	nstars;		/* Number of stars */
+int	nmag;		/* Number of magnitudes per star */
+double	*num;		/* Catalog numbers */
+double	*ra, *dec;	/* Positions in degrees */
+double	*pra, *pdec;	/* Proper motions, or NULL if none */
+double	**mag;		/* nmag arrays of magnitudes */
+int	*type;		/* Object types, or NULL if none */
+{
+    struct HpxHead head;
+    FILE *fcat;
+    long npix, ipix, lpad;
+    int *pixstart, *pixnext, *pix, *order, is, icol;
+    double *column, *values;
+    int *tcolumn;
+    char zero[8];
+
+    if (nside < 1 || nside > HPXMAXSIDE || nmag > MAXNMAG || nstars < 0) {
+	fprintf (stderr, "HPXWRITE: Cannot write nside %d, %d magnitudes\n",
+		 nside, nmag);
+	return (-1);
+	}
+    npix = 12L * nside * nside;
+
+    /* Sort the stars by pixel with a counting sort */
+    pixstart = (int *) calloc (npix + 1, sizeof (int));
+    pixnext = (int *) calloc (npix + 1, sizeof (int));
+    pix = (int *) malloc ((nstars + 1) * sizeof (int));
+    order = (int *) malloc ((nstars + 1) * sizeof (int));
+    column = (double *) malloc ((nstars + 1) * sizeof (double));
+    tcolumn = (int *) malloc ((nstars + 1) * sizeof (int));
+    if (pixstart == NULL || pixnext == NULL || pix == NULL || order == NULL ||
+	column == NULL || tcolumn == NULL) {
+	fprintf (stderr, "HPXWRITE: Cannot allocate index for %d stars\n",
+		 nstars);
+	if (pixstart) free (pixstart);
+	if (pixnext) free (pixnext);
+	if (pix) free (pix);
+	if (order) free (order);
+	if (column) free (column);
+	if (tcolumn) free (tcolumn);
+	return (-1);
+	}
+    for (is = 0; is < nstars; is++) {
+	pix[is] = hpxpix (nside, ra[is], dec[is]);
+	pixstart[pix[is]+1]++;
+	}
+    for (ipix = 0; ipix < npix; ipix++)
+	pixstart[ipix+1] = pixstart[ipix+1] + pixstart[ipix];
+    for (ipix = 0; ipix < npix; ipix++)
+	pixnext[ipix] = pixstart[ipix];
+    for (is = 0; is < nstars; is++)
+	order[pixnext[pix[is]]++] = is;
+
+    fcat = fopen (hpxfile, "wb");
+    if (fcat == NULL) {
+	fprintf (stderr, "HPXWRITE: Cannot write catalog %s\n", hpxfile);
+	nstars = -1;
+	goto done;
+	}
+
+    memset (&head, 0, sizeof (head));
+    memcpy (head.magic, HPXMAGIC, 8);
+    head.nside = nside;
+    head.nmag = nmag;
+    head.nstars = nstars;
+    head.sysref = sysref;
+    head.eqref = eqref;
+    head.epref = epref;
+    head.catprop = catprop;
+    if (title != NULL)
+	strncpy (head.title, title, 79);
+    memset (zero, 0, 8);
+    fwrite (&head, sizeof (head), 1, fcat);
+    fwrite (zero, 1, HPXHEAD - sizeof (head), fcat);
+
+    /* Index of first star in each pixel, padded to a multiple of 8 bytes */
+    fwrite (pixstart, sizeof (int), npix + 1, fcat);
+    lpad = ((npix + 1) * 4 + 7) / 8 * 8 - (npix + 1) * 4;
+    fwrite (zero, 1, lpad, fcat);
+
+    /* Columns of star data in pixel order */
+    for (icol = 0; icol < 5 + nmag; icol++) {
+	switch (icol) {
+	    case 0: values = num; break;
+	    case 1: values = ra; break;
+	    case 2: values = dec; break;
+	    case 3: values = pra; break;
+	    case 4: values = pdec; break;
+	    default: values = mag[icol-5];
+	    }
+	for (is = 0; is < nstars; is++)
+	    column[is] = (values != NULL) ? values[order[is]] : 0.0;
+	fwrite (column, sizeof (double), nstars, fcat);
+	}
+    for (is = 0; is < nstars; is++)
+	tcolumn[is] = (type != NULL) ? type[order[is]] : 0;
+    fwrite (tcolumn, sizeof (int), nstars, fcat);
+
+    if (fclose (fcat)) {
+	fprintf (stderr, "HPXWRITE: Error writing catalog %s\n", hpxfile);
+	nstars = -1;
+	}
+
+done:
+    free (pixstart);
+    free (pixnext);
+    free (pix);
+    free (order);
+    free (column);
+    free (tcolumn);
+    return (nstars);
+}
+
+
+/* Read the stars in one cell of the sky from a catalog in its own format,
+ * returning the number of stars in the cell, which may be more than nmax */
+
+static int
+hpxreadcell (refcatname, refcat, starcat, ra1, ra2, dec1, dec2, mag1, mag2,
+	     nmax, gnum, gra, gdec, gpra, gpdec, gmag, gtype, nlog)
+
+char	*refcatname;	/* Name of reference catalog */
+int	refcat;		/* Catalog code from wcscat.h */
+struct StarCat **starcat; /* Catalog data structure, kept open between cells */
+double	ra1, ra2;	/* Right ascension limits of cell in degrees */
+double	dec1, dec2;	/* Declination limits of cell in degrees */
+double	mag1, mag2;	/* Limiting magnitudes (none if equal) */
+int	nmax;		/* Maximum number of stars to return */
+double	*gnum, *gra, *gdec, *gpra, *gpdec; /* Star data (returned) */
+double	**gmag;		/* Magnitudes (returned) */
+int	*gtype;		/* Object types (returned) */
+int	nlog;		/* Verbose mode if > 1 */
+{
+    double cra, cdec, dra, ddec, eqout = 2000.0, epout = 0.0;
+    int sysout = WCS_J2000;
+    int nstars;
+
+    /* Read a slightly larger box, since stars on its edges are cut later */
+    cra = 0.5 * (ra1 + ra2);
+    cdec = 0.5 * (dec1 + dec2);
+    dra = 0.5 * (ra2 - ra1) + 1.0e-6;
+    ddec = 0.5 * (dec2 - dec1) + 1.0e-6;
+
+    switch (refcat) {
+	case UCAC1:
+	case UCAC2:
+	case UCAC3:
+	    nstars = ucacread (refcatname, cra, cdec, dra, ddec, 0.0, 0.0, 0,
+			       sysout, eqout, epout, mag1, mag2, 1, nmax,
+			       gnum, gra, gdec, gpra, gpdec, gmag, gtype, nlog);
+	    break;
+	case TYCHO2:
+	case TYCHO2E:
+	    nstars = ty2read (refcat, cra, cdec, dra, ddec, 0.0, 0.0, 0,
+			      sysout, eqout, epout, mag1, mag2, 1, nmax,
+			      gnum, gra, gdec, gpra, gpdec, gmag, gtype, nlog);
+	    break;
+	case TMPSC:
+	case TMPSCE:
+	case TMIDR2:
+	case TMXSC:
+	    nstars = tmcread (refcat, cra, cdec, dra, ddec, 0.0, 0.0, 0,
+			      sysout, eqout, epout, mag1, mag2, 1, nmax,
+			      gnum, gra, gdec, gmag, gtype, nlog);
+	    break;
+	case BINCAT:
+	    nstars = binread (refcatname, 0, cra, cdec, dra, ddec, 0.0, 0.0,
+			      sysout, eqout, epout, mag1, mag2, 1, nmax,
+			      starcat, gnum, gra, gdec, gpra, gpdec, gmag,
+			      gtype, NULL, nlog);
+	    break;
+	case TXTCAT:
+	    nstars = ctgread (refcatname, refcat, 0, cra, cdec, dra, ddec,
+			      0.0, 0.0, sysout, eqout, epout, mag1, mag2, 1,
+			      nmax, starcat, gnum, gra, gdec, gpra, gpdec,
+			      gmag, gtype, NULL, nlog);
+	    break;
+	default:
+	    fprintf (stderr, "HPXCONVERT: Cannot convert catalog %s\n",
+		     refcatname);
+	    nstars = -1;
+	}
+    return (nstars);
+}
+
+
+/* Reallocate *p to size bytes, returning 0, or -1 with *p unchanged if
+ * there is not enough memory */
+
+static int
+hpxgrow (p, size)
+
+void	**p;		/* Pointer to memory to reallocate (returned) */
+int	size;		/* New size in bytes */
+{
+    void *newp;
+
+    newp = realloc (*p, size);
+    if (newp == NULL)
+	return (-1);
+    *p = newp;
+    return (0);
+}
+
+
+/* HPXCONVERT -- Convert a local catalog in one of the zone or TDC formats
+ * to a HEALPix-indexed catalog, returning the number of stars written or
+ * -1 on failure.  The whole catalog (within the magnitude limits) is held
+ * in memory while it is sorted, so limit the magnitudes of large ones. */
+
+int
+hpxconvert (refcatname, hpxfile, nside, mag1, mag2, nlog)
+
+char	*refcatname;	/* Name of reference catalog */
+char	*hpxfile;	/* Path name of catalog file to write */
+int	nside;		/* HEALPix resolution parameter */
+double	mag1, mag2;	/* Limiting magnitudes (none if equal) */
+int	nlog;		/* 1 to log progress by declination band */
+{
+    struct StarCat *starcat = NULL;
+    char title[80];
+    int refcat, syscat, catprop, nmag, imag, is, nread, nstars, nalloc;
+    int ncell, icell;
+    double eqcat, epcat, ra1, ra2, dec1, dec2, ra, dec;
+    double *gnum, *gra, *gdec, *gpra, *gpdec, *gmag[MAXNMAG+1];
+    double *num, *cra, *cdec, *pra, *pdec, *mag[MAXNMAG+1];
+    int *gtype, *type;
+    double *cells;	/* Stack of cells still to read: ra1, ra2, dec1, dec2 */
+    int nstack, lstack;
+    int nomem;		/* 1 if memory ran out */
+
+    title[0] = (char) 0;
+    refcat = RefCat (refcatname, title, &syscat, &eqcat, &epcat, &catprop,
+		     &nmag);
+    if (nmag > MAXNMAG)
+	nmag = MAXNMAG;
+
+    /* Arrays for one cell, and for the whole catalog */
+    gnum = (double *) calloc (HPXCELLMAX, sizeof (double));
+    gra = (double *) calloc (HPXCELLMAX, sizeof (double));
+    gdec = (double *) calloc (HPXCELLMAX, sizeof (double));
+    gpra = (double *) calloc (HPXCELLMAX, sizeof (double));
+    gpdec = (double *) calloc (HPXCELLMAX, sizeof (double));
+    gtype = (int *) calloc (HPXCELLMAX, sizeof (int));
+    for (imag = 0; imag <= MAXNMAG; imag++)
+	gmag[imag] = (imag < nmag) ?
+		     (double *) calloc (HPXCELLMAX, sizeof (double)) : NULL;
+
+    nalloc = HPXCELLMAX;
+    num = (double *) malloc (nalloc * sizeof (double));
+    cra = (double *) malloc (nalloc * sizeof (double));
+    cdec = (double *) malloc (nalloc * sizeof (double));
+    pra = (double *) malloc (nalloc * sizeof (double));
+    pdec = (double *) malloc (nalloc * sizeof (double));
+    type = (int *) malloc (nalloc * sizeof (int));
+    nomem = (gnum == NULL || gra == NULL || gdec == NULL || gpra == NULL ||
+	     gpdec == NULL || gtype == NULL || num == NULL || cra == NULL ||
+	     cdec == NULL || pra == NULL || pdec == NULL || type == NULL);
+    for (imag = 0; imag < nmag; imag++) {
+	mag[imag] = (double *) malloc (nalloc * sizeof (double));
+	if (gmag[imag] == NULL || mag[imag] == NULL)
+	    nomem = 1;
+	}
+
+    /* Catalogs in zone files start with 1 degree declination bands split
+     * into 10 degree cells; files which are read whole on every search
+     * start with the whole sky.  Any cell with too many stars to read at
+     * once is split in four. */
+    lstack = 4 * 1024;
+    cells = (double *) malloc (lstack * 4 * sizeof (double));
+    nstack = 0;
+    if (cells == NULL)
+	nomem = 1;
+    if (nomem)
+	nstack = 0;
+    else if (refcat == BINCAT || refcat == TXTCAT) {
+	cells[0] = 0.0;
+	cells[1] = 360.0;
+	cells[2] = -90.0;
+	cells[3] = 90.0;
+	nstack = 1;
+	}
+    else {
+	for (icell = 180 * 36 - 1; icell >= 0; icell--) {
+	    if (nstack == lstack) {
+		lstack = lstack * 2;
+		if (hpxgrow ((void **)&cells, lstack*4*sizeof (double))) {
+		    nomem = 1;
+		    nstack = 0;
+		    break;
+		    }
+		}
+	    cells[4*nstack] = 10.0 * (icell % 36);
+	    cells[4*nstack+1] = cells[4*nstack] + 10.0;
+	    cells[4*nstack+2] = 90.0 - (icell / 36 + 1);
+	    cells[4*nstack+3] = cells[4*nstack+2] + 1.0;
+	    nstack++;
+	    }
+	}
+
+    nstars = 0;
+    ncell = 0;
+    while (nstack > 0) {
+	nstack--;
+	ra1 = cells[4*nstack];
+	ra2 = cells[4*nstack+1];
+	dec1 = cells[4*nstack+2];
+	dec2 = cells[4*nstack+3];
+
+	nread = hpxreadcell (refcatname, refcat, &starcat, ra1, ra2, dec1, dec2,
+			     mag1, mag2, HPXCELLMAX, gnum, gra, gdec, gpra,
+			     gpdec, gmag, gtype, 0);
+	if (nread < 0) {
+	    nstars = -1;
+	    break;
+	    }
+
+	/* Too many stars to read at once: split the cell */
+	if (nread > HPXCELLMAX) {
+	    if (nstack + 4 > lstack) {
+		lstack = lstack * 2;
+		if (hpxgrow ((void **)&cells, lstack*4*sizeof (double))) {
+		    nomem = 1;
+		    break;
+		    }
+		}
+	    for (icell = 0; icell < 4; icell++) {
+		cells[4*nstack] = (icell % 2) ? 0.5 * (ra1 + ra2) : ra1;
+		cells[4*nstack+1] = (icell % 2) ? ra2 : 0.5 * (ra1 + ra2);
+		cells[4*nstack+2] = (icell / 2) ? 0.5 * (dec1 + dec2) : dec1;
+		cells[4*nstack+3] = (icell / 2) ? dec2 : 0.5 * (dec1 + dec2);
+		nstack++;
+		}
+	    continue;
+	    }
+
+	/* Keep the stars inside the cell, so that none is taken twice */
+	for (is = 0; is < nread; is++) {
+	    ra = gra[is];
+	    dec = gdec[is];
+	    if (ra < 0.0)
+		ra = ra + 360.0;
+	    if (ra >= 360.0)
+		ra = ra - 360.0;
+	    if (ra < ra1 || ra >= ra2)
+		continue;
+	    if (dec < dec1 || (dec >= dec2 && dec2 < 90.0))
+		continue;
+
+	    if (nstars == nalloc) {
+		nalloc = nalloc * 2;
+		if (hpxgrow ((void **)&num, nalloc * sizeof (double)) ||
+		    hpxgrow ((void **)&cra, nalloc * sizeof (double)) ||
+		    hpxgrow ((void **)&cdec, nalloc * sizeof (double)) ||
+		    hpxgrow ((void **)&pra, nalloc * sizeof (double)) ||
+		    hpxgrow ((void **)&pdec, nalloc * sizeof (double)) ||
+		    hpxgrow ((void **)&type, nalloc * sizeof (int)))
+		    nomem = 1;
+		for (imag = 0; imag < nmag && !nomem; imag++) {
+		    if (hpxgrow ((void **)&mag[imag], nalloc * sizeof (double)))
+			nomem = 1;
+		    }
+		if (nomem)
+		    break;
+		}
+	    num[nstars] = gnum[is];
+	    cra[nstars] = ra;
+	    cdec[nstars] = dec;
+	    pra[nstars] = catprop ? gpra[is] : 0.0;
+	    pdec[nstars] = catprop ? gpdec[is] : 0.0;
+	    type[nstars] = gtype[is];
+	    for (imag = 0; imag < nmag; imag++)
+		mag[imag][nstars] = gmag[imag][is];
+	    nstars++;
+	    }
+	if (nomem)
+	    break;
+
+	ncell++;
+	if (nlog > 0 && ra1 == 0.0)
+	    fprintf (stderr, "HPXCONVERT: %d stars to dec %.1f\n",
+		     nstars, dec1);
+	}
+
+    if (starcat != NULL) {
+	if (refcat == BINCAT)
+	    binclose (starcat);
+	else if (refcat == TXTCAT)
+	    ctgclose (starcat);
+	}
+    if (nomem) {
+	fprintf (stderr, "HPXCONVERT: Out of memory at %d stars\n", nstars);
+	nstars = -1;
+	}
+
+    if (nstars >= 0)
+	nstars = hpxwrite (hpxfile, nside, title, WCS_J2000, 2000.0, epcat,
+			   catprop, nstars, nmag, num, cra, cdec, pra, pdec,
+			   mag, type);
+    if (nlog > 0 && nstars >= 0)
+	fprintf (stderr, "HPXCONVERT: %d stars from %d cells written to %s\n",
+		 nstars, ncell, hpxfile);
+
+    free (cells);
+    free (gnum);
+    free (gra);
+    free (gdec);
+    free (gpra);
+    free (gpdec);
+    free (gtype);
+    free (num);
+    free (cra);
+    free (cdec);
+    free (pra);
+    free (pdec);
+    free (type);
+    for (imag = 0; imag < nmag; imag++) {
+	free (gmag[imag]);
+	free (mag[imag]);
+	}
+    return (nstars);
+}
+
+/* Oct 19 2026	New subroutines for HEALPix-indexed local catalogs
+ * Oct 19 2026	Keep a heap of the faintest stars in hpxsearch()
+ * Oct 19 2026	Return -1 from hpxconvert() instead of exiting if out of memory
+ * Oct 19 2026	Rank stars by magnitude only if the list has the sort magnitude
+ * Oct 19 2026	Return NULL from hpxopen() and hpxalloc() if out of memory
+ */
@@ -46,6 +46,8 @@
  *		Get minimum of vector from 2D image of any numeric type
  * Subroutine:	getvec (image, bitpix, bz, bs, pix1, npix, dvec)
  *		Get vector from 2D image of any numeric type
+ * Subroutine:	getrow (image, bitpix, w, h, bz, bs, x, y, npix, dvec)
+ *		Get pixels from one row of 2D image of any numeric type
  * Subroutine:	putvec (image, bitpix, bz, bs, pix1, npix, dvec)
  *		Copy pixel vector into a vector of any numeric type
  * Subroutine:	addvec (image, bitpix, bz, bs, pix1, npix, dpix)
@@ -1067,6 +1069,20 @@ double	dpix;		/* Value by which to multiply pixels */
 
 /* GETVEC -- Get vector from 2D image of any numeric type */
 
+/* Each type gets its own conversion and scaling loop, with nothing in it
+   to keep the compiler from vectorizing it */
+#define GETVEC(type) { \
+    type *im = (type *) image + pix1; \
+    if (doscale) { \
+	for (ipix = 0; ipix < npix; ipix++) \
+	    dvec[ipix] = ((double) im[ipix] * bscale) + bzero; \
+	} \
+    else { \
+	for (ipix = 0; ipix < npix; ipix++) \
+	    dvec[ipix] = (double) im[ipix]; \
+	} \
+    }
+
 void
 getvec (image, bitpix, bzero, bscale, pix1, npix, dvec0)
 
@@ -1081,71 +1097,98 @@ int	npix;		/* Number of pixels to extract */
 double	*dvec0;		/* Vector of pixels (returned) */
 
 {
-    short *im2;
-    int *im4;
-    unsigned short *imu;
-    float *imr;
-    double *imd;
-    double *dvec;
-    int ipix, pix2;
+    double *dvec = dvec0;
+    int ipix, doscale;
 
-    pix2 = pix1 + npix;
-    dvec = dvec0;
+    /* Scale data if either BZERO or BSCALE keyword has been set */
+    doscale = (scale && (bzero != 0.0 || bscale != 1.0));
 
     switch (bitpix) {
 
 	case 8:
-	    for (ipix = pix1; ipix < pix2; ipix++)
-		*dvec++ = (double) *(image + ipix);
+	    GETVEC(char)
 	    break;
 
 	case 16:
-	    im2 = (short *)image;
-	    for (ipix = pix1; ipix < pix2; ipix++)
-		*dvec++ = (double) *(im2 + ipix);
+	    GETVEC(short)
 	    break;
 
 	case 32:
-	    im4 = (int *)image;
-	    for (ipix = pix1; ipix < pix2; ipix++)
-		*dvec++ = (double) *(im4 + ipix);
+	    GETVEC(int)
 	    break;
 
 	case -16:
-	    imu = (unsigned short *)image;
-	    for (ipix = pix1; ipix < pix2; ipix++)
-		*dvec++ = (double) *(imu + ipix);
+	    GETVEC(unsigned short)
 	    break;
 
 	case -32:
-	    imr = (float *)image;
-	    for (ipix = pix1; ipix < pix2; ipix++)
-		*dvec++ = (double) *(imr + ipix);
+	    GETVEC(float)
 	    break;
 
 	case -64:
-	    imd = (double *)image;
-	    for (ipix = pix1; ipix < pix2; ipix++)
-		*dvec++ = (double) *(imd + ipix);
+	    GETVEC(double)
 	    break;
 
 	}
 
-    /* Scale data if either BZERO or BSCALE keyword has been set */
-    if (scale && (bzero != 0.0 || bscale != 1.0)) {
-	dvec = dvec0;
-	for (ipix = pix1; ipix < pix2; ipix++) {
-	    *dvec = (*dvec * bscale) + bzero;
-	    dvec++;
-	    }
+    return;
+}
+
+
+/* GETROW -- Get pixels from one row of a 2D image of any numeric type,
+ * setting those off the image to 0, as getpix() would return them */
+
+void
+getrow (image, bitpix, w, h, bzero, bscale, x, y, npix, dvec)
+
+char	*image;		/* Image array as 1-D vector */
+int	bitpix;		/* FITS bits per pixel */
+			/*  16 = short, -16 = unsigned short, 32 = int */
+			/* -32 = float, -64 = double */
+int	w;		/* Image width in pixels */
+int	h;		/* Image height in pixels */
+double  bzero;		/* Zero point for pixel scaling */
+double  bscale;		/* Scale factor for pixel scaling */
+int	x;		/* Zero-based horizontal number of first pixel */
+int	y;		/* Zero-based vertical pixel number */
+int	npix;		/* Number of pixels to read */
+double	*dvec;		/* Vector of pixels (returned) */
+
+{
+    int ipix, x1, x2;
+
+    /* Part of row within image */
+    x1 = x;
+    if (x1 < 0)
+	x1 = 0;
+    x2 = x + npix;
+    if (x2 > w)
+	x2 = w;
+    if (y < 0 || y >= h || x1 >= x2) {
+	for (ipix = 0; ipix < npix; ipix++)
+	    dvec[ipix] = 0.0;
+	return;
 	}
 
+    for (ipix = 0; ipix < x1 - x; ipix++)
+	dvec[ipix] = 0.0;
+    getvec (image, bitpix, bzero, bscale, (y*w) + x1, x2 - x1, dvec + (x1-x));
+    for (ipix = x2 - x; ipix < npix; ipix++)
+	dvec[ipix] = 0.0;
     return;
 }
 
 
 /* PUTVEC -- Copy pixel vector into 2D image of any numeric type */
 
+/* Integers are rounded to the nearest value; as in getvec(), each type
+   gets a loop of its own */
+#define PUTVECI(type) { \
+    type *im = (type *) image + pix1; \
+    for (ipix = 0; ipix < npix; ipix++) \
+	im[ipix] = (type) ((dvec[ipix] < 0.0) ? dvec[ipix] - 0.5 : dvec[ipix] + 0.5); \
+    }
+
 void
 putvec (image, bitpix, bzero, bscale, pix1, npix, dvec)
 
@@ -1160,72 +1203,52 @@ int	npix;		/* Number of pixels to copy */
 double	*dvec;		/* Vector of pixels to copy */
 
 {
-    short *im2;
-    int *im4;
     unsigned short *imu;
     float *imr;
     double *imd;
-    int ipix, pix2;
-    double *dp = dvec;
-
-    pix2 = pix1 + npix;
+    int ipix;
 
     /* Scale data if either BZERO or BSCALE keyword has been set */
     if (scale && (bzero != 0.0 || bscale != 1.0)) {
-	for (ipix = pix1; ipix < pix2; ipix++) {
-	    *dp = (*dp - bzero) / bscale;
-	    dp++;
-	    }
-	dp = dvec;
+	for (ipix = 0; ipix < npix; ipix++)
+	    dvec[ipix] = (dvec[ipix] - bzero) / bscale;
 	}
 
     switch (bitpix) {
 
 	case 8:
-	    for (ipix = pix1; ipix < pix2; ipix++)
-		*(image+ipix) = (char) *dp++;
+	    for (ipix = 0; ipix < npix; ipix++)
+		image[pix1+ipix] = (char) dvec[ipix];
 	    break;
 
 	case 16:
-	    im2 = (short *)image;
-	    for (ipix = pix1; ipix < pix2; ipix++) {
-		if (*dp < 0.0)
-		    *(im2+ipix) = (short) (*dp++ - 0.5);
-		else
-		    *(im2+ipix) = (short) (*dp++ + 0.5);
-		}
+	    PUTVECI(short)
 	    break;
 
 	case 32:
-	    im4 = (int *)image;
-	    for (ipix = pix1; ipix < pix2; ipix++) {
-		if (*dp < 0.0)
-		    *(im4+ipix) = (int) (*dp++ - 0.5);
-		else
-		    *(im4+ipix) = (int) (*dp++ + 0.5);
-		}
+	    PUTVECI(int)
 	    break;
 
 	case -16:
-	    imu = (unsigned short *)image;
-	    for (ipix = pix1; ipix < pix2; ipix++) {
-		if (*dp < 0.0)
-		    *(imu+ipix) = (unsigned short) 0;
+	    imu = (unsigned short *) image + pix1;
+	    for (ipix = 0; ipix < npix; ipix++) {
+		if (dvec[ipix] < 0.0)
+		    imu[ipix] = (unsigned short) 0;
 		else
-		    *(imu+ipix) = (unsigned short) (*dp++ + 0.5);
+		    imu[ipix] = (unsigned short) (dvec[ipix] + 0.5);
 		}
 	    break;
 
 	case -32:
-	    imr = (float *)image;
-	    for (ipix = pix1; ipix < pix2; ipix++)
-		*(imr+ipix) = (float) *dp++;
+	    imr = (float *) image + pix1;
+	    for (ipix = 0; ipix < npix; ipix++)
+		imr[ipix] = (float) dvec[ipix];
 	    break;
 
 	case -64:
-	    imd = (double *)image;
-	    for (ipix = pix1; ipix < pix2; ipix++)
-		*(imd+ipix) = (double) *dp++;
+	    imd = (double *) image + pix1;
+	    for (ipix = 0; ipix < npix; ipix++)
+		imd[ipix] = dvec[ipix];
 	    break;
 	}
     return;
@@ -1538,4 +1561,8 @@ imswapped ()
  *
  * Jan  8 2007	Include fitsfile.h instead of imio.h
  * Jun 11 2007	Add minvec() and speed up maxvec()
+ *
+ * Oct 19 2026	In getvec() and putvec(), convert in one loop per data type
+ * Oct 19 2026	In putvec(), move to next value for negative unsigned shorts
+ * Oct 19 2026	Add getrow() to read part of a row as getpix() would
  */
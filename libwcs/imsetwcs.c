@@ -496,9 +496,6 @@ getstars:
     if (fitwcs) {
 	niter++;
 
-	/* Sort star-like objects in image by brightness (magnitude) */
-	MagSortStars (NULL,NULL,NULL,NULL,NULL,sx,sy,&sm,sp,NULL,ns,1,1);
-
 	/* If matching a catalog field the same size as the image field,
 	   use only as many star-like objects as reference stars.  If using
 	   a larger catalog field (imfrac > 0), increase the number of stars
@@ -536,6 +533,11 @@ getstars:
 		    nbg = nrg;
 		}
 	    }
+
+	/* Sort the nbs brightest star-like objects in image by brightness
+	   (magnitude) to the start; the others are only matched afterwards */
+	MagSelectStars (NULL,NULL,NULL,NULL,NULL,sx,sy,&sm,sp,NULL,ns,1,1,nbs);
+
 	if (verbose) {
 	    if (nbg == ng)
 		fprintf (stderr,"Using all %d reference stars\n", ng);
@@ -1407,4 +1409,6 @@ setmagfit ()
  * Sep 24 2009	Free pointers more carefully
  * Nov 13 2009	Print catalog magnitude name  in residual output header
  * Dec 14 2009	Allow more than nmag magnitudes to save other things
+ *
+ * Oct 19 2026	Sort only the image stars used for matching with MagSelectStars()
  */
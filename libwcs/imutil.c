@@ -26,6 +26,8 @@
  * medpixr4 (x, ival, ix, iy, nx, ny, ndx, ndy)
  * medpixr8 (x, ival, ix, iy, nx, ny, ndx, ndy)
  *	Compute median of rectangular group of pixels
+ * setfiltthread (nthread)
+ *	Set number of threads for median and mean filters (0 = one per CPU)
  *
  * char *meanfilt (buff, header, ndx, ndy, nlog)
  *	Mean filter an image
@@ -41,6 +43,8 @@
  *	Gaussian filter an image
  * char *gaussfill (buff, header, ndx, ndy, nlog)
  *	Set blank pixels to the Gaussian weighted sum of a box around each one
+ * setgiirwidth (width)
+ *	Filter recursively in gaussfilt() if Gaussian half-width >= width
  * gausswt (mx, my, nx)
  *	Compute Gaussian weights for a square region
  * gausspixi2 (image, ival, ix, iy, nx, ny)
@@ -62,6 +66,10 @@
 #include <stdlib.h>
 #include <math.h>
 #include "fitsfile.h"
+#ifdef _REENTRANT
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 #define MEDIAN 1
 #define MEAN 2
@@ -96,6 +104,41 @@ static int bpvali4;
 static float bpvalr4;
 static int nfilled;
 
+#define MEDSMALL 9	/* Largest median box sorted at each pixel */
+
+/* Rows of an image filtered by one thread */
+struct FiltBand {
+    char	*buff;		/* Image buffer */
+    char	*buffout;	/* Filtered image buffer (returned) */
+    int		bitpix;		/* Number of bits per pixel (<0=floating point) */
+    int		nx, ny;		/* Number of columns and rows in image */
+    int		ndx, ndy;	/* Number of columns and rows in filter box */
+    int		ix1, ix2;	/* Filter columns ix1 through ix2-1 */
+    int		iy1, iy2;	/* Filter rows iy1 through iy2-1 */
+    int		*rank;		/* Rank of each pixel by value, -1 if BLANK */
+    int		*order;		/* Index of pixel with each rank */
+    int		nrank;		/* Number of ranked pixels */
+    int		status;		/* 0 if rows were filtered, else -1 */
+};
+
+static int filtbands();
+static int filtrank();
+static int filtpix();
+static void filtrow();
+static void *medband();
+static void *medsmall();
+static void *meanband();
+static int gaussbands();
+static void *gaussband();
+static void *gaussiirrow();
+static void *gaussiircol();
+
+static int nfthread = 0;	/* Threads filtering bands of rows, 0 for one per CPU */
+void
+setfiltthread (nthread)
+int nthread;
+{ nfthread = nthread; return; }
+
 int
 getnfilled ()
 { return (nfilled); }
@@ -589,7 +632,6 @@ int	nlog;	/* Logging interval in pixels */
 {
 char	*buffret;	/* Modified image buffer (returned) */
 int	nx,ny;	/* Number of columns and rows in image */
-int	ix,iy;	/* Pixel around which to compute median */
 int	npix;	/* Number of pixels in image */
 int	bitpix;	/* Number of bits per pixel (<0=floating point) */
 int	naxes;
@@ -606,80 +648,29 @@ int	naxes;
 
     buffret = NULL;
     if (bitpix == 16) {
-	short *b1,*b2, *buffout;
 	bpvali2 = (short) bpval;
-	vi2 = NULL;
 	buffret = (char *) calloc (npix, sizeof (short));
-	buffout = (short *) buffret;
-	b1 = (short *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = medpixi2 (buff, *b1++, ix, iy, nx, ny, ndx, ndy);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"MEDFILT: %d lines filtered\r", iy+1);
-	    }
-	fprintf (stderr,"\n");
-	free (vi2);
-	vi2 = NULL;
 	}
     else if (bitpix == 32) {
-	int *b1, *b2, *buffout;
 	bpvali4 = (int) bpval;
-	vi4 = NULL;
 	buffret = (char *) calloc (npix, sizeof (int));
-	buffout = (int *) buffret;
-	b1 = (int *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = medpixi4 (buff, *b1++, ix, iy, nx, ny, ndx, ndy);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"MEDFILT: %d lines filtered\r", iy+1);
-	    }
-	fprintf (stderr,"\n");
-	free (vi4);
-	vi4 = NULL;
 	}
     else if (bitpix == -32) {
-	float *b1, *b2, *buffout;
-	buffret = (char *) calloc (npix, sizeof (float));
-	buffout = (float *) buffret;
-	b1 = (float *) buff;
-	b2 = buffout;
 	bpvalr4 = (float) bpval;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = medpixr4 (buff, *b1++, ix, iy, nx, ny, ndx, ndy);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"MEDFILT: %d lines filtered\r", iy+1);
-	    }
-	fprintf (stderr,"\n");
-	free (vr4);
-	vr4 = NULL;
+	buffret = (char *) calloc (npix, sizeof (float));
 	}
-    else if (bitpix == -64) {
-	double *b1, *b2, *buffout;
+    else if (bitpix == -64)
 	buffret = (char *) calloc (npix, sizeof (double));
-	buffout = (double *) buffret;
-	b1 = (double *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = medpixr8 (buff, *b1++, ix, iy, nx, ny, ndx, ndy);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"MEDFILT: %d lines filtered\r", iy+1);
-	    }
-	fprintf (stderr,"\n");
-	free (vr8);
-	vr8 = NULL;
+    if (buffret == NULL)
+	return (NULL);
+
+    if (filtbands (medband, buff, buffret, bitpix, nx, ny, ndx, ndy)) {
+	fprintf (stderr, "MEDFILT: Could not allocate filter buffers\n");
+	free (buffret);
+	return (NULL);
 	}
     if (nlog > 0)
-	fprintf (stderr,"MEDFILT: %d lines filtered\n", iy);
+	fprintf (stderr,"MEDFILT: %d lines filtered\n", ny);
     return (buffret);
 }
 
@@ -830,7 +821,7 @@ int	ndy;	/* Number of rows over which to compute the median */
     int jx, jx1, jx2, jy, jy1, jy2;
 
     /* Allocate working buffer if it hasn't already been allocated */
-    npix = ndx * ndy;
+    npix = (2 * (ndx / 2) + 1) * (2 * (ndy / 2) + 1);
     if (vi2 == NULL) {
 	vi2 = (short *) calloc (npix, sizeof (short));
 	if (vi2 == NULL) {
@@ -883,10 +874,10 @@ int	ndy;	/* Number of rows over which to compute the median */
 
     /* Sort numbers in working vector */
     else {
-	for (j = 2; j <= n; j++) {
+	for (j = 1; j < n; j++) {
 	    xx = vi2[j];
 	    i = j - 1;
-	    while (i > 0 && vi2[i] > xx) {
+	    while (i >= 0 && vi2[i] > xx) {
 		vi2[i+1] = vi2[i];
 		i--;
 		}
@@ -918,7 +909,7 @@ int	ndy;	/* Number of rows over which to compute the median */
     int jx, jx1, jx2, jy, jy1, jy2;
 
     /* Allocate working buffer if it hasn't already been allocated */
-    npix = ndx * ndy;
+    npix = (2 * (ndx / 2) + 1) * (2 * (ndy / 2) + 1);
     if (vi4 == NULL) {
 	vi4 = (int *) calloc (npix, sizeof (int));
 	if (vi4 == NULL) {
@@ -971,10 +962,10 @@ int	ndy;	/* Number of rows over which to compute the median */
 
     /* Sort numbers in working vector */
     else {
-	for (j = 2; j <= n; j++) {
+	for (j = 1; j < n; j++) {
 	    xx = vi4[j];
 	    i = j - 1;
-	    while (i > 0 && vi4[i] > xx) {
+	    while (i >= 0 && vi4[i] > xx) {
 		vi4[i+1] = vi4[i];
 		i--;
 		}
@@ -1004,7 +995,7 @@ int	ndy;	/* Number of rows over which to compute the median */
     int jx, jx1, jx2, jy, jy1, jy2;
 
     /* Allocate working buffer if it hasn't already been allocated */
-    npix = ndx * ndy;
+    npix = (2 * (ndx / 2) + 1) * (2 * (ndy / 2) + 1);
     if (vr4 == NULL) {
 	vr4 = (float *) calloc (npix, sizeof (float));
 	if (vr4 == NULL) {
@@ -1057,10 +1048,10 @@ int	ndy;	/* Number of rows over which to compute the median */
 
     /* Sort numbers in working vector */
     else {
-	for (j = 2; j <= n; j++) {
+	for (j = 1; j < n; j++) {
 	    xx = vr4[j];
 	    i = j - 1;
-	    while (i > 0 && vr4[i] > xx) {
+	    while (i >= 0 && vr4[i] > xx) {
 		vr4[i+1] = vr4[i];
 		i--;
 		}
@@ -1090,7 +1081,7 @@ int	ndy;	/* Number of rows over which to compute the median */
     int jx, jx1, jx2, jy, jy1, jy2;
 
     /* Allocate working buffer if it hasn't already been allocated */
-    npix = ndx * ndy;
+    npix = (2 * (ndx / 2) + 1) * (2 * (ndy / 2) + 1);
     if (vr8 == NULL) {
 	vr8 = (double *) calloc (npix, sizeof (double));
 	if (vr8 == NULL) {
@@ -1143,10 +1134,10 @@ int	ndy;	/* Number of rows over which to compute the median */
 
     /* Sort numbers in working vector */
     else {
-	for (j = 2; j <= n; j++) {
+	for (j = 1; j < n; j++) {
 	    xx = vr8[j];
 	    i = j - 1;
-	    while (i > 0 && vr8[i] > xx) {
+	    while (i >= 0 && vr8[i] > xx) {
 		vr8[i+1] = vr8[i];
 		i--;
 		}
@@ -1159,6 +1150,524 @@ int	ndy;	/* Number of rows over which to compute the median */
 }
 
 
+/* Filter an image one band of rows per thread, or one band of columns for
+   gaussiircol(), returning 0 if every band was filtered or -1 if buffers
+   could not be allocated */
+
+static int
+filtbands (filter, buff, buffout, bitpix, nx, ny, ndx, ndy)
+
+void	*(*filter)();	/* Filter for one band, medband(), meanband(), ... */
+char	*buff;		/* Image buffer */
+char	*buffout;	/* Filtered image buffer (returned) */
+int	bitpix;		/* Number of bits per pixel (<0=floating point) */
+int	nx,ny;		/* Number of columns and rows in image */
+int	ndx;		/* Number of columns in filter box */
+int	ndy;		/* Number of rows in filter box */
+{
+    struct FiltBand *band;
+    int i, nband, status, nrank;
+    int *rank, *order;
+#ifdef _REENTRANT
+    int nsplit;		/* Rows, or columns for gaussiircol(), to split */
+#endif
+
+    /* Medians of types other than 16-bit integers are found by rank */
+    rank = NULL;
+    order = NULL;
+    nrank = 0;
+    if (filter == medband && bitpix != 16 &&
+	(2*(ndx/2) + 1) * (2*(ndy/2) + 1) > MEDSMALL) {
+	rank = (int *) malloc (nx * ny * sizeof (int));
+	order = (int *) malloc (nx * ny * sizeof (int));
+	if (rank == NULL || order == NULL) {
+	    if (rank != NULL)
+		free (rank);
+	    if (order != NULL)
+		free (order);
+	    return (-1);
+	    }
+	nrank = filtrank (buff, bitpix, nx * ny, rank, order);
+	}
+
+    nband = 1;
+#ifdef _REENTRANT
+    nsplit = (filter == gaussiircol) ? nx : ny;
+    nband = nfthread;
+    if (nband < 1)
+	nband = (int) sysconf (_SC_NPROCESSORS_ONLN);
+    if (nband > nsplit)
+	nband = nsplit;
+    if (nband < 1)
+	nband = 1;
+#endif
+    band = (struct FiltBand *) calloc (nband, sizeof (struct FiltBand));
+    if (band == NULL) {
+	if (rank != NULL) {
+	    free (rank);
+	    free (order);
+	    }
+	return (-1);
+	}
+    for (i = 0; i < nband; i++) {
+	band[i].buff = buff;
+	band[i].buffout = buffout;
+	band[i].bitpix = bitpix;
+	band[i].nx = nx;
+	band[i].ny = ny;
+	band[i].ndx = ndx;
+	band[i].ndy = ndy;
+	band[i].ix1 = 0;
+	band[i].ix2 = nx;
+	band[i].iy1 = 0;
+	band[i].iy2 = ny;
+	if (filter == gaussiircol) {
+	    band[i].ix1 = (int) (((double) nx * i) / nband);
+	    band[i].ix2 = (int) (((double) nx * (i+1)) / nband);
+	    }
+	else {
+	    band[i].iy1 = (int) (((double) ny * i) / nband);
+	    band[i].iy2 = (int) (((double) ny * (i+1)) / nband);
+	    }
+	band[i].rank = rank;
+	band[i].order = order;
+	band[i].nrank = nrank;
+	}
+
+#ifdef _REENTRANT
+    if (nband > 1) {
+	pthread_t *threads;
+	int *started;
+	threads = (pthread_t *) calloc (nband, sizeof (pthread_t));
+	started = (int *) calloc (nband, sizeof (int));
+	for (i = 1; i < nband; i++) {
+	    if (threads != NULL && started != NULL)
+		started[i] = !pthread_create (&threads[i], NULL, filter,
+					      (void *) (band+i));
+	    }
+	(void) filter ((void *) band);
+	for (i = 1; i < nband; i++) {
+	    if (started != NULL && started[i])
+		pthread_join (threads[i], NULL);
+	    else
+		(void) filter ((void *) (band+i));
+	    }
+	if (threads != NULL)
+	    free (threads);
+	if (started != NULL)
+	    free (started);
+	}
+    else
+#endif
+	(void) filter ((void *) band);
+
+    status = 0;
+    for (i = 0; i < nband; i++) {
+	if (band[i].status)
+	    status = -1;
+	}
+    free (band);
+    if (rank != NULL) {
+	free (rank);
+	free (order);
+	}
+    return (status);
+}
+
+
+/* Image sorted by filtrank(); qsort() passes nothing else to rankcomp() */
+static char *rankbuff;
+static int rankbitpix;
+
+static int
+rankcomp (p1, p2)
+
+const void *p1, *p2;	/* Pointers to indices of pixels to compare */
+{
+    int i1 = *(const int *) p1;
+    int i2 = *(const int *) p2;
+    double v1, v2;
+
+    switch (rankbitpix) {
+	case 32:
+	    v1 = (double) ((int *)rankbuff)[i1];
+	    v2 = (double) ((int *)rankbuff)[i2];
+	    break;
+	case -32:
+	    v1 = (double) ((float *)rankbuff)[i1];
+	    v2 = (double) ((float *)rankbuff)[i2];
+	    break;
+	default:
+	    v1 = ((double *)rankbuff)[i1];
+	    v2 = ((double *)rankbuff)[i2];
+	    break;
+	}
+    if (v1 < v2)
+	return (-1);
+    else if (v1 > v2)
+	return (1);
+    else
+	return ((i1 > i2) - (i1 < i2));
+}
+
+
+/* Rank the good pixels of an image by value, ties by position, returning
+   the number ranked.  BLANK and NaN pixels get rank -1. */
+
+static int
+filtrank (buff, bitpix, npix, rank, order)
+
+char	*buff;	/* Image buffer */
+int	bitpix;	/* Number of bits per pixel (<0=floating point) */
+int	npix;	/* Number of pixels in image */
+int	*rank;	/* Rank of each pixel (returned) */
+int	*order;	/* Index of pixel with each rank (returned) */
+{
+    int i, n;
+    double v;
+
+    n = 0;
+    for (i = 0; i < npix; i++) {
+	rank[i] = -1;
+	if (filtpix (buff, bitpix, i, &v) && v == v)
+	    order[n++] = i;
+	}
+    rankbuff = buff;
+    rankbitpix = bitpix;
+    qsort ((void *) order, n, sizeof (int), rankcomp);
+    for (i = 0; i < n; i++)
+	rank[order[i]] = i;
+    return (n);
+}
+
+
+/* Return 1 and set *v to pixel i of an image buffer, or 0 if it is BLANK */
+
+static int
+filtpix (buff, bitpix, i, v)
+
+char	*buff;	/* Image buffer */
+int	bitpix;	/* Number of bits per pixel (<0=floating point) */
+int	i;	/* Pixel index */
+double	*v;	/* Pixel value (returned) */
+{
+    switch (bitpix) {
+	case 16:
+	    if (((short *)buff)[i] == bpvali2)
+		return (0);
+	    *v = (double) ((short *)buff)[i];
+	    return (1);
+	case 32:
+	    if (((int *)buff)[i] == bpvali4)
+		return (0);
+	    *v = (double) ((int *)buff)[i];
+	    return (1);
+	case -32:
+	    if (((float *)buff)[i] == bpvalr4)
+		return (0);
+	    *v = (double) ((float *)buff)[i];
+	    return (1);
+	case -64:
+	    if (((double *)buff)[i] == bpval)
+		return (0);
+	    *v = ((double *)buff)[i];
+	    return (1);
+	default:
+	    return (0);
+	}
+}
+
+
+/* Read n pixels from pixel i of an image buffer with getvec(), setting
+   good to 1 for those which are not BLANK or NaN, and to 0 with the pixel
+   value 0 for those which are */
+
+static void
+filtrow (buff, bitpix, i, n, v, good)
+
+char	*buff;	/* Image buffer */
+int	bitpix;	/* Number of bits per pixel (<0=floating point) */
+int	i;	/* Index of first pixel */
+int	n;	/* Number of pixels */
+double	*v;	/* Pixel values (returned) */
+double	*good;	/* 1.0 if pixel is not BLANK or NaN, else 0.0 (returned) */
+{
+    double blank;
+    int k;
+
+    switch (bitpix) {
+	case 16:
+	    blank = (double) bpvali2;
+	    break;
+	case 32:
+	    blank = (double) bpvali4;
+	    break;
+	case -32:
+	    blank = (double) bpvalr4;
+	    break;
+	default:
+	    blank = bpval;
+	    break;
+	}
+    getvec (buff, bitpix, 0.0, 1.0, i, n, v);
+    for (k = 0; k < n; k++) {
+	if (v[k] == blank || v[k] != v[k]) {
+	    good[k] = 0.0;
+	    v[k] = 0.0;
+	    }
+	else
+	    good[k] = 1.0;
+	}
+    return;
+}
+
+
+/* Set pixel i of the filtered image to v, or to the input pixel if no
+   pixel in the box was good */
+
+static void
+filtput (fb, i, n, v)
+
+struct FiltBand *fb;	/* Band being filtered */
+int	i;		/* Pixel index */
+int	n;		/* Number of good pixels in box */
+double	v;		/* Filtered value */
+{
+    switch (fb->bitpix) {
+	case 16:
+	    ((short *)fb->buffout)[i] = n ? (short) v : ((short *)fb->buff)[i];
+	    break;
+	case 32:
+	    ((int *)fb->buffout)[i] = n ? (int) v : ((int *)fb->buff)[i];
+	    break;
+	case -32:
+	    ((float *)fb->buffout)[i] = n ? (float) v : ((float *)fb->buff)[i];
+	    break;
+	case -64:
+	    ((double *)fb->buffout)[i] = n ? v : ((double *)fb->buff)[i];
+	    break;
+	}
+    return;
+}
+
+
+/* Median filter one band of rows.  A box sliding along each row keeps a
+ * histogram of its pixels, so each step only drops one column of the box
+ * and adds another instead of sorting it again, and the median moves from
+ * where it was on the previous step.  16-bit integers are binned by value;
+ * other types are binned by rank from filtrank(), one bit per rank with
+ * counts for every 32, 1024 and 32768 ranks to skip quickly to the median.
+ * Boxes of MEDSMALL pixels or fewer are simply sorted at each pixel.
+ */
+
+static void *
+medband (arg)
+
+void	*arg;	/* Band of rows to filter (struct FiltBand *) */
+{
+    struct FiltBand *fb = (struct FiltBand *) arg;
+    int nx = fb->nx;
+    int ny = fb->ny;
+    int nx2 = fb->ndx / 2;
+    int ny2 = fb->ndy / 2;
+    int *hist = NULL;		/* Histogram of 16-bit box, offset by 32768 */
+    unsigned int *rbit = NULL;	/* Bit set for each rank in box */
+    unsigned char *rcnt = NULL;	/* Number of ranks in box per 32 */
+    unsigned short *rsup = NULL; /* Number of ranks in box per 1024 */
+    int *rtop = NULL;		/* Number of ranks in box per 32768 */
+    unsigned int w;
+    double v;
+    short *img;
+    int ix, iy, jx, jy, jy1, jy2, n, k, m, lt, c, b, r, add, nw;
+
+    fb->status = 0;
+    if (fb->ndx * fb->ndy <= 0)
+	return (NULL);
+    if ((2*nx2 + 1) * (2*ny2 + 1) <= MEDSMALL)
+	return (medsmall (fb));
+    if (fb->bitpix == 16)
+	hist = (int *) calloc (65536, sizeof (int));
+    else {
+	nw = fb->nrank / 32 + 1;
+	rbit = (unsigned int *) calloc (nw, sizeof (unsigned int));
+	rcnt = (unsigned char *) calloc (nw, sizeof (unsigned char));
+	rsup = (unsigned short *) calloc (nw/32 + 1, sizeof (unsigned short));
+	rtop = (int *) calloc (nw/1024 + 1, sizeof (int));
+	}
+    if (hist == NULL &&
+	(rbit == NULL || rcnt == NULL || rsup == NULL || rtop == NULL)) {
+	if (rbit != NULL)
+	    free (rbit);
+	if (rcnt != NULL)
+	    free (rcnt);
+	if (rsup != NULL)
+	    free (rsup);
+	if (rtop != NULL)
+	    free (rtop);
+	fb->status = -1;
+	return (NULL);
+	}
+    img = (short *) fb->buff;
+
+    for (iy = fb->iy1; iy < fb->iy2; iy++) {
+	jy1 = iy - ny2;
+	if (jy1 < 0)
+	    jy1 = 0;
+	jy2 = iy + ny2 + 1;
+	if (jy2 > ny)
+	    jy2 = ny;
+
+	/* m is the histogram bin or 32768-rank block holding the median of
+	   the last step and lt is the number of pixels below it */
+	n = 0;
+	m = 0;
+	lt = 0;
+
+	/* The box is empty again when the last column has been dropped */
+	for (ix = -nx2 - 1; ix <= nx + nx2; ix++) {
+
+	    /* Drop the column leaving the box and add the one entering it */
+	    for (add = 0; add <= 1; add++) {
+		jx = add ? ix + nx2 : ix - nx2 - 1;
+		if (jx < 0 || jx >= nx)
+		    continue;
+		for (jy = jy1; jy < jy2; jy++) {
+		    if (hist != NULL) {
+			if (img[jy*nx + jx] == bpvali2)
+			    continue;
+			b = (int) img[jy*nx + jx] + 32768;
+			hist[b] = add ? hist[b] + 1 : hist[b] - 1;
+			}
+		    else {
+			r = fb->rank[jy*nx + jx];
+			if (r < 0)
+			    continue;
+			if (add) {
+			    rbit[r >> 5] |= 1U << (r & 31);
+			    rcnt[r >> 5]++;
+			    rsup[r >> 10]++;
+			    rtop[r >> 15]++;
+			    }
+			else {
+			    rbit[r >> 5] &= ~(1U << (r & 31));
+			    rcnt[r >> 5]--;
+			    rsup[r >> 10]--;
+			    rtop[r >> 15]--;
+			    }
+			b = r >> 15;
+			}
+		    n = add ? n + 1 : n - 1;
+		    if (b < m)
+			lt = add ? lt + 1 : lt - 1;
+		    }
+		}
+	    if (ix < 0 || ix >= nx)
+		continue;
+
+	    /* Median is the middle of the good pixels in the box */
+	    v = 0.0;
+	    if (n > 0) {
+		k = n / 2;
+		if (hist != NULL) {
+		    while (lt > k) {
+			m--;
+			lt = lt - hist[m];
+			}
+		    while (lt + hist[m] <= k) {
+			lt = lt + hist[m];
+			m++;
+			}
+		    v = (double) (m - 32768);
+		    }
+		else {
+		    while (lt > k) {
+			m--;
+			lt = lt - rtop[m];
+			}
+		    while (lt + rtop[m] <= k) {
+			lt = lt + rtop[m];
+			m++;
+			}
+
+		    /* Find the 1024-rank block, the 32-rank word, then the bit */
+		    c = lt;
+		    b = m * 32;
+		    while (c + rsup[b] <= k) {
+			c = c + rsup[b];
+			b++;
+			}
+		    b = b * 32;
+		    while (c + rcnt[b] <= k) {
+			c = c + rcnt[b];
+			b++;
+			}
+		    w = rbit[b];
+		    for (; c < k; c++)
+			w = w & (w - 1);
+		    r = b * 32;
+		    while (!(w & 1U)) {
+			w = w >> 1;
+			r++;
+			}
+		    filtpix (fb->buff, fb->bitpix, fb->order[r], &v);
+		    }
+		}
+	    filtput (fb, iy*nx + ix, n, v);
+	    }
+	}
+
+    if (hist != NULL)
+	free (hist);
+    if (rbit != NULL) {
+	free (rbit);
+	free (rcnt);
+	free (rsup);
+	free (rtop);
+	}
+    return (NULL);
+}
+
+
+/* Median filter one band of rows with a box of MEDSMALL pixels or fewer */
+
+static void *
+medsmall (fb)
+
+struct FiltBand *fb;	/* Band being filtered */
+{
+    int nx = fb->nx;
+    int ny = fb->ny;
+    int nx2 = fb->ndx / 2;
+    int ny2 = fb->ndy / 2;
+    double v, vec[MEDSMALL];
+    int ix, iy, jx, jy, i, n;
+
+    for (iy = fb->iy1; iy < fb->iy2; iy++) {
+	for (ix = 0; ix < nx; ix++) {
+
+	    /* Insert the good pixels of the box in order */
+	    n = 0;
+	    for (jy = iy - ny2; jy <= iy + ny2; jy++) {
+		if (jy < 0 || jy >= ny)
+		    continue;
+		for (jx = ix - nx2; jx <= ix + nx2; jx++) {
+		    if (jx < 0 || jx >= nx)
+			continue;
+		    if (!filtpix (fb->buff, fb->bitpix, jy*nx + jx, &v) || v != v)
+			continue;
+		    for (i = n; i > 0 && vec[i-1] > v; i--)
+			vec[i] = vec[i-1];
+		    vec[i] = v;
+		    n++;
+		    }
+		}
+	    filtput (fb, iy*nx + ix, n, n > 0 ? vec[n/2] : 0.0);
+	    }
+	}
+    return (NULL);
+}
+
+
 /* Mean filter an image */
 
 char *
@@ -1173,7 +1682,6 @@ int	nlog;	/* Logging interval in pixels */
 {
 char	*buffret;	/* Modified image buffer (returned) */
 int	nx,ny;	/* Number of columns and rows in image */
-int	ix,iy;	/* Pixel around which to compute mean */
 int	npix;	/* Number of pixels in image */
 int	bitpix;	/* Number of bits per pixel (<0=floating point) */
 int	naxes;
@@ -1190,76 +1698,29 @@ int	naxes;
 
     buffret = NULL;
     if (bitpix == 16) {
-	short *b1, *b2, *buffout;
 	bpvali2 = (short) bpval;
-	vi2 = NULL;
 	buffret = (char *) calloc (npix, sizeof (short));
-	buffout = (short *) buffret;
-	b1 = (short *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = meanpixi2 (buff, *b1++, ix, iy, nx, ny, ndx, ndy);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"MEANFILT: %d lines filtered\r", iy+1);
-	    }
-	free (vi2);
-	vi2 = NULL;
 	}
     else if (bitpix == 32) {
-	int *b1, *b2, *buffout;
 	bpvali4 = (int) bpval;
-	vi4 = NULL;
 	buffret = (char *) calloc (npix, sizeof (int));
-	buffout = (int *) buffret;
-	b1 = (int *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = meanpixi4 (buff, *b1++, ix, iy, nx, ny, ndx, ndy);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"MEANFILT: %d lines filtered\r", iy+1);
-	    }
-	free (vi4);
-	vi4 = NULL;
 	}
     else if (bitpix == -32) {
-	float *b1, *b2, *buffout;
-	buffret = (char *) calloc (npix, sizeof (float));
-	buffout = (float *) buffret;
 	bpvalr4 = (float) bpval;
-	b1 = (float *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = meanpixr4 (buff, *b1++, ix, iy, nx, ny, ndx, ndy);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"MEANFILT: %d lines filtered\r", iy+1);
-	    }
-	free (vr4);
-	vr4 = NULL;
+	buffret = (char *) calloc (npix, sizeof (float));
 	}
-    else if (bitpix == -64) {
-	double *b1, *b2, *buffout;
+    else if (bitpix == -64)
 	buffret = (char *) calloc (npix, sizeof (double));
-	buffout = (double *) buffret;
-	b1 = (double *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = meanpixr8 (buff, *b1++, ix, iy, nx, ny, ndx, ndy);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"MEANFILT: %d lines filtered\r", iy+1);
-	    }
-	free (vr8);
-	vr8 = NULL;
+    if (buffret == NULL)
+	return (NULL);
+
+    if (filtbands (meanband, buff, buffret, bitpix, nx, ny, ndx, ndy)) {
+	fprintf (stderr, "MEANFILT: Could not allocate filter buffers\n");
+	free (buffret);
+	return (NULL);
 	}
     if (nlog > 0)
-	fprintf (stderr,"MEANFILT: %d lines filtered\n", iy);
+	fprintf (stderr,"MEANFILT: %d lines filtered\n", ny);
     return (buffret);
 }
 
@@ -1637,6 +2098,133 @@ int	ndy;	/* Number of rows over which to compute the median */
 }
 
 
+/* Mean filter one band of rows.  Column sums over the box height are
+ * updated by adding the row entering the box and subtracting the one
+ * leaving it, and the box sum is slid along each row the same way.  Both
+ * are summed afresh every FILTRESUM steps so rounding cannot build up in
+ * floating point images.
+ */
+
+#define FILTRESUM	64
+
+static void *
+meanband (arg)
+
+void	*arg;	/* Band of rows to filter (struct FiltBand *) */
+{
+    struct FiltBand *fb = (struct FiltBand *) arg;
+    int nx = fb->nx;
+    int ny = fb->ny;
+    int nx2 = fb->ndx / 2;
+    int ny2 = fb->ndy / 2;
+    double *colsum;	/* Sum of good pixels in each column of the box */
+    int *colnum;	/* Number of good pixels in each column of the box */
+    double *v, *good;	/* Row of pixels and flags from filtrow() */
+    double sum;
+    int ix, iy, jx, jx1, jx2, jy, jy1, jy2, n;
+
+    fb->status = 0;
+    if (fb->ndx * fb->ndy <= 0)
+	return (NULL);
+    colsum = (double *) calloc (nx, sizeof (double));
+    colnum = (int *) calloc (nx, sizeof (int));
+    v = (double *) calloc (nx * 2, sizeof (double));
+    if (colsum == NULL || colnum == NULL || v == NULL) {
+	if (colsum != NULL)
+	    free (colsum);
+	if (colnum != NULL)
+	    free (colnum);
+	if (v != NULL)
+	    free (v);
+	fb->status = -1;
+	return (NULL);
+	}
+    good = v + nx;
+
+    for (iy = fb->iy1; iy < fb->iy2; iy++) {
+	jy1 = iy - ny2;
+	if (jy1 < 0)
+	    jy1 = 0;
+	jy2 = iy + ny2 + 1;
+	if (jy2 > ny)
+	    jy2 = ny;
+
+	/* Sum the columns of the box afresh */
+	if ((iy - fb->iy1) % FILTRESUM == 0) {
+	    for (ix = 0; ix < nx; ix++) {
+		colsum[ix] = 0.0;
+		colnum[ix] = 0;
+		}
+	    for (jy = jy1; jy < jy2; jy++) {
+		filtrow (fb->buff, fb->bitpix, jy*nx, nx, v, good);
+		for (ix = 0; ix < nx; ix++) {
+		    colsum[ix] = colsum[ix] + v[ix];
+		    colnum[ix] = colnum[ix] + (int) good[ix];
+		    }
+		}
+	    }
+
+	/* Add the row entering the box and drop the one leaving it */
+	else {
+	    jy = iy + ny2;
+	    if (jy < ny) {
+		filtrow (fb->buff, fb->bitpix, jy*nx, nx, v, good);
+		for (ix = 0; ix < nx; ix++) {
+		    colsum[ix] = colsum[ix] + v[ix];
+		    colnum[ix] = colnum[ix] + (int) good[ix];
+		    }
+		}
+	    jy = iy - ny2 - 1;
+	    if (jy >= 0) {
+		filtrow (fb->buff, fb->bitpix, jy*nx, nx, v, good);
+		for (ix = 0; ix < nx; ix++) {
+		    colsum[ix] = colsum[ix] - v[ix];
+		    colnum[ix] = colnum[ix] - (int) good[ix];
+		    }
+		}
+	    }
+
+	/* Slide the box along the row */
+	sum = 0.0;
+	n = 0;
+	for (ix = 0; ix < nx; ix++) {
+	    if (ix % FILTRESUM == 0) {
+		jx1 = ix - nx2;
+		if (jx1 < 0)
+		    jx1 = 0;
+		jx2 = ix + nx2 + 1;
+		if (jx2 > nx)
+		    jx2 = nx;
+		sum = 0.0;
+		n = 0;
+		for (jx = jx1; jx < jx2; jx++) {
+		    sum = sum + colsum[jx];
+		    n = n + colnum[jx];
+		    }
+		}
+	    else {
+		jx = ix + nx2;
+		if (jx < nx) {
+		    sum = sum + colsum[jx];
+		    n = n + colnum[jx];
+		    }
+		jx = ix - nx2 - 1;
+		if (jx >= 0) {
+		    sum = sum - colsum[jx];
+		    n = n - colnum[jx];
+		    }
+		}
+	    filtput (fb, iy*nx + ix, n, (n > 0) ? sum / (double) n : 0.0);
+	    }
+	}
+
+    free (colsum);
+    free (colnum);
+    free (v);
+    return (NULL);
+}
+
+
 /* Gaussian filter an image */
 
 char *
@@ -1651,7 +2239,6 @@ int	nlog;		/* Logging interval in pixels */
 {
     char *buffret;	/* Modified image buffer (returned) */
     int nx,ny;		/* Number of columns and rows in image */
-    int ix,iy;		/* Pixel around which to compute median */
     int npix;		/* Number of pixels in image */
     int bitpix;		/* Number of bits per pixel (<0=floating point) */
     int naxes;
@@ -1666,74 +2253,31 @@ int	nlog;		/* Logging interval in pixels */
     npix = nx * ny;
     hgetr8 (header, "BLANK", &bpval);
 
-    gausswt (ndx, ndy, nx);
-
     buffret = NULL;
     if (bitpix == 16) {
-	short *b1, *b2, *buffout;
 	bpvali2 = (short) bpval;
 	buffret = (char *) calloc (npix, sizeof (short));
-	buffout = (short *) buffret;
-	b1 = (short *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = gausspixi2 (buff, *b1++, ix, iy, nx, ny);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"GAUSSFILT: %d/%d lines filtered\r", iy+1,ny);
-	    }
-	fprintf (stderr,"\n");
 	}
     else if (bitpix == 32) {
-	int *b1, *b2, *buffout;
 	bpvali4 = (int) bpval;
 	buffret = (char *) calloc (npix, sizeof (int));
-	buffout = (int *) buffret;
-	b1 = (int *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = gausspixi4 (buff, *b1++, ix, iy, nx, ny);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"GAUSSFILT: %d/%d lines filtered\r", iy+1,ny);
-	}
-	fprintf (stderr,"\n");
 	}
     else if (bitpix == -32) {
-	float *b1, *b2, *buffout;
 	bpvalr4 = (float) bpval;
 	buffret = (char *) calloc (npix, sizeof (float));
-	buffout = (float *) buffret;
-	b1 = (float *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = gausspixr4 (buff, *b1++, ix, iy, nx, ny);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"GAUSSFILT: %d/%d lines filtered\r", iy+1,ny);
-	    }
-	fprintf (stderr,"\n");
 	}
-    else if (bitpix == -64) {
-	double *b1, *b2, *buffout;
+    else if (bitpix == -64)
 	buffret = (char *) calloc (npix, sizeof (double));
-	buffout = (double *) buffret;
-	b1 = (double *) buff;
-	b2 = buffout;
-	for (iy = 0; iy < ny; iy++) {
-	    for (ix = 0; ix < nx; ix++) {
-		*b2++ = gausspixr8 (buff, *b1++, ix, iy, nx, ny);
-		}
-	    if (nlog > 0 && (iy+1)%nlog == 0)
-		fprintf (stderr,"GAUSSFILT: %d/%d lines filtered\r", iy+1,ny);
-	    }
-	fprintf (stderr,"\n");
+    if (buffret == NULL)
+	return (NULL);
+
+    if (gaussbands (buff, buffret, bitpix, nx, ny, ndx, ndy)) {
+	fprintf (stderr, "GAUSSFILT: Could not allocate filter buffers\n");
+	free (buffret);
+	return (NULL);
 	}
-    if (nlog > 0 && (iy+1)%nlog == 0)
-	fprintf (stderr,"GAUSSFILT: %d/%d lines filtered\n", iy,ny);
+    if (nlog > 0)
+	fprintf (stderr,"GAUSSFILT: %d/%d lines filtered\n", ny, ny);
     return (buffret);
 }
 
@@ -1769,7 +2313,7 @@ int	naxes;
 
     nfilled = 0;
 
-    gausswt (ndx, nx);
+    gausswt (ndx, ndy, nx);
 
     buffret = NULL;
     if (bitpix == 16) {
@@ -1882,6 +2426,12 @@ setsubpix (nsubpix)
 double nsubpix;
 { nsub = nsubpix; return; }
 
+static double iirwidth = 0.0;	/* Smallest half-width filtered recursively, 0=never */
+void
+setgiirwidth (width)
+double width;
+{ iirwidth = width; return; }
+
 /* Compute Gaussian weights for a square region */
 
 void 
@@ -1891,7 +2441,7 @@ int	mx;	/* Width in pixels over which to compute the Gaussian */
 int	my;	/* Height in pixels over which to compute the Gaussian */
 int	nx;	/* Number of columns (naxis1) in image */
 {
-    int	i, idr, idc, jx, jy, jr;
+    int	i, idr, idc, jx, jy, jr, jc;
     double dsub, xd0, xd, xdr, xdc, twt, rad2;
     extern void setscale();
 
@@ -1924,7 +2474,7 @@ int	nx;	/* Number of columns (naxis1) in image */
 	    xdr = ((double) idr - xd0) / hwidth;
 	    for (jr = 0; jr < nsub; jr++) {
 		xdc = ((double)(idc) - xd0) / hwidth;
-		for (jr = 0; jr < nsub; jr++) {
+		for (jc = 0; jc < nsub; jc++) {
 		    rad2 = (xdc * xdc) + (xdr * xdr);
 		    gwt[i] = gwt[i] + exp (-rad2 / 2.0);
 		    xdc = xdc + xd;
@@ -1932,8 +2482,8 @@ int	nx;	/* Number of columns (naxis1) in image */
 		xdr = xdr + xd;
 		}
 	    twt = twt + gwt[i];
-	    iybox[i] = idc;
-	    ixbox[i] = idr;
+	    ixbox[i] = idc;
+	    iybox[i] = idr;
 	    ipbox[i] = (idr * nx) + idc;
 	    i++;
 	    }
@@ -1974,7 +2524,7 @@ int	nx,ny;	/* Number of columns and rows in image */
 	ixi = ix + ixbox[i];
 	iyi = iy + iybox[i];
 	if (ixi > -1 && iyi > -1 && ixi < nx && iyi < ny) {
-	    img = image + (iyi * ny) + ixi;
+	    img = image + (iyi * nx) + ixi;
 	    if (*img != bpvali2) {
 		flux = (double) *img;
 		twt = twt + gwt[i];
@@ -2019,7 +2569,7 @@ int	nx,ny;	/* Number of columns and rows in image */
 	ixi = ix + ixbox[i];
 	iyi = iy + iybox[i];
 	if (ixi > -1 && iyi > -1 && ixi < nx && iyi < ny) {
-	    img = image + (iyi * ny) + ixi;
+	    img = image + (iyi * nx) + ixi;
 	    if (*img != bpvali4) {
 		flux = (double) *img;
 		twt = twt + gwt[i];
@@ -2064,9 +2614,9 @@ int	nx,ny;	/* Number of columns and rows in image */
 	ixi = ix + ixbox[i];
 	iyi = iy + iybox[i];
 	if (ixi > -1 && iyi > -1 && ixi < nx && iyi < ny) {
-	    img = image + (iyi * ny) + ixi;
+	    img = image + (iyi * nx) + ixi;
 	    if (*img != bpvalr4) {
-		flux = (double) image[ixi + (iyi * ny)];
+		flux = (double) *img;
 		twt = twt + gwt[i];
 		tpix = tpix + gwt[i] * flux;
 		np++;
@@ -2109,9 +2659,9 @@ int	nx,ny;	/* Number of columns and rows in image */
 	ixi = ix + ixbox[i];
 	iyi = iy + iybox[i];
 	if (ixi > -1 && iyi > -1 && ixi < nx && iyi < ny) {
-	    img = image + (iyi * ny) + ixi;
+	    img = image + (iyi * nx) + ixi;
 	    if (*img != bpval) {
-		flux = image[ixi + (iyi * ny)];
+		flux = *img;
 		twt = twt + gwt[i];
 		tpix = tpix + gwt[i] * flux;
 		np++;
@@ -2130,6 +2680,447 @@ int	nx,ny;	/* Number of columns and rows in image */
 }
 
 
+/* Weights and buffers for gaussfilt(), which filters rows, then columns */
+
+static double *gwx = NULL;	/* Gaussian weights across ndx columns */
+static double *gwy = NULL;	/* Gaussian weights down ndy rows */
+static double giir[4];		/* Recursive filter B, b1/b0, b2/b0, b3/b0 */
+static double *giirnum = NULL;	/* Filtered sums of good pixels (recursive) */
+static double *giirden = NULL;	/* Filtered weights of good pixels (recursive) */
+static int *giircnt = NULL;	/* Good pixels in box along rows (recursive) */
+
+
+/* Compute normalized Gaussian weights along one axis of a box, as
+   gausswt() does for the whole box */
+
+static void
+gaussvec (m, g)
+
+int	m;	/* Width of box in pixels */
+double	*g;	/* Weights (returned) */
+{
+    int j, jr;
+    double dsub, xd0, xd, xdr, twt;
+
+    dsub = (double) nsub;
+    xd0 = (dsub - 1.0) / (dsub * 2.0);
+    xd = 1.0 / (hwidth * dsub);
+    twt = 0.0;
+    for (j = 0; j < m; j++) {
+	xdr = ((double) (j - m/2) - xd0) / hwidth;
+	g[j] = 0.0;
+	for (jr = 0; jr < nsub; jr++) {
+	    g[j] = g[j] + exp (-xdr * xdr / 2.0);
+	    xdr = xdr + xd;
+	    }
+	twt = twt + g[j];
+	}
+    for (j = 0; j < m; j++)
+	g[j] = g[j] / twt;
+    return;
+}
+
+
+/* Gaussian filter an image as a row pass and a column pass, with a
+ * recursive filter (Young and van Vliet 1995) instead of the box weights
+ * if the half-width is at least iirwidth.  Returns 0 if the image was
+ * filtered or -1 if buffers could not be allocated.
+ */
+
+static int
+gaussbands (buff, buffout, bitpix, nx, ny, ndx, ndy)
+
+char	*buff;		/* Image buffer */
+char	*buffout;	/* Filtered image buffer (returned) */
+int	bitpix;		/* Number of bits per pixel (<0=floating point) */
+int	nx,ny;		/* Number of columns and rows in image */
+int	ndx;		/* Number of columns in filter box */
+int	ndy;		/* Number of rows in filter box */
+{
+    double q, b0;
+    int status;
+
+    /* A box of one pixel leaves the image as it is */
+    if (ndx * ndy <= 1) {
+	memcpy (buffout, buff, nx * ny * (abs (bitpix) / 8));
+	return (0);
+	}
+
+    gwx = (double *) calloc (ndx, sizeof (double));
+    gwy = (double *) calloc (ndy, sizeof (double));
+    if (gwx == NULL || gwy == NULL) {
+	status = -1;
+	goto done;
+	}
+    gaussvec (ndx, gwx);
+    gaussvec (ndy, gwy);
+
+    if (iirwidth <= 0.0 || hwidth < iirwidth || hwidth < 0.5) {
+	status = filtbands (gaussband, buff, buffout, bitpix, nx, ny, ndx, ndy);
+	goto done;
+	}
+
+    if (hwidth >= 2.5)
+	q = 0.98711 * hwidth - 0.96330;
+    else
+	q = 3.97156 - 4.14554 * sqrt (1.0 - 0.26891 * hwidth);
+    b0 = 1.57825 + 2.44413*q + 1.4281*q*q + 0.422205*q*q*q;
+    giir[1] = (2.44413*q + 2.85619*q*q + 1.26661*q*q*q) / b0;
+    giir[2] = -(1.4281*q*q + 1.26661*q*q*q) / b0;
+    giir[3] = 0.422205*q*q*q / b0;
+    giir[0] = 1.0 - giir[1] - giir[2] - giir[3];
+
+    giirnum = (double *) malloc (nx * ny * sizeof (double));
+    giirden = (double *) malloc (nx * ny * sizeof (double));
+    giircnt = (int *) malloc (nx * ny * sizeof (int));
+    if (giirnum == NULL || giirden == NULL || giircnt == NULL)
+	status = -1;
+    else {
+	status = filtbands (gaussiirrow, buff, buffout, bitpix, nx, ny, ndx, ndy);
+	if (!status)
+	    status = filtbands (gaussiircol, buff, buffout, bitpix, nx, ny,
+				ndx, ndy);
+	}
+
+done:
+    if (gwx != NULL)
+	free (gwx);
+    if (gwy != NULL)
+	free (gwy);
+    if (giirnum != NULL)
+	free (giirnum);
+    if (giirden != NULL)
+	free (giirden);
+    if (giircnt != NULL)
+	free (giircnt);
+    gwx = NULL;
+    gwy = NULL;
+    giirnum = NULL;
+    giirden = NULL;
+    giircnt = NULL;
+    return (status);
+}
+
+
+/* Set pixel i of the Gaussian filtered image from the weighted sums of the
+   good pixels in its box, as gausspix*() would */
+
+static void
+gaussput (fb, i, np, tpix, twt, iir)
+
+struct FiltBand *fb;	/* Band being filtered */
+int	i;		/* Pixel index */
+int	np;		/* Number of good pixels in box */
+double	tpix;		/* Weighted sum of good pixels */
+double	twt;		/* Sum of weights of good pixels */
+int	iir;		/* 1 if sums are from the recursive filter */
+{
+    /* If enough surrounding pixels are good, replace the current pixel */
+    if (np > mpbox && twt > 0.0) {
+	if (iir || twt < 1.0)
+	    tpix = tpix / twt;
+	filtput (fb, i, 1, tpix);
+	}
+    else
+	filtput (fb, i, 0, 0.0);
+    return;
+}
+
+
+/* Set one row of good pixel values and flags, with BLANK and NaN pixels 0,
+   and the number of good pixels in the box along the row around each */
+
+static void
+gaussgood (fb, iy, pix, good, cnt)
+
+struct FiltBand *fb;	/* Band being filtered */
+int	iy;		/* Row of image */
+double	*pix;		/* Good pixel values (returned) */
+double	*good;		/* 1.0 for good pixels, else 0.0 (returned) */
+int	*cnt;		/* Good pixels in box along row (returned) */
+{
+    int nx = fb->nx;
+    int lox = -(fb->ndx / 2);
+    int hix = lox + fb->ndx - 1;
+    int ix, j, c;
+
+    filtrow (fb->buff, fb->bitpix, iy*nx, nx, pix, good);
+
+    /* Box around ix runs from ix+lox to ix+hix */
+    c = 0;
+    for (ix = 0; ix < hix && ix < nx; ix++)
+	c = c + (int) good[ix];
+    for (ix = 0; ix < nx; ix++) {
+	j = ix + hix;
+	if (j < nx)
+	    c = c + (int) good[j];
+	j = ix + lox - 1;
+	if (j >= 0)
+	    c = c - (int) good[j];
+	cnt[ix] = c;
+	}
+    return;
+}
+
+
+/* Gaussian filter one band of rows.  Each image row is filtered once
+ * along the row into a ring of the last ndy rows, and each output row is
+ * the sum of those down the columns, so a pixel costs ndx + ndy products
+ * rather than ndx * ndy.  The inner loops run along rows without branches
+ * so that the compiler can vectorize them.
+ */
+
+static void *
+gaussband (arg)
+
+void	*arg;	/* Band of rows to filter (struct FiltBand *) */
+{
+    struct FiltBand *fb = (struct FiltBand *) arg;
+    int nx = fb->nx;
+    int ny = fb->ny;
+    int ndx = fb->ndx;
+    int ndy = fb->ndy;
+    int lox = -(ndx / 2);
+    int loy = -(ndy / 2);
+    double *pix, *good, *rnum, *rden, *snum, *sden, *hn, *hd, w;
+    int *rcnt, *scnt, *hc;
+    int ix, iy, jy, jlast, jnext, k, off, ix1, ix2;
+
+    fb->status = 0;
+    pix = (double *) malloc (nx * 4 * sizeof (double));
+    rnum = (double *) malloc (nx * ndy * 2 * sizeof (double));
+    rcnt = (int *) malloc (nx * (ndy + 1) * sizeof (int));
+    if (pix == NULL || rnum == NULL || rcnt == NULL) {
+	if (pix != NULL)
+	    free (pix);
+	if (rnum != NULL)
+	    free (rnum);
+	if (rcnt != NULL)
+	    free (rcnt);
+	fb->status = -1;
+	return (NULL);
+	}
+    good = pix + nx;
+    snum = good + nx;
+    sden = snum + nx;
+    rden = rnum + nx * ndy;
+    scnt = rcnt + nx * ndy;
+
+    jnext = fb->iy1 + loy;
+    if (jnext < 0)
+	jnext = 0;
+    for (iy = fb->iy1; iy < fb->iy2; iy++) {
+
+	/* Filter the rows entering the box along the row */
+	jlast = iy + loy + ndy - 1;
+	if (jlast > ny - 1)
+	    jlast = ny - 1;
+	for (; jnext <= jlast; jnext++) {
+	    hn = rnum + (jnext % ndy) * nx;
+	    hd = rden + (jnext % ndy) * nx;
+	    hc = rcnt + (jnext % ndy) * nx;
+	    gaussgood (fb, jnext, pix, good, hc);
+	    for (ix = 0; ix < nx; ix++) {
+		hn[ix] = 0.0;
+		hd[ix] = 0.0;
+		}
+	    for (k = 0; k < ndx; k++) {
+		w = gwx[k];
+		off = lox + k;
+		ix1 = (off < 0) ? -off : 0;
+		ix2 = (off > 0) ? nx - off : nx;
+		for (ix = ix1; ix < ix2; ix++) {
+		    hn[ix] = hn[ix] + w * pix[ix+off];
+		    hd[ix] = hd[ix] + w * good[ix+off];
+		    }
+		}
+	    }
+
+	/* Sum the rows of the box down the columns */
+	for (ix = 0; ix < nx; ix++) {
+	    snum[ix] = 0.0;
+	    sden[ix] = 0.0;
+	    scnt[ix] = 0;
+	    }
+	for (k = 0; k < ndy; k++) {
+	    jy = iy + loy + k;
+	    if (jy < 0 || jy >= ny)
+		continue;
+	    w = gwy[k];
+	    hn = rnum + (jy % ndy) * nx;
+	    hd = rden + (jy % ndy) * nx;
+	    hc = rcnt + (jy % ndy) * nx;
+	    for (ix = 0; ix < nx; ix++) {
+		snum[ix] = snum[ix] + w * hn[ix];
+		sden[ix] = sden[ix] + w * hd[ix];
+		scnt[ix] = scnt[ix] + hc[ix];
+		}
+	    }
+	for (ix = 0; ix < nx; ix++)
+	    gaussput (fb, iy*nx + ix, scnt[ix], snum[ix], sden[ix], 0);
+	}
+
+    free (pix);
+    free (rnum);
+    free (rcnt);
+    return (NULL);
+}
+
+
+/* Run the recursive Gaussian forward and back along n values */
+
+static void
+gaussiir (v, n)
+
+double	*v;	/* Values to filter in place */
+int	n;	/* Number of values */
+{
+    double b = giir[0], a1 = giir[1], a2 = giir[2], a3 = giir[3];
+    double w1, w2, w3;
+    int i;
+
+    /* Pixels off the edge of the image are blank, so start from 0 */
+    w1 = w2 = w3 = 0.0;
+    for (i = 0; i < n; i++) {
+	v[i] = b * v[i] + a1 * w1 + a2 * w2 + a3 * w3;
+	w3 = w2;
+	w2 = w1;
+	w1 = v[i];
+	}
+    w1 = w2 = w3 = 0.0;
+    for (i = n - 1; i >= 0; i--) {
+	v[i] = b * v[i] + a1 * w1 + a2 * w2 + a3 * w3;
+	w3 = w2;
+	w2 = w1;
+	w1 = v[i];
+	}
+    return;
+}
+
+
+/* Recursively Gaussian filter one band of rows along the rows */
+
+static void *
+gaussiirrow (arg)
+
+void	*arg;	/* Band of rows to filter (struct FiltBand *) */
+{
+    struct FiltBand *fb = (struct FiltBand *) arg;
+    int nx = fb->nx;
+    int iy;
+    double *good;
+
+    fb->status = 0;
+    good = (double *) malloc (nx * sizeof (double));
+    if (good == NULL) {
+	fb->status = -1;
+	return (NULL);
+	}
+    for (iy = fb->iy1; iy < fb->iy2; iy++) {
+	gaussgood (fb, iy, giirnum + iy*nx, good, giircnt + iy*nx);
+	memcpy (giirden + iy*nx, good, nx * sizeof (double));
+	gaussiir (giirnum + iy*nx, nx);
+	gaussiir (giirden + iy*nx, nx);
+	}
+    free (good);
+    return (NULL);
+}
+
+
+/* Run the recursive Gaussian forward and back down columns ix1 through
+   ix2-1 of an nx by ny array, a row at a time */
+
+static void
+gaussiirdown (v, nx, ny, ix1, ix2, zero)
+
+double	*v;		/* Values to filter in place */
+int	nx, ny;		/* Number of columns and rows */
+int	ix1, ix2;	/* Columns to filter */
+double	*zero;		/* nx zeros for rows off the edge */
+{
+    double b = giir[0], a1 = giir[1], a2 = giir[2], a3 = giir[3];
+    double *w0, *w1, *w2, *w3;
+    int ix, iy;
+
+    w1 = w2 = w3 = zero;
+    for (iy = 0; iy < ny; iy++) {
+	w0 = v + iy * nx;
+	for (ix = ix1; ix < ix2; ix++)
+	    w0[ix] = b * w0[ix] + a1 * w1[ix] + a2 * w2[ix] + a3 * w3[ix];
+	w3 = w2;
+	w2 = w1;
+	w1 = w0;
+	}
+    w1 = w2 = w3 = zero;
+    for (iy = ny - 1; iy >= 0; iy--) {
+	w0 = v + iy * nx;
+	for (ix = ix1; ix < ix2; ix++)
+	    w0[ix] = b * w0[ix] + a1 * w1[ix] + a2 * w2[ix] + a3 * w3[ix];
+	w3 = w2;
+	w2 = w1;
+	w1 = w0;
+	}
+    return;
+}
+
+
+/* Recursively Gaussian filter one band of columns down the columns after
+   gaussiirrow() has filtered every row */
+
+static void *
+gaussiircol (arg)
+
+void	*arg;	/* Band of columns to filter (struct FiltBand *) */
+{
+    struct FiltBand *fb = (struct FiltBand *) arg;
+    int nx = fb->nx;
+    int ny = fb->ny;
+    int loy = -(fb->ndy / 2);
+    int hiy = loy + fb->ndy - 1;
+    int ix, iy, j, *cnt;
+    double *zero;
+
+    fb->status = 0;
+    zero = (double *) calloc (nx, sizeof (double));
+    cnt = (int *) calloc (nx, sizeof (int));
+    if (zero == NULL || cnt == NULL) {
+	if (zero != NULL)
+	    free (zero);
+	if (cnt != NULL)
+	    free (cnt);
+	fb->status = -1;
+	return (NULL);
+	}
+    gaussiirdown (giirnum, nx, ny, fb->ix1, fb->ix2, zero);
+    gaussiirdown (giirden, nx, ny, fb->ix1, fb->ix2, zero);
+
+    /* Count good pixels in the box as it moves down from iy+loy to iy+hiy */
+    for (iy = 0; iy < hiy && iy < ny; iy++) {
+	for (ix = fb->ix1; ix < fb->ix2; ix++)
+	    cnt[ix] = cnt[ix] + giircnt[iy*nx + ix];
+	}
+    for (iy = 0; iy < ny; iy++) {
+	j = iy + hiy;
+	if (j < ny) {
+	    for (ix = fb->ix1; ix < fb->ix2; ix++)
+		cnt[ix] = cnt[ix] + giircnt[j*nx + ix];
+	    }
+	j = iy + loy - 1;
+	if (j >= 0) {
+	    for (ix = fb->ix1; ix < fb->ix2; ix++)
+		cnt[ix] = cnt[ix] - giircnt[j*nx + ix];
+	    }
+	for (ix = fb->ix1; ix < fb->ix2; ix++)
+	    gaussput (fb, iy*nx + ix, cnt[ix], giirnum[iy*nx + ix],
+		      giirden[iy*nx + ix], 1);
+	}
+
+    free (zero);
+    free (cnt);
+    return (NULL);
+}
+
+
 /* Return image buffer reduced by a given factor */
 
 char *
@@ -2157,7 +3148,8 @@ int	bitsin;		/* Number of bits per input pixel (<0=floating point) */
 int	naxes;
 double	pixij;		/* Summed value of rebinned pixel */
 double	bzero, bscale;
-double	pixval, dnp;
+double	*pixrow;	/* Pixels from one row of input image */
+double	dnp;
 short	*buffi2 = NULL;
 int	*buffi4 = NULL;
 float	*buffr4 = NULL;
@@ -2220,6 +3212,14 @@ double	*buffr8 = NULL;
 	image1 = (char *) calloc (npix1, sizeof (double));
 	buffr8 = (double *) image1;
 	}
+    pixrow = (double *) calloc (xfactor + 1, sizeof (double));
+    if (image1 == NULL || pixrow == NULL) {
+	if (image1 != NULL)
+	    free (image1);
+	if (pixrow != NULL)
+	    free (pixrow);
+	return (NULL);
+	}
 
     /* Fill output buffer */
     for (jy = 0; jy < ny1; jy++) {
@@ -2237,9 +3237,9 @@ double	*buffr8 = NULL;
 		    nxf = nx - kx + 1;
 		else
 		    nxf = xfactor;
+		getrow (image, bitsin, nx,ny,bzero,bscale, kx,ky, nxf, pixrow);
 		for (ix = 0; ix < nxf; ix++) {
-		    pixval = getpix (image, bitsin, nx,ny,bzero,bscale,kx++,ky);
-		    pixij = pixij + pixval;
+		    pixij = pixij + pixrow[ix];
 		    dnp++;
 		    }
 		ky++;
@@ -2286,6 +3286,7 @@ double	*buffr8 = NULL;
     if (nlog > 0)
 	fprintf (stderr,"\n");
 
+    free (pixrow);
     return (image1);
 }
 
@@ -2417,7 +3418,7 @@ double	cx,cy;		/* center x,y of aperture */
 double	rad;		/* radius of aperture */
 double	*sumw;		/* sum of values of pixel weights (returned) */
 {
-    double x, y, factor, flux, bs, bz, wsum;
+    double x, y, factor, flux, bs, bz, wsum, *pixrow;
     int ix1, ix2, iy1, iy2, ix, iy, bitpix, nx, ny;
 
     *sumw = 0.0;
@@ -2444,13 +3445,20 @@ double	*sumw;		/* sum of values of pixel weights (returned) */
     if (ix2 > nx)
 	ix2 = nx;
 
+    if (ix2 < ix1)
+	return (wsum);
+    pixrow = (double *) calloc (ix2 - ix1 + 1, sizeof (double));
+    if (pixrow == NULL)
+	return (wsum);
+
     for (iy = iy1; iy <= iy2; iy++) {
 	y = (double) iy;
+	getrow (imbuff, bitpix, nx, ny, bz, bs, ix1-1, iy-1, ix2-ix1+1, pixrow);
 	for (ix = ix1; ix <= ix2; ix++) {
 	    x = (double) ix;
 	    factor = imapfr (x,y,cx,cy,rad);
 	    *sumw = *sumw + factor;
-	    flux = getpix1 (imbuff, bitpix, nx, ny, bz, bs, ix, iy);
+	    flux = pixrow[ix - ix1];
 	    wsum = wsum + (factor * flux);
 
 	    /* fprintf (stderr, "IMAPSB: (%d,%d)= %f weight= %f\n",
@@ -2462,6 +3470,7 @@ double	*sumw;		/* sum of values of pixel weights (returned) */
     fprintf (stderr, "IMAPSB: sum of weighted intensity = %f\n", wsum);
  */
 
+    free (pixrow);
     return (wsum);
 }
 
@@ -2788,4 +3797,15 @@ double	rad;
  *
  * Jan  8 2007	Drop unused variables from SetBadVal()
  * Jan 11 2007	Add circular aperture photometry in PhotPix()
+ *
+ * Oct 19 2026	Filter with a sliding histogram of values or ranks in medfilt()
+ * Oct 19 2026	Filter with running column and box sums in meanfilt()
+ * Oct 19 2026	Filter bands of rows in separate threads if _REENTRANT
+ * Oct 19 2026	Sort all of the box in medpix*(), sized for even box widths
+ * Oct 19 2026	Filter rows, then columns in gaussfilt(), recursively if wide
+ * Oct 19 2026	Fix row length and box orientation in gausspix*(), gausswt()
+ * Oct 19 2026	Fix call to gausswt() in gaussfill()
+ * Oct 19 2026	Read rows with getvec() or getrow() in meanfilt(), gaussfilt(),
+ *		ShrinkFITSImage(), and PhotPix()
+ * Oct 19 2026	Leave NaN pixels out of the running sums in meanfilt()
  */
@@ -41,6 +41,8 @@
 #define MINRAD		1	/* Minimum radius for a star */
 #define MINPEAK		10	/* Minimum peak for a star */
 #define MINSEP		10	/* Minimum separations for stars */
+#define NFSTHREAD	0	/* Threads searching bands, 0 for one per CPU */
+#define MINBAND		64	/* Fewest rows in a band searched by one thread */
 
 /* The following are used in star matching (matchstar.c) */
 #define	FTOL	0.0000001	/* Fractional change of chisqr() to be done */
@@ -68,4 +70,6 @@
  *
  * Mar 30 2006	Add NXYDEC and set default to 2 (constant value was 1)
  * Apr 25 2006	Add RNOISE and set default to previous constant value of 50
+ *
+ * Oct 19 2026	Add NFSTHREAD and MINBAND for searching bands of rows in threads
  */
@@ -31,6 +31,9 @@
  * int StarFluxSort()		Return brightest of two stars based on flux
  * void MagSortStars()		Sort stars list based on magnitude
  * int StarMagSort()		Return brightest of two stars based on mag.
+ * int MagSelectStars()		Sort only the brightest stars to the start
+ * void MagHeapInit()		Order a full star list with the faintest first
+ * int MagHeapDown()		Return faintest star after the first is replaced
  * void RASortStars()		Sort stars based on right ascension
  * int StarRASort()		Return star with lowest right ascension
  * void DecSortStars()		Sort stars based on declination
@@ -67,6 +70,21 @@ typedef struct {
     char   *obj;	/* Object name */
 } StarInfo;
 
+/* Sort key for one star, sorted in place of the whole star entry */
+typedef struct {
+    double key;		/* Value by which to sort */
+    int index;		/* Position of star in input arrays */
+} StarKey;
+
+static int StarKeySort();
+static void StarKeySelect();
+static void StarOrder();
+static void SortColumn();
+static void SortDouble();
+static double StarMagKey();
+static int MagFainter();
+static void MagHeapSift();
+
 /* Sort image stars by decreasing flux */
 
 void
@@ -79,29 +97,22 @@ int	*sc;
 int	ns;
 
 {
-    StarInfo *stars;
-    int StarFluxSort ();
+    StarKey *keys;
     int i;
 
-    stars = (StarInfo *) calloc ((unsigned int)ns, sizeof(StarInfo));
-
-    for (i = 0; i < ns; i++) {
-	stars[i].x = sx[i];
-	stars[i].y = sy[i];
-	stars[i].b = sb[i];
-	stars[i].c = sc[i];
-	}
-
-    qsort ((char *)stars, ns, sizeof(StarInfo), StarFluxSort);
+    keys = (StarKey *) calloc ((unsigned int)ns, sizeof(StarKey));
+    if (keys == NULL)
+	return;
 
+    /* Decreasing flux is increasing negative flux */
     for (i = 0; i < ns; i++) {
-	sx[i] = stars[i].x;
-	sy[i] = stars[i].y;
-	sb[i] = stars[i].b;
-	sc[i] = stars[i].c;
+	keys[i].key = -sb[i];
+	keys[i].index = i;
 	}
+    qsort ((char *)keys, ns, sizeof(StarKey), StarKeySort);
 
-    free ((char *)stars);
+    StarOrder (keys, ns, NULL, NULL, NULL, NULL, NULL, sx, sy, &sb, sc, NULL, 1);
+    free ((char *)keys);
     return;
 }
 
@@ -147,84 +158,90 @@ int	nm;		/* Number of magnitudes per star */
 int	ms;		/* Magnitude by which to sort (1 to nmag) */
 
 {
-    StarInfo *stars;
-    int i, j, hasnum, haspos, hasobj, haspm, hasxy;
-    int StarMagSort();
+    (void) MagSelectStars (sn, sra, sdec, spra, spdec, sx, sy, sm, sc, sobj,
+			   ns, nm, ms, ns);
+    return;
+}
 
-    stars = (StarInfo *) calloc ((unsigned int)ns, sizeof(StarInfo));
 
+/* MagSelectStars -- Move the nsel brightest stars to the start of the
+ * arrays in order of increasing magnitude, leaving the rest in no order,
+ * and return the number moved.  Only the sort keys are sorted, and the
+ * star arrays are rearranged in place. */
+
+int
+MagSelectStars (sn, sra, sdec, spra, spdec, sx, sy, sm, sc, sobj, ns, nm, ms,
+		nsel)
+
+double *sn;		/* Identifying number */
+double *sra;		/* Right Ascension */
+double *sdec;		/* Declination */
+double *spra;		/* Right Ascension proper motion */
+double *spdec;		/* Declination proper motion */
+double *sx;		/* Image X coordinate */
+double *sy;		/* Image Y coordinate */
+double **sm;		/* Magnitudes */
+int    *sc;		/* Other 4-byte information */
+char   **sobj;		/* Object name */
+int	ns;		/* Number of stars */
+int	nm;		/* Number of magnitudes per star */
+int	ms;		/* Magnitude by which to sort (1 to nmag) */
+int	nsel;		/* Number of brightest stars to sort to the start */
+
+{
+    StarKey *keys;
+    int i;
+
+    if (ns < 2 || nsel < 1 || nm < 1)
+	return (0);
+    if (nsel > ns)
+	nsel = ns;
     if (ms > 0 && ms <= nm)
 	magsort = ms - 1;
 
-    if (sn == NULL)
-	hasnum = 0;
-    else
-	hasnum = 1;
-    if (sra != NULL && sdec != NULL)
-	haspos = 1;
-    else
-	haspos = 0;
-    if (spra != NULL && spdec != NULL)
-	haspm = 1;
-    else
-	haspm = 0;
-    if (sx != NULL && sy != NULL)
-	hasxy = 1;
-    else
-	hasxy = 0;
-    if (sobj == NULL)
-	hasobj = 0;
-    else
-	hasobj = 1;
-
+    keys = (StarKey *) calloc ((unsigned int)ns, sizeof(StarKey));
+    if (keys == NULL)
+	return (0);
     for (i = 0; i < ns; i++) {
-	if (hasnum)
-	    stars[i].n = sn[i];
-	if (haspos) {
-	    stars[i].ra = sra[i];
-	    stars[i].dec = sdec[i];
-	    }
-	if (haspm) {
-	    stars[i].pra = spra[i];
-	    stars[i].pdec = spdec[i];
-	    }
-	if (hasxy) {
-	    stars[i].x = sx[i];
-	    stars[i].y = sy[i];
-	    }
-	for (j = 0; j < nm; j++)
-	    stars[i].m[j] = sm[j][i];
-	stars[i].c = sc[i];
-	if (hasobj)
-	    stars[i].obj = sobj[i];
+	keys[i].key = StarMagKey (sm, nm, i);
+	keys[i].index = i;
 	}
 
-    qsort ((char *)stars, ns, sizeof(StarInfo), StarMagSort);
+    /* Partition around the nsel'th brightest star, then sort only those */
+    if (nsel < ns)
+	StarKeySelect (keys, ns, nsel);
+    qsort ((char *)keys, nsel, sizeof(StarKey), StarKeySort);
 
-    for (i = 0; i < ns; i++) {
-	if (hasnum)
-	    sn[i] = stars[i].n;
-	if (haspos) {
-	    sra[i] = stars[i].ra;
-	    sdec[i] = stars[i].dec;
-	    }
-	if (haspm) {
-	    spra[i] = stars[i].pra;
-	    spdec[i] = stars[i].pdec;
-	    }
-	if (hasxy) {
-	    sx[i] = stars[i].x;
-	    sy[i] = stars[i].y;
-	    }
-	for (j = 0; j < nm; j++)
-	    sm[j][i] = stars[i].m[j];
-	sc[i] = stars[i].c;
-	if (hasobj)
-	    sobj[i] = stars[i].obj;
-	}
+    StarOrder (keys, ns, sn, sra, sdec, spra, spdec, sx, sy, sm, sc, sobj, nm);
+    free ((char *)keys);
+    return (nsel);
+}
 
-    free ((char *)stars);
-    return;
+
+/* Magnitude used to sort a star, as in StarMagSort() */
+
+static double
+StarMagKey (sm, nm, i)
+
+double	**sm;		/* Magnitudes */
+int	nm;		/* Number of magnitudes per star */
+int	i;		/* Star */
+{
+    double b;
+    int j;
+
+    b = sm[magsort][i];
+
+    /* If sort magnitude is not set, check the others until one is found */
+    if (b > 100.0)
+	b = b - 100.0;
+    for (j = 0; j < 4 && b == 99.90; j++) {
+	if (j < nm)
+	    b = sm[j][i];
+	else
+	    b = 0.0;
+	}
+    return (b);
 }
 
 
@@ -405,70 +422,20 @@ char   **sobj;		/* Object name */
 int	ns;		/* Number of stars to sort */
 int	nm;		/* Number of magnitudes per star */
 {
-    StarInfo *stars;
-    int i, j, hasnum, hasobj, haspm, hasxy;
-    int StarRASort();
-
-    stars = (StarInfo *) calloc ((unsigned int)ns, sizeof(StarInfo));
-
-    if (sn == NULL)
-	hasnum = 0;
-    else
-	hasnum = 1;
-    if (spra != NULL && spdec != NULL)
-	haspm = 1;
-    if (sx != NULL && sy != NULL)
-	hasxy = 1;
-    else
-	hasxy = 0;
-    if (sobj == NULL)
-	hasobj = 0;
-    else
-	hasobj = 1;
-
-    for (i = 0; i < ns; i++) {
-	if (hasnum)
-	    stars[i].n = sn[i];
-	stars[i].ra = sra[i];
-	stars[i].dec = sdec[i];
-	if (haspm) {
-	    stars[i].pra = spra[i];
-	    stars[i].pdec = spdec[i];
-	    }
-	if (hasxy) {
-	    stars[i].x = sx[i];
-	    stars[i].y = sy[i];
-	    }
-	for (j = 0; j < nm; j++)
-	    stars[i].m[j] = sm[j][i];
-	stars[i].c = sc[i];
-	if (hasobj)
-	    stars[i].obj = sobj[i];
-	}
-
-    qsort ((char *)stars, ns, sizeof(StarInfo), StarRASort);
+    StarKey *keys;
+    int i;
 
+    keys = (StarKey *) calloc ((unsigned int)ns, sizeof(StarKey));
+    if (keys == NULL)
+	return;
     for (i = 0; i < ns; i++) {
-	if (hasnum)
-	    sn[i] = stars[i].n;
-	sra[i] = stars[i].ra;
-	sdec[i] = stars[i].dec;
-	if (haspm) {
-	    spra[i] = stars[i].pra;
-	    spdec[i] = stars[i].pdec;
-	    }
-	if (hasxy) {
-	    sx[i] = stars[i].x;
-	    sy[i] = stars[i].y;
-	    }
-	for (j = 0; j < nm; j++)
-	    sm[j][i] = stars[i].m[j];
-	sc[i] = stars[i].c;
-	if (hasobj)
-	    sobj[i] = stars[i].obj;
+	keys[i].key = sra[i];
+	keys[i].index = i;
 	}
+    qsort ((char *)keys, ns, sizeof(StarKey), StarKeySort);
 
-    free ((char *)stars);
+    StarOrder (keys, ns, sn, sra, sdec, spra, spdec, sx, sy, sm, sc, sobj, nm);
+    free ((char *)keys);
     return;
 }
 
@@ -1089,6 +1056,244 @@ double	rad;		/* Maximum separation in arcseconds to merge */
     return (no);
 }
 
+/* Order sort keys by increasing value, then by position, so that the
+ * order of stars with the same value does not change (called by qsort) */
+
+static int
+StarKeySort (ssp1, ssp2)
+
+const void *ssp1, *ssp2;
+
+{
+    StarKey *k1 = (StarKey *)ssp1;
+    StarKey *k2 = (StarKey *)ssp2;
+
+    if (k1->key < k2->key)
+	return (-1);
+    else if (k1->key > k2->key)
+	return (1);
+    else if (k1->index < k2->index)
+	return (-1);
+    else if (k1->index > k2->index)
+	return (1);
+    else
+	return (0);
+}
+
+
+/* Partially order sort keys so that the nsel smallest come first */
+
+static void
+StarKeySelect (keys, nkeys, nsel)
+
+StarKey	*keys;		/* Sort keys */
+int	nkeys;		/* Number of sort keys */
+int	nsel;		/* Number of smallest keys to put first */
+{
+    StarKey pivot, temp;
+    int left, right, i, j, mid;
+
+    left = 0;
+    right = nkeys - 1;
+    while (right > left) {
+
+	/* Median of three pivot, moved to the right end */
+	mid = left + (right - left) / 2;
+	if (StarKeySort (&keys[mid], &keys[left]) < 0) {
+	    temp = keys[mid]; keys[mid] = keys[left]; keys[left] = temp;
+	    }
+	if (StarKeySort (&keys[right], &keys[left]) < 0) {
+	    temp = keys[right]; keys[right] = keys[left]; keys[left] = temp;
+	    }
+	if (StarKeySort (&keys[mid], &keys[right]) < 0) {
+	    temp = keys[mid]; keys[mid] = keys[right]; keys[right] = temp;
+	    }
+	pivot = keys[right];
+
+	/* Partition; keys are all different, since positions are */
+	i = left;
+	for (j = left; j < right; j++) {
+	    if (StarKeySort (&keys[j], &pivot) < 0) {
+		temp = keys[i]; keys[i] = keys[j]; keys[j] = temp;
+		i++;
+		}
+	    }
+	temp = keys[i]; keys[i] = keys[right]; keys[right] = temp;
+
+	/* Keep the part holding the nsel'th key */
+	if (i == nsel - 1 || i == nsel)
+	    break;
+	else if (i < nsel)
+	    left = i + 1;
+	else
+	    right = i - 1;
+	}
+    return;
+}
+
+
+/* Rearrange every star array which is present in sorted key order, one
+ * column at a time through a single work column */
+
+static void
+StarOrder (keys, ns, sn, sra, sdec, spra, spdec, sx, sy, sm, sc, sobj, nm)
+
+StarKey	*keys;		/* Sort keys, in sorted order */
+int	ns;		/* Number of stars */
+double	*sn, *sra, *sdec, *spra, *spdec, *sx, *sy;
+double	**sm;		/* Magnitudes */
+int	*sc;		/* Other 4-byte information */
+char	**sobj;		/* Object names */
+int	nm;		/* Number of magnitudes per star */
+{
+    char *work;
+    int j;
+
+    work = (char *) malloc (ns * sizeof (double));
+    if (work == NULL)
+	return;
+    SortDouble (sn, keys, ns, (double *) work);
+    SortDouble (sra, keys, ns, (double *) work);
+    SortDouble (sdec, keys, ns, (double *) work);
+    SortDouble (spra, keys, ns, (double *) work);
+    SortDouble (spdec, keys, ns, (double *) work);
+    SortDouble (sx, keys, ns, (double *) work);
+    SortDouble (sy, keys, ns, (double *) work);
+    if (sm != NULL) {
+	for (j = 0; j < nm; j++)
+	    SortDouble (sm[j], keys, ns, (double *) work);
+	}
+    SortColumn ((char *)sc, sizeof (int), keys, ns, work);
+    SortColumn ((char *)sobj, sizeof (char *), keys, ns, work);
+    free (work);
+    return;
+}
+
+
+/* Put a column of numbers in sorted key order */
+
+static void
+SortDouble (a, keys, ns, work)
+
+double	*a;		/* Column to rearrange (ignored if NULL) */
+StarKey	*keys;		/* Sort keys, in sorted order */
+int	ns;		/* Number of stars */
+double	*work;		/* Work column of ns numbers */
+{
+    int i;
+
+    if (a == NULL)
+	return;
+    for (i = 0; i < ns; i++)
+	work[i] = a[keys[i].index];
+    memcpy (a, work, ns * sizeof (double));
+    return;
+}
+
+
+/* Put a column of integers or pointers in sorted key order */
+
+static void
+SortColumn (a, size, keys, ns, work)
+
+char	*a;		/* Column to rearrange (ignored if NULL) */
+int	size;		/* Size of one entry in bytes (int or pointer) */
+StarKey	*keys;		/* Sort keys, in sorted order */
+int	ns;		/* Number of stars */
+char	*work;		/* Work column of ns * size bytes */
+{
+    int i;
+
+    if (a == NULL)
+	return;
+    if (size == sizeof (int)) {
+	for (i = 0; i < ns; i++)
+	    ((int *)work)[i] = ((int *)a)[keys[i].index];
+	}
+    else {
+	for (i = 0; i < ns; i++)
+	    ((char **)work)[i] = ((char **)a)[keys[i].index];
+	}
+    memcpy (a, work, ns * size);
+    return;
+}
+
+
+/* MagHeapInit -- Order the indices of a full list of stars so that the
+ * faintest is first, as a heap which MagHeapDown() keeps in order when
+ * catalog readers replace that star with a brighter one */
+
+void
+MagHeapInit (mag, heap, n)
+
+double	*mag;		/* Magnitudes of stars in list */
+int	*heap;		/* Indices of stars in heap order (returned) */
+int	n;		/* Number of stars in list */
+{
+    int i;
+
+    for (i = 0; i < n; i++)
+	heap[i] = i;
+    for (i = n / 2 - 1; i >= 0; i--)
+	MagHeapSift (mag, heap, n, i);
+    return;
+}
+
+
+/* MagHeapDown -- Restore heap order after the magnitude of the first
+ * (faintest) star changes, returning the new faintest star */
+
+int
+MagHeapDown (mag, heap, n)
+
+double	*mag;		/* Magnitudes of stars in list */
+int	*heap;		/* Indices of stars in heap order */
+int	n;		/* Number of stars in list */
+{
+    MagHeapSift (mag, heap, n, 0);
+    return (heap[0]);
+}
+
+
+/* Move a star down the heap until no star below it is fainter.  Of stars
+ * with the same magnitude, the one earliest in the list counts as fainter,
+ * so the star replaced is the one a linear search would find. */
+
+static int
+MagFainter (mag, i1, i2)
+
+double	*mag;
+int	i1, i2;
+{
+    if (mag[i1] != mag[i2])
+	return (mag[i1] > mag[i2]);
+    else
+	return (i1 < i2);
+}
+
+static void
+MagHeapSift (mag, heap, n, i)
+
+double	*mag;		/* Magnitudes of stars in list */
+int	*heap;		/* Indices of stars in heap order */
+int	n;		/* Number of stars in list */
+int	i;		/* Position in heap of star to move down */
+{
+    int child, temp;
+
+    while ((child = 2 * i + 1) < n) {
+	if (child + 1 < n && MagFainter (mag, heap[child+1], heap[child]))
+	    child++;
+	if (!MagFainter (mag, heap[child], heap[i]))
+	    break;
+	temp = heap[i];
+	heap[i] = heap[child];
+	heap[child] = temp;
+	i = child;
+	}
+    return;
+}
+
 /* Jun 13 1996	New program
  * Oct 18 1996	Add sorting by X value
  * Nov 13 1996	Add second magnitude
@@ -1133,4 +1338,8 @@ double	rad;		/* Maximum separation in arcseconds to merge */
  * Jan 11 2007	Include fitsfile.h
  *
  * Nov  6 2009	Set number of magnitudes from MAXNMAG parameter in wcscat.h
+ *
+ * Oct 19 2026	Sort keys, not whole star entries, in Flux/Mag/RASortStars
+ * Oct 19 2026	Add MagSelectStars() to sort only the brightest stars
+ * Oct 19 2026	Add MagHeapInit() and MagHeapDown() for catalog readers
  */
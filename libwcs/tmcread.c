@@ -97,6 +97,7 @@ int	nlog;		/* 1 for diagnostics */
     double faintmag=0.0; /* Faintest magnitude */
     double maxdist=0.0; /* Largest distance */
     int	faintstar=0;	/* Faintest star */
+    int	*faintheap = NULL;	/* Stars in order of decreasing magnitude */
     int	farstar=0;	/* Most distant star */
     int nreg = 0;	/* Number of 2MASS point source regions in search */
     int rlist[MAXREG];	/* List of regions */
@@ -464,15 +465,23 @@ int	nlog;		/* 1 for diagnostics */
 			else
 			    gtype[faintstar] = 0;
 			gdist[faintstar] = dist;
-			faintmag = 0.0;
-
-			/* Find new faintest star */
-			for (i = 0; i < nstarmax; i++) {
-			    if (gmag[magsort][i] > faintmag) {
-				faintmag = gmag[magsort][i];
-				faintstar = i;
+			/* Find new faintest star, keeping the list in heap order */
+			if (faintheap != NULL)
+			    faintstar = MagHeapDown (gmag[magsort], faintheap, nstarmax);
+			else {
+			    faintheap = (int *) calloc (nstarmax, sizeof (int));
+			    if (faintheap != NULL) {
+				MagHeapInit (gmag[magsort], faintheap, nstarmax);
+				faintstar = faintheap[0];
+				}
+			    else {
+				for (i = 0; i < nstarmax; i++) {
+				    if (gmag[magsort][i] > gmag[magsort][faintstar])
+					faintstar = i;
+				    }
 				}
 			    }
+			faintmag = gmag[magsort][faintstar];
 			}
 
 		    nstar++;
@@ -514,6 +523,8 @@ int	nlog;		/* 1 for diagnostics */
 	    fprintf (stderr,"TMCREAD: %d stars found; only %d returned\n",
 		     nstar,nstarmax);
 	}
+    if (faintheap != NULL)
+	free ((void *)faintheap);
     return (nstar);
 }
 
@@ -1535,4 +1546,6 @@ int	istar;		/* Star sequence in 2MASS zone file */
  * Nov 20 2007	Fix bug which offset limit flag by one (found by Gus Muensch)
  *
  * Sep 28 2009	Print correct heading for n<0 Extended Source tab table
+ *
+ * Oct 19 2026	Keep a heap of the faintest stars instead of rescanning a full list
  */
@@ -90,6 +90,7 @@ int	nlog;		/* 1 for diagnostics */
     double faintmag=0.0; /* Faintest magnitude */
     double maxdist=0.0; /* Largest distance */
     int	faintstar=0;	/* Faintest star */
+    int	*faintheap = NULL;	/* Stars in order of decreasing magnitude */
     int	farstar=0;	/* Most distant star */
     int nreg = 0;	/* Number of Tycho 2 regions in search */
     int regnum[MAXREG];	/* List of region numbers */
@@ -398,15 +399,23 @@ int	nlog;		/* 1 for diagnostics */
 			    gmag[3][faintstar] = star->xmag[3];
 			    }
 			gdist[faintstar] = dist;
-			faintmag = 0.0;
-
-			/* Find new faintest star */
-			for (i = 0; i < nstarmax; i++) {
-			    if (gmag[magsort1][i] > faintmag) {
-				faintmag = gmag[magsort1][i];
-				faintstar = i;
+			/* Find new faintest star, keeping the list in heap order */
+			if (faintheap != NULL)
+			    faintstar = MagHeapDown (gmag[magsort1], faintheap, nstarmax);
+			else {
+			    faintheap = (int *) calloc (nstarmax, sizeof (int));
+			    if (faintheap != NULL) {
+				MagHeapInit (gmag[magsort1], faintheap, nstarmax);
+				faintstar = faintheap[0];
+				}
+			    else {
+				for (i = 0; i < nstarmax; i++) {
+				    if (gmag[magsort1][i] > gmag[magsort1][faintstar])
+					faintstar = i;
+				    }
 				}
 			    }
+			faintmag = gmag[magsort1][faintstar];
 			}
 
 		    nstar++;
@@ -448,6 +457,8 @@ int	nlog;		/* 1 for diagnostics */
 	    fprintf (stderr,"TY2READ: %d stars found; only %d returned\n",
 		     nstar,nstarmax);
 	}
+    if (faintheap != NULL)
+	free ((void *)faintheap);
     return (nstar);
 }
 
@@ -1461,4 +1472,6 @@ char	*filename;	/* Name of file for which to find size */
  * Jul  6 2007	Skip stars with entry read errors; stop if catalog problem
  * Jul  6 2007	Print read errors in ty2star() only
  * Jun  9 2007	Fix bug so that sequential catalog entry reading works
+ *
+ * Oct 19 2026	Keep a heap of the faintest stars instead of rescanning a full list
  */
@@ -141,6 +141,7 @@ int	nlog;		/* 1 for diagnostics */
     double faintmag=0.0;	/* Faintest magnitude */
     double maxdist=0.0;		/* Largest distance */
     int	faintstar=0;		/* Faintest star */
+    int	*faintheap = NULL;	/* Stars in order of decreasing magnitude */
     int	farstar=0;		/* Most distant star */
     int nz;			/* Number of UCAC regions in search */
     int zlist[MAXZONE];		/* List of region numbers */
@@ -528,15 +529,23 @@ int	nlog;		/* 1 for diagnostics */
 				gtype[faintstar] = (1000 * nim) + ncat;
 				}
 			    gdist[faintstar] = dist;
-			    faintmag = 0.0;
-
-			    /* Find new faintest star */
-			    for (i = 0; i < nstarmax; i++) {
-				if (gmag[magsort][i] > faintmag) {
-				    faintmag = gmag[magsort][i];
-				    faintstar = i;
+			    /* Find new faintest star, keeping the list in heap order */
+			    if (faintheap != NULL)
+				faintstar = MagHeapDown (gmag[magsort], faintheap, nstarmax);
+			    else {
+				faintheap = (int *) calloc (nstarmax, sizeof (int));
+				if (faintheap != NULL) {
+				    MagHeapInit (gmag[magsort], faintheap, nstarmax);
+				    faintstar = faintheap[0];
+				    }
+				else {
+				    for (i = 0; i < nstarmax; i++) {
+					if (gmag[magsort][i] > gmag[magsort][faintstar])
+					    faintstar = i;
+					}
 				    }
 				}
+			    faintmag = gmag[magsort][faintstar];
 			    }
 
 			nstar++;
@@ -582,6 +591,8 @@ int	nlog;		/* 1 for diagnostics */
 	    fprintf (stderr,"UCACREAD: %d stars found; only %d returned\n",
 		     nstar,nstarmax);
 	}
+    if (faintheap != NULL)
+	free ((void *)faintheap);
     return (nstar);
 }
 
@@ -1551,4 +1562,6 @@ char *string;	/* Address of Integer*4 or Real*4 vector */
  * Nov  5 2009	Return errors in position and proper motion as magnitudes
  * Nov  5 2009	Return UCAC2 and UCAC3 RA proper motion and error as RA degrees
  * Dec 14 2009	Drop nmag1 from ucacread() and ucacrnum(); it wasn't being used
+ *
+ * Oct 19 2026	Keep a heap of the faintest stars instead of rescanning a full list
  */
@@ -62,6 +62,7 @@
  * Subroutine:	pix2wcs (wcs,xpix,ypix,xpos,ypos) pixel coordinates -> sky coordinates
  * Subroutine:	wcsc2pix (wcs,xpos,ypos,coorsys,xpix,ypix,offscl) sky coordinates -> pixel coordinates
  * Subroutine:	wcs2pix (wcs,xpos,ypos,xpix,ypix,offscl) sky coordinates -> pixel coordinates
+ * Subroutine:	wcs2pixn (wcs,n,xpos,ypos,xpix,ypix,offscl) arrays of sky coordinates -> pixel coordinates
  * Subroutine:  wcszin (izpix) sets third dimension for pix2wcs() and pix2wcst()
  * Subroutine:  wcszout (wcs) returns third dimension from wcs2pix()
  * Subroutine:	setwcsfile (filename)  Set file name for error messages 
@@ -2272,6 +2273,98 @@ int	*offscl;	/* 0 if within bounds, else off scale */
 }
 
 
+/* Convert arrays of World Coordinates to pixel coordinates */
+
+void
+wcs2pixn (wcs, n, xpos, ypos, xpix, ypix, offscl)
+
+struct WorldCoor *wcs;	/* World coordinate system structure */
+int	n;		/* Number of positions */
+double	*xpos,*ypos;	/* World coordinates in degrees */
+double	*xpix,*ypix;	/* Image coordinates in pixels (returned) */
+int	*offscl;	/* 0 if within bounds, else off scale (returned) */
+{
+    double xi, yi, eqin, *imgpix;
+    int i, i0, sysin, lng, lat;
+    struct WcsConPlan con;
+
+    if (nowcs (wcs) || n < 1)
+	return;
+
+    /* The first position also initializes the WCSLIB structures */
+    wcs2pix (wcs, xpos[0], ypos[0], &xpix[0], &ypix[0], &offscl[0]);
+    i0 = 1;
+
+    /* Project the rest together if nothing but a WCSLIB projection and
+       a linear transformation lies between sky and pixels */
+    if (wcs->wcs == NULL && wcs->wcsdep == NULL && wcs->distcode == 0 &&
+	wcs->wcsproj != WCS_OLD && wcs->prjcode > 0 &&
+	wcs->prjcode != WCS_DSS && wcs->prjcode != WCS_PLT &&
+	wcs->prjcode != WCS_TNX && wcs->prjcode != WCS_CSC &&
+	wcs->prjcode != WCS_QSC && wcs->prjcode != WCS_TSC &&
+	wcs->lin.naxis == 2 && wcs->lin.flag == LINSET &&
+	wcs->wcsl.flag == WCSSET && wcs->wcsl.cubeface == -1 &&
+	wcs->cel.flag == CELSET && strcmp (wcs->wcsl.pcode, "NCP")) {
+	sysin = wcscsys (wcs->radecin);
+	eqin = wcsceq (wcs->radecin);
+	lng = wcs->wcsl.lng;
+	lat = wcs->wcsl.lat;
+
+	/* Celestial coordinates in the system of the image */
+	for (i = i0; i < n; i++) {
+	    xpix[i] = xpos[i];
+	    ypix[i] = ypos[i];
+	    if (wcs->latbase == 90)
+		ypix[i] = 90.0 - ypix[i];
+	    else if (wcs->latbase == -90)
+		ypix[i] = ypix[i] - 90.0;
+	    }
+	if (sysin > 0 && sysin != 6 && sysin != 10) {
+	    wcsconplan (sysin, wcs->syswcs, eqin, wcs->equinox, wcs->epoch,
+			&con);
+	    wcsconn (&con, n-i0, xpix+i0, ypix+i0);
+	    }
+
+	/* Projected coordinates, then pixels */
+	i = celfwdn (wcs->wcsl.pcode, n-i0, xpix+i0, ypix+i0, 1, &wcs->cel,
+		     &wcs->prj, xpix+i0, ypix+i0, 1, offscl+i0);
+	if (i == 0 || i == 3) {
+	    imgpix = wcs->lin.imgpix;
+	    for (i = i0; i < n; i++) {
+		if (offscl[i]) {
+		    offscl[i] = 1;
+		    xpix[i] = 0.0;
+		    ypix[i] = 0.0;
+		    continue;
+		    }
+		xi = (lng == 0) ? xpix[i] : ypix[i];
+		yi = (lat == 1) ? ypix[i] : xpix[i];
+		xpix[i] = imgpix[0]*xi + imgpix[1]*yi + wcs->lin.crpix[0];
+		ypix[i] = imgpix[2]*xi + imgpix[3]*yi + wcs->lin.crpix[1];
+
+		/* Off image but within bounds of projection */
+		if (xpix[i] < 0.5 || ypix[i] < 0.5)
+		    offscl[i] = 2;
+		else if (xpix[i] > wcs->nxpix + 0.5 || ypix[i] > wcs->nypix + 0.5)
+		    offscl[i] = 2;
+		}
+	    i0 = n;
+	    }
+	}
+
+    /* Anything else goes through wcs2pix() one position at a time */
+    for (i = i0; i < n; i++)
+	wcs2pix (wcs, xpos[i], ypos[i], &xpix[i], &ypix[i], &offscl[i]);
+
+    wcs->offscl = offscl[n-1];
+    wcs->xpos = xpos[n-1];
+    wcs->ypos = ypos[n-1];
+    wcs->xpix = xpix[n-1];
+    wcs->ypix = ypix[n-1];
+    return;
+}
+
+
 int
 wcspos (xpix, ypix, wcs, xpos, ypos)
 
@@ -2934,4 +3027,7 @@ char *cwcs;	/* Keyword suffix character for output WCS */
  * Feb 23 2007	Fix bug when checking for "DET" in CTYPEi
  * Apr  2 2007	Fix PC to CD matrix conversion
  * Jul 25 2007	Compute distance between two coordinates using d2v3()
+ *
+ * Oct 19 2026	Add wcs2pixn() to convert arrays of sky coordinates with celfwdn()
+ * Oct 19 2026	Convert coordinate systems in wcs2pixn() with one wcsconplan()
  */
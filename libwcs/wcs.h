@@ -154,6 +154,25 @@ struct WorldCoor {
   int		logwcs;		/* 1 if DC-FLAG is set for log wavelength */
 };
 
+/* Precomputed coordinate system conversion (wcscon.c) */
+struct WcsConPlan {
+  int		sys1, sys2;	/* Input and output coordinate systems */
+  double	eq1, eq2;	/* Input and output equinoxes */
+  double	epoch;		/* Besselian epoch in years */
+  int		mode;		/* WCSCON_NONE, WCSCON_ROTATE, or WCSCON_SCALAR */
+  double	rmat[9];	/* Rotation, v(sys2) = rmat * v(sys1) */
+};
+
+/* Precomputed pixel to sky transformation (wcsxform.c) */
+struct WcsXform {
+  struct WorldCoor *wcs;	/* WCS from which this was set up */
+  int		tan;		/* 1 for the closed-form TAN path, else pix2wcs() */
+  struct WcsConPlan con;	/* Conversion to the output system, if any */
+  double	crpix[2];	/* Reference pixel */
+  double	m[9];		/* Pixel offset (x, y, 1) to celestial direction */
+  double	lng0;		/* Celestial longitude of the native pole */
+};
+
 /* Projections (1-26 are WCSLIB) (values for wcs->prjcode) */
 #define WCS_PIX -1	/* Pixel WCS */
 #define WCS_LIN  0	/* Linear projection */
@@ -202,6 +221,11 @@ struct WorldCoor {
 #define WCS_XY		10	/* X-Y Cartesian coordinates */
 #define WCS_ICRS	11	/* ICRS right ascension and declination */
 
+/* Coordinate conversion methods (values for WcsConPlan.mode) */
+#define WCSCON_NONE	0	/* Systems and equinoxes are the same */
+#define WCSCON_ROTATE	1	/* One rotation matrix */
+#define WCSCON_SCALAR	2	/* wcscon() one position at a time */
+
 /* Method to use */
 #define WCS_BEST	0	/* Use best WCS projections */
 #define WCS_ALT		1	/* Use not best WCS projections */
@@ -286,6 +310,15 @@ extern "C" {
 	int len,		/* Length of FITS header */
 	char *wcschar);		/* WCS character (A-Z) */
 
+    struct WorldCoor **wcsinitall ( /* set up all WCS structures from a header */
+	const char* hstring,	/* FITS header */
+	const char* wcschar,	/* WCS character (A-Z), or NULL for all */
+	int *nwcs);		/* Number of WCS structures returned */
+
+    void wcsfreeall (		/* Free WCS structures from wcsinitall() */
+	struct WorldCoor **wcslist, /* List of WCS structures */
+	int nwcs);		/* Number of WCS structures in list */
+
     /* WCS subroutines in wcs.c */
     void wcsfree (		/* Free a WCS structure and its contents */
 	struct WorldCoor *wcs);	/* World coordinate system structure */
@@ -331,6 +364,35 @@ extern "C" {
         double *ypix,	/* Image vertical coordinate in pixels (returned) */
         int *offscl);
 
+    void wcs2pixn (	/* Convert arrays of World Coordinates to pixel coordinates */
+        struct WorldCoor *wcs,  /* World coordinate system structure */
+        int n,		/* Number of positions */
+        double *xpos,	/* Longitudes/Right Ascensions in degrees */
+        double *ypos,	/* Latitudes/Declinations in degrees */
+        double *xpix,	/* Image horizontal coordinates in pixels (returned) */
+        double *ypix,	/* Image vertical coordinates in pixels (returned) */
+        int *offscl);	/* Off scale flags, as from wcs2pix() (returned) */
+
+    /* Precomputed pixel to sky transformations (wcsxform.c) */
+    struct WcsXform *wcsxform ( /* Set up a pixel to sky transformation */
+	struct WorldCoor *wcs);	/* World coordinate system structure */
+    void wcsxfree (		/* Free a transformation from wcsxform() */
+	struct WcsXform *xf);	/* Transformation from wcsxform() */
+    int xfpix2wcs (	/* Convert pixel coordinates to World Coordinates */
+	struct WcsXform *xf,	/* Transformation from wcsxform() */
+        double xpix,	/* Image horizontal coordinate in pixels */
+        double ypix,	/* Image vertical coordinate in pixels */
+        double *xpos,	/* Longitude/Right Ascension in degrees (returned) */
+        double *ypos);	/* Latitude/Declination in degrees (returned) */
+    void xfpix2wcsn (	/* Convert arrays of pixel coordinates to World Coordinates */
+	struct WcsXform *xf,	/* Transformation from wcsxform() */
+        int n,		/* Number of positions */
+        double *xpix,	/* Image horizontal coordinates in pixels */
+        double *ypix,	/* Image vertical coordinates in pixels */
+        double *xpos,	/* Longitudes/Right Ascensions in degrees (returned) */
+        double *ypos,	/* Latitudes/Declinations in degrees (returned) */
+        int *offscl);	/* Off scale flags (returned) */
+
     double wcsdist(	/* Compute angular distance between 2 sky positions */
 	double ra1,	/* First longitude/right ascension in degrees */
 	double dec1,	/* First latitude/declination in degrees */
@@ -554,6 +616,20 @@ extern "C" {
 	double *dphi,	/* Latitude or declination in degrees
 			   Input in sys1, returned in sys2 */
 	double epoch);	/* Besselian epoch in years */
+    void wcsconplan(	/* Set up a conversion between coordinate systems */
+	int sys1,	/* Input coordinate system (J2000, B1950, ECLIPTIC, GALACTIC */
+	int sys2,	/* Output coordinate system (J2000, B1950, ECLIPTIC, GALACTIC */
+	double eq1,	/* Input equinox (default of sys1 if 0.0) */
+	double eq2,	/* Output equinox (default of sys2 if 0.0) */
+	double epoch,	/* Besselian epoch in years */
+	struct WcsConPlan *plan); /* Conversion plan (returned) */
+    void wcsconn(	/* Convert arrays of coordinates using a plan */
+	struct WcsConPlan *plan, /* Conversion plan from wcsconplan() */
+	int n,		/* Number of positions */
+	double *dtheta,	/* Longitudes or right ascensions in degrees
+			   Input in sys1, returned in sys2 */
+	double *dphi);	/* Latitudes or declinations in degrees
+			   Input in sys1, returned in sys2 */
     void fk425e (	/* Convert B1950(FK4) to J2000(FK5) coordinates */
 	double *ra,	/* Right ascension in degrees (B1950 in, J2000 out) */
 	double *dec,	/* Declination in degrees (B1950 in, J2000 out) */
@@ -701,6 +777,8 @@ struct WorldCoor *wcsinitn(); /* set up a WCS structure from a FITS image header
 struct WorldCoor *wcsninitn(); /* set up a WCS structure from a FITS image header */
 struct WorldCoor *wcsinitc(); /* set up a WCS structure from a FITS image header */
 struct WorldCoor *wcsninitc(); /* set up a WCS structure from a FITS image header */
+struct WorldCoor **wcsinitall(); /* set up all WCS structures from a FITS header */
+void wcsfreeall();	/* Free WCS structures set up by wcsinitall() */
 struct WorldCoor *wcsxinit(); /* set up a WCS structure from arguments */
 struct WorldCoor *wcskinit(); /* set up a WCS structure from keyword values */
 void wcsfree(void);		/* Free a WCS structure and its contents */
@@ -734,6 +812,11 @@ int pix2wcst();		/* Convert pixel coordinates to World Coordinate string */
 void pix2wcs();		/* Convert pixel coordinates to World Coordinates */
 void wcsc2pix();	/* Convert World Coordinates to pixel coordinates */
 void wcs2pix();		/* Convert World Coordinates to pixel coordinates */
+void wcs2pixn();		/* Convert arrays of World Coordinates to pixel coordinates */
+struct WcsXform *wcsxform(); /* Set up a pixel to sky transformation */
+void wcsxfree();	/* Free a transformation set up by wcsxform() */
+int xfpix2wcs();	/* Convert pixel coordinates using a transformation */
+void xfpix2wcsn();	/* Convert arrays of pixel coordinates using a transformation */
 void setdefwcs();	/* Call to use AIPS classic WCS (also not PLT or TNX */
 int getdefwcs();	/* Call to get flag for AIPS classic WCS */
 int wcszin();		/* Set coordinate in third dimension (face) */
@@ -753,6 +836,8 @@ int cpwcs();		/* Copy WCS keywords with no suffix to ones with suffix */
 void wcscon();		/* Convert between coordinate systems and equinoxes */
 void wcsconp();		/* Convert between coordinate systems and equinoxes */
 void wcsconv();		/* Convert between coordinate systems and equinoxes */
+void wcsconplan();	/* Set up a conversion between coordinate systems */
+void wcsconn();		/* Convert arrays of coordinates using a plan */
 void fk425e();		/* Convert B1950(FK4) to J2000(FK5) coordinates */
 void fk524e();		/* Convert J2000(FK5) to B1950(FK4) coordinates */
 int wcscsys();		/* Set coordinate system from string */
@@ -914,4 +999,9 @@ extern int tnxpix();	/* Inverse transform (world to physical) gnomonic projectio
  * Jan 10 2007	Add ANSI prototypes for all subroutines
  * Feb  1 2007	Add wcs.wcslog for log wavelength
  * Jul 25 2007	Add v2s3(), s2v3(), d2v3(), v2d3() for coordinate-vector conversion
+ *
+ * Oct 19 2026	Add wcsinitall() and wcsfreeall()
+ * Oct 19 2026	Add wcs2pixn()
+ * Oct 19 2026	Add struct WcsXform and wcsxform.c subroutines
+ * Oct 19 2026	Add struct WcsConPlan, wcsconplan(), and wcsconn()
  */
@@ -231,6 +231,42 @@ struct Range {
     int irange;		/* Index of current range */
 };
 
+/* HEALPix-indexed local catalog, mapped into memory (hpxread.c) */
+struct HpxCat {
+    char *data;		/* Catalog file mapped into memory */
+    long ldata;		/* Length of mapped file in bytes */
+    int nside;		/* HEALPix resolution parameter */
+    int nmag;		/* Number of magnitudes per star */
+    int nstars;		/* Number of stars in catalog */
+    int sysref;		/* Catalog coordinate system */
+    double eqref;	/* Catalog equinox */
+    double epref;	/* Catalog epoch */
+    int catprop;	/* 1 if proper motions are present */
+    char title[80];	/* Catalog description */
+    int *pixstart;	/* Index of first star in each RING pixel, +1 at end */
+    double *num;	/* Catalog numbers */
+    double *ra;		/* Right ascensions in degrees */
+    double *dec;	/* Declinations in degrees */
+    double *pra;	/* Right ascension proper motions */
+    double *pdec;	/* Declination proper motions */
+    double *mag[MAXNMAG]; /* Magnitudes */
+    int *type;		/* Object types */
+};
+
+/* Stars returned by a HEALPix-indexed catalog search, one array per column */
+struct HpxStars {
+    int nstars;		/* Number of stars returned */
+    int nmax;		/* Maximum number of stars to return */
+    int nmag;		/* Number of magnitudes per star */
+    double *num;	/* Catalog numbers */
+    double *ra;		/* Right ascensions in degrees */
+    double *dec;	/* Declinations in degrees */
+    double *pra;	/* Right ascension proper motions */
+    double *pdec;	/* Declination proper motions */
+    double *mag[MAXNMAG]; /* Magnitudes */
+    int *type;		/* Object types */
+};
+
 /* Flags for sorting catalog search results */
 #define SORT_UNSET	-1	/* Catalog sort flag not set yet */
 #define SORT_NONE	0	/* Do not sort catalog output */
@@ -401,7 +437,7 @@ extern "C" {
 			 * (image of number of catalog objects per bin if 0) */
 	int nlog);	/* Verbose mode if >1, number of sources per log line */
     void setgsclass(	/* Set GSC object class to return (<0=all) */
-	int class);	/* Class of objects to return */
+	int gsclass);	/* Class of objects to return */
 
 /* Subroutine to read GSC II catalog over the web */
     int gsc2read(	/* Read sources by sky region from GSC II Catalog */
@@ -657,6 +693,63 @@ extern "C" {
 			 * (image of number of catalog objects per bin if 0) */
 	int nlog);	/* Verbose mode if > 1, number of sources per log line */
 
+    struct HpxCat *hpxopen( /* Open HEALPix-indexed local catalog */
+	char *hpxfile);	/* Path name of catalog file */
+    void hpxclose(	/* Close HEALPix-indexed local catalog */
+	struct HpxCat *hc); /* HEALPix catalog descriptor */
+    int hpxcone(	/* Find stars within a circle in a HEALPix catalog */
+	struct HpxCat *hc, /* HEALPix catalog descriptor */
+	double cra,	/* Search center right ascension in degrees */
+	double cdec,	/* Search center declination in degrees */
+	double drad,	/* Search radius in degrees */
+	double mag1,	/* Limiting magnitudes (none if equal) */
+	double mag2,	/* Limiting magnitudes (none if equal) */
+	int sortmag,	/* Number of magnitude by which to limit and keep */
+	struct HpxStars *stars); /* Stars found (returned) */
+    int hpxbox(		/* Find stars within a box in a HEALPix catalog */
+	struct HpxCat *hc, /* HEALPix catalog descriptor */
+	double cra,	/* Search center right ascension in degrees */
+	double cdec,	/* Search center declination in degrees */
+	double dra,	/* Search half width in right ascension in degrees */
+	double ddec,	/* Search half-width in declination in degrees */
+	double mag1,	/* Limiting magnitudes (none if equal) */
+	double mag2,	/* Limiting magnitudes (none if equal) */
+	int sortmag,	/* Number of magnitude by which to limit and keep */
+	struct HpxStars *stars); /* Stars found (returned) */
+    struct HpxStars *hpxalloc( /* Allocate arrays for HEALPix search */
+	int nmax,	/* Maximum number of stars to return */
+	int nmag);	/* Number of magnitudes per star */
+    void hpxfree(	/* Free arrays for HEALPix search */
+	struct HpxStars *stars); /* Stars returned by a search */
+    int hpxwrite(	/* Write HEALPix-indexed local catalog */
+	char *hpxfile,	/* Path name of catalog file to write */
+	int nside,	/* HEALPix resolution parameter */
+	char *title,	/* Catalog description */
+	int sysref,	/* Catalog coordinate system */
+	double eqref,	/* Catalog equinox */
+	double epref,	/* Catalog epoch */
+	int catprop,	/* 1 if proper motions are present */
+	int nstars,	/* Number of stars */
+	int nmag,	/* Number of magnitudes per star */
+	double *num,	/* Catalog numbers */
+	double *ra,	/* Right ascensions in degrees */
+	double *dec,	/* Declinations in degrees */
+	double *pra,	/* Right ascension proper motions, or NULL */
+	double *pdec,	/* Declination proper motions, or NULL */
+	double **mag,	/* nmag arrays of magnitudes */
+	int *type);	/* Object types, or NULL */
+    int hpxconvert(	/* Convert local catalog to HEALPix-indexed catalog */
+	char *refcatname, /* Name of reference catalog */
+	char *hpxfile,	/* Path name of catalog file to write */
+	int nside,	/* HEALPix resolution parameter */
+	double mag1,	/* Limiting magnitudes (none if equal) */
+	double mag2,	/* Limiting magnitudes (none if equal) */
+	int nlog);	/* 1 to log progress */
+    int hpxpix(		/* Return HEALPix RING pixel for a position */
+	int nside,	/* HEALPix resolution parameter */
+	double ra,	/* Right ascension in degrees */
+	double dec);	/* Declination in degrees */
+
     int ujcread(	/* Read sources by sky region from USNO J Catalog */
 	char *refcatname, /* Name of catalog (UJC, xxxxx.usno) */
 	double cra,	/* Search center J2000 right ascension in degrees */
@@ -1104,6 +1197,29 @@ extern "C" {
 	int ns,		/* Number of stars to sort */
 	int nm,		/* Number of magnitudes per star */
 	int ms);	/* Magnitude by which to sort (1 to nmag) */
+    int MagSelectStars(	/* Sort brightest image stars to start of arrays */
+	double *sn,	/* Identifying number */
+	double *sra,	/* Right Ascension */
+	double *sdec,	/* Declination */
+	double *spra,	/* Right Ascension proper motion */
+	double *spdec,	/* Declination proper motion */
+	double *sx,	/* Image X coordinate */
+	double *sy,	/* Image Y coordinate */
+	double **sm,	/* Magnitudes */
+	int *sc,	/* Other 4-byte information */
+	char **sobj,	/* Object name */
+	int ns,		/* Number of stars */
+	int nm,		/* Number of magnitudes per star */
+	int ms,		/* Magnitude by which to sort (1 to nmag) */
+	int nsel);	/* Number of brightest stars to sort */
+    void MagHeapInit(	/* Put faintest of a full star list first */
+	double *mag,	/* Magnitudes of stars in list */
+	int *heap,	/* Indices of stars in heap order (returned) */
+	int n);		/* Number of stars in list */
+    int MagHeapDown(	/* Return faintest star after first one changes */
+	double *mag,	/* Magnitudes of stars in list */
+	int *heap,	/* Indices of stars in heap order */
+	int n);		/* Number of stars in list */
     void IDSortStars(	/* Sort image stars by increasing ID Number value */
 	double *sn,	/* Identifying number */
 	double *sra,	/* Right Ascension */
@@ -1418,6 +1534,17 @@ int ucacread();		/* Read sources by sky region from USNO UCAC 1 Catalog */
 int ucacrnum();		/* Read sources by ID number from USNO UCAC 1 Catalog */
 int ucacbin();		/* Bin sources from USNO UCAC 1 Catalog */
 
+/* Subroutines to read HEALPix-indexed local catalogs (hpxread.c) */
+struct HpxCat *hpxopen(); /* Open HEALPix-indexed local catalog */
+void hpxclose();	/* Close HEALPix-indexed local catalog */
+int hpxcone();		/* Find stars within a circle in a HEALPix catalog */
+int hpxbox();		/* Find stars within a box in a HEALPix catalog */
+struct HpxStars *hpxalloc(); /* Allocate arrays for HEALPix search */
+void hpxfree();		/* Free arrays for HEALPix search */
+int hpxwrite();		/* Write HEALPix-indexed local catalog */
+int hpxconvert();	/* Convert local catalog to HEALPix-indexed catalog */
+int hpxpix();		/* Return HEALPix RING pixel for a position */
+
 /* Subroutines to read local copies of USNO UJ catalog (ucacread.c) */
 int ujcread();		/* Read sources by sky region from USNO J Catalog */
 int ujcrnum();		/* Read sources by ID number from USNO J Catalog */
@@ -1487,6 +1614,9 @@ char *daoline();	/* Read line from image source position x y mag file */
 /* Subroutines for sorting tables of star positions and magnitudes from sortstar.c */
 void FluxSortStars();	/* Sort image stars by decreasing flux */
 void MagSortStars();	/* Sort image stars by increasing magnitude */
+int MagSelectStars();	/* Sort brightest image stars to start of arrays */
+void MagHeapInit();	/* Put faintest of a full star list first */
+int MagHeapDown();	/* Return faintest star after first one changes */
 void IDSortStars();	/* Sort image stars by increasing ID Number value */
 void RASortStars();	/* Sort image stars by increasing right ascension */
 void DecSortStars();	/* Sort image stars by increasing declination */
@@ -1690,4 +1820,8 @@ CASB
  * Oct 30 2009	Add position and proper motion error to star structure
  * Nov  2 2009	Add numbers of images and catalogs to star structure
  * Nov  3 2009	Parameterize as MAXNMAG the maximum number of magnitudes
+ *
+ * Oct 19 2026	Add HpxCat and HpxStars structures and hpxread.c subroutines
+ * Oct 19 2026	Rename setgsclass() argument so this header can be used from C++
+ * Oct 19 2026	Add MagSelectStars(), MagHeapInit() and MagHeapDown()
  */
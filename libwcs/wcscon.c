@@ -34,6 +34,10 @@
  *              convert coordinates and proper motion between coordinate systems
  * Subroutine:  wcsconv (sys1,sys2,eq1,eq2,ep1,ep2,dtheta,dphi,ptheta,pphi,px,rv)
  *              convert coordinates and proper motion between coordinate systems
+ * Subroutine:  wcsconplan (sys1,sys2,eq1,eq2,epoch,plan)
+ *              set up a conversion between coordinate systems as one rotation
+ * Subroutine:  wcsconn (plan,n,dtheta,dphi)
+ *              convert arrays of coordinates using a plan from wcsconplan()
  * Subroutine:	wcscsys (cstring) returns code for coordinate system in string
  * Subroutine:	wcsceq (wcstring) returns equinox in years from system string
  * Subroutine:	wcscstr (sys,equinox,epoch) returns system string from equinox
@@ -1882,6 +1886,250 @@ double	epoch;	/* Besselian epoch in years */
 }
 
 
+/* Multiply matrix m in place by rotation r (or its transpose) on the left,
+   so that r is applied after whatever m already does */
+
+static void
+planrot (r, trans, m)
+
+double	*r;	/* 3x3 rotation matrix */
+int	trans;	/* 1 to apply the transpose of r */
+double	*m;	/* 3x3 matrix (modified) */
+{
+    double t[9];
+    int i, j, k;
+
+    for (i = 0; i < 3; i++) {
+	for (j = 0; j < 3; j++) {
+	    t[3*i+j] = 0.0;
+	    for (k = 0; k < 3; k++) {
+		if (trans)
+		    t[3*i+j] = t[3*i+j] + r[3*k+i] * m[3*k+j];
+		else
+		    t[3*i+j] = t[3*i+j] + r[3*i+k] * m[3*k+j];
+		}
+	    }
+	}
+    for (i = 0; i < 9; i++)
+	m[i] = t[i];
+    return;
+}
+
+
+/* Add the J2000 to ecliptic of epoch rotation, or its inverse, as fk52ecl()
+   and ecl2fk5() do it */
+
+static void
+planecl (epoch, trans, m)
+
+double	epoch;	/* Besselian epoch in years */
+int	trans;	/* 1 for ecliptic to J2000 */
+double	*m;	/* 3x3 matrix (modified) */
+{
+    double t, eps0, rmat[9];
+    void rotmat(), mprecfk5();
+
+    if (!trans && epoch != 2000.0) {
+	mprecfk5 (2000.0, epoch, rmat);
+	planrot (rmat, 0, m);
+	}
+    t = (epoch - 2000.0) * 0.01;
+    eps0 = secrad ((84381.448 + (-46.8150 + (-0.00059 + 0.001813*t) * t) * t));
+    rotmat (1, eps0, 0.0, 0.0, rmat);
+    planrot (rmat, trans, m);
+    if (trans && epoch != 2000.0) {
+	mprecfk5 (epoch, 2000.0, rmat);
+	planrot (rmat, 0, m);
+	}
+    return;
+}
+
+
+/* Set up a conversion from coordinate system sys1 to coordinate system sys2
+   which wcsconn() can apply to any number of positions.  Every step which
+   wcscon() would take is a fixed rotation except between FK4 and FK5, so
+   the steps are multiplied into one matrix once here; conversions through
+   fk425() or fk524() are left to wcscon() one position at a time. */
+
+void
+wcsconplan (sys1, sys2, eq1, eq2, epoch, plan)
+
+int	sys1;	/* Input coordinate system (J2000, B1950, ECLIPTIC, GALACTIC */
+int	sys2;	/* Output coordinate system (J2000, B1950, ECLIPTIC, GALACTIC */
+double	eq1;	/* Input equinox (default of sys1 if 0.0) */
+double	eq2;	/* Output equinox (default of sys2 if 0.0) */
+double	epoch;	/* Besselian epoch in years */
+struct WcsConPlan *plan; /* Conversion plan (returned) */
+{
+    double ep, rmat[9];
+    int i, sky1, sky2;
+    void mprecfk4(), mprecfk5();
+
+    plan->sys1 = sys1;
+    plan->sys2 = sys2;
+    plan->eq1 = eq1;
+    plan->eq2 = eq2;
+    plan->epoch = epoch;
+    for (i = 0; i < 9; i++)
+	plan->rmat[i] = 0.0;
+    plan->rmat[0] = 1.0;
+    plan->rmat[4] = 1.0;
+    plan->rmat[8] = 1.0;
+
+    /* Set equinoxes and ICRS systems exactly as wcscon() does */
+    if (eq1 == 0.0) {
+	if (sys1 == WCS_B1950)
+	    eq1 = 1950.0;
+	else
+	    eq1 = 2000.0;
+	}
+    if (eq2 == 0.0) {
+	if (sys2 == WCS_B1950)
+	    eq2 = 1950.0;
+	else
+	    eq2 = 2000.0;
+	}
+    if (sys1 == WCS_ICRS && sys2 == WCS_ICRS)
+	eq2 = eq1;
+    if (sys1 == WCS_J2000 && sys2 == WCS_ICRS && eq1 == 2000.0) {
+	eq2 = eq1;
+	sys1 = sys2;
+	}
+    if (sys1 == WCS_ICRS && sys2 == WCS_J2000 && eq2 == 2000.0) {
+	eq1 = eq2;
+	sys1 = sys2;
+	}
+
+    /* Nothing to do */
+    if (sys2 == sys1 && eq1 == eq2) {
+	plan->mode = WCSCON_NONE;
+	return;
+	}
+
+    /* Leave non-celestial systems and FK4 <-> FK5 to wcscon() */
+    sky1 = (sys1 == WCS_J2000 || sys1 == WCS_B1950 || sys1 == WCS_ICRS ||
+	    sys1 == WCS_GALACTIC || sys1 == WCS_ECLIPTIC);
+    sky2 = (sys2 == WCS_J2000 || sys2 == WCS_B1950 || sys2 == WCS_ICRS ||
+	    sys2 == WCS_GALACTIC || sys2 == WCS_ECLIPTIC);
+    if (!sky1 || !sky2 ||
+	(sys1 == WCS_B1950 && (sys2 == WCS_J2000 || sys2 == WCS_ECLIPTIC)) ||
+	(sys2 == WCS_B1950 && (sys1 == WCS_J2000 || sys1 == WCS_ECLIPTIC))) {
+	plan->mode = WCSCON_SCALAR;
+	return;
+	}
+    plan->mode = WCSCON_ROTATE;
+
+    /* Precess from input equinox, if necessary */
+    if (eq1 != eq2) {
+	if (sys1 == WCS_B1950 && eq1 != 1950.0) {
+	    mprecfk4 (eq1, 1950.0, rmat);
+	    planrot (rmat, 0, plan->rmat);
+	    }
+	if (sys1 == WCS_J2000 && eq1 != 2000.0) {
+	    mprecfk5 (eq1, 2000.0, rmat);
+	    planrot (rmat, 0, plan->rmat);
+	    }
+	}
+
+    /* Ecliptic coordinates are referred to the epoch */
+    if (epoch > 0)
+	ep = epoch;
+    else
+	ep = 2000.0;
+
+    /* Convert to B1950 FK4, J2000 FK5, galactic, or ecliptic */
+    if (sys2 == WCS_B1950) {
+	if (sys1 == WCS_GALACTIC)
+	    planrot (&bgal[0][0], 1, plan->rmat);
+	}
+    else if (sys2 == WCS_J2000) {
+	if (sys1 == WCS_GALACTIC)
+	    planrot (&jgal[0][0], 1, plan->rmat);
+	else if (sys1 == WCS_ECLIPTIC)
+	    planecl (ep, 1, plan->rmat);
+	}
+    else if (sys2 == WCS_GALACTIC) {
+	if (sys1 == WCS_B1950)
+	    planrot (&bgal[0][0], 0, plan->rmat);
+	else if (sys1 == WCS_J2000)
+	    planrot (&jgal[0][0], 0, plan->rmat);
+	else if (sys1 == WCS_ECLIPTIC) {
+	    planecl (ep, 1, plan->rmat);
+	    planrot (&jgal[0][0], 0, plan->rmat);
+	    }
+	}
+    else if (sys2 == WCS_ECLIPTIC) {
+	if (sys1 == WCS_J2000)
+	    planecl (ep, 0, plan->rmat);
+	else if (sys1 == WCS_GALACTIC) {
+	    planrot (&jgal[0][0], 1, plan->rmat);
+	    planecl (ep, 0, plan->rmat);
+	    }
+	}
+
+    /* Precess to desired equinox, if necessary */
+    if (eq1 != eq2) {
+	if (sys2 == WCS_B1950 && eq2 != 1950.0) {
+	    mprecfk4 (1950.0, eq2, rmat);
+	    planrot (rmat, 0, plan->rmat);
+	    }
+	if (sys2 == WCS_J2000 && eq2 != 2000.0) {
+	    mprecfk5 (2000.0, eq2, rmat);
+	    planrot (rmat, 0, plan->rmat);
+	    }
+	}
+    return;
+}
+
+
+/* Convert arrays of coordinates using a plan set up by wcsconplan() */
+
+void
+wcsconn (plan, n, dtheta, dphi)
+
+struct WcsConPlan *plan; /* Conversion plan from wcsconplan() */
+int	n;		/* Number of positions */
+double	*dtheta;	/* Longitudes or right ascensions in degrees
+			   Input in sys1, returned in sys2 */
+double	*dphi;		/* Latitudes or declinations in degrees
+			   Input in sys1, returned in sys2 */
+{
+    double *r = plan->rmat;
+    double rtheta, rphi, cphi, x, y, z, v0, v1, v2;
+    int i;
+
+    if (plan->mode == WCSCON_NONE)
+	return;
+
+    if (plan->mode == WCSCON_SCALAR) {
+	for (i = 0; i < n; i++)
+	    wcscon (plan->sys1, plan->sys2, plan->eq1, plan->eq2,
+		    &dtheta[i], &dphi[i], plan->epoch);
+	return;
+	}
+
+    for (i = 0; i < n; i++) {
+	rtheta = degrad (dtheta[i]);
+	rphi = degrad (dphi[i]);
+	cphi = cos (rphi);
+	v0 = cos (rtheta) * cphi;
+	v1 = sin (rtheta) * cphi;
+	v2 = sin (rphi);
+	x = r[0]*v0 + r[1]*v1 + r[2]*v2;
+	y = r[3]*v0 + r[4]*v1 + r[5]*v2;
+	z = r[6]*v0 + r[7]*v1 + r[8]*v2;
+
+	/* Longitude between 0 and 360 degrees as v2s3() returns it */
+	rtheta = atan2 (y, x);
+	if (rtheta < 0.0)
+	    rtheta = rtheta + (2.0 * PI);
+	dtheta[i] = raddeg (rtheta);
+	dphi[i] = raddeg (atan2 (z, sqrt (x*x + y*y)));
+	}
+    return;
+}
+
+
 /* The following routines are modified from Patrick Wallace's SLALIB */
 
 /* Precess coordinates between epochs in FK4 */
@@ -2325,4 +2573,6 @@ double *r;	/* Distance to object in same units as pos (returned) */
  *
  * Aug 15 2007	Clean up code in rotmat()
  * Nov  8 2007	In wcsconp, make it clear that proper motion is in spherical coordinates
+ *
+ * Oct 19 2026	Add wcsconplan() and wcsconn() to convert many positions at once
  */
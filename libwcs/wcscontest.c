@@ -0,0 +1,124 @@
+/* File wcscontest.c
+ * Check that wcsconn() with a plan from wcsconplan() converts positions to
+ * the same coordinates as wcscon() does one position at a time, for every
+ * pair of coordinate systems, input and output equinoxes, and epochs.
+ *
+ * Positions are spread over the sky, including both poles and longitudes
+ * of 0 and 360 degrees, and the largest angular difference between the
+ * two conversions must be less than MAXDIFF degrees.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "wcs.h"
+
+#define NPOS	400
+#define NSYS	6
+#define NEQ	5
+#define NEP	4
+#define MAXDIFF	1.0e-10
+
+static int syss[NSYS] = {WCS_J2000, WCS_B1950, WCS_ICRS, WCS_GALACTIC,
+			 WCS_ECLIPTIC, WCS_ALTAZ};
+static char *sysnames[NSYS] = {"J2000","B1950","ICRS","galactic","ecliptic",
+			       "altaz"};
+static double eqs[NEQ] = {0.0, 1950.0, 2000.0, 1875.5, 2050.0};
+static double eps[NEP] = {0.0, 1950.0, 2000.0, 2026.8};
+
+/* Return the angle in degrees between two positions from the chord between
+ * them, which, unlike the arccosine in wcsdist(), keeps its precision for
+ * tiny angles */
+
+static double
+angdiff (ra1, dec1, ra2, dec2)
+
+double	ra1, dec1, ra2, dec2;
+{
+    double dx, dy, dz;
+
+    dx = cos (degrad (dec1)) * cos (degrad (ra1)) -
+	 cos (degrad (dec2)) * cos (degrad (ra2));
+    dy = cos (degrad (dec1)) * sin (degrad (ra1)) -
+	 cos (degrad (dec2)) * sin (degrad (ra2));
+    dz = sin (degrad (dec1)) - sin (degrad (dec2));
+    return (raddeg (2.0 * asin (0.5 * sqrt (dx*dx + dy*dy + dz*dz))));
+}
+
+int
+main ()
+{
+    struct WcsConPlan plan;
+    double ra0[NPOS], dec0[NPOS], ra1[NPOS], dec1[NPOS], ra2[NPOS], dec2[NPOS];
+    double diff, maxdiff;
+    int i, is1, is2, ie1, ie2, iep, npair, nbad;
+
+    srand (11);
+    for (i = 0; i < NPOS; i++) {
+	ra0[i] = 360.0 * (double) rand() / (double) RAND_MAX;
+	dec0[i] = raddeg (asin (2.0 * (double) rand() / (double) RAND_MAX - 1.0));
+	}
+    ra0[0] = 0.0;
+    dec0[0] = 90.0;
+    ra0[1] = 180.0;
+    dec0[1] = -90.0;
+    ra0[2] = 0.0;
+    dec0[2] = 0.0;
+    ra0[3] = 360.0;
+    dec0[3] = 45.0;
+
+    maxdiff = 0.0;
+    npair = 0;
+    nbad = 0;
+    for (is1 = 0; is1 < NSYS; is1++) {
+    for (is2 = 0; is2 < NSYS; is2++) {
+    for (ie1 = 0; ie1 < NEQ; ie1++) {
+    for (ie2 = 0; ie2 < NEQ; ie2++) {
+    for (iep = 0; iep < NEP; iep++) {
+	for (i = 0; i < NPOS; i++) {
+	    ra1[i] = ra0[i];
+	    dec1[i] = dec0[i];
+	    ra2[i] = ra0[i];
+	    dec2[i] = dec0[i];
+	    wcscon (syss[is1], syss[is2], eqs[ie1], eqs[ie2], &ra1[i],
+		    &dec1[i], eps[iep]);
+	    }
+	wcsconplan (syss[is1], syss[is2], eqs[ie1], eqs[ie2], eps[iep], &plan);
+	wcsconn (&plan, NPOS, ra2, dec2);
+	npair++;
+
+	diff = 0.0;
+	for (i = 0; i < NPOS; i++) {
+	    if (ra1[i] == ra2[i] && dec1[i] == dec2[i])
+		continue;
+	    if (syss[is2] == WCS_ALTAZ)
+		diff = fabs (ra1[i] - ra2[i]) + fabs (dec1[i] - dec2[i]);
+	    else
+		diff = angdiff (ra1[i], dec1[i], ra2[i], dec2[i]);
+	    if (!(diff <= maxdiff))
+		maxdiff = diff;
+	    if (!(diff < MAXDIFF)) {
+		if (nbad < 10)
+		    printf ("%s %.1f -> %s %.1f epoch %.1f: %.8f %.8f -> %.10f %.10f, plan %.10f %.10f\n",
+			    sysnames[is1], eqs[ie1], sysnames[is2], eqs[ie2],
+			    eps[iep], ra0[i], dec0[i], ra1[i], dec1[i],
+			    ra2[i], dec2[i]);
+		nbad++;
+		}
+	    }
+	}
+	}
+	}
+	}
+	}
+
+    printf ("%d conversions of %d positions, largest difference %.3g degrees\n",
+	    npair, NPOS, maxdiff);
+    if (nbad) {
+	printf ("%d positions differ by %g degrees or more\n", nbad, MAXDIFF);
+	printf ("wcscontest FAILED\n");
+	return (1);
+	}
+    printf ("wcscontest passed\n");
+    return (0);
+}
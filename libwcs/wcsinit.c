@@ -34,6 +34,8 @@
  * Subroutine:	wcsninitn (hstring,lh, name) sets a WCS structure for specified WCS
  * Subroutine:	wcsinitc (hstring, mchar) sets a WCS structure if multiple
  * Subroutine:	wcsninitc (hstring,lh,mchar) sets a WCS structure if multiple
+ * Subroutine:	wcsinitall (hstring,mchar,nwcs) sets WCS structures for all WCS
+ * Subroutine:	wcsfreeall (wcslist,nwcs) frees WCS structures from wcsinitall
  * Subroutine:	wcschar (hstring, name) returns suffix for specifed WCS
  * Subroutine:	wcseq (hstring, wcs) set radecsys and equinox from image header
  * Subroutine:	wcseqm (hstring, wcs, mchar) set radecsys and equinox if multiple
@@ -208,6 +210,117 @@ const char *hstring;	/* character string containing FITS header information
 }
 
 
+/* set up WCS structures for the primary and every alternate WCS in a FITS
+ * image header, or only for the one with suffix wchar if it is not NULL.
+ * The header is scanned once for CTYPE1a and CTYPE2a keywords to find which
+ * alternates exist, and keyword lookups go through a hash index while the structures
+ * are set.  Only structures with a usable WCS are returned, primary first
+ * and then in suffix order; free them with wcsfreeall(). */
+
+struct WorldCoor **
+wcsinitall (hstring, wchar, nwcs)
+
+const char *hstring;	/* character string containing FITS header information
+			   in the format <keyword>= <value> [/ <comment>] */
+const char *wchar;	/* Suffix of the only WCS wanted, or NULL for all */
+int	*nwcs;		/* Number of WCS structures returned */
+{
+    struct WorldCoor **wcslist, *wcs;
+    char present[27];	/* 1 if WCS with suffix (none, A-Z) may be present */
+    char mchar;
+    const char *card;
+    int lhead, icard, iwcs, indexed, c;
+
+    *nwcs = 0;
+
+    /* The primary WCS is always tried, as it need not use CTYPEi */
+    for (iwcs = 0; iwcs < 27; iwcs++)
+	present[iwcs] = (char) 0;
+    present[0] = (char) 1;
+
+    /* Find alternates with both CTYPE1a and CTYPE2a in one pass */
+    for (lhead = 0; lhead < 256000 && hstring[lhead] != (char) 0; lhead++);
+    for (icard = 0; icard + 80 <= lhead; icard = icard + 80) {
+	card = hstring + icard;
+	if (strncmp (card, "CTYPE", 5) || (card[5] != '1' && card[5] != '2'))
+	    continue;
+	c = (int) card[6];
+	if (c > 96 && c < 123)
+	    c = c - 32;
+	if (c > 64 && c < 91 && (card[7] == ' ' || card[7] == '='))
+	    present[c - 64] = present[c - 64] | (card[5] == '1' ? 2 : 4);
+	}
+    for (iwcs = 1; iwcs < 27; iwcs++)
+	present[iwcs] = (char) (present[iwcs] == 6);
+
+    /* Keep only the requested WCS */
+    if (wchar != NULL) {
+	mchar = wchar[0];
+	if (mchar > 96 && mchar < 123)
+	    mchar = mchar - 32;
+	for (iwcs = 0; iwcs < 27; iwcs++) {
+	    if (iwcs > 0 && mchar != (char) (64 + iwcs))
+		present[iwcs] = (char) 0;
+	    else if (iwcs == 0 && mchar != (char) 0 && mchar != ' ')
+		present[iwcs] = (char) 0;
+	    }
+	}
+
+    wcslist = (struct WorldCoor **) calloc (27, sizeof (struct WorldCoor *));
+    if (wcslist == NULL)
+	return (NULL);
+
+    /* Index the header keywords unless the caller already has */
+    indexed = hindexed (hstring);
+    if (!indexed)
+	hindex (hstring);
+
+    for (iwcs = 0; iwcs < 27; iwcs++) {
+	if (!present[iwcs])
+	    continue;
+	if (iwcs > 0)
+	    mchar = (char) (64 + iwcs);
+	else
+	    mchar = (char) 0;
+	wcs = wcsinitc (hstring, &mchar);
+	if (nowcs (wcs))
+	    wcsfree (wcs);
+	else
+	    wcslist[(*nwcs)++] = wcs;
+	}
+
+    if (!indexed)
+	hunindex (hstring);
+
+    if (*nwcs == 0) {
+	free (wcslist);
+	return (NULL);
+	}
+    return (wcslist);
+}
+
+
+/* free the WCS structures and list returned by wcsinitall() */
+
+void
+wcsfreeall (wcslist, nwcs)
+
+struct WorldCoor **wcslist;	/* List of WCS structures */
+int	nwcs;			/* Number of WCS structures in list */
+{
+    int iwcs;
+
+    if (wcslist == NULL)
+	return;
+    for (iwcs = 0; iwcs < nwcs; iwcs++) {
+	if (wcslist[iwcs] != NULL)
+	    wcsfree (wcslist[iwcs]);
+	}
+    free (wcslist);
+    return;
+}
+
+
 /* set up a WCS structure from a FITS image header for specified suffix */
 
 struct WorldCoor *
@@ -1380,4 +1493,6 @@ char	*mchar;		/* Suffix character for one of multiple WCS */
  * Jun 27 2008	If NAXIS1 and NAXIS2 not present, check for IMAGEW and IMAGEH
  *
  * Mar 24 2009	Fix dimension bug if NAXISi not present (fix from John Burns)
+ *
+ * Oct 19 2026	Add wcsinitall() and wcsfreeall() to set all WCS in one pass
  */
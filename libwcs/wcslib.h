@@ -205,8 +205,20 @@ struct celprm {
               double *, double *,
               struct celprm *,
               double *, double *);
+   int celfwdn(const char *, const int,
+              const double [], const double [], const int,
+              struct celprm *,
+              struct prjprm *,
+              double [], double [], const int,
+              int []);
+   int celrevn(const char *, const int,
+              const double [], const double [], const int,
+              struct prjprm *,
+              struct celprm *,
+              double [], double [], const int,
+              int []);
 #else
-   int celset(), celfwd(), celrev();
+   int celset(), celfwd(), celrev(), celfwdn(), celrevn();
 #endif
 
 extern const char *celset_errmsg[];
@@ -387,4 +399,6 @@ extern const char *wcsmix_errmsg[];
  * Mar 12 2002	Doug Mink - Update for WCSLIB 2.8.2, especially proj.h
  * Nov 29 2006	Doug Mink - Drop semicolon at end of C++ ifdef
  * Jan  4 2007	Doug Mink - Drop extra declarations of SZP subroutines
+ *
+ * Oct 19 2026	Add celfwdn() and celrevn()
  */
@@ -0,0 +1,209 @@
+/*** File libwcs/wcsxform.c
+ *** October 19, 2026
+ *** Precomputed pixel to sky transformations
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ * wcsxform (wcs)	Set up a pixel to sky transformation for a WCS
+ * wcsxfree (xf)	Free a transformation set up by wcsxform()
+ * xfpix2wcs (xf,xpix,ypix,xpos,ypos) Pixel to sky coordinates
+ * xfpix2wcsn (xf,n,xpix,ypix,xpos,ypos,offscl) Arrays of pixels to sky
+
+ * A gnomonic (TAN) WCS with nothing but a linear transformation between
+ * pixels and the projection plane reduces to an affine map from pixels
+ * to an unnormalized direction vector, whose right ascension and
+ * declination follow from two arctangents.  wcsxform() folds CRPIX, the
+ * CD matrix and the spherical rotation into that map once, and
+ * xfpix2wcs() evaluates it without going through the projection
+ * dispatch of pix2wcs().  Any other WCS is handed to pix2wcs().
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "wcs.h"
+
+/* Set up a pixel to sky transformation for a WCS, returning NULL if
+   memory cannot be allocated */
+
+struct WcsXform *
+wcsxform (wcs)
+
+struct WorldCoor *wcs;	/* World coordinate system structure */
+{
+    struct WcsXform *xf;
+    double xpos, ypos, cphip, sphip, c1, s1, r0, *eul, *piximg;
+    double mx[3], my[3], u, v, w, xp, yp, cl, sl, t[9], *r;
+    int i, j, lng, lat;
+
+    xf = (struct WcsXform *) calloc (1, sizeof (struct WcsXform));
+    if (xf == NULL)
+	return (NULL);
+    xf->wcs = wcs;
+    xf->tan = 0;
+    if (nowcs (wcs))
+	return (xf);
+
+    /* One conversion makes sure the WCSLIB structures are set up */
+    pix2wcs (wcs, wcs->xrefpix, wcs->yrefpix, &xpos, &ypos);
+
+    if (wcs->prjcode != WCS_TAN || wcs->wcsproj == WCS_OLD ||
+	wcs->wcs != NULL || wcs->distcode != 0 ||
+	wcs->lin.naxis != 2 || wcs->lin.flag != LINSET ||
+	wcs->wcsl.flag != WCSSET || wcs->wcsl.cubeface != -1 ||
+	wcs->cel.flag != CELSET || strcmp (wcs->prj.code, "TAN"))
+	return (xf);
+
+    /* Rows of the linear transformation giving projection plane x and y */
+    lng = wcs->wcsl.lng;
+    lat = wcs->wcsl.lat;
+    piximg = wcs->lin.piximg;
+    xf->crpix[0] = wcs->lin.crpix[0];
+    xf->crpix[1] = wcs->lin.crpix[1];
+
+    /* Native direction (-y, x, r0) as an affine function of pixels */
+    r0 = wcs->prj.r0;
+    for (i = 0; i < 2; i++) {
+	mx[i] = -piximg[lat*2+i];
+	my[i] = piximg[lng*2+i];
+	}
+    mx[2] = 0.0;
+    my[2] = 0.0;
+
+    /* Rotate native direction cosines to celestial ones, as celrevn() */
+    eul = wcs->cel.euler;
+    cphip = cos (eul[2] * PI / 180.0);
+    sphip = sin (eul[2] * PI / 180.0);
+    c1 = eul[3];
+    s1 = eul[4];
+    for (i = 0; i < 3; i++) {
+	u = mx[i];
+	v = my[i];
+	w = (i == 2) ? r0 : 0.0;
+	xp =  u*cphip + v*sphip;
+	yp = -u*sphip + v*cphip;
+	xf->m[i] = w*s1 - xp*c1;
+	xf->m[3+i] = -yp;
+	xf->m[6+i] = xp*s1 + w*c1;
+	}
+    xf->lng0 = eul[0];
+
+    /* A conversion to the output system which is one rotation goes into
+       the same matrix, after turning to the celestial longitude origin */
+    wcsconplan (wcs->syswcs, wcs->sysout, wcs->equinox, wcs->eqout,
+		wcs->epoch, &xf->con);
+    if (xf->con.mode == WCSCON_ROTATE) {
+	cl = cos (xf->lng0 * PI / 180.0);
+	sl = sin (xf->lng0 * PI / 180.0);
+	r = xf->con.rmat;
+	for (j = 0; j < 3; j++) {
+	    u = xf->m[j];
+	    v = xf->m[3+j];
+	    w = xf->m[6+j];
+	    xp = u*cl - v*sl;
+	    yp = u*sl + v*cl;
+	    for (i = 0; i < 3; i++)
+		t[3*i+j] = r[3*i]*xp + r[3*i+1]*yp + r[3*i+2]*w;
+	    }
+	for (i = 0; i < 9; i++)
+	    xf->m[i] = t[i];
+	xf->lng0 = 0.0;
+	xf->con.mode = WCSCON_NONE;
+	}
+    xf->tan = 1;
+    return (xf);
+}
+
+
+/* Free a transformation set up by wcsxform() */
+
+void
+wcsxfree (xf)
+
+struct WcsXform *xf;	/* Transformation from wcsxform() */
+{
+    if (xf != NULL)
+	free (xf);
+    return;
+}
+
+
+/* Convert pixel coordinates to World Coordinates, returning the off-scale
+   flag of pix2wcs() */
+
+int
+xfpix2wcs (xf, xpix, ypix, xpos, ypos)
+
+struct WcsXform *xf;	/* Transformation from wcsxform() */
+double	xpix, ypix;	/* x and y image coordinates in pixels */
+double	*xpos, *ypos;	/* RA and Dec in degrees (returned) */
+{
+    struct WorldCoor *wcs = xf->wcs;
+    double dx, dy, a, b, z, xp, yp;
+
+    if (!xf->tan) {
+	pix2wcs (wcs, xpix, ypix, xpos, ypos);
+	return (wcs->offscl);
+	}
+
+    dx = xpix - xf->crpix[0];
+    dy = ypix - xf->crpix[1];
+    a = xf->m[0]*dx + xf->m[1]*dy + xf->m[2];
+    b = xf->m[3]*dx + xf->m[4]*dy + xf->m[5];
+    z = xf->m[6]*dx + xf->m[7]*dy + xf->m[8];
+    xp = xf->lng0 + atan2 (b, a) * 180.0 / PI;
+    yp = atan2 (z, sqrt (a*a + b*b)) * 180.0 / PI;
+
+    if (xf->con.mode != WCSCON_NONE)
+	wcsconn (&xf->con, 1, &xp, &yp);
+    if (wcs->latbase == 90)
+	yp = 90.0 - yp;
+    else if (wcs->latbase == -90)
+	yp = yp - 90.0;
+
+    /* Keep RA/longitude within range as pix2wcs() does */
+    if (wcs->sysout > 0 && wcs->sysout != 6 && wcs->sysout != 10) {
+	if (xp < 0.0)
+	    xp = xp + 360.0;
+	else if (xp > 360.0)
+	    xp = xp - 360.0;
+	}
+    *xpos = xp;
+    *ypos = yp;
+    return (0);
+}
+
+
+/* Convert arrays of pixel coordinates to World Coordinates */
+
+void
+xfpix2wcsn (xf, n, xpix, ypix, xpos, ypos, offscl)
+
+struct WcsXform *xf;	/* Transformation from wcsxform() */
+int	n;		/* Number of positions */
+double	*xpix, *ypix;	/* x and y image coordinates in pixels */
+double	*xpos, *ypos;	/* RA and Dec in degrees (returned) */
+int	*offscl;	/* 0 if within bounds, else off scale (returned) */
+{
+    int i;
+
+    for (i = 0; i < n; i++)
+	offscl[i] = xfpix2wcs (xf, xpix[i], ypix[i], &xpos[i], &ypos[i]);
+    return;
+}
+
+/* Oct 19 2026	New subroutines for precomputed pixel to sky transformations
+ * Oct 19 2026	Fold rotations to the output coordinate system into the matrix
+ */
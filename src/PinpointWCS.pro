@@ -21,8 +21,14 @@ HEADERS += version.h \
            backend/FITSThread.h \
            backend/PinpointWCSUtils.h \
            backend/PPWcsImage.h \
+           backend/Session.h \
+           backend/StatisticsCache.h \
+           backend/FitsHeaderIndex.h \
+           backend/TileReader.h \
+           backend/ReferenceCatalog.h \
            # backend/RemoteData.h \
            gui/AboutDialog.h \
+           gui/CatalogOverlay.h \
            gui/Commands.h \
            gui/CoordinateMarker.h \
            gui/CoordinatePanel.h \
@@ -53,8 +59,14 @@ SOURCES += main.cpp \
            backend/FITSThread.cpp \
            backend/PinpointWCSUtils.cpp \
            backend/PPWcsImage.cpp \
+           backend/Session.cpp \
+           backend/StatisticsCache.cpp \
+           backend/FitsHeaderIndex.cpp \
+           backend/TileReader.cpp \
+           backend/ReferenceCatalog.cpp \
            # backend/RemoteData.cpp \
            gui/AboutDialog.cpp \
+           gui/CatalogOverlay.cpp \
            gui/Commands.cpp \
            gui/CoordinateMarker.cpp \
            gui/CoordinatePanel.cpp \
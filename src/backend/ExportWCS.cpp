@@ -23,6 +23,13 @@
 #include <QDebug>
 #include <QImage>
 #include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QTextStream>
+#include <QMap>
+#include <QStringList>
+#include <QtConcurrentMap>
 #include "fitsio.h"
 #include "version.h"
 #include "ExportWCS.h"
@@ -288,6 +295,14 @@ void ExportWCS::exportFITS()
 		return;
 	}
 	
+	// Write CHECKSUM and DATASUM so the export can be verified on ingest
+	if (fits_write_chksum(fptr, &status))
+	{
+		fitsexport = false;
+		emit exportResults(fitsexport);
+		return;
+	}
+	
 	// Close FITS file
 	if (fits_close_file(fptr, &status))
 	{
@@ -313,6 +328,231 @@ void ExportWCS::exportAVMDetailed()
 	exportAVM(true);
 }
 
+
+// Open an image for update, falling back on packet scanning when no smart handler exists
+static bool openForUpdate(SXMPFiles &epoimage, const std::string &f)
+{
+	XMP_OptionBits opts = kXMPFiles_OpenForUpdate|kXMPFiles_OpenUseSmartHandler;
+	
+	bool ok = epoimage.OpenFile(f, kXMP_UnknownFile, opts);
+	if (!ok)
+	{
+		qDebug() << "No smart handler available for the file.";
+		qDebug() << "Trying packet scanning ...";
+		
+		// Packet scanning technique
+		opts = kXMPFiles_OpenForUpdate|kXMPFiles_OpenUsePacketScanning;
+		ok = epoimage.OpenFile(f, kXMP_UnknownFile, opts);
+	}
+	return ok;
+}
+
+
+// Replace the coordinate and publisher metadata of an XMP packet with the computed WCS
+static void setSpatialMetadata(SXMPMeta &avm, struct WorldCoor *wcs, ComputeWCS *computewcs, bool detailed)
+{
+	// Register namespaces
+	std::string avmprefix;
+//	std::string cxcprefix;
+	SXMPMeta::RegisterNamespace(kXMP_NS_AVM, "avm", &avmprefix);
+//	SXMPMeta::RegisterNamespace(kXMP_NS_CXC, "cxc", &cxcprefix);
+	
+	// Clean the existing Coordinate Metadata
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.CoordinateFrame");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Equinox");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.ReferenceValue");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.ReferenceDimension");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.ReferencePixel");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Scale");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Rotation");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.CoordsystemProjection");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Quality");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Notes");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.FITSheader");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.CDMatrix");	// Just in case some outdated AVM is stored
+	
+	// Clean existing Publisher Metadata
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Publisher.MetadataDate");
+	avm.DeleteProperty(kXMP_NS_AVM, "avm:Publisher.MetadataVersion");
+	
+	// Clean the existing CXC Metadata
+//	avm.DeleteProperty(kXMP_NS_CXC, "cxc:WCSResolver");
+//	avm.DeleteProperty(kXMP_NS_CXC, "cxc:WCSResolverVersion");
+//	avm.DeleteProperty(kXMP_NS_CXC, "cxc:WCSResolverRevision");
+	
+	// Initialize QStrings to format the WCS data
+	QString equinox = QString("%1").arg(wcs->equinox, 0, 'f', 1);
+	QString crval1 = QString("%1").arg(wcs->xref, 0, 'f', 11);
+	QString crval2 = QString("%1").arg(wcs->yref, 0, 'f', 11);				
+	QString crpix1 = QString("%1").arg(wcs->xrefpix - 0.5, 0, 'f', 11);
+	QString crpix2 = QString("%1").arg(wcs->yrefpix + 0.5, 0, 'f', 11);
+	QString scale1 = QString("%1").arg(-1*computewcs->scale, 0, 'f', 11);
+	QString scale2 = QString("%1").arg(computewcs->scale, 0, 'f', 11);
+	QString orientation = QString("%1").arg(computewcs->orientation, 0, 'f', 11);
+	QString width = QString("%1").arg(computewcs->width, 0, 'f', 2);
+	QString height = QString("%1").arg(computewcs->height, 0, 'f', 2);
+	QString spatialnotes = QString("World Coordinate System resolved using PinpointWCS %1 revision %2 by the Chandra X-ray Center").arg(VERSION).arg(REVISION);
+	
+	// Add the pixel coordinates to Spatial.Notes
+	if (detailed)
+	{
+		QString data = QString("\n\n%1\t\t%2\t\t%3\t\t%4\n").arg("FITS X").arg("FITS Y").arg("EPO X").arg("EPO Y");
+		spatialnotes.append(data);
+		
+		for (int i=0; i < computewcs->refCoords->size(); i++)
+		{
+			QString data = QString("%1\t\t%2\t\t%3\t\t%4\n").arg(computewcs->refCoords->at(i).x(), 0, 'f', 2).arg(computewcs->refCoords->at(i).y(), 0, 'f', 2).arg(computewcs->epoCoords->at(i).x(), 0, 'f', 2).arg(computewcs->epoCoords->at(i).y(), 0, 'f', 2);
+			spatialnotes.append(data);
+		}
+		
+		// Get the center pixel (for STScI)
+		QString center_x = QString("\n%1").arg(computewcs->width/2., 0, 'f', 2);
+		QString center_y = QString("%1").arg(computewcs->height/2., 0, 'f', 2);
+		QString center_ra = QString("%1").arg(computewcs->centerRA, 0, 'f', 11);
+		QString center_dec = QString("%1").arg(computewcs->centerDec, 0, 'f', 11);
+		
+		QString centerpix = QString("\nCenter Pixel Coordinates:%1\t%2\n%3\t%4").arg(center_x).arg(center_ra).arg(center_y).arg(center_dec);
+		spatialnotes.append(centerpix);
+	}
+	
+	// Begin modifying AVM
+	XMP_OptionBits itemOptions;
+	itemOptions = kXMP_PropValueIsArray|kXMP_PropArrayIsOrdered;
+	
+	// Set the Coordinate Metadata
+	avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.CoordinateFrame", "ICRS", 0);
+	avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.Equinox", equinox.toStdString(), 0);
+	avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceValue", itemOptions, crval1.toStdString());
+	avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceValue", itemOptions, crval2.toStdString());
+	avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceDimension", itemOptions, width.toStdString());
+	avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceDimension", itemOptions, height.toStdString());
+	avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferencePixel", itemOptions, crpix1.toStdString());
+	avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferencePixel", itemOptions, crpix2.toStdString());				
+	avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.Scale", itemOptions, scale1.toStdString());
+	avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.Scale", itemOptions, scale2.toStdString());
+	avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.Rotation", orientation.toStdString(), 0);
+	avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.CoordsystemProjection", "TAN", 0);
+	avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.Quality", "Full", 0);
+	avm.SetLocalizedText(kXMP_NS_AVM, "avm:Spatial.Notes", "x-default", "x-default", spatialnotes.toStdString(), 0);
+//	avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.FITSheader", "SPATIAL FITS HEADER TEST", 0);
+	
+	// Set Publisher Metadata
+	XMP_DateTime updatedTime;
+	SXMPUtils::CurrentDateTime(&updatedTime);
+	avm.SetProperty_Date(kXMP_NS_AVM, "avm:MetadataDate", updatedTime, 0);
+	avm.SetProperty(kXMP_NS_AVM, "avm:MetadataVersion", AVM_VERSION, 0);
+	
+	// Set CXC Metadata
+//	avm.SetProperty(kXMP_NS_CXC, "cxc:WCSResolver", "PinpointWCS developed by the Chandra X-ray Center", 0);
+//	avm.SetProperty(kXMP_NS_CXC, "cxc:WCSResolverVersion", VERSION, 0);
+//	avm.SetProperty(kXMP_NS_CXC, "cxc:WCSResolverRevision", REVISION, 0);
+}
+
+
+// Serialize the XMP object to RDF and dump it to a text file
+static bool writePacket(SXMPMeta &avm, const QString &path)
+{
+	std::string xmpstr;
+	avm.SerializeToBuffer(&xmpstr);
+	
+	std::ofstream outFile;
+	outFile.open(path.toStdString().c_str());
+	if (!outFile.is_open())
+		return false;
+	outFile << xmpstr;
+	outFile.close();
+	
+	return !outFile.fail();
+}
+
+
+// Key identifying an image in the manifest, so that different spellings
+// of the same path name a single entry
+static QString manifestKey(const QString &image)
+{
+	QFileInfo info(image);
+	QString key = info.canonicalFilePath();
+	return key.isEmpty() ? info.absoluteFilePath() : key;
+}
+
+
+// Record a sidecar in the manifest kept alongside the image, replacing any
+// earlier entry for the same image
+static bool recordInManifest(const QString &image, const QString &sidecar)
+{
+	QFileInfo info(image);
+	QFile manifest(info.absoluteDir().filePath(SIDECAR_MANIFEST));
+	QString key = manifestKey(image);
+	
+	// Keep the entries for other images
+	QStringList lines;
+	if (manifest.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		QTextStream in(&manifest);
+		while (!in.atEnd())
+		{
+			QString line = in.readLine();
+			if (!line.isEmpty() && manifestKey(line.section('\t', 0, 0)) != key)
+				lines << line;
+		}
+		manifest.close();
+	}
+	
+	lines << QString("%1\t%2\t%3").arg(info.absoluteFilePath()).arg(QFileInfo(sidecar).absoluteFilePath()).arg(QDateTime::currentDateTime().toString(Qt::ISODate));
+	
+	if (!manifest.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+		return false;
+	
+	QTextStream out(&manifest);
+	for (int i=0; i < lines.size(); i++)
+		out << lines.at(i) << "\n";
+	out.flush();
+	manifest.close();
+	
+	return manifest.error() == QFile::NoError;
+}
+
+
+// Embed a single manifest entry into its image.  Called concurrently
+// from embedSidecars, so it must not touch any ExportWCS state.
+static bool embedSidecar(const QString &entry)
+{
+	QString image = entry.section('\t', 0, 0);
+	QString sidecar = entry.section('\t', 1, 1);
+	
+	// Read the serialized packet
+	QFile packetFile(sidecar);
+	if (!packetFile.open(QIODevice::ReadOnly))
+	{
+		qDebug() << "Could not read sidecar" << sidecar;
+		return false;
+	}
+	QByteArray packet = packetFile.readAll();
+	packetFile.close();
+	
+	try
+	{
+		SXMPMeta avm(packet.constData(), packet.size());
+		SXMPFiles epoimage;
+		
+		if (!openForUpdate(epoimage, image.toStdString()))
+			return false;
+		
+		bool ok = epoimage.CanPutXMP(avm);
+		if (ok)
+			epoimage.PutXMP(avm);
+		epoimage.CloseFile();
+		
+		return ok;
+	}
+	catch (XMP_Error &e)
+	{
+		std::cout << "Error: " << e.GetErrMsg() << std::endl;
+		return false;
+	}
+}
+
+
 void ExportWCS::exportXMP()
 {
 	qDebug() << "Attempting to export XMP Packet ...";
@@ -334,26 +574,12 @@ void ExportWCS::exportXMP()
 	{
 		try
 		{
-			// Put the good stuff here
-			
-			// Set some options that will be used to open the file
-			XMP_OptionBits opts = kXMPFiles_OpenForUpdate|kXMPFiles_OpenUseSmartHandler;
-			
 			// Initialize some variables
 			bool ok;
 			SXMPFiles epoimage;
 			
 			// Open the file
-			ok = epoimage.OpenFile(f, kXMP_UnknownFile, opts);
-			if (!ok)
-			{
-				qDebug() << "No smart handler available for the file.";
-				qDebug() << "Trying packet scanning ...";
-				
-				// Packet scanning technique
-				opts = kXMPFiles_OpenForUpdate|kXMPFiles_OpenUsePacketScanning;
-				ok = epoimage.OpenFile(f, kXMP_UnknownFile, opts);
-			}
+			ok = openForUpdate(epoimage, f);
 			
 			// Procede if file is open
 			if (ok)
@@ -362,66 +588,8 @@ void ExportWCS::exportXMP()
 				SXMPMeta avm;
 				epoimage.GetXMP(&avm);
 				
-				// Register namespaces
-				std::string avmprefix;
-				SXMPMeta::RegisterNamespace(kXMP_NS_AVM, "avm", &avmprefix);
-				
-				// Clean the existing Coordinate Metadata
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.CoordinateFrame");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Equinox");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.ReferenceValue");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.ReferenceDimension");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.ReferencePixel");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Scale");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Rotation");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.CoordsystemProjection");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Quality");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Notes");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.FITSheader");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.CDMatrix");	// Just in case some outdated AVM is stored
-				
-				// Clean existing Publisher Metadata
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Publisher.MetadataDate");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Publisher.MetadataVersion");
-				
-				// Initialize QStrings to format the WCS data
-				QString equinox = QString("%1").arg(wcs->equinox, 0, 'f', 1);
-				QString crval1 = QString("%1").arg(wcs->xref, 0, 'f', 11);
-				QString crval2 = QString("%1").arg(wcs->yref, 0, 'f', 11);				
-				QString crpix1 = QString("%1").arg(wcs->xrefpix - 0.5, 0, 'f', 11);
-				QString crpix2 = QString("%1").arg(wcs->yrefpix + 0.5, 0, 'f', 11);
-				QString scale1 = QString("%1").arg(-1*computewcs->scale, 0, 'f', 11);
-				QString scale2 = QString("%1").arg(computewcs->scale, 0, 'f', 11);
-				QString orientation = QString("%1").arg(computewcs->orientation, 0, 'f', 11);
-				QString width = QString("%1").arg(computewcs->width, 0, 'f', 2);
-				QString height = QString("%1").arg(computewcs->height, 0, 'f', 2);
-				QString spatialnotes = QString("World Coordinate System resolved using PinpointWCS %1 revision %2 by the Chandra X-ray Center").arg(VERSION).arg(REVISION);
-								
-				// Begin modifying AVM
-				XMP_OptionBits itemOptions;
-				itemOptions = kXMP_PropValueIsArray|kXMP_PropArrayIsOrdered;
-				
-				// Set the Coordinate Metadata
-				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.CoordinateFrame", "ICRS", 0);
-				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.Equinox", equinox.toStdString(), 0);
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceValue", itemOptions, crval1.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceValue", itemOptions, crval2.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceDimension", itemOptions, width.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceDimension", itemOptions, height.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferencePixel", itemOptions, crpix1.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferencePixel", itemOptions, crpix2.toStdString());				
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.Scale", itemOptions, scale1.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.Scale", itemOptions, scale2.toStdString());
-				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.Rotation", orientation.toStdString(), 0);
-				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.CoordsystemProjection", "TAN", 0);
-				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.Quality", "Full", 0);
-				avm.SetLocalizedText(kXMP_NS_AVM, "avm:Spatial.Notes", "x-default", "x-default", spatialnotes.toStdString(), 0);
-				
-				// Set Publisher Metadata
-				XMP_DateTime updatedTime;
-				SXMPUtils::CurrentDateTime(&updatedTime);
-				avm.SetProperty_Date(kXMP_NS_AVM, "avm:MetadataDate", updatedTime, 0);
-				avm.SetProperty(kXMP_NS_AVM, "avm:MetadataVersion", AVM_VERSION, 0);
+				// Set the coordinate and publisher metadata
+				setSpatialMetadata(avm, wcs, computewcs, false);
 				
 				//
 				// Dump XMP packet to text file
@@ -437,16 +605,8 @@ void ExportWCS::exportXMP()
 					return;
 				}
 				
-				// Serialize the XMP object to RDF
-				std::string xmpstr;
-				avm.SerializeToBuffer(&xmpstr);
-				std::ofstream outFile;
-				outFile.open(saveas.toStdString().c_str());
-				outFile << xmpstr;
-				outFile.close();
-
 				// Broadcast results
-				emit exportResults(true);
+				emit exportResults(writePacket(avm, saveas));
 			}
 			else
 				emit exportResults(false);
@@ -471,15 +631,20 @@ void ExportWCS::exportXMP()
 	}
 }
 
-void ExportWCS::exportAVM(bool detailed)
+
+bool ExportWCS::exportAVMSidecar(bool detailed)
 {
-	qDebug() << "Attempting to export AVM ...";
+	qDebug() << "Attempting to export AVM sidecar ...";
 	
 	std::string f = filename->toStdString();
+	bool ok = false;
 	
 	// Initialize the Adobe XMP Toolkit
 	if (!SXMPMeta::Initialize())
+	{
 		emit exportResults(false);
+		return false;
+	}
 	
 	// Set some options
 	XMP_OptionBits options = 0;
@@ -492,26 +657,129 @@ void ExportWCS::exportAVM(bool detailed)
 	{
 		try
 		{
-			// Put the good stuff here
+			// Start from the packet already in the image.  The image itself is
+			// only opened for reading, but the sidecar and the manifest are
+			// written into its directory, which must therefore be writable.
+			SXMPMeta avm;
+			SXMPFiles epoimage;
+			
+			bool opened = epoimage.OpenFile(f, kXMP_UnknownFile, kXMPFiles_OpenForRead|kXMPFiles_OpenUseSmartHandler);
+			if (!opened)
+				opened = epoimage.OpenFile(f, kXMP_UnknownFile, kXMPFiles_OpenForRead|kXMPFiles_OpenUsePacketScanning);
+			if (opened)
+			{
+				epoimage.GetXMP(&avm);
+				epoimage.CloseFile();
+			}
+			
+			// Set the coordinate and publisher metadata
+			setSpatialMetadata(avm, wcs, computewcs, detailed);
 			
-			// Set some options that will be used to open the file
-			XMP_OptionBits opts = kXMPFiles_OpenForUpdate|kXMPFiles_OpenUseSmartHandler;
+			// Write the sidecar next to the image and index it
+			saveas = *filename+".xmp";
+			ok = writePacket(avm, saveas) && recordInManifest(*filename, saveas);
+			emit exportResults(ok);
+		}
+		catch (XMP_Error &e)
+		{
+			std::cout << "Error: " << e.GetErrMsg() << std::endl;
 			
+			// Broadcast results
+			emit exportResults(false);
+		}
+		
+		// Terminate the XMP Toolkit
+		SXMPFiles::Terminate();
+		SXMPMeta::Terminate();
+	}
+	else
+	{
+		qDebug() << "Could not initialize SXMPFiles!";
+		SXMPMeta::Terminate();
+		
+		// Broadcast results
+		emit exportResults(false);
+	}
+	
+	return ok;
+}
+
+
+int ExportWCS::embedSidecars(const QString &manifest)
+{
+	qDebug() << "Embedding AVM sidecars from" << manifest << "...";
+	
+	// Read the manifest, keeping only the latest sidecar for each image
+	QFile file(manifest);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return -1;
+	
+	QMap<QString, QString> entries;
+	QTextStream in(&file);
+	while (!in.atEnd())
+	{
+		QString line = in.readLine();
+		if (line.section('\t', 1, 1).isEmpty())
+			continue;
+		entries.insert(manifestKey(line.section('\t', 0, 0)), line);
+	}
+	file.close();
+	
+	// Initialize the Adobe XMP Toolkit once for all worker threads
+	if (!SXMPMeta::Initialize())
+		return -1;
+	
+	XMP_OptionBits options = 0;
+#if UNIX_ENV
+	options |= kXMPFiles_ServerMode;
+#endif
+	
+	if (!SXMPFiles::Initialize(options))
+	{
+		qDebug() << "Could not initialize SXMPFiles!";
+		SXMPMeta::Terminate();
+		return -1;
+	}
+	
+	// Each image is independent, so embed them in parallel
+	QList<bool> results = QtConcurrent::blockingMapped<QList<bool> >(entries.values(), embedSidecar);
+	
+	// Terminate the XMP Toolkit
+	SXMPFiles::Terminate();
+	SXMPMeta::Terminate();
+	
+	qDebug() << results.count(true) << "of" << results.size() << "sidecars embedded";
+	return results.count(true);
+}
+
+
+void ExportWCS::exportAVM(bool detailed)
+{
+	qDebug() << "Attempting to export AVM ...";
+	
+	std::string f = filename->toStdString();
+	
+	// Initialize the Adobe XMP Toolkit
+	if (!SXMPMeta::Initialize())
+		emit exportResults(false);
+	
+	// Set some options
+	XMP_OptionBits options = 0;
+#if UNIX_ENV
+	options |= kXMPFiles_ServerMode;
+#endif
+	
+	// Initialize SXMPFiles
+	if (SXMPFiles::Initialize(options))
+	{
+		try
+		{
 			// Initialize some variables
 			bool ok;
 			SXMPFiles epoimage;
 			
 			// Open the file
-			ok = epoimage.OpenFile(f, kXMP_UnknownFile, opts);
-			if (!ok)
-			{
-				qDebug() << "No smart handler available for the file.";
-				qDebug() << "Trying packet scanning ...";
-				
-				// Packet scanning technique
-				opts = kXMPFiles_OpenForUpdate|kXMPFiles_OpenUsePacketScanning;
-				ok = epoimage.OpenFile(f, kXMP_UnknownFile, opts);
-			}
+			ok = openForUpdate(epoimage, f);
 			
 			// Procede if file is open
 			if (ok)
@@ -520,101 +788,8 @@ void ExportWCS::exportAVM(bool detailed)
 				SXMPMeta avm;
 				epoimage.GetXMP(&avm);
 				
-				// Register namespaces
-				std::string avmprefix;
-//				std::string cxcprefix;
-				SXMPMeta::RegisterNamespace(kXMP_NS_AVM, "avm", &avmprefix);
-//				SXMPMeta::RegisterNamespace(kXMP_NS_CXC, "cxc", &cxcprefix);
-				
-				// Clean the existing Coordinate Metadata
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.CoordinateFrame");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Equinox");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.ReferenceValue");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.ReferenceDimension");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.ReferencePixel");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Scale");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Rotation");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.CoordsystemProjection");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Quality");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.Notes");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.FITSheader");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Spatial.CDMatrix");	// Just in case some outdated AVM is stored
-				
-				// Clean existing Publisher Metadata
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Publisher.MetadataDate");
-				avm.DeleteProperty(kXMP_NS_AVM, "avm:Publisher.MetadataVersion");
-				
-				// Clean the existing CXC Metadata
-//				avm.DeleteProperty(kXMP_NS_CXC, "cxc:WCSResolver");
-//				avm.DeleteProperty(kXMP_NS_CXC, "cxc:WCSResolverVersion");
-//				avm.DeleteProperty(kXMP_NS_CXC, "cxc:WCSResolverRevision");
-				
-				// Initialize QStrings to format the WCS data
-				QString equinox = QString("%1").arg(wcs->equinox, 0, 'f', 1);
-				QString crval1 = QString("%1").arg(wcs->xref, 0, 'f', 11);
-				QString crval2 = QString("%1").arg(wcs->yref, 0, 'f', 11);				
-				QString crpix1 = QString("%1").arg(wcs->xrefpix - 0.5, 0, 'f', 11);
-				QString crpix2 = QString("%1").arg(wcs->yrefpix + 0.5, 0, 'f', 11);
-				QString scale1 = QString("%1").arg(-1*computewcs->scale, 0, 'f', 11);
-				QString scale2 = QString("%1").arg(computewcs->scale, 0, 'f', 11);
-				QString orientation = QString("%1").arg(computewcs->orientation, 0, 'f', 11);
-				QString width = QString("%1").arg(computewcs->width, 0, 'f', 2);
-				QString height = QString("%1").arg(computewcs->height, 0, 'f', 2);
-				QString spatialnotes = QString("World Coordinate System resolved using PinpointWCS %1 revision %2 by the Chandra X-ray Center").arg(VERSION).arg(REVISION);
-				
-				// Add the pixel coordinates to Spatial.Notes
-				if (detailed)
-				{
-					QString data = QString("\n\n%1\t\t%2\t\t%3\t\t%4\n").arg("FITS X").arg("FITS Y").arg("EPO X").arg("EPO Y");
-					spatialnotes.append(data);
-					
-					for (int i=0; i < computewcs->refCoords->size(); i++)
-					{
-						QString data = QString("%1\t\t%2\t\t%3\t\t%4\n").arg(computewcs->refCoords->at(i).x(), 0, 'f', 2).arg(computewcs->refCoords->at(i).y(), 0, 'f', 2).arg(computewcs->epoCoords->at(i).x(), 0, 'f', 2).arg(computewcs->epoCoords->at(i).y(), 0, 'f', 2);
-						spatialnotes.append(data);
-					}
-					
-					// Get the center pixel (for STScI)
-					QString center_x = QString("\n%1").arg(computewcs->width/2., 0, 'f', 2);
-					QString center_y = QString("%1").arg(computewcs->height/2., 0, 'f', 2);
-					QString center_ra = QString("%1").arg(computewcs->centerRA, 0, 'f', 11);
-					QString center_dec = QString("%1").arg(computewcs->centerDec, 0, 'f', 11);
-				
-					QString centerpix = QString("\nCenter Pixel Coordinates:%1\t%2\n%3\t%4").arg(center_x).arg(center_ra).arg(center_y).arg(center_dec);
-					spatialnotes.append(centerpix);
-				}
-				
-				// Begin modifying AVM
-				XMP_OptionBits itemOptions;
-				itemOptions = kXMP_PropValueIsArray|kXMP_PropArrayIsOrdered;
-				
-				// Set the Coordinate Metadata
-				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.CoordinateFrame", "ICRS", 0);
-				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.Equinox", equinox.toStdString(), 0);
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceValue", itemOptions, crval1.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceValue", itemOptions, crval2.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceDimension", itemOptions, width.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferenceDimension", itemOptions, height.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferencePixel", itemOptions, crpix1.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.ReferencePixel", itemOptions, crpix2.toStdString());				
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.Scale", itemOptions, scale1.toStdString());
-				avm.AppendArrayItem(kXMP_NS_AVM, "avm:Spatial.Scale", itemOptions, scale2.toStdString());
-				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.Rotation", orientation.toStdString(), 0);
-				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.CoordsystemProjection", "TAN", 0);
-				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.Quality", "Full", 0);
-				avm.SetLocalizedText(kXMP_NS_AVM, "avm:Spatial.Notes", "x-default", "x-default", spatialnotes.toStdString(), 0);
-//				avm.SetProperty(kXMP_NS_AVM, "avm:Spatial.FITSheader", "SPATIAL FITS HEADER TEST", 0);
-				
-				// Set Publisher Metadata
-				XMP_DateTime updatedTime;
-				SXMPUtils::CurrentDateTime(&updatedTime);
-				avm.SetProperty_Date(kXMP_NS_AVM, "avm:MetadataDate", updatedTime, 0);
-				avm.SetProperty(kXMP_NS_AVM, "avm:MetadataVersion", AVM_VERSION, 0);
-				
-                                // Set CXC Metadata
-//				avm.SetProperty(kXMP_NS_CXC, "cxc:WCSResolver", "PinpointWCS developed by the Chandra X-ray Center", 0);
-//				avm.SetProperty(kXMP_NS_CXC, "cxc:WCSResolverVersion", VERSION, 0);
-//				avm.SetProperty(kXMP_NS_CXC, "cxc:WCSResolverRevision", REVISION, 0);
+				// Set the coordinate and publisher metadata
+				setSpatialMetadata(avm, wcs, computewcs, detailed);
 				
 				// Write XMP object to file
 				if (epoimage.CanPutXMP(avm))
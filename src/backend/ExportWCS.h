@@ -30,6 +30,9 @@
 
 #define AVM_VERSION "1.2"
 
+// Index of AVM sidecars written next to the images they describe
+#define SIDECAR_MANIFEST "pinpointwcs_sidecars.txt"
+
 class ExportWCS : public QObject {
 	
 	Q_OBJECT
@@ -43,11 +46,15 @@ public:
 	void setWCS(struct WorldCoor *w);
 	void clearWCS();
 	
+	// Embed every sidecar listed in a manifest into its image
+	static int embedSidecars(const QString &manifest);
+	
 public slots:
 	void exportFITS();
 	void exportAVMClean();
 	void exportAVMDetailed();
 	void exportXMP();
+	bool exportAVMSidecar(bool detailed = false);
 	
 signals:
 	void exportResults(bool success);
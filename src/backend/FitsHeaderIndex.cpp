@@ -0,0 +1,87 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QDebug>
+
+#include "FitsHeaderIndex.h"
+
+
+FitsHeaderIndex::FitsHeaderIndex(fitsfile *fptr)
+{
+	status = 0;
+	numhdus = 0;
+	
+	fits_get_num_hdus(fptr, &numhdus, &status);
+	if (status)
+	{
+		fits_report_error(stderr, status);
+		return;
+	}
+	
+	for (int kk=1; kk <= numhdus; kk++)
+	{
+		int hdutype, naxis;
+		int ncards;
+		char *header = NULL;
+		FitsHeader entry;
+		status = 0;
+		
+		fits_movabs_hdu(fptr, kk, &hdutype, &status);
+		fits_get_hdu_type(fptr, &hdutype, &status);
+		if (status or hdutype != IMAGE_HDU)
+			continue;
+		
+		// Compressed images report their uncompressed dimensions here
+		fits_get_img_dim(fptr, &naxis, &status);
+		if (status or naxis != 2)
+			continue;
+		fits_get_img_size(fptr, 2, entry.naxisn, &status);
+		if (status)
+			continue;
+		
+		// Tile compressed headers are translated to those of the image
+		fits_convert_hdr2str(fptr, 1, NULL, 0, &header, &ncards, &status);
+		if (status)
+		{
+			free(header);
+			fits_report_error(stderr, status);
+			continue;
+		}
+		entry.hdu = kk;
+		entry.header = QByteArray(header);
+		free(header);
+		
+		qDebug() << "Indexed HDU" << kk << ncards << "cards";
+		images << entry;
+	}
+	status = 0;
+}
+
+
+FitsHeaderIndex::~FitsHeaderIndex()
+{}
+
+
+const FitsHeader *FitsHeaderIndex::find(int hdu) const
+{
+	for (int ii=0; ii < images.size(); ii++)
+		if (images[ii].hdu == hdu)
+			return &images[ii];
+	return NULL;
+}
@@ -0,0 +1,52 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FITSHEADERINDEX_H
+#define FITSHEADERINDEX_H
+
+#include <QList>
+#include <QByteArray>
+
+// External libraries
+#include "fitsio.h"
+
+// Header of a single two dimensional image HDU
+struct FitsHeader {
+	int hdu;
+	long naxisn[2];
+	QByteArray header;	// Concatenated 80 character cards, as passed to WCSTools
+};
+
+// Index of the image HDUs in a FITS file, built from the headers alone.
+// No pixel data is read, so choosing an HDU costs a pass over the header
+// records only, regardless of how large (or compressed) the images are.
+class FitsHeaderIndex {
+	
+public:
+	FitsHeaderIndex(fitsfile *fptr);
+	~FitsHeaderIndex();
+	
+	int status;
+	int numhdus;
+	QList<FitsHeader> images;
+	
+	const FitsHeader *find(int hdu) const;
+};
+
+#endif
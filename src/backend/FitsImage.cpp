@@ -18,6 +18,9 @@
  */
 
 #include <QDebug>
+#include <QSettings>
+#include <QCoreApplication>
+#include <QtConcurrentRun>
 
 #include <algorithm>
 #include <exception>
@@ -25,6 +28,40 @@
 #include "math.h"
 #include "FitsImage.h"
 #include "PinpointWCSUtils.h"
+#include "StatisticsCache.h"
+#include "FitsHeaderIndex.h"
+#include "TileReader.h"
+
+
+// Runs on a worker thread, with its own handle, while the image is read
+static int verifyChecksum(fitsfile *vptr)
+{
+	int dataok, hduok;
+	int vstatus = 0;
+	
+	if (fits_verify_chksum(vptr, &dataok, &hduok, &vstatus))
+		return CHECKSUM_UNCHECKED;
+	if (dataok < 0 || hduok < 0)
+		return CHECKSUM_INVALID;
+	if (dataok == 0 && hduok == 0)
+		return CHECKSUM_MISSING;
+	return CHECKSUM_VALID;
+}
+
+
+// Waits for the verification started on vptr, then closes the handle
+static int finishChecksum(fitsfile *&vptr, QFuture<int> &verification)
+{
+	int vstatus = 0;
+	int result;
+	
+	if (!vptr)
+		return CHECKSUM_UNCHECKED;
+	result = verification.result();
+	fits_close_file(vptr, &vstatus);
+	vptr = NULL;
+	return result;
+}
 
 
 FitsImage::FitsImage(QString &fileName) : PPWcsImage()
@@ -36,14 +73,19 @@ FitsImage::FitsImage(QString &fileName) : PPWcsImage()
 	status = 0;
 	lowerPercentile = 0.0025;
 	upperPercentile = 0.9975;
+	stretch = LINEAR_STRETCH;
 	
 	downsampled = false;
+	levelsRestored = false;
+	checksum = CHECKSUM_UNCHECKED;
+	wcsxf = NULL;
 }
 
 
 FitsImage::~FitsImage()
 {
 	qDebug() << "~FitsImage";
+	wcsxfree(wcsxf);
 	free(imagedata);
 	free(fptr);
 }
@@ -58,68 +100,93 @@ bool FitsImage::setup()
 	imagedata = NULL;
 	renderdata = NULL;
 	
-	// Open FITS file
-	fits_open_file(&fptr, filename.toStdString().c_str(), READONLY, &status);
+#ifdef CFITSIO_BUFFER_POOL
+	// Headers of every HDU are scanned before the chosen image is read, so
+	// keep a pool large enough to hold them and read ahead through the pixels.
+	// The pool applies to every file cfitsio opens, so the previous one is
+	// restored as soon as this file is open.
+	int poolbuffers, poolreadahead;
+	fits_get_buffer_pool(&poolbuffers, &poolreadahead, &status);
+	fits_set_buffer_pool(FITS_IOBUFFERS, FITS_READAHEAD, &status);
+#endif
+	
+	// Open FITS file, memory mapped where cfitsio provides the mmap:// driver,
+	// and gzipped files through gzstream:// so pixels are read while inflating
+	if (filename.endsWith(".gz", Qt::CaseInsensitive))
+		fitsurl = "gzstream://" + filename;
+	else
+		fitsurl = "mmap://" + filename;
+	fits_open_file(&fptr, fitsurl.toStdString().c_str(), READONLY, &status);
+	if (status)
+	{
+		status = 0;
+		fits_clear_errmsg();
+		fitsurl = filename;
+		fits_open_file(&fptr, fitsurl.toStdString().c_str(), READONLY, &status);
+	}
+#ifdef CFITSIO_BUFFER_POOL
+	int poolstatus = 0;
+	fits_set_buffer_pool(poolbuffers, poolreadahead, &poolstatus);
+#endif
 	if (status)
 	{
 		fits_report_error(stderr, status);
 		return false;
 	}
 	
-	// Check the number of HDUs
-	fits_get_num_hdus(fptr, &numhdus, &status);
-	if (status)
+	// Index the image HDUs from their headers, before any pixels are read
+	FitsHeaderIndex index(fptr);
+	if (index.status)
 	{
-		fits_report_error(stderr, status);
+		fits_close_file(fptr, &status);
 		return false;
 	}
+	numhdus = index.numhdus;
 	
 	// Set number of images to zero
 	numimgs = 0;
 	
-	// Begin looping over each HDU
-	for (int kk=1; kk <= numhdus; kk++)
+	// Check for statistics from a previous open of this file
+	StatisticsCache cache(filename);
+	bool cached = cache.lookup();
+	if (cached && !index.find(cache.hdu))
+		cached = false;
+	
+	// Try the image HDU chosen last time first, then the rest in order
+	QList<const FitsHeader*> candidates;
+	if (cached)
+		candidates << index.find(cache.hdu);
+	for (int ii=0; ii < index.images.size(); ii++)
+		if (!cached || index.images[ii].hdu != cache.hdu)
+			candidates << &index.images[ii];
+	
+	// Begin looping over the candidate image HDUs
+	for (int cc=0; cc < candidates.size(); cc++)
 	{
 		int ii;
+		const FitsHeader *entry = candidates[cc];
+		int kk = entry->hdu;
 		status = 0;
 		
-		// Change to another HDU and check type
-		fits_movabs_hdu(fptr, kk, &hdutype, &status);
-		fits_get_hdu_type(fptr, &hdutype, &status);
-		
 		qDebug() << "Header Number: " << kk;
 		
-		if (hdutype != IMAGE_HDU)
-			continue;
-		
-		// Check image dimensions and size
-		fits_get_img_dim(fptr, &naxis, &status);
-		if (status)
-		{
-			qDebug() << "fits_get_img_dim";
-			fits_report_error(stderr, status);
-			continue;
-		}
+		naxis = 2;
+		naxisn[0] = entry->naxisn[0];
+		naxisn[1] = entry->naxisn[1];
+		width = naxisn[0];
+		height = naxisn[1];
 		
-		if (naxis != 2)
-		{
-			qDebug() << "Image does not have the correct dimensions ...";
+		// Check that the image contains sufficient WCS
+		if ( !verifyWCS(*entry, (cached && cache.hdu == kk) ? cache.alt : 0) )
 			continue;
-		}
 		
-		fits_get_img_size(fptr, 2, naxisn, &status);
+		// Only now move to the HDU holding the pixels
+		fits_movabs_hdu(fptr, kk, &hdutype, &status);
 		if (status)
 		{
-			qDebug() << "fits_get_img_size";
 			fits_report_error(stderr, status);
 			continue;
 		}
-		width = naxisn[0];
-		height = naxisn[1];
-		
-		// Check that the image contains sufficient WCS
-		if ( !verifyWCS() )
-			continue;
 		
 		// Compute the total number of pixels in image array
 		numelements = width*height;
@@ -136,6 +203,36 @@ bool FitsImage::setup()
 		}
 		qDebug() << "BITPIX: " << bitpix;
 		
+		// Verify the checksums on a second handle, overlapping the pixel read,
+		// downsampling and statistics below rather than adding to the load time
+		QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
+		fitsfile *vptr = NULL;
+		QFuture<int> verification;
+		if (settings.value("verifychecksums", false).toBool())
+		{
+			int vstatus = 0;
+			fits_open_file(&vptr, fitsurl.toStdString().c_str(), READONLY, &vstatus);
+			fits_movabs_hdu(vptr, kk, NULL, &vstatus);
+			if (vstatus)
+			{
+				if (vptr)
+					fits_close_file(vptr, &vstatus);
+				vptr = NULL;
+				fits_clear_errmsg();
+			}
+			else if (!fits_is_reentrant())
+			{
+				// cfitsio is not thread safe, and a gzstream:// file is
+				// inflated by whichever thread reads it, so verify here
+				checksum = verifyChecksum(vptr);
+				fits_close_file(vptr, &vstatus);
+				vptr = NULL;
+				qDebug() << "Checksum verification:" << checksum;
+			}
+			else
+				verification = QtConcurrent::run(verifyChecksum, vptr);
+		}
+		
 		// Allocate memory for the first pixel
 		fpixel = (long *) malloc(naxis * sizeof(long));
 		
@@ -143,21 +240,61 @@ bool FitsImage::setup()
 		for (ii=0; ii<naxis; ii++)
 			fpixel[ii] = 1;
 		
+		// Images too large for either axis are binned while they are read, so
+		// the full resolution array is never held in memory
+		M = 1;
+		downsampled = false;
+		if (width > DOWNSAMPLE_SIZE or height > DOWNSAMPLE_SIZE)
+		{
+			if (width > height)
+				M = width / DOWNSAMPLE_SIZE;
+			else
+				M = height / DOWNSAMPLE_SIZE;
+			qDebug() << "Downsampling Factor:" << M;
+			
+			long newW, newH;
+			fits_read_img_binned(fptr, M, NULL, &newW, &newH, &status);
+			width = newW;
+			height = newH;
+			numelements = width * height;
+			downsampled = true;
+		}
+		
 		// Allocate memory for the image pixels
 		imagedata = (float *) malloc(numelements * sizeof(float));
 		if (!imagedata)
 		{
 			qDebug() << "Failed to allocate memory for the image array ...";
 			free(fpixel);
+			finishChecksum(vptr, verification);
 			continue;
 		}
 		
-		fits_read_pix(fptr, TFLOAT, fpixel, numelements, NULL, imagedata, NULL, &status);
+		// Tile compressed images are decompressed in parallel bands
+		TileReader tiles(fitsurl, fptr, kk);
+		if (downsampled)
+		{
+			if (tiles.isTiled())
+				tiles.readBinned(imagedata, M, &status);
+			else
+			{
+				long newW, newH;
+				fits_read_img_binned(fptr, M, imagedata, &newW, &newH, &status);
+			}
+		}
+		else
+		{
+			if (tiles.isTiled())
+				tiles.read(imagedata, width, height, &status);
+			else
+				fits_read_pix(fptr, TFLOAT, fpixel, numelements, NULL, imagedata, NULL, &status);
+		}
 		free(fpixel);		
 		if (status)
 		{
 			// Free the allocated memory
 			free(imagedata);
+			finishChecksum(vptr, verification);
 			qDebug() << "fits_read_pix";
 			fits_report_error(stderr, status);
 			continue;
@@ -178,27 +315,49 @@ bool FitsImage::setup()
 		*/
 		// Set some default parameters (or only one for now)
 		inverted = false;
-		
-		// Downsample the image if either axis is too large
-		if (width > DOWNSAMPLE_SIZE or height > DOWNSAMPLE_SIZE){
-			if (width > height)
-				M = width / DOWNSAMPLE_SIZE;
-			else
-				M = height / DOWNSAMPLE_SIZE;
+
+		if (cached && cache.hdu == kk)
+		{
+			// Reuse the statistics computed the last time
+			minpixel = cache.minpixel;
+			maxpixel = cache.maxpixel;
+			if (!levelsRestored)
+			{
+				vmin = cache.vmin;
+				vmax = cache.vmax;
+				lowerLimit = cache.lowerLimit;
+				upperLimit = cache.upperLimit;
+				difference = vmax - vmin;
+			}
+		}
+		else
+		{
+			// Calculate the minimum and maximum pixel values
+			calculateExtremals();
 			
-			// Begin downsampling
-			int newW, newH;
-			downsample(&imagedata, width, height, M, &newW, &newH);
-			width = newW;
-			height = newH;
-			numelements = width * height;
+			// Calcuate percentiles, unless they were restored from a session
+			if (!levelsRestored)
+			{
+				calculatePercentile(lowerPercentile, upperPercentile);
+				
+				// Save the statistics for the next open
+				cache.hdu = kk;
+				cache.alt = alt;
+				cache.minpixel = minpixel;
+				cache.maxpixel = maxpixel;
+				cache.vmin = vmin;
+				cache.vmax = vmax;
+				cache.lowerLimit = lowerLimit;
+				cache.upperLimit = upperLimit;
+				cache.store();
+			}
 		}
-
-		// Calculate the minimum and maximum pixel values
-		calculateExtremals();
 		
-		// Calcuate percentiles
-		calculatePercentile(lowerPercentile, upperPercentile);
+		if (vptr)
+		{
+			checksum = finishChecksum(vptr, verification);
+			qDebug() << "Checksum verification:" << checksum;
+		}
 		
 		// Initialize a working array
 		renderdata = (float *) malloc(numelements * sizeof(float));
@@ -210,7 +369,7 @@ bool FitsImage::setup()
 		}
 		
 		// Calibrate Image
-		if ( !calibrateImage(LINEAR_STRETCH, vmin, vmax) )
+		if ( !calibrateImage(stretch, vmin, vmax) )
 			continue;
 		
 		break;
@@ -220,6 +379,13 @@ bool FitsImage::setup()
 		break;
 	}
 	
+#ifdef CFITSIO_BUFFER_POOL
+	long hits, misses, rahits;
+	int bufstatus = 0;
+	fits_get_buffer_stats(fptr, &hits, &misses, &rahits, &bufstatus);
+	qDebug() << "I/O buffers:" << hits << "hits," << misses << "misses," << rahits << "read ahead";
+#endif
+	
 	// Seems that no HDU was appropriate ...
 	fits_close_file(fptr, &status);
 	
@@ -230,61 +396,57 @@ bool FitsImage::setup()
 }
 
 
-bool FitsImage::verifyWCS()
+bool FitsImage::verifyWCS(const FitsHeader &entry, char althint)
 {
 
 	qDebug() << "Verifying World Coordinate System ...";
-	// Define all the variables needed for complete WCS
-	char *header;
-	int ncards;
+	char *header = (char *) entry.header.constData();
 	alt = NULL;
-	
-	// Call cfitsio routines to get the header
-	fits_hdr2str(fptr, 1, NULL, 0, &header, &ncards, &status);
-	if (status)
+	wcs = NULL;
+	
+	// Try the hinted alternate (if any) on its own first, then set up every
+	// WCS the header defines in a single pass and take the first, which is
+	// the primary when it is usable
+	int nwcs = 0;
+	struct WorldCoor **wcslist = NULL;
+	if (althint)
 	{
-		// Free the allocated memory
-		free(header);
-		qDebug() << "fits_hdr2str";
-		fits_report_error(stderr, status);
-		return false;
+		char hint[2] = {althint, 0};
+		wcslist = wcsinitall(header, hint, &nwcs);
 	}
+	if (!wcslist)
+		wcslist = wcsinitall(header, NULL, &nwcs);
 	
-	// Pass header to WCSTools
-	wcs = wcsinit(header);
-	if (nowcs(wcs))
+	if (wcslist)
 	{
-		// No primary WCS found, check alternates
-		int ii;
-		char *alts = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-		for (ii=0; ii<26; ii++)
-		{
-			wcs = wcsinitc(header, &alts[ii]);
-			if (nowcs(wcs))
-			{
-				// Check if the last possible alternate
-				if (ii==25)
-				{
-					qDebug() << "No WCS found ...";
-					free(header);
-					return false;
-				}
-				// Try next alternate
-				continue;
-			}
-			
-			// Alternate WCS found
-			alt = alts[ii];
+		wcs = wcslist[0];
+		alt = wcs->wcschar;
+		if (alt)
 			qDebug() << "Alternate WCS found, " << alt;
-			break;			
-		}
+		
+		// Keep the chosen WCS, free the others
+		wcslist[0] = NULL;
+		wcsfreeall(wcslist, nwcs);
+	}
+	
+	if (!wcs)
+	{
+		qDebug() << "No WCS found ...";
+		return false;
 	}
 	
+	// Keep the header so the WCS can be rebuilt without reopening the file
+	wcsheader = entry.header;
+	
 	// Set output coordinates, needed by pix2wcs
 	wcsoutinit(wcs, "J2000");
+	
+	// Precompute the pixel to sky transformation for the cursor readout
+	wcsxfree(wcsxf);
+	wcsxf = wcsxform(wcs);
+	wcsconplan(wcs->syswcs, WCS_J2000, wcs->equinox, wcs->eqout, wcs->epoch, &j2000con);
 //	PinpointWCSUtils::dumpWCS(wcs);
 	
-	qDebug() << "WCS found!!!";\
 	return true;
 }
 
@@ -293,7 +455,8 @@ void FitsImage::calculateExtremals()
 {
 	int i;
 	// Determine min and max
-	for (i=0; i<numelements; i++)
+	minpixel = maxpixel = imagedata[0];
+	for (i=1; i<numelements; i++)
 	{
 		if (imagedata[i] < minpixel)
 			minpixel = imagedata[i];
@@ -302,38 +465,6 @@ void FitsImage::calculateExtremals()
 	}
 }
 
-// Borrowed from Astrometry.net code
-void FitsImage::downsample(float** arr, int W, int H, int S, int* newW, int* newH)
-{
-	qDebug() << "Downsampling Factor:" << S;
-	
-	int i, j, I, J;
-	
-	*newW = (W + S-1) / S;
-	*newH = (H + S-1) / S;
-	
-	// Average SxS blocks, placing the result in the bottom (newW * newH) first pixels.
-	for (j=0; j<*newH; j++) {
-        for (i=0; i<*newW; i++) {
-            float sum = 0.0;
-            int N = 0;
-            for (J=0; J<S; J++) {
-                if (j*S + J >= H)
-                    break;
-                for (I=0; I<S; I++) {
-                    if (i*S + I >= W)
-                        break;
-					sum += (*arr)[(j*S + J)*W + (i*S + I)];
-					N++;
-                }
-            }
-            (*arr)[j * (*newW) + i] = sum / (float)N;
-        }
-    }
-	*arr = (float *) realloc(*arr, (*newW) * (*newH) * sizeof(float));
-	downsampled = true;
-}
-
 bool FitsImage::calculatePercentile(float lp, float up)
 {		
 	// Set some variables and parameters
@@ -568,6 +699,18 @@ bool FitsImage::calibrateImage(int s, float minpix, float maxpix)
 	return true;
 }
 
+void FitsImage::restoreLevels(int s, float minpix, float maxpix, float lower, float upper)
+{
+	// Must be called before setup() so the percentile pass can be skipped
+	stretch = s;
+	vmin = minpix;
+	vmax = maxpix;
+	lowerLimit = lower;
+	upperLimit = upper;
+	difference = vmax - vmin;
+	levelsRestored = true;
+}
+
 void FitsImage::setStretch(int s)
 {
 	qDebug() << "Setting Stretch";
@@ -615,6 +758,37 @@ QPointF FitsImage::fpix2pix(QPointF pos)
 }
 
 
+int FitsImage::sky2pix(int n, const double *ra, const double *dec, QVector<QPointF> &pos, QVector<int> &index)
+{
+	// Project a batch of positions, in the coordinate system of the WCS,
+	// keeping the scene positions of those that fall on the image
+	pos.clear();
+	index.clear();
+	if (!wcs)
+		return 0;
+	
+	pos.reserve(n);
+	index.reserve(n);
+	
+	// Project the whole batch at once rather than calling wcs2pix per star
+	QVector<double> xf(n), yf(n);
+	QVector<int> offscl(n);
+	wcs2pixn(wcs, n, const_cast<double*>(ra), const_cast<double*>(dec), xf.data(), yf.data(), offscl.data());
+	
+	for (int i=0; i<n; i++)
+	{
+		if (offscl[i])
+			continue;
+		
+		// Transform FITS pixels to binned QGraphicsScene pixels (the inverse of fpix2pix)
+		pos.append(QPointF((xf[i]-1.5)/M + 1, (naxisn[1]-yf[i]-0.5)/M + 1));
+		index.append(i);
+	}
+	
+	return pos.size();
+}
+
+
 float FitsImage::pixelIntensity(QPointF pos)
 {
 	if (pos.x() > 0 && pos.x() < width && pos.y() > 0 && pos.y() < height)
@@ -772,11 +946,14 @@ double* FitsImage::pix2sky(QPointF pos)
 	xf = xf+0.5;
 	yf = (naxisn[1]-yf)+0.5;
 	
-	pix2wcs(wcs, xf, yf, &world[0], &world[1]);
+	if (wcsxf)
+		xfpix2wcs(wcsxf, xf, yf, &world[0], &world[1]);
+	else
+		pix2wcs(wcs, xf, yf, &world[0], &world[1]);
 	
 	// Check if coordinates are other than J2000
 	if (wcs->syswcs != WCS_J2000)
-		wcscon(wcs->syswcs, WCS_J2000, wcs->equinox, wcs->eqout, &world[0], &world[1], wcs->epoch);
+		wcsconn(&j2000con, 1, &world[0], &world[1]);
 	
 	// Perhaps the transformationStatus needs to be checked ...
 	return world;
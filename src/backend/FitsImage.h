@@ -21,6 +21,7 @@
 #define FITSIMAGE_H
 
 #include <QImage>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 class QPixmap;
@@ -33,9 +34,22 @@ QT_END_NAMESPACE
 
 #include "PPWcsImage.h"
 
+struct FitsHeader;
+
 #define DOWNSAMPLE_SIZE 2048
 //#define DOWNSAMPLE_SIZE 6144
 
+// cfitsio buffer pool used when loading: buffers of 2880 bytes kept per file,
+// and records read ahead while pixels are read sequentially
+#define FITS_IOBUFFERS 512
+#define FITS_READAHEAD 32
+
+// Outcome of verifying the CHECKSUM and DATASUM keywords on open
+#define CHECKSUM_UNCHECKED 0
+#define CHECKSUM_MISSING 1
+#define CHECKSUM_VALID 2
+#define CHECKSUM_INVALID 3
+
 #define LINEAR_STRETCH 0
 #define LOG_STRETCH 1
 #define SQRT_STRETCH 2
@@ -59,9 +73,14 @@ public:
 	float* imagedata;
 	int stretch;
 	QPixmap pixmap;
+	QByteArray wcsheader;
+	char alt;
+	int checksum;			// One of CHECKSUM_*, verified when the preference is set
 	
 	// Public Methods
 	QPointF fpix2pix(QPointF pos);
+	int sky2pix(int n, const double *ra, const double *dec, QVector<QPointF> &pos, QVector<int> &index);
+	void restoreLevels(int s, float minpix, float maxpix, float lower, float upper);
 	
 public slots:
 	void setStretch(int s);
@@ -77,16 +96,18 @@ signals:
 	
 private:
 	// Methods
-	bool verifyWCS();
+	bool verifyWCS(const FitsHeader &entry, char althint = 0);
 	void calculateExtremals();
-	void downsample(float** arr, int W, int H, int S, int* newW, int* newH);
 	bool calculatePercentile(float lp, float up);
 	bool calibrateImage(int s, float minpix, float maxpix);
 	float pixelIntensity(QPointF pos);
 		
 	// Attributes
 	fitsfile *fptr;
+	QString fitsurl;
 	int status, wcsstatus;
+	struct WcsXform *wcsxf;		// Precomputed pixel to sky transformation
+	struct WcsConPlan j2000con;	// Precomputed conversion to J2000
 	int numhdus, numimgs, naxis, hdutype;
 	long width, height;
 	long numelements;
@@ -95,8 +116,8 @@ private:
 	float* renderdata;
 	float lowerPercentile;
 	float upperPercentile;
-	char alt;
 	bool inverted;
+	bool levelsRestored;
 };
 
 #endif
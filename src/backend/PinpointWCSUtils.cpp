@@ -24,6 +24,9 @@
 #include <math.h>
 
 #include <QString>
+#include <QFile>
+#include <QDataStream>
+#include <QCryptographicHash>
 
 #include "PinpointWCSUtils.h"
 
@@ -217,5 +220,32 @@ namespace PinpointWCSUtils {
 		
 	} // dumpWCS
 	
+	// Hash the size and the whole content of a file, a block at a time, so
+	// that an image edited anywhere is told apart from the one a session or
+	// the statistics cache was saved with.
+	QByteArray fingerprint(const QString &path)
+	{
+		const qint64 blocksize = 1 << 20;
+		QFile file(path);
+		if (!file.open(QIODevice::ReadOnly))
+			return QByteArray();
+		
+		QCryptographicHash hash(QCryptographicHash::Md5);
+		QByteArray size;
+		QDataStream(&size, QIODevice::WriteOnly) << file.size();
+		hash.addData(size);
+		while (!file.atEnd())
+		{
+			QByteArray block = file.read(blocksize);
+			if (block.isEmpty())
+				break;
+			hash.addData(block);
+		}
+		bool ok = file.error() == QFile::NoError;
+		file.close();
+		
+		return ok ? hash.result() : QByteArray();
+	} // fingerprint
+	
 }  // namespace
 
@@ -20,6 +20,9 @@
 #ifndef PINPOINTWCS_UTILS_H
 #define PINPOINTWCS_UTILS_H
 
+#include <QString>
+#include <QByteArray>
+
 #include "wcs.h"
 
 namespace PinpointWCSUtils
@@ -32,6 +35,9 @@ namespace PinpointWCSUtils
 	
 	// Functions for checking WCS
 	void dumpWCS(struct WorldCoor *wcs);
+	
+	// Functions for identifying files across sessions
+	QByteArray fingerprint(const QString &path);
 };
 
 #endif
@@ -0,0 +1,180 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QDebug>
+#include <string.h>
+#include "ReferenceCatalog.h"
+#include "wcscat.h"
+
+ReferenceCatalog::ReferenceCatalog()
+{
+	found = 0;
+}
+
+
+ReferenceCatalog::~ReferenceCatalog() {}
+
+
+bool ReferenceCatalog::load(const QString &name, FitsImage *image, int maxstars)
+{
+	qDebug() << "Loading reference catalog" << name << "...";
+	title = name;
+	found = 0;
+	positions.clear();
+	magnitudes.clear();
+	
+	if (!image->wcs)
+		return false;
+	
+	QByteArray catname = name.toLocal8Bit();
+	QVector<double> ra(maxstars), dec(maxstars), mag(maxstars);
+	
+	int nstars;
+	if (name.endsWith(".hpx"))
+		nstars = readHealpix(catname.data(), image->wcs, maxstars, ra.data(), dec.data(), mag.data());
+	else
+		nstars = readCatalog(catname.data(), image->wcs, maxstars, ra.data(), dec.data(), mag.data());
+	if (nstars < 0)
+		return false;
+	
+	// Project the whole batch onto the image at once
+	QVector<int> index;
+	image->sky2pix(nstars, ra.data(), dec.data(), positions, index);
+	magnitudes.resize(index.size());
+	for (int i=0; i<index.size(); i++)
+		magnitudes[i] = mag[index[i]];
+	
+	qDebug() << found << "stars in region," << positions.size() << "on the image";
+	return true;
+}
+
+
+int ReferenceCatalog::readCatalog(char *refcatname, struct WorldCoor *wcs, int maxstars, double *ra, double *dec, double *mag)
+{
+	char cattitle[80];
+	int syscat, catprop, nmag;
+	double eqcat, epcat;
+	int refcat = RefCat(refcatname, cattitle, &syscat, &eqcat, &epcat, &catprop, &nmag);
+	
+	// Search a little beyond the edges of the image, in its own coordinate system
+	double cra, cdec, dra, ddec;
+	wcssize(wcs, &cra, &cdec, &dra, &ddec);
+	dra = 1.05*dra;
+	ddec = 1.05*ddec;
+	int sysout = wcs->syswcs;
+	double eqout = wcs->equinox;
+	double epout = wcs->epoch;
+	
+	QVector<double> num(maxstars), pra(maxstars), pdec(maxstars), mags((MAXNMAG+1)*maxstars);
+	QVector<int> type(maxstars);
+	double *gmag[MAXNMAG+1];
+	for (int i=0; i<=MAXNMAG; i++)
+		gmag[i] = mags.data() + i*maxstars;
+	
+	struct StarCat *starcat = NULL;
+	int nstars;
+	switch (refcat)
+	{
+		case UCAC1:
+		case UCAC2:
+		case UCAC3:
+			nstars = ucacread(refcatname, cra, cdec, dra, ddec, 0.0, 0.0, 0, sysout, eqout, epout, 0.0, 0.0, 1, maxstars,
+							  num.data(), ra, dec, pra.data(), pdec.data(), gmag, type.data(), 0);
+			break;
+		case TYCHO2:
+		case TYCHO2E:
+			nstars = ty2read(refcat, cra, cdec, dra, ddec, 0.0, 0.0, 0, sysout, eqout, epout, 0.0, 0.0, 1, maxstars,
+							 num.data(), ra, dec, pra.data(), pdec.data(), gmag, type.data(), 0);
+			break;
+		case TMPSC:
+		case TMPSCE:
+		case TMIDR2:
+		case TMXSC:
+			nstars = tmcread(refcat, cra, cdec, dra, ddec, 0.0, 0.0, 0, sysout, eqout, epout, 0.0, 0.0, 1, maxstars,
+							 num.data(), ra, dec, gmag, type.data(), 0);
+			break;
+		case BINCAT:
+			nstars = binread(refcatname, 0, cra, cdec, dra, ddec, 0.0, 0.0, sysout, eqout, epout, 0.0, 0.0, 1, maxstars,
+							 &starcat, num.data(), ra, dec, pra.data(), pdec.data(), gmag, type.data(), NULL, 0);
+			if (starcat)
+				binclose(starcat);
+			break;
+		case TXTCAT:
+			nstars = ctgread(refcatname, refcat, 0, cra, cdec, dra, ddec, 0.0, 0.0, sysout, eqout, epout, 0.0, 0.0, 1, maxstars,
+							 &starcat, num.data(), ra, dec, pra.data(), pdec.data(), gmag, type.data(), NULL, 0);
+			if (starcat)
+				ctgclose(starcat);
+			break;
+		default:
+			qDebug() << "No local reader for catalog" << refcatname;
+			return -1;
+	}
+	if (nstars < 0)
+		return -1;
+	
+	title = cattitle;
+	found = nstars;
+	if (nstars > maxstars)
+		nstars = maxstars;
+	if (nmag > 0)
+		memcpy(mag, gmag[0], nstars*sizeof(double));
+	else
+		memset(mag, 0, nstars*sizeof(double));
+	return nstars;
+}
+
+
+int ReferenceCatalog::readHealpix(char *refcatname, struct WorldCoor *wcs, int maxstars, double *ra, double *dec, double *mag)
+{
+	struct HpxCat *hc = hpxopen(refcatname);
+	if (!hc)
+		return -1;
+	
+	// HEALPix catalogs are stored in J2000, so search there and convert back
+	double cra, cdec, dra, ddec;
+	wcssize(wcs, &cra, &cdec, &dra, &ddec);
+	dra = 1.05*dra;
+	ddec = 1.05*ddec;
+	bool convert = (wcs->syswcs != WCS_J2000 || wcs->equinox != 2000.0);
+	if (convert)
+		wcscon(wcs->syswcs, WCS_J2000, wcs->equinox, 2000.0, &cra, &cdec, wcs->epoch);
+	
+	struct HpxStars *stars = hpxalloc(maxstars, hc->nmag);
+	if (!stars)
+	{
+		hpxclose(hc);
+		return -1;
+	}
+	found = hpxbox(hc, cra, cdec, dra, ddec, 0.0, 0.0, 1, stars);
+	
+	int nstars = stars->nstars;
+	for (int i=0; i<nstars; i++)
+	{
+		ra[i] = stars->ra[i];
+		dec[i] = stars->dec[i];
+		mag[i] = (hc->nmag > 0) ? stars->mag[0][i] : 0.0;
+		if (convert)
+			wcscon(WCS_J2000, wcs->syswcs, 2000.0, wcs->equinox, &ra[i], &dec[i], wcs->epoch);
+	}
+	
+	title = hc->title;
+	hpxfree(stars);
+	hpxclose(hc);
+	return nstars;
+}
@@ -0,0 +1,52 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef REFERENCECATALOG_H
+#define REFERENCECATALOG_H
+
+#include <QString>
+#include <QVector>
+#include <QPointF>
+
+#include "FitsImage.h"
+
+#define CATALOG_MAXSTARS 100000
+
+// Stars from a local reference catalog that fall on a FITS image.  Any
+// catalog the libwcs readers know by name (ucac2, ucac3, tycho2, tmc, ...),
+// an ASCII or binary catalog file, or a HEALPix-indexed .hpx file may be used.
+class ReferenceCatalog {
+	
+public:
+	ReferenceCatalog();
+	~ReferenceCatalog();
+	
+	bool load(const QString &name, FitsImage *image, int maxstars = CATALOG_MAXSTARS);
+	
+	QString title;
+	int found;					// Stars in the search region, may exceed maxstars
+	QVector<QPointF> positions;	// Scene positions of the stars on the image
+	QVector<float> magnitudes;
+	
+private:
+	int readCatalog(char *refcatname, struct WorldCoor *wcs, int maxstars, double *ra, double *dec, double *mag);
+	int readHealpix(char *refcatname, struct WorldCoor *wcs, int maxstars, double *ra, double *dec, double *mag);
+};
+
+#endif
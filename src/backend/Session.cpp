@@ -0,0 +1,170 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QDebug>
+#include <QFile>
+#include <QDataStream>
+
+#include "Session.h"
+#include "ComputeWCS.h"
+#include "ExportWCS.h"
+#include "PinpointWCSUtils.h"
+
+
+Session::Session()
+{
+	stretch = 0;
+	vmin = vmax = lowerLimit = upperLimit = 0;
+	M = 1;
+	alt = 0;
+	width = height = 0;
+}
+
+
+Session::~Session()
+{}
+
+
+bool Session::save(const QString &path)
+{
+	qDebug() << "Saving session to" << path << "...";
+	
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	
+	// Fingerprint the images so a stale session can be detected on load
+	fitsHash = PinpointWCSUtils::fingerprint(fitsPath);
+	epoHash = PinpointWCSUtils::fingerprint(epoPath);
+	
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_4_6);
+	out << (quint32) SESSION_MAGIC << (quint32) SESSION_VERSION;
+	out << fitsPath << epoPath << fitsHash << epoHash;
+	out << refCoords << epoCoords;
+	out << (qint32) stretch << vmin << vmax << lowerLimit << upperLimit << (qint32) M;
+	out << wcsheader << (qint8) alt;
+	out << width << height;
+	file.close();
+	
+	return out.status() == QDataStream::Ok;
+}
+
+
+bool Session::load(const QString &path)
+{
+	qDebug() << "Loading session from" << path << "...";
+	
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_4_6);
+	
+	// Check that this is a session file we understand
+	quint32 magic, version;
+	in >> magic >> version;
+	if (magic != SESSION_MAGIC || version > SESSION_VERSION)
+	{
+		qDebug() << "Not a PinpointWCS session file ...";
+		return false;
+	}
+	
+	qint32 s, m;
+	qint8 a;
+	in >> fitsPath >> epoPath >> fitsHash >> epoHash;
+	in >> refCoords >> epoCoords;
+	in >> s >> vmin >> vmax >> lowerLimit >> upperLimit >> m;
+	in >> wcsheader >> a;
+	in >> width >> height;
+	file.close();
+	
+	stretch = s;
+	M = m;
+	alt = a;
+	
+	// Every reference marker needs a (possibly unset) EPO partner
+	if (refCoords.size() != epoCoords.size())
+		return false;
+	
+	return in.status() == QDataStream::Ok;
+}
+
+
+bool Session::verify()
+{
+	// Images must still exist and be unchanged since the session was saved
+	if (PinpointWCSUtils::fingerprint(fitsPath) != fitsHash)
+	{
+		qDebug() << "FITS image has changed since the session was saved ...";
+		return false;
+	}
+	if (PinpointWCSUtils::fingerprint(epoPath) != epoHash)
+	{
+		qDebug() << "EPO image has changed since the session was saved ...";
+		return false;
+	}
+	return true;
+}
+
+
+struct WorldCoor* Session::referenceWCS()
+{
+	if (wcsheader.isEmpty())
+		return NULL;
+	
+	// Rebuild the reference WCS from the stored header, without touching pixels
+	struct WorldCoor *wcs = wcsinitc(wcsheader.constData(), &alt);
+	if (nowcs(wcs))
+		return NULL;
+	wcsoutinit(wcs, "J2000");
+	
+	return wcs;
+}
+
+
+bool Session::exportSidecar()
+{
+	struct WorldCoor *refWCS = referenceWCS();
+	if (!refWCS)
+		return false;
+	
+	// Refit the EPO WCS from the stored correspondence pairs
+	ComputeWCS computewcs(&refCoords, &epoCoords, refWCS, width, height);
+	computewcs.setDownsampleFactor(M);
+	computewcs.computeTargetWCS();
+	if (!computewcs.epoWCS)
+	{
+		qDebug() << "Not enough points in session to compute a WCS ...";
+		wcsfree(refWCS);
+		return false;
+	}
+	
+	// Write the AVM next to the EPO image
+	struct WorldCoor *targetWCS = computewcs.initTargetWCS();
+	ExportWCS exportwcs(&epoPath, NULL, &computewcs);
+	exportwcs.setWCS(targetWCS);
+	bool ok = exportwcs.exportAVMSidecar();
+	
+	wcsfree(targetWCS);
+	wcsfree(refWCS);
+	return ok;
+}
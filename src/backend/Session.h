@@ -0,0 +1,69 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QPointF>
+
+#include "wcs.h"
+
+#define SESSION_MAGIC 0x50505753	// "PPWS"
+#define SESSION_VERSION 1
+#define SESSION_EXTENSION "ppwcs"
+
+class Session {
+	
+public:
+	Session();
+	~Session();
+	
+	bool save(const QString &path);
+	bool load(const QString &path);
+	bool verify();
+	struct WorldCoor* referenceWCS();
+	bool exportSidecar();
+	
+	// Images and their fingerprints when the session was saved
+	QString fitsPath;
+	QString epoPath;
+	QByteArray fitsHash;
+	QByteArray epoHash;
+	
+	// Correspondence pairs from the CoordinateModel
+	QList<QPointF> refCoords;
+	QList<QPointF> epoCoords;
+	
+	// Display state of the FITS image
+	int stretch;
+	float vmin, vmax, lowerLimit, upperLimit;
+	int M;
+	
+	// Reference WCS, kept as the header it was parsed from
+	QByteArray wcsheader;
+	char alt;
+	
+	// Dimensions of the EPO image
+	double width, height;
+};
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QDesktopServices>
+
+#include "StatisticsCache.h"
+#include "FitsImage.h"
+#include "PinpointWCSUtils.h"
+
+
+StatisticsCache::StatisticsCache(const QString &filename)
+{
+	hdu = 1;
+	alt = 0;
+	minpixel = maxpixel = 0;
+	vmin = vmax = lowerLimit = upperLimit = 0;
+	
+	// Derive the key from the file and the parameters the statistics depend on
+	QFileInfo info(filename);
+	QByteArray key;
+	QDataStream stream(&key, QIODevice::WriteOnly);
+	stream << (quint32) STATISTICS_CACHE_VERSION << (qint32) DOWNSAMPLE_SIZE;
+	stream << info.size() << info.lastModified().toTime_t();
+	stream << PinpointWCSUtils::fingerprint(filename);
+	
+	QString hex = QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex();
+	QString dir = QDesktopServices::storageLocation(QDesktopServices::CacheLocation) + "/statistics";
+	path = dir + "/" + hex;
+}
+
+
+StatisticsCache::~StatisticsCache()
+{}
+
+
+bool StatisticsCache::lookup()
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_4_6);
+	
+	qint32 h;
+	qint8 a;
+	in >> h >> a;
+	in >> minpixel >> maxpixel;
+	in >> vmin >> vmax >> lowerLimit >> upperLimit;
+	file.close();
+	
+	if (in.status() != QDataStream::Ok)
+		return false;
+	
+	hdu = h;
+	alt = a;
+	
+	qDebug() << "Using cached statistics from" << path;
+	return true;
+}
+
+
+bool StatisticsCache::store()
+{
+	QDir().mkpath(QFileInfo(path).absolutePath());
+	
+	// Write to a temporary file first so a concurrent reader never sees a partial entry
+	QString tmppath = path + ".tmp";
+	QFile file(tmppath);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_4_6);
+	out << (qint32) hdu << (qint8) alt;
+	out << minpixel << maxpixel;
+	out << vmin << vmax << lowerLimit << upperLimit;
+	file.close();
+	
+	if (out.status() != QDataStream::Ok)
+	{
+		QFile::remove(tmppath);
+		return false;
+	}
+	
+	QFile::remove(path);
+	return QFile::rename(tmppath, path);
+}
@@ -0,0 +1,52 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef STATISTICSCACHE_H
+#define STATISTICSCACHE_H
+
+#include <QString>
+
+#define STATISTICS_CACHE_VERSION 2
+
+// On-disk cache of the statistics FitsImage computes over a FITS file.
+// Entries are keyed by the size, modification time and fingerprint of the
+// file, so an edited or replaced file never picks up stale statistics.
+class StatisticsCache {
+	
+public:
+	StatisticsCache(const QString &filename);
+	~StatisticsCache();
+	
+	bool lookup();
+	bool store();
+	
+	// Which HDU and WCS alternate were chosen
+	int hdu;
+	char alt;
+	
+	// Statistics of the (possibly downsampled) image
+	float minpixel, maxpixel;
+	float vmin, vmax, lowerLimit, upperLimit;
+	
+private:
+	QString path;
+};
+
+#endif
@@ -0,0 +1,226 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QDebug>
+#include <QList>
+#include <QVector>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <limits>
+
+#include "TileReader.h"
+
+
+// Contiguous range of full width image rows, aligned to tile rows and,
+// when binning, to block rows
+struct TileBand {
+	fitsfile *fptr;
+	long y0, y1;
+	long width;
+	float *dest;
+	int binfactor;		// Block size, or 0 to read without binning
+	long chunkrows;		// Rows binned at a time, whole tile and block rows
+	int status;
+};
+
+
+// Read a band and average it in binfactor x binfactor blocks as
+// fits_read_img_binned does, a few tile rows at a time so the band is never
+// held at full resolution
+static void binBand(TileBand &band)
+{
+	long M = band.binfactor;
+	long nbx = (band.width + M - 1) / M;
+	long chunkrows = band.chunkrows;
+	long inc[2] = {1, 1};
+	float nulval = std::numeric_limits<float>::quiet_NaN();
+	
+	QVector<float> pix(chunkrows * band.width);
+	QVector<double> sum(nbx);
+	QVector<long> count(nbx);
+	
+	for (long y=band.y0; y <= band.y1; y += chunkrows)
+	{
+		long nrows = qMin(chunkrows, band.y1 - y + 1);
+		long blc[2] = {1, y};
+		long trc[2] = {band.width, y + nrows - 1};
+		if (fits_read_subset(band.fptr, TFLOAT, blc, trc, inc, &nulval, pix.data(), NULL, &band.status))
+			return;
+		
+		// Null pixels are read as NaN, and left out of the means
+		for (long jj=0; jj < nrows; jj += M)
+		{
+			sum.fill(0.);
+			count.fill(0);
+			for (long row=jj; row < qMin(jj + M, nrows); row++)
+			{
+				const float *p = pix.constData() + row * band.width;
+				for (long ii=0; ii < band.width; ii++)
+				{
+					if (p[ii] == p[ii])
+					{
+						sum[ii / M] += p[ii];
+						count[ii / M]++;
+					}
+				}
+			}
+			
+			float *out = band.dest + ((y - 1 + jj) / M) * nbx;
+			for (long bx=0; bx < nbx; bx++)
+				out[bx] = count[bx] ? (float) (sum[bx] / count[bx]) : nulval;
+		}
+	}
+}
+
+
+static void readBand(TileBand &band)
+{
+	if (band.binfactor)
+	{
+		binBand(band);
+		return;
+	}
+	
+	long blc[2] = {1, band.y0};
+	long trc[2] = {band.width, band.y1};
+	long inc[2] = {1, 1};
+	
+	fits_read_subset(band.fptr, TFLOAT, blc, trc, inc, NULL, band.dest + (band.y0 - 1) * band.width, NULL, &band.status);
+}
+
+
+TileReader::TileReader(const QString &fname, fitsfile *f, int h)
+{
+	filename = fname;
+	fptr = f;
+	hdu = h;
+	
+	int status = 0;
+	compressed = fits_is_compressed_image(fptr, &status);
+	tilewidth = tileheight = 1;
+	if (!compressed)
+		return;
+	
+	// Tiles default to one image row (ZTILE1 = NAXIS1, ZTILE2 = 1)
+	long znaxis1 = 0;
+	fits_read_key(fptr, TLONG, "ZNAXIS1", &znaxis1, NULL, &status);
+	tilewidth = znaxis1;
+	status = 0;
+	fits_read_key(fptr, TLONG, "ZTILE1", &tilewidth, NULL, &status);
+	status = 0;
+	fits_read_key(fptr, TLONG, "ZTILE2", &tileheight, NULL, &status);
+	if (tilewidth < 1 or tileheight < 1)
+		compressed = false;
+}
+
+
+TileReader::~TileReader()
+{}
+
+
+bool TileReader::isTiled()
+{
+	return compressed;
+}
+
+
+bool TileReader::read(float *dest, long width, long height, int *status)
+{
+	return readBands(dest, width, height, 0, status);
+}
+
+
+bool TileReader::readBinned(float *dest, int binfactor, int *status)
+{
+	long naxes[2] = {1, 1};
+	if (fits_get_img_size(fptr, 2, naxes, status))
+		return false;
+	
+	return readBands(dest, naxes[0], naxes[1], binfactor, status);
+}
+
+
+bool TileReader::readBands(float *dest, long width, long height, int binfactor, int *status)
+{
+	// Bands start on a tile row, and when binning on a block row as well
+	long unit = tileheight;
+	while (binfactor and unit % binfactor)
+		unit += tileheight;
+	long units = (height + unit - 1) / unit;
+	long chunkrows = unit * qMax(1L, 1048576 / (unit * width));
+	
+	// Read the first tile row on this thread.  Besides returning pixels, this
+	// initializes the lookup tables the decoders allocate on first use.
+	TileBand first = {fptr, 1, qMin(unit, height), width, dest, binfactor, chunkrows, 0};
+	readBand(first);
+	if (first.status)
+	{
+		*status = first.status;
+		return false;
+	}
+	if (units == 1)
+		return true;
+	
+	// cfitsio built without --enable-reentrant cannot be called from several
+	// threads at once, so read the rest of the image as a single band
+	if (!fits_is_reentrant())
+	{
+		TileBand rest = {fptr, unit + 1, height, width, dest, binfactor, chunkrows, 0};
+		readBand(rest);
+		*status = rest.status;
+		return *status == 0;
+	}
+	
+	// Divide the remaining tile rows into one band per thread
+	int nbands = qMin((long) QThread::idealThreadCount(), units - 1);
+	if (nbands < 1)
+		nbands = 1;
+	long unitsperband = (units - 1 + nbands - 1) / nbands;
+	
+	QList<TileBand> bands;
+	for (long row=1; row < units; row += unitsperband)
+	{
+		TileBand band = {NULL, row * unit + 1, qMin((row + unitsperband) * unit, height), width, dest, binfactor, chunkrows, 0};
+		
+		// Handles are opened and closed on this thread only, since cfitsio
+		// does not lock its table of open files unless built reentrant
+		fits_open_file(&band.fptr, filename.toStdString().c_str(), READONLY, &band.status);
+		fits_movabs_hdu(band.fptr, hdu, NULL, &band.status);
+		bands << band;
+		if (band.status)
+			break;
+	}
+	
+	if (!bands.last().status)
+	{
+		qDebug() << "Decompressing" << (height + tileheight - 1) / tileheight << "tile rows in" << bands.size() << "bands ...";
+		QtConcurrent::blockingMap(bands, readBand);
+	}
+	
+	for (int ii=0; ii < bands.size(); ii++)
+	{
+		int closestatus = 0;
+		if (bands[ii].status and !*status)
+			*status = bands[ii].status;
+		if (bands[ii].fptr)
+			fits_close_file(bands[ii].fptr, &closestatus);
+	}
+	
+	return *status == 0;
+}
@@ -0,0 +1,55 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEREADER_H
+#define TILEREADER_H
+
+#include <QString>
+
+// External libraries
+#include "fitsio.h"
+
+// Reads a tile compressed (fpack) image by decompressing bands of tile rows
+// concurrently.  Each band is read through its own read-only handle, which
+// cfitsio backs with an independent FITSfile and I/O buffers.  Bands are
+// only read concurrently if cfitsio was configured with --enable-reentrant.
+class TileReader {
+	
+public:
+	TileReader(const QString &filename, fitsfile *fptr, int hdu);
+	~TileReader();
+	
+	bool isTiled();
+	bool read(float *dest, long width, long height, int *status);
+	
+	// Same result as fits_read_img_binned, with the bands binned concurrently
+	bool readBinned(float *dest, int binfactor, int *status);
+	
+	long tilewidth, tileheight;
+	
+private:
+	QString filename;
+	fitsfile *fptr;
+	int hdu;
+	bool compressed;
+	
+	bool readBands(float *dest, long width, long height, int binfactor, int *status);
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QDebug>
+#include <QPainter>
+#include <QtAlgorithms>
+
+#include "CatalogOverlay.h"
+#include "math.h"
+
+struct CatalogStar {
+	int cell;
+	float mag;
+	int index;
+	bool operator<(const CatalogStar &other) const
+	{
+		return (cell < other.cell) or (cell == other.cell and mag < other.mag);
+	}
+};
+
+
+CatalogOverlay::CatalogOverlay(const QVector<QPointF> &pos, const QVector<float> &mag, const QRectF &rect, QGraphicsItem *parent)
+: QGraphicsItem(parent)
+{
+	qDebug() << "Initializing CatalogOverlay object ...";
+	bounds = rect;
+	int n = pos.size();
+	
+	// Choose a cell size giving a handful of stars per cell
+	cellSize = sqrt(bounds.width() * bounds.height() * CATALOG_CELL_STARS / qMax(n, 1));
+	cellSize = qMax(cellSize, 32.0f);
+	ncols = qMax(1, int(ceil(bounds.width() / cellSize)));
+	nrows = qMax(1, int(ceil(bounds.height() / cellSize)));
+	
+	// Sort the stars by cell, and by magnitude within each cell
+	QVector<CatalogStar> stars(n);
+	float brightest = 0, faintest = 0;
+	for (int i=0; i<n; i++)
+	{
+		int col = qBound(0, int((pos[i].x() - bounds.left()) / cellSize), ncols-1);
+		int row = qBound(0, int((pos[i].y() - bounds.top()) / cellSize), nrows-1);
+		stars[i].cell = row*ncols + col;
+		stars[i].mag = mag[i];
+		stars[i].index = i;
+		if (i == 0 or mag[i] < brightest)
+			brightest = mag[i];
+		if (i == 0 or mag[i] > faintest)
+			faintest = mag[i];
+	}
+	qSort(stars);
+	
+	// Brighter stars get larger markers, from 2 to 7 screen pixels
+	float range = qMax(faintest - brightest, 1.0f);
+	positions.resize(n);
+	radii.resize(n);
+	cellStart.fill(n, ncols*nrows + 1);
+	for (int i=n-1; i>=0; i--)
+	{
+		positions[i] = pos[stars[i].index];
+		radii[i] = 2 + 5 * (faintest - stars[i].mag) / range;
+		cellStart[stars[i].cell] = i;
+	}
+	
+	// Empty cells start where the next occupied cell does
+	for (int k=ncols*nrows-1; k>=0; k--)
+		if (cellStart[k] > cellStart[k+1])
+			cellStart[k] = cellStart[k+1];
+	
+	setZValue(1);
+	setFlag(QGraphicsItem::ItemIsSelectable, false);
+	setFlag(QGraphicsItem::ItemIsMovable, false);
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+	setAcceptedMouseButtons(Qt::NoButton);
+}
+
+
+CatalogOverlay::~CatalogOverlay() {}
+
+
+QRectF CatalogOverlay::boundingRect() const
+{
+	return bounds;
+}
+
+
+QPainterPath CatalogOverlay::shape() const
+{
+	// Never the target of a click, so markers beneath stay easy to pick
+	return QPainterPath();
+}
+
+
+void CatalogOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+	Q_UNUSED(widget);
+	if (positions.isEmpty())
+		return;
+	
+	qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+	QRectF exposed = option->exposedRect.intersected(bounds);
+	if (lod <= 0 or exposed.isEmpty())
+		return;
+	
+	// Only the cells overlapping the exposed rect are visited
+	int col1 = qBound(0, int((exposed.left() - bounds.left()) / cellSize), ncols-1);
+	int col2 = qBound(0, int((exposed.right() - bounds.left()) / cellSize), ncols-1);
+	int row1 = qBound(0, int((exposed.top() - bounds.top()) / cellSize), nrows-1);
+	int row2 = qBound(0, int((exposed.bottom() - bounds.top()) / cellSize), nrows-1);
+	
+	// Thin by magnitude: each cell draws its brightest stars, about one
+	// per CATALOG_SPACING square of screen pixels it covers
+	float side = cellSize * lod / CATALOG_SPACING;
+	int allowed = qMax(1, int(side*side));
+	
+	QPen pen(QColor(0, 255, 255));
+	pen.setCosmetic(true);
+	painter->setPen(pen);
+	painter->setBrush(Qt::NoBrush);
+	
+	for (int row=row1; row<=row2; row++)
+		for (int col=col1; col<=col2; col++)
+		{
+			int k = row*ncols + col;
+			int last = qMin(cellStart[k+1], cellStart[k] + allowed);
+			for (int i=cellStart[k]; i<last; i++)
+			{
+				qreal r = radii[i] / lod;
+				painter->drawEllipse(positions[i], r, r);
+			}
+		}
+}
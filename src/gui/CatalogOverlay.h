@@ -0,0 +1,58 @@
+/*
+ *  PinpointWCS is developed by the Chandra X-ray Center
+ *  Education and Public Outreach Group
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CATALOG_OVERLAY_H
+#define CATALOG_OVERLAY_H
+
+#include <QGraphicsItem>
+#include <QStyleOptionGraphicsItem>
+#include <QVector>
+
+#define CATALOG_CELL_STARS 16	// Average number of stars per grid cell
+#define CATALOG_SPACING 14		// Closest screen spacing of drawn stars, in pixels
+
+// Every star of a reference catalog drawn by one item.  Stars are binned in
+// a grid over the image, brightest first within each cell, so painting only
+// visits the cells in the exposed rect and, when zoomed out, draws just the
+// brightest few stars of each cell.
+class CatalogOverlay : public QGraphicsItem
+{
+	
+public:
+	enum {Type = UserType + 2};
+	CatalogOverlay(const QVector<QPointF> &pos, const QVector<float> &mag, const QRectF &rect, QGraphicsItem *parent = 0);
+	~CatalogOverlay();
+	
+	// Required methods to implement
+	QRectF boundingRect() const;
+	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+	QPainterPath shape() const;
+	int type() const { return Type; }
+	
+private:
+	QRectF bounds;
+	float cellSize;
+	int ncols, nrows;
+	QVector<int> cellStart;		// Index of first star in each cell, and one past the last
+	QVector<QPointF> positions;	// Stars sorted by cell, then by magnitude
+	QVector<float> radii;		// Marker radius in screen pixels
+	
+};
+
+#endif
@@ -28,6 +28,7 @@ GraphicsScene::GraphicsScene(QPixmap *pix, bool ref, QObject *parent)
 {
 	reference = ref;
 	movingItem = 0;
+	catalogOverlay = 0;
 	setSceneRect(0, 0, pix->width(), pix->height());	
 	ptr_pixmap = addPixmap(*pix);
 	
@@ -145,6 +146,24 @@ void GraphicsScene::signalItemMoved(CoordinateMarker *m, QPointF oldPos)
 }
 
 
+void GraphicsScene::setCatalog(const QVector<QPointF> &pos, const QVector<float> &mag)
+{
+	// Reference stars are drawn by one item over the pixmap, beneath the markers
+	clearCatalog();
+	catalogOverlay = new CatalogOverlay(pos, mag, sceneRect(), ptr_pixmap);
+}
+
+
+void GraphicsScene::clearCatalog()
+{
+	if (catalogOverlay)
+	{
+		delete catalogOverlay;
+		catalogOverlay = 0;
+	}
+}
+
+
 float GraphicsScene::computeRadii()
 {	
 	// Use the measure and zoom factor to determine the radius in a
@@ -23,6 +23,7 @@
 #include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
 #include "CoordinateMarker.h"
+#include "CatalogOverlay.h"
 #include "GraphicsView.h"
 
 class GraphicsScene : public QGraphicsScene
@@ -37,6 +38,8 @@ public:
 	QGraphicsRectItem *centralItem;
 	bool clickable;
 	void signalItemMoved(CoordinateMarker *m, QPointF oldPos);
+	void setCatalog(const QVector<QPointF> &pos, const QVector<float> &mag);
+	void clearCatalog();
 		
 protected:
 	void mouseMoveEvent(QGraphicsSceneMouseEvent* event);
@@ -50,6 +53,7 @@ private:
 	QPointF oldPos;
 	QGraphicsItem *movingItem;
 	QGraphicsPixmapItem *ptr_pixmap;
+	CatalogOverlay *catalogOverlay;
 	
 	float computeRadii();
 	
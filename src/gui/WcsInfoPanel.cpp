@@ -21,6 +21,7 @@
 #include <QPalette>
 
 #include "WcsInfoPanel.h"
+#include "FitsImage.h"
 
 WcsInfoPanel::WcsInfoPanel(bool ref, QWidget *parent)
 : QFrame(parent)
@@ -57,6 +58,8 @@ WcsInfoPanel::WcsInfoPanel(bool ref, QWidget *parent)
 	{
 		ui.misc1->setText("Orientation:");
 		ui.misc1_input2->clear();
+		ui.checksum->hide();
+		ui.checksum_input->hide();
 	}
 }
 
@@ -86,6 +89,8 @@ void WcsInfoPanel::updateFontSize(QFont font)
     ui.ctype->setFont(font);
     ui.ctype1_input->setFont(font);
     ui.ctype2_input->setFont(font);
+    ui.checksum->setFont(font);
+    ui.checksum_input->setFont(font);
 }
 
 
@@ -141,6 +146,27 @@ void WcsInfoPanel::loadWCS(struct WorldCoor* wcs, double rms_x, double rms_y)
 }
 
 
+void WcsInfoPanel::setChecksum(int checksum)
+{
+	// Report the outcome of verifying CHECKSUM and DATASUM on open
+	switch (checksum)
+	{
+		case CHECKSUM_VALID:
+			ui.checksum_input->setText("Valid");
+			break;
+		case CHECKSUM_INVALID:
+			ui.checksum_input->setText("Invalid");
+			break;
+		case CHECKSUM_MISSING:
+			ui.checksum_input->setText("None");
+			break;
+		default:
+			ui.checksum_input->setText("-");
+			break;
+	}
+}
+
+
 void WcsInfoPanel::clear()
 {
 	ui.radesys_input->setText("-");
@@ -156,6 +182,7 @@ void WcsInfoPanel::clear()
 	ui.misc1_input1->setText("-");
 	ui.misc2_input1->setText("-");
 	ui.misc2_input2->setText("-");	
+	ui.checksum_input->setText("-");
 	if (reference)
 		ui.misc1_input2->setText("-");
 
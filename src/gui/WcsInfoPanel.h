@@ -34,6 +34,7 @@ class WcsInfoPanel : public QFrame
 		WcsInfoPanel(bool ref, QWidget *parent = 0);
 		~WcsInfoPanel();
 		void loadWCS(struct WorldCoor* wcs, double rms_x = NULL, double rms_y = NULL);
+		void setChecksum(int checksum);
 		void clear();
 		
 	public slots:
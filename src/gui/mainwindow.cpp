@@ -58,6 +58,17 @@ MainWindow::MainWindow()
 	connect(ui.dropLabel_2, SIGNAL(readyForImport()), this, SLOT(setupImages()));
 	connect(ui.actionAbout_PinpointWCS, SIGNAL(triggered(bool)), aboutDialog, SLOT(exec()));
 	connect(ui.actionPinpointWCSHelp, SIGNAL(triggered(bool)), this, SLOT(getHelp()));
+	connect(ui.actionEmbed_Sidecars, SIGNAL(triggered(bool)), this, SLOT(embedSidecars()));
+	connect(ui.actionReference_Catalog, SIGNAL(triggered(bool)), this, SLOT(loadReferenceCatalog()));
+	
+	// Checksum verification on open is a saved preference
+	QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
+	ui.actionVerify_Checksums->setChecked(settings.value("verifychecksums", false).toBool());
+	connect(ui.actionVerify_Checksums, SIGNAL(toggled(bool)), this, SLOT(setVerifyChecksums(bool)));
+	
+	connect(ui.actionOpen_Session, SIGNAL(triggered(bool)), this, SLOT(openSession()));
+	connect(ui.actionSave_Session, SIGNAL(triggered(bool)), this, SLOT(saveSession()));
+	session = NULL;
 	
 //	connect(this, SIGNAL(objectResized(QSize)), helpPanel, SLOT(parentResized(QSize)));
 //	connect(this, SIGNAL(objectResized(QSize)), this, SLOT(updateHelpPanelProperties()));
@@ -128,6 +139,7 @@ bool MainWindow::teardownWorkspace()
 	disconnect(ui.actionAVM, SIGNAL(triggered(bool)), exportwcs, SLOT(exportAVMClean()));
 	disconnect(ui.actionDetailed_AVM, SIGNAL(triggered(bool)), exportwcs, SLOT(exportAVMDetailed()));
         disconnect(ui.actionXMP_Packet, SIGNAL(triggered(bool)), exportwcs, SLOT(exportXMP()));
+	disconnect(ui.actionAVM_Sidecar, SIGNAL(triggered(bool)), exportwcs, SLOT(exportAVMSidecar()));
 
 	// And more signals ...
 	disconnect(ui.actionCoordinate_Table, SIGNAL(triggered(bool)), coordinateTableDialog, SLOT(toggle()));
@@ -172,6 +184,9 @@ bool MainWindow::teardownWorkspace()
 	ui.actionRotate_Clockwise->setEnabled(false);
 	ui.actionRotate_Counterclockwise->setEnabled(false);
 	
+	// Disable Advanced Menu items
+	ui.actionReference_Catalog->setEnabled(false);
+	
 	// Deconstruct the undostack and data model
 	ui.menuEdit->removeAction(redoAction);
 	ui.menuEdit->removeAction(undoAction);
@@ -204,6 +219,8 @@ bool MainWindow::teardownWorkspace()
 	
 	// Disable from menu
 	ui.actionNew_Workspace->setEnabled(false);
+	ui.actionSave_Session->setEnabled(false);
+	ui.actionOpen_Session->setEnabled(true);
 	
 	return true;
 }
@@ -289,6 +306,9 @@ bool MainWindow::setupWorkspace()
 	ui.actionRotate_Counterclockwise->setEnabled(true);
 	ui.actionCentroid->setEnabled(true);
 	
+	// Reference stars can be overlaid when the FITS image has a WCS
+	ui.actionReference_Catalog->setEnabled(fitsImage->wcs != NULL);
+	
 	// Set up the WcsInfoPanel for each image
 	fitsWcsInfoPanel->parentResized(ui.graphicsView_1->size());
 	epoWcsInfoPanel->parentResized(ui.graphicsView_2->size());
@@ -303,6 +323,7 @@ bool MainWindow::setupWorkspace()
 	epoCoordPanel->show();
 	buildCoordPanelMachine();
 	fitsWcsInfoPanel->loadWCS(fitsImage->wcs);
+	fitsWcsInfoPanel->setChecksum(fitsImage->checksum);
 	
 	// Set up the FitsToolbar, set range and value for sliders
 	fitsToolbar->setExtremals(fitsImage->lowerLimit, fitsImage->upperLimit);
@@ -358,6 +379,7 @@ bool MainWindow::setupWorkspace()
 	connect(ui.actionAVM, SIGNAL(triggered(bool)), exportwcs, SLOT(exportAVMClean()));
 	connect(ui.actionDetailed_AVM, SIGNAL(triggered(bool)), exportwcs, SLOT(exportAVMDetailed()));
         connect(ui.actionXMP_Packet, SIGNAL(triggered(bool)), exportwcs, SLOT(exportXMP()));
+	connect(ui.actionAVM_Sidecar, SIGNAL(triggered(bool)), exportwcs, SLOT(exportAVMSidecar()));
 	
 	// And more signals ...
 	connect(ui.actionCoordinate_Table, SIGNAL(triggered(bool)), coordinateTableDialog, SLOT(toggle()));
@@ -385,8 +407,10 @@ bool MainWindow::setupWorkspace()
 	connect(fitsImage, SIGNAL(centroid(QPointF)), this, SLOT(updateWithCentroid(QPointF)));
 	connect(ui.actionOpen_in_DS9, SIGNAL(triggered()), this, SLOT(openDS9()));
 	
-	// Enable the teardown menu item
+	// Enable the teardown and session menu items
 	ui.actionNew_Workspace->setEnabled(true);
+	ui.actionSave_Session->setEnabled(true);
+	ui.actionOpen_Session->setEnabled(false);
 	
 	// Scan preference file to set the WCS format
 	QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
@@ -399,6 +423,10 @@ bool MainWindow::setupWorkspace()
 	// TODO: Testing coordinate info panel by setting some markers for the M101 data
         //testIIII();
 	
+	// Replay the markers of a restored session
+	if (session)
+		restoreSession();
+	
 	return true;
 }
 
@@ -450,6 +478,11 @@ bool MainWindow::startFITSThread(QString &filename)
 	fitsThread = new FITSThread();
 	connect(fitsThread, SIGNAL(finished()), this, SLOT(loadFITSImage()));
 	fitsImage = new FitsImage(filename);
+	
+	// Reuse the display levels of a restored session
+	if (session)
+		fitsImage->restoreLevels(session->stretch, session->vmin, session->vmax, session->lowerLimit, session->upperLimit);
+	
 	fitsThread->setup(fitsImage);
 	fitsThread->start();
 
@@ -710,6 +743,7 @@ void MainWindow::enableExport()
 		ui.actionFITS_Image->setEnabled(true);
 		ui.actionDetailed_AVM->setEnabled(true);
                 ui.actionXMP_Packet->setEnabled(true);
+		ui.actionAVM_Sidecar->setEnabled(true);
 		
 		// Create EPO WCS object and load WCS to panel and export object
 		epoImage->wcs = computewcs->initTargetWCS();
@@ -723,6 +757,7 @@ void MainWindow::enableExport()
 		ui.actionFITS_Image->setEnabled(false);
 		ui.actionDetailed_AVM->setEnabled(false);
                 ui.actionXMP_Packet->setEnabled(false);
+		ui.actionAVM_Sidecar->setEnabled(false);
 
 		// Disable prediction of EPO coordinate
 		ui.actionFit_Point->setEnabled(false);
@@ -846,6 +881,131 @@ void MainWindow::resizeEvent(QResizeEvent *event)
 }
 
 
+void MainWindow::setVerifyChecksums(bool verify)
+{
+	// Read by FitsImage the next time a FITS image is opened
+	QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
+	settings.setValue("verifychecksums", verify);
+}
+
+
+void MainWindow::embedSidecars()
+{
+	QString manifest = QFileDialog::getOpenFileName(this, "Embed AVM Sidecars", QDir::homePath(), QString("Manifest(%1)").arg(SIDECAR_MANIFEST));
+	if (manifest.isEmpty())
+		return;
+	
+	int embedded = ExportWCS::embedSidecars(manifest);
+	if (embedded < 0)
+		QMessageBox::warning(this, "Embed AVM Sidecars", "The manifest could not be processed.");
+	else
+		QMessageBox::information(this, "Embed AVM Sidecars", QString("%1 sidecar(s) embedded.").arg(embedded));
+}
+
+
+void MainWindow::loadReferenceCatalog()
+{
+	// Catalog names known to libwcs or a path to a local catalog file
+	QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
+	bool ok;
+	QString name = QInputDialog::getText(this, "Reference Catalog",
+										 "Catalog name (ucac3, tycho2, tmc, ...) or file, empty to remove:",
+										 QLineEdit::Normal, settings.value("referencecatalog").toString(), &ok);
+	if (!ok)
+		return;
+	
+	name = name.trimmed();
+	if (name.isEmpty())
+	{
+		fitsScene->clearCatalog();
+		return;
+	}
+	
+	ReferenceCatalog catalog;
+	if (!catalog.load(name, fitsImage))
+	{
+		QMessageBox::warning(this, "Reference Catalog", QString("The catalog %1 could not be read.").arg(name));
+		return;
+	}
+	settings.setValue("referencecatalog", name);
+	fitsScene->setCatalog(catalog.positions, catalog.magnitudes);
+	statusBar()->showMessage(QString("%1: %2 stars on the image").arg(catalog.title).arg(catalog.positions.size()), 5000);
+}
+
+
+void MainWindow::openSession()
+{
+	QString path = QFileDialog::getOpenFileName(this, "Open Session", QDir::homePath(), QString("Sessions(*.%1)").arg(SESSION_EXTENSION));
+	if (path.isEmpty())
+		return;
+	
+	Session *s = new Session;
+	if (!s->load(path) || !s->verify())
+	{
+		QMessageBox::warning(this, "Open Session", "The session could not be restored.  Check that its images have not been moved or modified.");
+		delete s;
+		return;
+	}
+	session = s;
+	
+	// Stand in for the user dropping both images
+	ui.dropLabel_1->filepath = session->fitsPath;
+	ui.dropLabel_1->setText(session->fitsPath.split("/").last());
+	ui.dropLabel_1->ready = true;
+	ui.dropLabel_2->filepath = session->epoPath;
+	ui.dropLabel_2->setText(session->epoPath.split("/").last());
+	ui.dropLabel_2->ready = true;
+	setupImages();
+}
+
+
+void MainWindow::restoreSession()
+{
+	// Check the stretch the session was saved with
+	QList<QAction*> stretches = stretchActionGroup->actions();
+	if (session->stretch >= 0 && session->stretch < stretches.size())
+		stretches.at(session->stretch)->setChecked(true);
+	
+	// Replay the correspondence pairs through the data model
+	for (int i=0; i < session->refCoords.size(); i++)
+	{
+		dataModel->setData(fitsScene, session->refCoords.at(i));
+		if (session->epoCoords.at(i) != QPointF(-1, -1))
+			dataModel->setData(epoScene, session->epoCoords.at(i));
+	}
+	
+	delete session;
+	session = NULL;
+}
+
+
+void MainWindow::saveSession()
+{
+	QString path = QFileDialog::getSaveFileName(this, "Save Session", ui.dropLabel_2->filepath+"."+SESSION_EXTENSION, QString("Sessions(*.%1)").arg(SESSION_EXTENSION));
+	if (path.isEmpty())
+		return;
+	
+	Session s;
+	s.fitsPath = ui.dropLabel_1->filepath;
+	s.epoPath = ui.dropLabel_2->filepath;
+	s.refCoords = dataModel->refCoords;
+	s.epoCoords = dataModel->epoCoords;
+	s.stretch = fitsImage->stretch;
+	s.vmin = fitsImage->vmin;
+	s.vmax = fitsImage->vmax;
+	s.lowerLimit = fitsImage->lowerLimit;
+	s.upperLimit = fitsImage->upperLimit;
+	s.M = fitsImage->M;
+	s.wcsheader = fitsImage->wcsheader;
+	s.alt = fitsImage->alt;
+	s.width = epoImage->pixmap->width();
+	s.height = epoImage->pixmap->height();
+	
+	if (!s.save(path))
+		QMessageBox::warning(this, "Save Session", "The session could not be saved.");
+}
+
+
 void MainWindow::getHelp()
 {
 	QDesktopServices::openUrl(QUrl("https://www.cfa.harvard.edu/~akapadia/pinpointwcs/"));
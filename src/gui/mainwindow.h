@@ -29,6 +29,7 @@
 #include <QSettings>
 #include <QDesktopServices>
 #include <QUrl>
+#include <QInputDialog>
 //#include <QtNetwork>
 
 #include "ui_PinpointWCS.h"
@@ -48,6 +49,8 @@
 #include "MessageBox.h"
 #include "FITSThread.h"
 #include "DS9Thread.h"
+#include "Session.h"
+#include "ReferenceCatalog.h"
 //#include "HelpPanel.h"
  
 class MainWindow : public QMainWindow
@@ -95,6 +98,9 @@ private:
 	ComputeWCS *computewcs;
 	ExportWCS *exportwcs;
 	
+	// Session being restored, if any
+	Session *session;
+	
 	// State Machines Attributes
 //	QStateMachine *HelpPanelMachine;
 //	QState *HelpPanelOn;
@@ -144,6 +150,7 @@ private:
 	void teardownCoordPanelMachine();
 	void teardownImageAdjustmentMachine();
 	void resizeEvent(QResizeEvent *event);
+	void restoreSession();
 	
 private slots:
 	bool setupImages();
@@ -163,6 +170,11 @@ private slots:
 	void updateWithCentroid(QPointF pos);
 	void openDS9();
 	void closeDS9();
+	void embedSidecars();
+	void setVerifyChecksums(bool verify);
+	void loadReferenceCatalog();
+	void openSession();
+	void saveSession();
 	void getHelp();
 	
 	// A slots for testing ...
@@ -18,6 +18,8 @@
  */
 
 #include <QApplication>
+#include <QCoreApplication>
+#include <iostream>
 #include "mainwindow.h"
 #include <time.h>
 #include "version.h"
@@ -33,6 +35,33 @@ int main(int argc, char *argv[])
 	std::cout << seconds << std::endl;
 	*/
 	
+	// Headless mode: embed AVM sidecars listed in a manifest and exit
+	if (argc == 3 && QString(argv[1]) == "--embed-sidecars")
+	{
+		QCoreApplication batch(argc, argv);
+		int embedded = ExportWCS::embedSidecars(QString(argv[2]));
+		if (embedded < 0)
+		{
+			std::cerr << "Could not process manifest " << argv[2] << std::endl;
+			return 1;
+		}
+		std::cout << embedded << " sidecar(s) embedded" << std::endl;
+		return 0;
+	}
+	
+	// Headless mode: export an AVM sidecar from a saved session and exit
+	if (argc == 3 && QString(argv[1]) == "--export-session")
+	{
+		QCoreApplication batch(argc, argv);
+		Session session;
+		if (!session.load(QString(argv[2])) || !session.verify())
+		{
+			std::cerr << "Could not restore session " << argv[2] << std::endl;
+			return 1;
+		}
+		return session.exportSidecar() ? 0 : 1;
+	}
+	
 	// Initialize application
 	QApplication app(argc, argv);
 	app.setApplicationName("PinpointWCS");